@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../include/zkl.h"
+
+// Library API benchmark: compiles small programs over and over through one
+// compiler, as a server embedding zkl would, and reports the time per
+// compilation of a valid program and of one with an error.
+//
+// Usage: bench_api [compilations] [statements]
+
+// Helper to read the monotonic clock
+static double now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to build a program of `statements` products
+static char* make_source(long statements, const char* tail) {
+    size_t capacity = 64 + statements * 48 + strlen(tail);
+    char* source = malloc(capacity);
+    size_t length = snprintf(source, capacity, "public y\ninput x0\ninput x1\nv0 = x0 * x1\n");
+    for (long i = 1; i < statements; i++) {
+        length += snprintf(source + length, capacity - length, "v%ld = v%ld * v%ld + %ld * x%ld\n", i, i - 1,
+                           i / 2, i % 7 + 1, i % 2);
+    }
+    snprintf(source + length, capacity - length, "assert(v%ld == y)\noutput v%ld\n%s", statements - 1,
+             statements - 1, tail);
+    return source;
+}
+
+// Helper to time `count` compilations of a program
+static void run(ZklCompiler* compiler, const char* what, const char* source, long count, ZklStatus expected) {
+    size_t length = strlen(source);
+    zkl_compile(compiler, source, length, NULL);
+    double start = now();
+    for (long i = 0; i < count; i++) {
+        if (zkl_compile(compiler, source, length, NULL) != expected) {
+            printf("%s: unexpected status\n", what);
+            exit(1);
+        }
+    }
+    double seconds = now() - start;
+    printf("%-8s %6ld compilations of %zu bytes: %8.2f us each, %.1f MiB/s\n", what, count, length,
+           seconds / count * 1e6, (double)length * count / seconds / (1 << 20));
+}
+
+int main(int argc, char** argv) {
+    long count = argc > 1 ? atol(argv[1]) : 20000;
+    long statements = argc > 2 ? atol(argv[2]) : 20;
+    char* valid = make_source(statements, "");
+    char* broken = make_source(statements, "w = v0 * undefined\n");
+    ZklCompiler* compiler = zkl_compiler_create();
+    run(compiler, "valid", valid, count, ZKL_OK);
+    run(compiler, "error", broken, count, ZKL_ERROR_SOURCE);
+    zkl_compiler_free(compiler);
+    free(valid);
+    free(broken);
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../src/driver/batch.h"
+
+// Batch compilation benchmark: writes a directory of circuits of uneven
+// sizes, then compiles it on one thread and on every CPU (or the given
+// number of threads).
+//
+// Usage: bench_batch [files] [statements in the largest file] [threads]
+
+// Helper to write a source of `statements` products reading near and far
+// predecessors
+static void write_source(const char* path, long statements) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        perror(path);
+        exit(1);
+    }
+    fprintf(file, "public y\ninput x0\ninput x1\nv0 = x0 * x1\n");
+    for (long i = 1; i < statements; i++) {
+        fprintf(file, "v%ld = v%ld * v%ld + %ld * x%ld\n", i, i - 1, i / 2, i % 7 + 1, i % 2);
+    }
+    fprintf(file, "assert(v%ld == y)\noutput v%ld\n", statements - 1, statements - 1);
+    fclose(file);
+}
+
+// Helper to compile the directory and report the totals
+static void run(const char* what, int threads, BatchFile* files, uint32_t count) {
+    BatchOptions options = {threads, 0, NULL};
+    BatchSummary summary;
+    compile_batch(&options, files, count, &summary);
+    printf("%-10s %2d threads: %7.3f s wall, %7.3f s compiling (%.2fx), %.1f MiB/s, %llu constraints%s\n", what,
+           summary.threads, summary.seconds, summary.busy_seconds, summary.busy_seconds / summary.seconds,
+           summary.source_bytes / summary.seconds / (1 << 20), (unsigned long long)summary.constraints,
+           summary.failed ? " (FAILED)" : "");
+}
+
+int main(int argc, char** argv) {
+    long count = argc > 1 ? atol(argv[1]) : 200;
+    long largest = argc > 2 ? atol(argv[2]) : 50000;
+    int threads = argc > 3 ? atoi(argv[3]) : 0;
+    char dir[64];
+    snprintf(dir, sizeof(dir), "/tmp/bench_batch_%ld", (long)getpid());
+    mkdir(dir, 0700);
+
+    // Sizes follow 1/rank, like a release with a few big circuits and many
+    // small ones
+    char** sources = NULL;
+    uint32_t found = 0;
+    for (long i = 0; i < count; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/circuit%04ld.zkl", dir, i);
+        write_source(path, largest / (i % 37 + 1) + 1);
+    }
+    batch_add_sources(&sources, &found, dir);
+    BatchFile* files = calloc(found, sizeof(BatchFile));
+    for (uint32_t i = 0; i < found; i++) {
+        files[i].source = sources[i];
+        files[i].circuit = batch_circuit_path(sources[i], NULL);
+    }
+
+    run("serial", 1, files, found);
+    run("parallel", threads, files, found);
+
+    for (uint32_t i = 0; i < found; i++) {
+        remove(files[i].circuit);
+        remove(sources[i]);
+        free((char*)files[i].circuit);
+        free(sources[i]);
+    }
+    free(sources);
+    free(files);
+    rmdir(dir);
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/backend/constraint_checker.h"
+#include "../src/backend/witness_generator.h"
+#include "synthetic.h"
+
+// Constraint checker benchmark: builds a circuit of N statements directly
+// as IR (like bench_witness), computes one witness, then checks it against
+// the constraints with 1, 2, 4, ... threads up to the CPU count.
+//
+// Usage: bench_check [statements]
+
+#define INPUTS 8
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    long statements = argc > 1 ? atol(argv[1]) : 1000000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    IRProgram* program = (IRProgram*)arena_calloc(&ctx.arena, 1, sizeof(IRProgram));
+    program->capacity = (uint32_t)(statements * 3 + INPUTS + 2);
+    program->instrs = (IRInstruction*)arena_alloc(&ctx.arena, sizeof(IRInstruction) * program->capacity);
+    program->locations = (IRLocation*)arena_alloc(&ctx.arena, sizeof(IRLocation) * program->capacity);
+    field_pool_init(&program->constants, &ctx.arena);
+
+    // v[i] = 3 * (v[i - 1] * v[i / 2] + x[i % INPUTS]): one product and two
+    // linear operations per statement
+    FieldElement three;
+    field_from_u64(ctx.field, &three, 3);
+    ValueId constant = ir_add_constant(&ctx, program, &three);
+    ValueId* v = malloc(sizeof(ValueId) * (statements + 1));
+    ValueId inputs[INPUTS];
+    for (int k = 0; k < INPUTS; k++) {
+        inputs[k] = synthetic_instruction(program, k == 0 ? IR_OP_PUBLIC : IR_OP_INPUT, SYMBOL_NONE, IR_NO_VALUE,
+                                          IR_NO_VALUE);
+    }
+    v[0] = inputs[0];
+    for (long i = 1; i <= statements; i++) {
+        ValueId product = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, v[i - 1], v[i / 2]);
+        ValueId sum = synthetic_instruction(program, IR_OP_ADD, SYMBOL_NONE, product, inputs[i % INPUTS]);
+        v[i] = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, sum, constant);
+    }
+    free(v);
+
+    R1CS* r1cs = compile_constraints(&ctx, program);
+    WitnessPlan* plan = witness_plan_create(&ctx, program, r1cs);
+    FieldElement assignment[INPUTS];
+    for (int k = 0; k < INPUTS; k++) field_from_u64(ctx.field, &assignment[k], 2 + k);
+    FieldElement* witness = malloc(sizeof(FieldElement) * r1cs->variable_count);
+    FieldElement* scratch = malloc(sizeof(FieldElement) * witness_scratch_size(plan));
+    if (!witness || !scratch || witness_generate(&ctx, plan, assignment, witness, scratch) != WITNESS_OK) {
+        fprintf(stderr, "Error: Could not compute the witness.\n");
+        return 1;
+    }
+    free(scratch);
+    uint32_t nonzeros = r1cs->a.nonzeros + r1cs->b.nonzeros + r1cs->c.nonzeros;
+    printf("check: %u constraints, %u variables, %u nonzeros\n", r1cs->constraint_count, r1cs->variable_count,
+           nonzeros);
+
+    ConstraintViolation violations[4];
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int threads = 1; threads <= (cpus > 1 ? cpus : 1); threads *= 2) {
+        ThreadPool* pool = thread_pool_create(threads);
+        double t0 = now_seconds();
+        uint32_t violated = check_constraints(ctx.field, r1cs, pool, witness, violations, 4);
+        double t1 = now_seconds();
+        printf("check: %2d threads: %.3f s (%.2f M constraints/s, %.1f ns/nonzero per core), %u violated\n",
+               threads, t1 - t0, r1cs->constraint_count / (t1 - t0) / 1e6,
+               (t1 - t0) * threads / nonzeros * 1e9, violated);
+        thread_pool_destroy(pool);
+    }
+
+    // A corrupted variable breaks the constraints that use it
+    field_add(ctx.field, &witness[r1cs->variable_count / 2], &witness[r1cs->variable_count / 2], &ctx.field->one);
+    ThreadPool* pool = thread_pool_create(0);
+    uint32_t violated = check_constraints(ctx.field, r1cs, pool, witness, violations, 4);
+    printf("check: corrupted variable %u: %u violated, first at constraint %u\n", r1cs->variable_count / 2,
+           violated, violated ? violations[0].constraint : 0);
+    thread_pool_destroy(pool);
+
+    free(witness);
+    context_free(&ctx);
+    return 0;
+}
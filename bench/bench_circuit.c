@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/backend/circuit_file.h"
+#include "synthetic.h"
+
+// Circuit file benchmark: builds an IR program with N products directly
+// (like bench_r1cs), lowers it, writes it as a circuit file and times
+// loading it back, both the load itself and a first pass over every
+// nonzero of the mapped matrices.
+//
+// Usage: bench_circuit [constraints] [path]
+
+#define INPUTS 8
+#define RELOADS 100
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to touch every nonzero of a matrix, as a prover's first pass would
+static uint64_t checksum(const SparseMatrix* matrix) {
+    uint64_t sum = 0;
+    for (uint32_t k = 0; k < matrix->nonzeros; k++) sum += matrix->columns[k] ^ matrix->coefficients[k];
+    return sum;
+}
+
+int main(int argc, char** argv) {
+    long constraints = argc > 1 ? atol(argv[1]) : 1000000;
+    char default_path[64];
+    snprintf(default_path, sizeof(default_path), "/tmp/bench_circuit_%ld.zklc", (long)getpid());
+    const char* path = argc > 2 ? argv[2] : default_path;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    IRProgram* program = (IRProgram*)arena_calloc(&ctx.arena, 1, sizeof(IRProgram));
+    program->capacity = (uint32_t)(constraints * 3 + INPUTS);
+    program->instrs = (IRInstruction*)arena_alloc(&ctx.arena, sizeof(IRInstruction) * program->capacity);
+    program->locations = (IRLocation*)arena_alloc(&ctx.arena, sizeof(IRLocation) * program->capacity);
+    field_pool_init(&program->constants, &ctx.arena);
+
+    // v[i] = 3 * (v[i - 1] * v[i / 2] + x[i % INPUTS]), every product named
+    FieldElement three;
+    field_from_u64(ctx.field, &three, 3);
+    ValueId constant = ir_add_constant(&ctx, program, &three);
+    ValueId* v = malloc(sizeof(ValueId) * (constraints + 1));
+    ValueId inputs[INPUTS];
+    char name[32];
+    for (int k = 0; k < INPUTS; k++) {
+        snprintf(name, sizeof(name), "x%d", k);
+        inputs[k] = synthetic_instruction(program, k == 0 ? IR_OP_PUBLIC : IR_OP_INPUT,
+                                          intern_cstr(&ctx.symbols, name), IR_NO_VALUE, IR_NO_VALUE);
+    }
+    v[0] = inputs[0];
+    for (long i = 1; i <= constraints; i++) {
+        snprintf(name, sizeof(name), "p%ld", i);
+        ValueId product =
+            synthetic_instruction(program, IR_OP_MUL, intern_cstr(&ctx.symbols, name), v[i - 1], v[i / 2]);
+        ValueId sum = synthetic_instruction(program, IR_OP_ADD, SYMBOL_NONE, product, inputs[i % INPUTS]);
+        v[i] = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, sum, constant);
+    }
+    free(v);
+
+    double t0 = now_seconds();
+    R1CS* r1cs = compile_constraints(&ctx, program);
+    double t1 = now_seconds();
+    if (save_circuit(&ctx, program, r1cs, path) != 0) {
+        perror("save_circuit");
+        return 1;
+    }
+    double t2 = now_seconds();
+
+    // The first load after writing waits on the freshly written file; time
+    // it separately from the steady state a prover or verifier sees
+    Circuit* circuit = load_circuit(path);
+    double t3 = now_seconds();
+    if (!circuit) return 1;
+    for (int k = 0; k < RELOADS; k++) {
+        free_circuit(circuit);
+        circuit = load_circuit(path);
+    }
+    double t4 = now_seconds();
+    uint64_t sum = checksum(&circuit->r1cs.a) + checksum(&circuit->r1cs.b) + checksum(&circuit->r1cs.c);
+    double t5 = now_seconds();
+    uint32_t found = circuit_find_variable(circuit, "p1");
+    double t6 = now_seconds();
+    uint64_t expected = checksum(&r1cs->a) + checksum(&r1cs->b) + checksum(&r1cs->c);
+
+    printf("circuit: %u constraints, %u variables, %.1f MB file\n", r1cs->constraint_count, r1cs->variable_count,
+           circuit->file->size / 1e6);
+    printf("circuit: lower %.3f s, save %.3f s (%.0f MB/s)\n", t1 - t0, t2 - t1, circuit->file->size / 1e6 / (t2 - t1));
+    printf("circuit: load %.3f ms after saving, %.1f us when reloaded; first pass over nonzeros %.3f s; "
+           "name lookup %.1f us\n", (t3 - t2) * 1e3, (t4 - t3) / RELOADS * 1e6, t5 - t4, (t6 - t5) * 1e6);
+    if (sum != expected || found == CIRCUIT_NO_NAME) {
+        printf("circuit: round trip mismatch\n");
+        return 1;
+    }
+
+    free_circuit(circuit);
+    if (argc <= 2) unlink(path);
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,74 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/math/field.h"
+
+// Field arithmetic microbenchmark: ns/op for single and batch operations
+// over each supported field.
+//
+// Usage: bench_field [batch_size]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void bench(const Field* field, size_t n) {
+    FieldElement* a = malloc(sizeof(FieldElement) * n);
+    FieldElement* b = malloc(sizeof(FieldElement) * n);
+    FieldElement* out = malloc(sizeof(FieldElement) * n);
+    FieldElement* scratch = malloc(sizeof(FieldElement) * n);
+    for (size_t i = 0; i < n; i++) {
+        field_from_u64(field, &a[i], i * 0x9E3779B97F4A7C15ull + 1);
+        field_mul(field, &a[i], &a[i], &a[i]); // Spread values over the whole field
+        field_from_u64(field, &b[i], i + 7);
+    }
+
+    // Dependent chain, so latency is measured rather than throughput
+    FieldElement acc = field->one;
+    double t0 = now_seconds();
+    for (size_t i = 0; i < n; i++) field_mul(field, &acc, &acc, &b[i]);
+    double t1 = now_seconds();
+    printf("%-10s mul        %8.1f ns/op\n", field->name, (t1 - t0) / n * 1e9);
+
+    t0 = now_seconds();
+    for (size_t i = 0; i < n; i++) field_add(field, &acc, &acc, &b[i]);
+    t1 = now_seconds();
+    printf("%-10s add        %8.1f ns/op\n", field->name, (t1 - t0) / n * 1e9);
+
+    size_t inversions = n < 10000 ? n : 10000;
+    t0 = now_seconds();
+    for (size_t i = 0; i < inversions; i++) field_inv(field, &out[i], &a[i]);
+    t1 = now_seconds();
+    printf("%-10s inv        %8.1f ns/op\n", field->name, (t1 - t0) / inversions * 1e9);
+
+    t0 = now_seconds();
+    field_batch_mul(field, out, a, b, n);
+    t1 = now_seconds();
+    printf("%-10s batch-mul  %8.1f ns/op\n", field->name, (t1 - t0) / n * 1e9);
+
+    t0 = now_seconds();
+    field_batch_add(field, out, a, b, n);
+    t1 = now_seconds();
+    printf("%-10s batch-add  %8.1f ns/op\n", field->name, (t1 - t0) / n * 1e9);
+
+    t0 = now_seconds();
+    field_batch_inv(field, out, a, n, scratch);
+    t1 = now_seconds();
+    printf("%-10s batch-inv  %8.1f ns/op (n=%zu)\n", field->name, (t1 - t0) / n * 1e9, n);
+
+    // Keep the chain results observable
+    if (field_is_zero(&acc) && field_is_zero(&out[n - 1])) printf("(zero)\n");
+    free(a);
+    free(b);
+    free(out);
+    free(scratch);
+}
+
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? (size_t)atol(argv[1]) : 1000000;
+    bench(&FIELD_BN254, n);
+    bench(&FIELD_BLS12_381, n);
+    return 0;
+}
@@ -0,0 +1,99 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "../src/backend/compile_cache.h"
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+
+// Incremental compilation benchmark: compiles an N-statement program
+// whole, then through a compile cache that starts empty, then again
+// unchanged, and again after a one-line edit in the middle.
+//
+// Usage: bench_incremental [statements]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to generate the program: a chain where v[i] reads v[i - 1] and
+// v[i / 2 - 1], so each statement has readers near and far
+static char* generate(long statements, long edited, size_t* length) {
+    size_t capacity = (size_t)statements * 48 + 256;
+    char* source = malloc(capacity);
+    size_t n = (size_t)snprintf(source, capacity, "public y\ninput x0\ninput x1\ninput x2\n");
+    for (long i = 0; i < statements; i++) {
+        char a[24], b[24];
+        if (i > 0) snprintf(a, sizeof(a), "v%ld", i - 1);
+        else snprintf(a, sizeof(a), "x0");
+        if (i >= 2) snprintf(b, sizeof(b), "v%ld", i / 2 - 1);
+        else snprintf(b, sizeof(b), "x1");
+        long k = i == edited ? 100 : i % 7 + 1;
+        n += (size_t)snprintf(source + n, capacity - n, "v%ld = %s * %s + %ld * x%ld\n", i, a, b, k, i % 3);
+    }
+    n += (size_t)snprintf(source + n, capacity - n, "assert(v%ld == y)\noutput v%ld\n", statements - 1,
+                          statements - 1);
+    *length = n;
+    return source;
+}
+
+// Helper to run and report one compilation through the cache
+static void run_incremental(const char* what, const char* path, const char* source, size_t length, double cold) {
+    CompilerContext ctx;
+    context_init(&ctx);
+    double t0 = now_seconds();
+    CompileCache* cache = compile_cache_open(path, ctx.field);
+    double t1 = now_seconds();
+    TokenStream* stream = tokenize_buffer(&ctx, source, length);
+    double t2 = now_seconds();
+    IRProgram* program;
+    IncrementalStats stats;
+    R1CS* r1cs = compile_incremental(&ctx, cache, stream, &program, &stats);
+    double t3 = now_seconds();
+    if (compile_cache_save(cache) != 0) perror("bench_incremental: saving the cache");
+    compile_cache_close(cache);
+    double t4 = now_seconds();
+    printf("%-14s %7.3f s (%4.1f%% of whole): open %.3f, lex %.3f, compile %.3f, save %.3f; "
+           "%u reused, %u compiled; %u constraints\n",
+           what, t4 - t0, (t4 - t0) / cold * 100, t1 - t0, t2 - t1, t3 - t2, t4 - t3, stats.reused, stats.compiled,
+           r1cs->constraint_count);
+    context_free(&ctx);
+}
+
+int main(int argc, char** argv) {
+    long statements = argc > 1 ? atol(argv[1]) : 1000000;
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/bench_incremental_%ld.zklcache", (long)getpid());
+    unlink(path);
+    size_t length, edited_length;
+    char* source = generate(statements, -1, &length);
+    char* edited = generate(statements, statements / 2, &edited_length);
+
+    // The whole-program pipeline, for reference
+    CompilerContext ctx;
+    context_init(&ctx);
+    double t0 = now_seconds();
+    AST* ast = parse_tokens(&ctx, tokenize_buffer(&ctx, source, length));
+    validate_program(&ctx, ast);
+    IRProgram* program = optimize_ir(&ctx, generate_ir(&ctx, ast));
+    R1CS* r1cs = compile_constraints(&ctx, program);
+    double cold = now_seconds() - t0;
+    printf("%-14s %7.3f s; %u constraints\n", "whole program", cold, r1cs->constraint_count);
+    context_free(&ctx);
+
+    run_incremental("empty cache", path, source, length, cold);
+    run_incremental("unchanged", path, source, length, cold);
+    run_incremental("one-line edit", path, edited, edited_length, cold);
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("incremental: %ld statements; peak RSS %ld KiB\n", statements, usage.ru_maxrss);
+    unlink(path);
+    free(source);
+    free(edited);
+    return 0;
+}
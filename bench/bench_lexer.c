@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/frontend/lexer.h"
+
+// Lexer throughput benchmark: writes a synthetic multi-megabyte .zkl file,
+// then tokenizes it through the memory-mapped path and reports MB/s.
+//
+// Usage: bench_lexer [megabytes] [iterations]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? (size_t)atol(argv[1]) : 64;
+    int iterations = argc > 2 ? atoi(argv[2]) : 5;
+    const char* path = "bench_lexer_input.zkl";
+
+    FILE* out = fopen(path, "w");
+    if (!out) {
+        fprintf(stderr, "Error: Could not create '%s'.\n", path);
+        return 1;
+    }
+    size_t written = 0;
+    for (long i = 0; written < megabytes << 20; i++) {
+        if (i % 8 == 7) {
+            written += fprintf(out, "assert(v%ld == (v%ld + %ld) * v%ld)\n", i - 1, i - 2, i, i - 3);
+        } else {
+            written += fprintf(out, "v%ld = %ld * (v%ld + 12345) - v%ld / 7\n", i, i, i / 2, i / 3);
+        }
+    }
+    fclose(out);
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    double best = 0;
+    size_t count = 0;
+    for (int it = 0; it < iterations; it++) {
+        double start = now_seconds();
+        TokenStream* tokens = tokenize_file(&ctx, path);
+        double elapsed = now_seconds() - start;
+        count = tokens->count;
+        context_reset(&ctx);
+        if (best == 0 || elapsed < best) best = elapsed;
+    }
+    context_free(&ctx);
+    remove(path);
+
+    printf("lexer (%s): %zu bytes, %zu tokens, best of %d: %.3f s, %.1f MB/s, %.1f Mtokens/s\n",
+           lexer_scan_name(), written, count, iterations, best, written / best / 1e6, count / best / 1e6);
+    return 0;
+}
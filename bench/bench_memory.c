@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include "../src/frontend/lexer.h"
+#include "../src/frontend/parser.h"
+#include "../src/ir/ir_generator.h"
+
+// Front-end memory benchmark: lexes, parses and lowers a synthetic program
+// of N assignments, then reports arena usage and peak RSS.
+//
+// Usage: bench_memory [statements]
+
+int main(int argc, char** argv) {
+    long statements = argc > 1 ? atol(argv[1]) : 1000000;
+
+    size_t size = (size_t)statements * 48 + 64, used = 0;
+    char* source = malloc(size);
+    used += snprintf(source, size, "v0 = 1\n");
+    for (long i = 1; i < statements; i++) {
+        used += snprintf(source + used, size - used, "v%ld = v%ld * %ld + v%ld\n", i, i - 1, i % 97, i / 2);
+    }
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    TokenStream* tokens = tokenize_buffer(&ctx, source, used);
+    AST* ast = parse_tokens(&ctx, tokens);
+    IRProgram* ir = generate_ir(&ctx, ast);
+    size_t instructions = ir->count;
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("memory: %ld statements, %zu tokens, %zu IR instructions, %u symbols\n",
+           statements, tokens->count, instructions, ctx.symbols.count - 1);
+    printf("memory: arena %zu allocations, %zu bytes in %zu blocks; peak RSS %ld KiB\n",
+           ctx.arena.allocations, ctx.arena.bytes, ctx.arena.blocks, usage.ru_maxrss);
+
+    context_free(&ctx);
+    free(source);
+    return 0;
+}
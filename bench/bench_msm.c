@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/backend/proof_generator.h"
+
+// Multi-scalar multiplication benchmark: checks msm against the naive sum
+// at 2^10 points, sweeps the window size at 2^16, then times msm on G1 for
+// 2^16 .. 2^max points and on G2 for up to 2^18.
+//
+// Usage: bench_msm [max_log2 (default 20, up to 24)] [threads (default all)]
+
+#define CONVERT_CHUNK 4096
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to make the points (i + 1) * G, a chunk at a time
+static void* make_points(const CurveGroup* group, size_t n) {
+    unsigned char* points = (unsigned char*)malloc(n * group->affine_size);
+    unsigned char* jacobian = (unsigned char*)malloc(CONVERT_CHUNK * group->jacobian_size);
+    unsigned char* scratch = (unsigned char*)malloc(2 * CONVERT_CHUNK * group->coordinate_size);
+    const void* generator = group == &CURVE_G1 ? (const void*)&G1_GENERATOR : (const void*)&G2_GENERATOR;
+    unsigned char acc[sizeof(G2Jacobian)];
+    group->set_infinity(acc);
+    for (size_t begin = 0; begin < n; begin += CONVERT_CHUNK) {
+        size_t count = n - begin < CONVERT_CHUNK ? n - begin : CONVERT_CHUNK;
+        for (size_t k = 0; k < count; k++) {
+            group->add_mixed(acc, acc, generator);
+            memcpy(jacobian + k * group->jacobian_size, acc, group->jacobian_size);
+        }
+        if (group == &CURVE_G1) {
+            g1_batch_to_affine((G1Affine*)points + begin, (const G1Jacobian*)jacobian, count, (FieldElement*)scratch);
+        } else {
+            g2_batch_to_affine((G2Affine*)points + begin, (const G2Jacobian*)jacobian, count, (Fq2*)scratch);
+        }
+    }
+    free(jacobian);
+    free(scratch);
+    return points;
+}
+
+// Helper to make n pseudo-random scalars of full width
+static FieldElement* make_scalars(size_t n) {
+    FieldElement* scalars = (FieldElement*)malloc(n * sizeof(FieldElement));
+    FieldElement shift, limb;
+    field_from_u64(&FIELD_BN254, &shift, 1);
+    for (int k = 0; k < 64; k++) field_add(&FIELD_BN254, &shift, &shift, &shift);  // 2^64
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < n; i++) {
+        field_from_u64(&FIELD_BN254, &scalars[i], 0);
+        for (int k = 0; k < FIELD_LIMBS; k++) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            field_from_u64(&FIELD_BN254, &limb, state);
+            field_mul(&FIELD_BN254, &scalars[i], &scalars[i], &shift);
+            field_add(&FIELD_BN254, &scalars[i], &scalars[i], &limb);
+        }
+    }
+    return scalars;
+}
+
+// Helper to time one msm
+static double time_msm(const CurveGroup* group, ThreadPool* pool, void* out, const void* points,
+                       const FieldElement* scalars, size_t n, int window) {
+    double t0 = now_seconds();
+    msm(group, pool, out, points, scalars, n, window);
+    return now_seconds() - t0;
+}
+
+static void bench(const CurveGroup* group, ThreadPool* pool, int min_log2, int max_log2, int sweep) {
+    size_t most = (size_t)1 << max_log2;
+    void* points = make_points(group, most);
+    FieldElement* scalars = make_scalars(most);
+    G2Jacobian fast, slow;  // Large enough for either group
+
+    // Correctness, and the speedup over one multiplication per point
+    size_t n = 1024;
+    double t = time_msm(group, pool, &fast, points, scalars, n, 0);
+    double t0 = now_seconds();
+    msm_naive(group, &slow, points, scalars, n);
+    double naive = now_seconds() - t0;
+    int ok = group == &CURVE_G1 ? g1_equal((G1Jacobian*)&fast, (G1Jacobian*)&slow) : g2_equal(&fast, &slow);
+    printf("%s 2^10: msm %.2f ms, naive %.2f ms (%.1fx), %s\n", group->name, t * 1e3, naive * 1e3,
+           naive / t, ok ? "results match" : "RESULTS DIFFER");
+    if (!ok) exit(1);
+
+    if (sweep) {
+        n = (size_t)1 << min_log2;
+        for (int window = msm_window_size(n) - 3; window <= msm_window_size(n) + 3; window++) {
+            t = time_msm(group, pool, &fast, points, scalars, n, window);
+            printf("%s 2^%d window %2d: %8.2f ms%s\n", group->name, min_log2, window, t * 1e3,
+                   window == msm_window_size(n) ? " (default)" : "");
+        }
+    }
+
+    for (int log2 = min_log2; log2 <= max_log2; log2++) {
+        n = (size_t)1 << log2;
+        t = time_msm(group, pool, &fast, points, scalars, n, 0);
+        printf("%s 2^%d: %10.1f ms, %7.0f ns/point (window %d)\n", group->name, log2, t * 1e3, t / n * 1e9,
+               msm_window_size(n));
+    }
+    free(points);
+    free(scalars);
+}
+
+int main(int argc, char** argv) {
+    int max_log2 = argc > 1 ? atoi(argv[1]) : 20;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    if (max_log2 < 16) max_log2 = 16;
+    if (max_log2 > 24) max_log2 = 24;
+
+    ThreadPool* pool = thread_pool_create(threads);
+    printf("%d threads\n", thread_pool_size(pool));
+    bench(&CURVE_G1, pool, 16, max_log2, 1);
+    bench(&CURVE_G2, pool, 16, max_log2 < 18 ? max_log2 : 18, 0);
+    thread_pool_destroy(pool);
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/math/ntt.h"
+
+// NTT throughput benchmark over BN254's scalar field: forward, inverse and
+// coset transforms of 2^10 .. 2^max points. Above NTT_BLOCK_LOG it also
+// times the four-step layout on a two-worker pool, for comparison with the
+// direct transform when the machine has a single CPU.
+//
+// Usage: bench_ntt [max_log2 (default 20, up to 24)] [threads (default all)]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+typedef void (*Transform)(const NttDomain* domain, ThreadPool* pool, FieldElement* values);
+
+// Helper to time one transform and report it per butterfly (n/2 log n of them)
+static void run(const char* what, Transform transform, const NttDomain* domain, ThreadPool* pool,
+                FieldElement* values) {
+    double t0 = now_seconds();
+    transform(domain, pool, values);
+    double t = now_seconds() - t0;
+    double butterflies = (double)domain->size / 2 * domain->log_size;
+    printf("2^%-2u %-14s %10.2f ms %8.1f Melem/s %6.1f ns/butterfly\n", domain->log_size, what, t * 1e3,
+           domain->size / t / 1e6, t / butterflies * 1e9);
+}
+
+int main(int argc, char** argv) {
+    int max_log2 = argc > 1 ? atoi(argv[1]) : 20;
+    int threads = argc > 2 ? atoi(argv[2]) : 0;
+    if (max_log2 < 10) max_log2 = 10;
+    if (max_log2 > 24) max_log2 = 24;
+
+    ThreadPool* pool = thread_pool_create(threads);
+    printf("%d threads\n", thread_pool_size(pool));
+    FieldElement* values = (FieldElement*)malloc(sizeof(FieldElement) << max_log2);
+    for (size_t i = 0; i < (size_t)1 << max_log2; i++) {
+        field_from_u64(&FIELD_BN254, &values[i], i * 0x9E3779B97F4A7C15ull + 1);
+    }
+
+    for (int log2 = 10; log2 <= max_log2; log2 += 2) {
+        NttDomain* domain = ntt_domain_create(&FIELD_BN254, (uint32_t)log2);
+        run("forward", ntt_forward, domain, pool, values);
+        run("inverse", ntt_inverse, domain, pool, values);
+        run("coset forward", ntt_coset_forward, domain, pool, values);
+        if (log2 > NTT_BLOCK_LOG && thread_pool_size(pool) == 1) {
+            ThreadPool* pair = thread_pool_create(2);
+            run("four-step x2", ntt_forward, domain, pair, values);
+            thread_pool_destroy(pair);
+        }
+        ntt_domain_free(domain);
+    }
+
+    free(values);
+    thread_pool_destroy(pool);
+    return 0;
+}
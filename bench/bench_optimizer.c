@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/frontend/lexer.h"
+#include "../src/frontend/parser.h"
+#include "../src/ir/ir_generator.h"
+#include "../src/ir/optimizer.h"
+
+// Optimizer benchmark: times optimize_ir on programs of growing size to
+// check that the passes stay linear in the instruction count, then prints
+// the per-pass report for a program of products rooted at an input, which
+// nothing folds away, with an unread variable every tenth statement.
+//
+// Usage: bench_optimizer [max_statements]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    long max_size = argc > 1 ? atol(argv[1]) : 200000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    for (long n = 2000; n <= max_size; n *= 10) {
+        // n statements, each reading earlier variables, closed by an
+        // assertion on the last value so every fold feeds a check
+        size_t size = (size_t)n * 48 + 64, used = 0;
+        char* source = malloc(size);
+        used += snprintf(source, size, "v0 = 1\n");
+        for (long i = 1; i < n; i++) {
+            used += snprintf(source + used, size - used, "v%ld = v%ld * %ld + v%ld\n", i, i - 1, i % 97, i / 2);
+        }
+        used += snprintf(source + used, size - used, "assert(v%ld == v%ld)\n", n - 1, n - 1);
+
+        IRProgram* ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize_buffer(&ctx, source, used)));
+        uint32_t instructions = ir->count;
+        double t0 = now_seconds();
+        optimize_ir(&ctx, ir);
+        double t1 = now_seconds();
+        printf("statements %8ld  instructions %9u  optimize %8.4f s (%5.1f ns/instr)\n",
+               n, instructions, t1 - t0, (t1 - t0) / instructions * 1e9);
+        free(source);
+        context_reset(&ctx);
+    }
+
+    // Products of earlier values, starting from an input and ending in an
+    // output; the d variables are dead code
+    size_t size = (size_t)max_size * 56 + 64, used = 0;
+    char* source = malloc(size);
+    used += snprintf(source, size, "input v0\n");
+    for (long i = 1; i < max_size; i++) {
+        used += snprintf(source + used, size - used, "v%ld = 2 * v%ld * v%ld + %ld\n", i, i - 1, i / 2, i % 97);
+        if (i % 10 == 0) used += snprintf(source + used, size - used, "d%ld = v%ld * v%ld\n", i, i, i / 3);
+    }
+    used += snprintf(source + used, size - used, "output v%ld\n", max_size - 1);
+    IRProgram* ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize_buffer(&ctx, source, used)));
+    OptimizerReport report;
+    double t0 = now_seconds();
+    optimize_ir_report(&ctx, ir, &report);
+    double t1 = now_seconds();
+    printf("\nwith an input, %ld statements: optimize %.4f s (%.1f ns/instr)\n", max_size, t1 - t0,
+           (t1 - t0) / report.instructions_before * 1e9);
+    print_optimizer_report(&report);
+    free(source);
+
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/frontend/lexer.h"
+#include "../src/frontend/parser.h"
+#include "../src/frontend/validator.h"
+#include "../src/ir/ir_generator.h"
+
+// Parser scaling benchmark: times parse_tokens, validate_program and
+// generate_ir on long programs and on deeply nested expressions.
+//
+// Usage: bench_parser [max_size]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Times the phases after lexing on the given source
+static void run(CompilerContext* ctx, const char* label, long n, const char* source, size_t length) {
+    TokenStream* tokens = tokenize_buffer(ctx, source, length);
+    double t0 = now_seconds();
+    AST* ast = parse_tokens(ctx, tokens);
+    double t1 = now_seconds();
+    validate_program(ctx, ast);
+    double t2 = now_seconds();
+    generate_ir(ctx, ast);
+    double t3 = now_seconds();
+    printf("%-10s n=%9ld  parse %8.4f s (%5.1f ns/n)  validate %8.4f s  irgen %8.4f s\n",
+           label, n, t1 - t0, (t1 - t0) / n * 1e9, t2 - t1, t3 - t2);
+    context_reset(ctx);
+}
+
+int main(int argc, char** argv) {
+    long max_size = argc > 1 ? atol(argv[1]) : 1000000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    for (long n = 1000; n <= max_size; n *= 10) {
+        // n statements, each reading earlier variables
+        size_t size = (size_t)n * 48 + 64, used = 0;
+        char* source = malloc(size);
+        used += snprintf(source, size, "v0 = 1\n");
+        for (long i = 1; i < n; i++) {
+            used += snprintf(source + used, size - used, "v%ld = v%ld * %ld + v%ld\n", i, i - 1, i % 97, i / 2);
+        }
+        run(&ctx, "statements", n, source, used);
+
+        // One expression nested n levels deep: 1 + (1 + (1 + ...))
+        used = snprintf(source, size, "z = ");
+        for (long i = 0; i < n; i++) used += snprintf(source + used, size - used, "1 + (");
+        source[used++] = '1';
+        memset(source + used, ')', n);
+        used += n;
+        run(&ctx, "nesting", n, source, used);
+        free(source);
+    }
+    context_free(&ctx);
+    return 0;
+}
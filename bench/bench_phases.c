@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "synthetic.h"
+
+// Front-end phase benchmark: times tokenize_buffer, parse_tokens,
+// validate_program, generate_ir and optimize_ir separately on synthetic
+// programs of every shape, at sizes growing tenfold from min to max
+// statements. Small programs are compiled repeatedly and the fastest run
+// of each phase is kept. A shape stops growing once its source would pass
+// the size limit, since compiling takes memory a good multiple of the
+// source size.
+//
+// The results are tab-separated, one row per shape, size and phase after
+// a header row, for scripts to compare (see compare_bench.py):
+//
+//   shape statements bytes phase seconds ns_per_statement mib_per_s
+//
+// Usage: bench_phases [max statements] [min statements] [max megabytes] [shape]
+
+#define PHASES 5
+#define MIN_SECONDS 0.25    // Repeat small programs for at least this long
+#define MAX_RUNS 50
+
+static const char* const PHASE_NAMES[PHASES] = {"tokenize", "parse", "validate", "irgen", "optimize"};
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to compile a program once, recording the time of each phase
+static void compile_once(CompilerContext* ctx, const char* source, size_t length, double* seconds) {
+    double t0 = now_seconds();
+    TokenStream* tokens = tokenize_buffer(ctx, source, length);
+    double t1 = now_seconds();
+    AST* ast = parse_tokens(ctx, tokens);
+    double t2 = now_seconds();
+    validate_program(ctx, ast);
+    double t3 = now_seconds();
+    IRProgram* program = generate_ir(ctx, ast);
+    double t4 = now_seconds();
+    optimize_ir(ctx, program);
+    double t5 = now_seconds();
+    seconds[0] = t1 - t0;
+    seconds[1] = t2 - t1;
+    seconds[2] = t3 - t2;
+    seconds[3] = t4 - t3;
+    seconds[4] = t5 - t4;
+    context_reset(ctx);
+}
+
+// Helper to print one result row
+static void report(const char* shape, long statements, size_t bytes, const char* phase, double seconds) {
+    printf("%s\t%ld\t%zu\t%s\t%.9f\t%.2f\t%.2f\n", shape, statements, bytes, phase, seconds,
+           seconds / statements * 1e9, bytes / seconds / (1 << 20));
+}
+
+int main(int argc, char** argv) {
+    long max_size = argc > 1 ? atol(argv[1]) : 1000000;
+    long min_size = argc > 2 ? atol(argv[2]) : 1000;
+    size_t max_bytes = (size_t)(argc > 3 ? atol(argv[3]) : 64) << 20;
+    const char* only = argc > 4 ? argv[4] : NULL;
+    if (min_size < 10) min_size = 10;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    printf("shape\tstatements\tbytes\tphase\tseconds\tns_per_statement\tmib_per_s\n");
+    for (int shape = 0; shape < SHAPE_COUNT; shape++) {
+        if (only && strcmp(only, SHAPE_NAMES[shape]) != 0) continue;
+        for (long n = min_size; n <= max_size; n *= 10) {
+            size_t length;
+            char* source = generate_program((SyntheticShape)shape, n, SYNTHETIC_SEED(shape), &length);
+            if (length > max_bytes && n > min_size) {
+                fprintf(stderr, "%s: skipping %ld statements and more: %zu bytes of source\n", SHAPE_NAMES[shape],
+                        n, length);
+                free(source);
+                break;
+            }
+
+            double best[PHASES], seconds[PHASES], start = now_seconds();
+            compile_once(&ctx, source, length, best);
+            for (int run = 1; run < MAX_RUNS && now_seconds() - start < MIN_SECONDS; run++) {
+                compile_once(&ctx, source, length, seconds);
+                for (int p = 0; p < PHASES; p++) {
+                    if (seconds[p] < best[p]) best[p] = seconds[p];
+                }
+            }
+            double total = 0;
+            for (int p = 0; p < PHASES; p++) {
+                report(SHAPE_NAMES[shape], n, length, PHASE_NAMES[p], best[p]);
+                total += best[p];
+            }
+            report(SHAPE_NAMES[shape], n, length, "total", total);
+            fflush(stdout);
+            free(source);
+        }
+    }
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "../src/backend/constraint_compiler.h"
+#include "synthetic.h"
+
+// Constraint compiler benchmark: builds an IR program with N products
+// directly (bypassing the front end, so 10M-constraint circuits fit in
+// memory) and times its lowering to R1CS.
+//
+// Usage: bench_r1cs [constraints]
+
+#define INPUTS 8
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    long constraints = argc > 1 ? atol(argv[1]) : 1000000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    IRProgram* program = (IRProgram*)arena_calloc(&ctx.arena, 1, sizeof(IRProgram));
+    program->capacity = (uint32_t)(constraints * 3 + INPUTS);
+    program->instrs = (IRInstruction*)arena_alloc(&ctx.arena, sizeof(IRInstruction) * program->capacity);
+    program->locations = (IRLocation*)arena_alloc(&ctx.arena, sizeof(IRLocation) * program->capacity);
+    field_pool_init(&program->constants, &ctx.arena);
+
+    // v[i] = 3 * (v[i - 1] * v[i / 2] + x[i % INPUTS]): one product and two
+    // linear operations per statement
+    FieldElement three;
+    field_from_u64(ctx.field, &three, 3);
+    ValueId constant = ir_add_constant(&ctx, program, &three);
+    ValueId* v = malloc(sizeof(ValueId) * (constraints + 1));
+    ValueId inputs[INPUTS];
+    for (int k = 0; k < INPUTS; k++) {
+        inputs[k] = synthetic_instruction(program, k == 0 ? IR_OP_PUBLIC : IR_OP_INPUT, SYMBOL_NONE, IR_NO_VALUE,
+                                          IR_NO_VALUE);
+    }
+    v[0] = inputs[0];
+    for (long i = 1; i <= constraints; i++) {
+        ValueId product = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, v[i - 1], v[i / 2]);
+        ValueId sum = synthetic_instruction(program, IR_OP_ADD, SYMBOL_NONE, product, inputs[i % INPUTS]);
+        v[i] = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, sum, constant);
+    }
+    free(v);
+
+    double t0 = now_seconds();
+    R1CS* r1cs = compile_constraints(&ctx, program);
+    double t1 = now_seconds();
+
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("r1cs: %u instructions -> %u constraints in %.3f s (%.1f ns/constraint, %.2f M constraints/s)\n",
+           program->count, r1cs->constraint_count, t1 - t0, (t1 - t0) / r1cs->constraint_count * 1e9,
+           r1cs->constraint_count / (t1 - t0) / 1e6);
+    print_r1cs_stats(r1cs);
+    printf("r1cs: arena %zu bytes; peak RSS %ld KiB\n", ctx.arena.bytes, usage.ru_maxrss);
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../src/frontend/parser.h"
+#include "../src/frontend/validator.h"
+
+// Validator scaling benchmark: builds programs of N assignments, each
+// reading two earlier variables, and times validate_program alone.
+//
+// Usage: bench_validator [max_statements]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Builds "v0 = 1; v<i> = v<i-1> + v<i/2>" directly as an AST
+static AST* build_program(CompilerContext* ctx, long statements) {
+    Symbol* names = malloc(sizeof(Symbol) * statements);
+    char name[32];
+    for (long i = 0; i < statements; i++) {
+        names[i] = intern(&ctx->symbols, name, snprintf(name, sizeof(name), "v%ld", i));
+    }
+    uint32_t one = field_pool_add(&ctx->constants, &ctx->field->one);
+
+    AST* ast = ast_create(ctx, NULL, (uint32_t)(statements * 4));
+    ast_add_node(ctx, ast, AST_LITERAL, AST_OP_NONE, one, AST_NO_NODE, AST_NO_NODE);
+    ast_add_node(ctx, ast, AST_ASSIGNMENT, AST_OP_NONE, names[0], AST_NO_NODE, AST_NO_NODE);
+    for (long i = 1; i < statements; i++) {
+        NodeId lhs = ast_add_node(ctx, ast, AST_VARIABLE, AST_OP_NONE, names[i - 1], AST_NO_NODE, AST_NO_NODE);
+        ast_add_node(ctx, ast, AST_VARIABLE, AST_OP_NONE, names[i / 2], AST_NO_NODE, AST_NO_NODE);
+        ast_add_node(ctx, ast, AST_BINARY_OP, AST_OP_ADD, SYMBOL_NONE, AST_NO_NODE, lhs);
+        ast_add_node(ctx, ast, AST_ASSIGNMENT, AST_OP_NONE, names[i], AST_NO_NODE, AST_NO_NODE);
+    }
+    free(names);
+    return ast;
+}
+
+int main(int argc, char** argv) {
+    long max_statements = argc > 1 ? atol(argv[1]) : 1000000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    for (long n = 1000; n <= max_statements; n *= 10) {
+        AST* ast = build_program(&ctx, n);
+        double start = now_seconds();
+        validate_program(&ctx, ast);
+        double elapsed = now_seconds() - start;
+        printf("validator: %9ld statements in %8.4f s, %6.1f ns/statement\n", n, elapsed, elapsed / n * 1e9);
+        context_reset(&ctx);
+    }
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <time.h>
+#include "../tests/example_circuit.h"
+
+// Groth16 verification throughput for the example circuit in
+// tests/example_circuit.h: the generic verifier, which prepares the key on
+// every call, against the generated one with the key baked in, one proof
+// at a time and in batches sharing a final exponentiation.
+//
+// Usage: bench_verifier [proofs (default 64)]
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to report a run of n verifications
+static void report(const char* what, size_t n, double seconds, int valid) {
+    printf("%-22s %6zu proofs %10.2f ms %10.1f proofs/s%s\n", what, n, seconds * 1e3, n / seconds,
+           valid ? "" : "  (REJECTED)");
+}
+
+int main(int argc, char** argv) {
+    size_t count = argc > 1 ? (size_t)atol(argv[1]) : 64;
+    if (count < 1) count = 1;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    Groth16Trapdoor trapdoor;
+    FieldElement ic_scalars[EXAMPLE_PUBLIC_COUNT + 1];
+    VerifyingKey* key = example_setup(&ctx, &trapdoor, ic_scalars);
+    Groth16Proof* proofs = malloc(sizeof(Groth16Proof) * count);
+    FieldElement* inputs = malloc(sizeof(FieldElement) * EXAMPLE_PUBLIC_COUNT * count);
+    for (size_t k = 0; k < count; k++) {
+        FieldElement* x = inputs + k * EXAMPLE_PUBLIC_COUNT;
+        example_inputs(x, 1000 + k, 7 * k + 2);
+        groth16_simulate_proof(&trapdoor, ic_scalars, EXAMPLE_PUBLIC_COUNT, x, k, &proofs[k]);
+    }
+
+    // The generic verifier is slow enough that a few proofs tell
+    size_t generic = count < 8 ? count : 8;
+    int valid = 1;
+    double t0 = now_seconds();
+    for (size_t k = 0; k < generic; k++) {
+        valid &= groth16_verify(key, &proofs[k], inputs + k * EXAMPLE_PUBLIC_COUNT);
+    }
+    report("generic", generic, now_seconds() - t0, valid);
+
+    valid = 1;
+    t0 = now_seconds();
+    for (size_t k = 0; k < count; k++) valid &= example_verify(&proofs[k], inputs + k * EXAMPLE_PUBLIC_COUNT);
+    report("generated", count, now_seconds() - t0, valid);
+
+    for (size_t batch = 4; batch <= count; batch *= 4) {
+        char what[48];
+        snprintf(what, sizeof(what), "generated batch %zu", batch);
+        valid = 1;
+        size_t done = 0;
+        t0 = now_seconds();
+        for (; done + batch <= count; done += batch) {
+            valid &= example_verify_batch(proofs + done, inputs + done * EXAMPLE_PUBLIC_COUNT, batch);
+        }
+        report(what, done, now_seconds() - t0, valid);
+    }
+
+    free(inputs);
+    free(proofs);
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "../src/backend/witness_generator.h"
+#include "synthetic.h"
+
+// Witness generation benchmark: builds a circuit of N statements directly
+// as IR (like bench_r1cs), then generates witnesses for a batch of random
+// input assignments with 1, 2, 4, ... threads up to the CPU count.
+//
+// Usage: bench_witness [statements] [assignments]
+
+#define INPUTS 8
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char** argv) {
+    long statements = argc > 1 ? atol(argv[1]) : 1000;
+    uint32_t count = argc > 2 ? (uint32_t)atol(argv[2]) : 20000;
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    IRProgram* program = (IRProgram*)arena_calloc(&ctx.arena, 1, sizeof(IRProgram));
+    program->capacity = (uint32_t)(statements * 3 + INPUTS + 2);
+    program->instrs = (IRInstruction*)arena_alloc(&ctx.arena, sizeof(IRInstruction) * program->capacity);
+    program->locations = (IRLocation*)arena_alloc(&ctx.arena, sizeof(IRLocation) * program->capacity);
+    field_pool_init(&program->constants, &ctx.arena);
+
+    // v[i] = 3 * (v[i - 1] * v[i / 2] + x[i % INPUTS]), then assert the
+    // last value is not zero
+    FieldElement three;
+    field_from_u64(ctx.field, &three, 3);
+    ValueId constant = ir_add_constant(&ctx, program, &three);
+    ValueId* v = malloc(sizeof(ValueId) * (statements + 1));
+    ValueId inputs[INPUTS];
+    for (int k = 0; k < INPUTS; k++) {
+        inputs[k] = synthetic_instruction(program, k == 0 ? IR_OP_PUBLIC : IR_OP_INPUT, SYMBOL_NONE, IR_NO_VALUE,
+                                          IR_NO_VALUE);
+    }
+    v[0] = inputs[0];
+    for (long i = 1; i <= statements; i++) {
+        ValueId product = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, v[i - 1], v[i / 2]);
+        ValueId sum = synthetic_instruction(program, IR_OP_ADD, SYMBOL_NONE, product, inputs[i % INPUTS]);
+        v[i] = synthetic_instruction(program, IR_OP_MUL, SYMBOL_NONE, sum, constant);
+    }
+    synthetic_instruction(program, IR_OP_ASSERT, SYMBOL_NONE, v[statements], IR_NO_VALUE);
+    free(v);
+
+    R1CS* r1cs = compile_constraints(&ctx, program);
+    double t0 = now_seconds();
+    WitnessPlan* plan = witness_plan_create(&ctx, program, r1cs);
+    double t1 = now_seconds();
+    printf("witness: %u instructions, %u variables; plan built in %.3f ms (%u steps)\n",
+           program->count, r1cs->variable_count, (t1 - t0) * 1e3, plan->step_count);
+
+    FieldElement* assignments = malloc(sizeof(FieldElement) * (size_t)count * INPUTS);
+    srand(1);
+    for (size_t i = 0; i < (size_t)count * INPUTS; i++) field_from_u64(ctx.field, &assignments[i], 1 + rand());
+    FieldElement* witnesses = malloc(sizeof(FieldElement) * (size_t)count * r1cs->variable_count);
+    uint32_t* failures = malloc(sizeof(uint32_t) * count);
+    if (!assignments || !witnesses || !failures) {
+        fprintf(stderr, "Error: Memory allocation failed for %u witnesses.\n", count);
+        return 1;
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    for (int threads = 1; threads <= (cpus > 1 ? cpus : 1); threads *= 2) {
+        ThreadPool* pool = thread_pool_create(threads);
+        t0 = now_seconds();
+        uint32_t failed = witness_generate_batch(&ctx, plan, pool, assignments, count, witnesses, failures);
+        t1 = now_seconds();
+        double rate = count / (t1 - t0);
+        printf("witness: %2d threads: %u witnesses in %.3f s (%.0f witnesses/s, %.0f witnesses/s per core, "
+               "%.1f ns/step), %u failed\n",
+               threads, count, t1 - t0, rate, rate / threads, (t1 - t0) * threads / count / plan->step_count * 1e9,
+               failed);
+        thread_pool_destroy(pool);
+    }
+
+    free(assignments);
+    free(witnesses);
+    free(failures);
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""Compare two bench_phases results and flag regressions.
+
+Usage: compare_bench.py BASELINE.tsv CURRENT.tsv [--threshold PERCENT]
+
+Prints the change in time of every phase found in both files, and exits
+with status 1 if any phase of a program taking at least 1 ms got slower
+by more than the threshold (10% by default).
+"""
+
+import argparse
+import csv
+import sys
+
+MIN_SECONDS = 0.001     # Faster phases are too noisy to judge
+
+
+def load(path):
+    with open(path, newline="") as f:
+        return {(row["shape"], int(row["statements"]), row["phase"]): float(row["seconds"])
+                for row in csv.DictReader(f, delimiter="\t")}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0, help="percent slowdown to fail on")
+    args = parser.parse_args()
+
+    baseline, current = load(args.baseline), load(args.current)
+    regressions = 0
+    print(f"{'shape':<8} {'statements':>10} {'phase':<9} {'before':>10} {'after':>10} {'change':>8}")
+    for key in sorted(baseline.keys() & current.keys()):
+        before, after = baseline[key], current[key]
+        change = (after / before - 1) * 100 if before > 0 else 0.0
+        flag = ""
+        if change > args.threshold and max(before, after) >= MIN_SECONDS:
+            flag = "  REGRESSION"
+            regressions += 1
+        shape, statements, phase = key
+        print(f"{shape:<8} {statements:>10} {phase:<9} {before:>10.6f} {after:>10.6f} {change:>+7.1f}%{flag}")
+    if regressions:
+        print(f"{regressions} phases slower by more than {args.threshold:g}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,25 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "synthetic.h"
+
+// Writes a synthetic program to standard output, for timing the zkl
+// command itself on the programs bench_phases uses.
+//
+// Usage: gen_program <chain|wide|deep|asserts> <statements> [seed]
+
+int main(int argc, char** argv) {
+    int shape = 0;
+    while (argc > 1 && shape < SHAPE_COUNT && strcmp(argv[1], SHAPE_NAMES[shape]) != 0) shape++;
+    long statements = argc > 2 ? atol(argv[2]) : 0;
+    if (shape == SHAPE_COUNT || statements < 4) {
+        fprintf(stderr, "Usage: %s <chain|wide|deep|asserts> <statements> [seed]\n", argv[0]);
+        return 1;
+    }
+    uint64_t seed = argc > 3 ? strtoull(argv[3], NULL, 0) : SYNTHETIC_SEED(shape);
+    size_t length;
+    char* source = generate_program((SyntheticShape)shape, statements, seed ? seed : 1, &length);
+    fwrite(source, 1, length, stdout);
+    free(source);
+    return 0;
+}
@@ -0,0 +1,153 @@
+#ifndef SYNTHETIC_H
+#define SYNTHETIC_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/ir/ir_generator.h"
+
+// Deterministic generator of synthetic programs for the benchmarks. The
+// same shape, size and seed always give the same text, so timings taken
+// on different builds compare like with like.
+//
+// Every program reads two private inputs and one public input, and ends by
+// checking and outputting its last variable, so the optimizer cannot fold
+// the work away. References to earlier variables are drawn at random.
+
+// Kinds of program
+typedef enum {
+    SHAPE_CHAIN,        // Short assignments, each reading one or two earlier variables
+    SHAPE_WIDE,         // Sums of 8 products of earlier variables
+    SHAPE_DEEP,         // Expressions nested up to 32 parentheses deep
+    SHAPE_ASSERTS,      // Every other statement an assertion
+    SHAPE_COUNT
+} SyntheticShape;
+
+static const char* const SHAPE_NAMES[SHAPE_COUNT] = {"chain", "wide", "deep", "asserts"};
+
+// Seed of the standard program of each shape
+#define SYNTHETIC_SEED(shape) (0x9E3779B97F4A7C15ull + (shape))
+
+// A program being written
+typedef struct {
+    char* text;
+    size_t length;
+    size_t capacity;
+    uint64_t state;         // xorshift64 state
+} SyntheticBuffer;
+
+// Helper to append formatted text
+static inline void synthetic_append(SyntheticBuffer* buffer, const char* format, ...) {
+    for (;;) {
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(buffer->text + buffer->length, buffer->capacity - buffer->length, format, args);
+        va_end(args);
+        if ((size_t)written < buffer->capacity - buffer->length) {
+            buffer->length += written;
+            return;
+        }
+        buffer->capacity *= 2;
+        buffer->text = (char*)realloc(buffer->text, buffer->capacity);
+        if (!buffer->text) {
+            fprintf(stderr, "Out of memory generating a program\n");
+            exit(1);
+        }
+    }
+}
+
+// Helper to draw an earlier variable: mostly recent ones, like real code,
+// sometimes any
+static inline long synthetic_pick(SyntheticBuffer* buffer, long defined) {
+    buffer->state ^= buffer->state << 13;
+    buffer->state ^= buffer->state >> 7;
+    buffer->state ^= buffer->state << 17;
+    uint64_t r = buffer->state >> 8;
+    long back = (r & 3) ? (long)((r >> 2) % 8) : (long)((r >> 2) % defined);
+    return back < defined ? defined - 1 - back : 0;
+}
+
+// Helper to append one nested operand, `depth` levels deep
+static inline void synthetic_nested(SyntheticBuffer* buffer, long defined, int depth) {
+    for (int d = 0; d < depth; d++) {
+        synthetic_append(buffer, "(v%ld %c ", synthetic_pick(buffer, defined), d % 3 == 1 ? '*' : '+');
+    }
+    synthetic_append(buffer, "x%d", depth % 2);
+    for (int d = 0; d < depth; d++) synthetic_append(buffer, ")");
+}
+
+/**
+ * Generates a program of a given shape.
+ *
+ * @param shape The kind of program.
+ * @param statements Number of statements, counting declarations and
+ *        assertions; at least 4.
+ * @param seed Seed of the variable references; nonzero.
+ * @param length Receives the length of the text.
+ * @return The NUL-terminated text, allocated with malloc.
+ */
+static inline char* generate_program(SyntheticShape shape, long statements, uint64_t seed, size_t* length) {
+    SyntheticBuffer buffer = {NULL, 0, (size_t)statements * 48 + 256, seed};
+    buffer.text = (char*)malloc(buffer.capacity);
+    synthetic_append(&buffer, "public y\ninput x0\ninput x1\nv0 = x0 * x1\n");
+    long defined = 1;
+    for (long s = 6; s < statements; s++) {
+        long v = defined;
+        switch (shape) {
+            case SHAPE_CHAIN:
+                if (v % 3 == 0) {
+                    synthetic_append(&buffer, "v%ld = v%ld + %ld\n", v, v - 1, v % 97);
+                } else {
+                    synthetic_append(&buffer, "v%ld = v%ld * v%ld\n", v, v - 1, synthetic_pick(&buffer, defined));
+                }
+                break;
+            case SHAPE_WIDE:
+                synthetic_append(&buffer, "v%ld = v%ld * x0", v, v - 1);
+                for (int term = 1; term < 8; term++) {
+                    synthetic_append(&buffer, " + %d * v%ld * v%ld", term, synthetic_pick(&buffer, defined),
+                                     synthetic_pick(&buffer, defined));
+                }
+                synthetic_append(&buffer, "\n");
+                break;
+            case SHAPE_DEEP:
+                synthetic_append(&buffer, "v%ld = v%ld * ", v, v - 1);
+                synthetic_nested(&buffer, defined, (int)(v % 32) + 1);
+                synthetic_append(&buffer, "\n");
+                break;
+            case SHAPE_ASSERTS:
+                if (s % 2 == 0) {
+                    synthetic_append(&buffer, "assert(v%ld * x1 == v%ld + x0)\n", v - 1,
+                                     synthetic_pick(&buffer, defined));
+                    continue;
+                }
+                synthetic_append(&buffer, "v%ld = v%ld * v%ld + x1\n", v, v - 1, synthetic_pick(&buffer, defined));
+                break;
+            default:
+                break;
+        }
+        defined++;
+    }
+    synthetic_append(&buffer, "assert(v%ld == y)\noutput v%ld\n", defined - 1, defined - 1);
+    *length = buffer.length;
+    return buffer.text;
+}
+
+// The benchmarks of later phases skip the front end and build their IR
+// directly, one instruction per source line.
+
+// Helper to append an instruction to a program sized up front
+static inline ValueId synthetic_instruction(IRProgram* program, IROpType op, Symbol name, ValueId src1,
+                                            ValueId src2) {
+    IRInstruction* instr = &program->instrs[program->count];
+    instr->op = op;
+    instr->name = name;
+    instr->src1 = src1;
+    instr->src2 = src2;
+    program->locations[program->count].line = (int)program->count + 1;
+    program->locations[program->count].column = 1;
+    return program->count++;
+}
+
+#endif // SYNTHETIC_H
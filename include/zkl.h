@@ -0,0 +1,135 @@
+#ifndef ZKL_H
+#define ZKL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The ZKL compiler as a library, for embedding in long-running processes.
+//
+// A ZklCompiler compiles one program at a time from a buffer in memory.
+// It keeps its memory from one compilation to the next, so compiling a
+// small circuit costs microseconds once the compiler is warm. Errors in
+// the program are returned as diagnostics; the library never exits the
+// process (it still aborts if memory runs out). Compilers are independent:
+// use one per thread.
+typedef struct ZklCompiler ZklCompiler;
+
+// A compiled circuit. It belongs to the compiler that produced it and is
+// valid until that compiler's next compilation, or until it is freed.
+typedef struct ZklCircuit ZklCircuit;
+
+// Outcome of a call
+typedef enum {
+    ZKL_OK = 0,
+    ZKL_ERROR_SOURCE,       // The program has errors; see the diagnostics
+    ZKL_ERROR_IO,           // A file could not be written; errno says why
+    ZKL_ERROR_ARGUMENT      // A required argument was NULL
+} ZklStatus;
+
+// The compiler stage that found an error
+typedef enum {
+    ZKL_STAGE_LEXER,
+    ZKL_STAGE_PARSER,
+    ZKL_STAGE_VALIDATOR,
+    ZKL_STAGE_IR,
+    ZKL_STAGE_OPTIMIZER,
+    ZKL_STAGE_CONSTRAINTS
+} ZklStage;
+
+// An error in a program
+typedef struct {
+    ZklStage stage;         // Stage that found the error
+    int line;               // 1-based line, or 0 if the error has no position
+    int column;             // 1-based column, or 0 if the error has no position
+    const char* message;    // What is wrong, e.g. "Undefined variable 'x'"
+} ZklDiagnostic;
+
+// The size and interface of a circuit
+typedef struct {
+    uint32_t constraints;
+    uint32_t variables;         // Including the constant 1
+    uint32_t public_inputs;     // Declared with 'public'
+    uint32_t public_outputs;    // Declared with 'output'
+    uint32_t private_inputs;    // Declared with 'input'
+} ZklCircuitInfo;
+
+// Function prototypes
+
+/**
+ * Creates a compiler.
+ *
+ * @return The compiler, or NULL if memory runs out.
+ */
+ZklCompiler* zkl_compiler_create(void);
+
+/**
+ * Frees a compiler and the circuit it last produced.
+ */
+void zkl_compiler_free(ZklCompiler* compiler);
+
+/**
+ * Compiles a program to a constraint system, running the whole pipeline:
+ * lexing, parsing, validation, IR generation, optimization and constraint
+ * generation. The previous circuit and diagnostics of the compiler are
+ * discarded first.
+ *
+ * @param compiler The compiler.
+ * @param source The program text; need not be NUL-terminated.
+ * @param length Length of the text in bytes.
+ * @param circuit If not NULL, receives the circuit, or NULL on failure.
+ * @return ZKL_OK, or ZKL_ERROR_SOURCE if the program has errors.
+ */
+ZklStatus zkl_compile(ZklCompiler* compiler, const char* source, size_t length, ZklCircuit** circuit);
+
+/**
+ * Returns the number of diagnostics the last compilation produced. A
+ * compilation stops at its first error, so this is 0 or 1 for now.
+ */
+uint32_t zkl_diagnostic_count(const ZklCompiler* compiler);
+
+/**
+ * Returns one of the last compilation's diagnostics. Its message is valid
+ * until the compiler's next compilation.
+ *
+ * @param compiler The compiler.
+ * @param index 0 .. zkl_diagnostic_count() - 1.
+ * @return The diagnostic, or NULL if index is out of range.
+ */
+const ZklDiagnostic* zkl_diagnostic(const ZklCompiler* compiler, uint32_t index);
+
+/**
+ * Formats a diagnostic as "path:line:column: error: message", leaving out
+ * the path if it is NULL and the position if there is none. Like snprintf,
+ * the text is truncated to fit and its full length is returned.
+ */
+int zkl_format_diagnostic(const ZklDiagnostic* diagnostic, const char* path, char* buffer, size_t size);
+
+/**
+ * Returns a short description of a status, e.g. "source has errors".
+ */
+const char* zkl_status_string(ZklStatus status);
+
+/**
+ * Describes a circuit's size and interface.
+ */
+void zkl_circuit_info(const ZklCircuit* circuit, ZklCircuitInfo* info);
+
+/**
+ * Writes a circuit to a circuit file, which zkl tools and load_circuit
+ * read. The file is replaced atomically.
+ *
+ * @param circuit The circuit.
+ * @param path Path of the file to write.
+ * @return ZKL_OK, or ZKL_ERROR_IO (with errno set) if writing failed.
+ */
+ZklStatus zkl_circuit_save(const ZklCircuit* circuit, const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // ZKL_H
@@ -0,0 +1,393 @@
+#include "circuit_file.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A named variable, for sorting the name index
+typedef struct {
+    const char* name;
+    uint32_t variable;
+} NamedVariable;
+
+static int compare_named(const void* a, const void* b) {
+    const NamedVariable* x = (const NamedVariable*)a;
+    const NamedVariable* y = (const NamedVariable*)b;
+    int order = strcmp(x->name, y->name);
+    if (order != 0) return order;
+    return x->variable < y->variable ? -1 : x->variable > y->variable;
+}
+
+// Helper to round a size up to the section alignment
+static uint64_t align_up(uint64_t size) {
+    return (size + CIRCUIT_ALIGNMENT - 1) & ~(uint64_t)(CIRCUIT_ALIGNMENT - 1);
+}
+
+// Write a constraint system as a circuit file
+int save_circuit(const CompilerContext* ctx, const IRProgram* program, const R1CS* r1cs, const char* path) {
+    // Name each value after the variable defined by it or copied from it
+    Symbol* value_names = (Symbol*)calloc(program->count ? program->count : 1, sizeof(Symbol));
+    uint32_t* variable_names = (uint32_t*)malloc(sizeof(uint32_t) * (r1cs->variable_count ? r1cs->variable_count : 1));
+    NamedVariable* named = (NamedVariable*)malloc(sizeof(NamedVariable) * (r1cs->variable_count ? r1cs->variable_count : 1));
+    size_t names_capacity = 4096, names_size = 0;
+    char* names = (char*)malloc(names_capacity);
+    uint32_t* name_index = NULL;
+    int status = -1;
+    if (!value_names || !variable_names || !named || !names) goto done;
+
+    for (uint32_t i = 0; i < program->count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (instr->name == SYMBOL_NONE) continue;
+        if (instr->op == IR_OP_OUTPUT) {
+            // The name goes to the public output rather than the
+            // computed value (and the copies) it reveals
+            ValueId v = instr->src1;
+            while (!ir_is_const(v) && value_names[v] == instr->name && program->instrs[v].op != IR_OP_INPUT &&
+                   program->instrs[v].op != IR_OP_PUBLIC) {
+                value_names[v] = SYMBOL_NONE;
+                if (program->instrs[v].op != IR_OP_ASSIGN) break;
+                v = program->instrs[v].src1;
+            }
+        }
+        value_names[i] = instr->name;
+        if (instr->op == IR_OP_ASSIGN && !ir_is_const(instr->src1) && value_names[instr->src1] == SYMBOL_NONE) {
+            value_names[instr->src1] = instr->name;
+        }
+    }
+    uint32_t named_count = 0;
+    for (uint32_t v = 0; v < r1cs->variable_count; v++) {
+        ValueId origin = r1cs->variable_origins[v];
+        Symbol name = v == R1CS_ONE || (origin & R1CS_INVERSE_FLAG) ? SYMBOL_NONE : value_names[origin];
+        if (name == SYMBOL_NONE) {
+            variable_names[v] = CIRCUIT_NO_NAME;
+            continue;
+        }
+        uint32_t length = symbol_length(&ctx->symbols, name);
+        if (names_size + length + 1 > names_capacity) {
+            while (names_size + length + 1 > names_capacity) names_capacity *= 2;
+            char* grown = (char*)realloc(names, names_capacity);
+            if (!grown) goto done;
+            names = grown;
+        }
+        variable_names[v] = (uint32_t)names_size;
+        memcpy(names + names_size, symbol_text(&ctx->symbols, name), length + 1);
+        named[named_count].name = symbol_text(&ctx->symbols, name);
+        named[named_count++].variable = v;
+        names_size += length + 1;
+    }
+    qsort(named, named_count, sizeof(NamedVariable), compare_named);
+    name_index = (uint32_t*)malloc(sizeof(uint32_t) * (named_count ? named_count : 1));
+    if (!name_index) goto done;
+    for (uint32_t k = 0; k < named_count; k++) name_index[k] = named[k].variable;
+
+    // Lay out the sections
+    CircuitHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CIRCUIT_MAGIC, sizeof(CIRCUIT_MAGIC));
+    header.version = CIRCUIT_VERSION;
+    header.byte_order = CIRCUIT_BYTE_ORDER;
+    strncpy(header.field, ctx->field->name, sizeof(header.field) - 1);
+    memcpy(header.modulus, ctx->field->modulus, sizeof(header.modulus));
+    header.constraint_count = r1cs->constraint_count;
+    header.variable_count = r1cs->variable_count;
+    header.public_count = r1cs->public_count;
+    header.input_count = r1cs->input_count;
+    header.output_count = r1cs->output_count;
+    header.coefficient_count = r1cs->coefficients.count;
+    header.named_count = named_count;
+    header.folded_linear = r1cs->folded_linear;
+    header.materialized = r1cs->materialized;
+
+    const void* data[CIRCUIT_SECTION_COUNT];
+    const SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+    for (int m = 0; m < 3; m++) {
+        header.nonzeros[m] = matrices[m]->nonzeros;
+        data[CIRCUIT_A_ROWS + 3 * m] = matrices[m]->row_offsets;
+        data[CIRCUIT_A_COLUMNS + 3 * m] = matrices[m]->columns;
+        data[CIRCUIT_A_COEFFICIENTS + 3 * m] = matrices[m]->coefficients;
+        header.sections[CIRCUIT_A_ROWS + 3 * m].size = sizeof(uint32_t) * ((uint64_t)r1cs->constraint_count + 1);
+        header.sections[CIRCUIT_A_COLUMNS + 3 * m].size = sizeof(uint32_t) * (uint64_t)matrices[m]->nonzeros;
+        header.sections[CIRCUIT_A_COEFFICIENTS + 3 * m].size = sizeof(uint32_t) * (uint64_t)matrices[m]->nonzeros;
+    }
+    data[CIRCUIT_COEFFICIENTS] = r1cs->coefficients.values;
+    header.sections[CIRCUIT_COEFFICIENTS].size = sizeof(FieldElement) * (uint64_t)r1cs->coefficients.count;
+    data[CIRCUIT_LOCATIONS] = r1cs->locations;
+    header.sections[CIRCUIT_LOCATIONS].size = sizeof(IRLocation) * (uint64_t)r1cs->constraint_count;
+    data[CIRCUIT_VARIABLE_NAMES] = variable_names;
+    header.sections[CIRCUIT_VARIABLE_NAMES].size = sizeof(uint32_t) * (uint64_t)r1cs->variable_count;
+    data[CIRCUIT_NAME_INDEX] = name_index;
+    header.sections[CIRCUIT_NAME_INDEX].size = sizeof(uint32_t) * (uint64_t)named_count;
+    data[CIRCUIT_NAMES] = names;
+    header.sections[CIRCUIT_NAMES].size = names_size;
+
+    // Each section is preceded by padding up to its aligned offset
+    FileChunk chunks[1 + 2 * CIRCUIT_SECTION_COUNT];
+    size_t chunk_count = 0;
+    uint64_t offset = sizeof(CircuitHeader);
+    chunks[chunk_count++] = (FileChunk){&header, sizeof(CircuitHeader)};
+    for (int s = 0; s < CIRCUIT_SECTION_COUNT; s++) {
+        uint64_t aligned = align_up(offset);
+        if (aligned > offset) chunks[chunk_count++] = (FileChunk){NULL, aligned - offset};
+        header.sections[s].offset = aligned;
+        chunks[chunk_count++] = (FileChunk){data[s], header.sections[s].size};
+        offset = aligned + header.sections[s].size;
+    }
+    header.file_size = offset;
+    status = write_file(path, chunks, chunk_count);
+
+done:
+    if (status != 0 && errno == 0) errno = ENOMEM;
+    free(value_names);
+    free(variable_names);
+    free(named);
+    free(names);
+    free(name_index);
+    return status;
+}
+
+// Helper to check that a section lies within the file, is aligned for
+// direct access and holds count elements of the given size
+static int section_valid(const CircuitHeader* header, CircuitSection section, uint64_t count, size_t element) {
+    const CircuitExtent* extent = &header->sections[section];
+    return extent->offset % CIRCUIT_ALIGNMENT == 0 && extent->offset <= header->file_size &&
+           extent->size <= header->file_size - extent->offset && extent->size == count * element;
+}
+
+// Map a circuit file and point a constraint system into it
+Circuit* load_circuit(const char* path) {
+    MappedFile* file = map_file(path);
+    if (!file) {
+        fprintf(stderr, "Error: Could not read circuit file '%s'.\n", path);
+        return NULL;
+    }
+
+    const CircuitHeader* header = (const CircuitHeader*)file->data;
+    const char* problem = NULL;
+    const Field* field = NULL;
+    if (file->size < sizeof(CircuitHeader) || memcmp(header->magic, CIRCUIT_MAGIC, sizeof(CIRCUIT_MAGIC)) != 0) {
+        problem = "not a circuit file";
+    } else if (header->version != CIRCUIT_VERSION) {
+        problem = "unsupported format version";
+    } else if (header->byte_order != CIRCUIT_BYTE_ORDER) {
+        problem = "written with a different byte order";
+    } else if (header->file_size != file->size) {
+        problem = "truncated";
+    } else if (memchr(header->field, '\0', sizeof(header->field)) == NULL ||
+               !(field = field_by_name(header->field)) ||
+               memcmp(field->modulus, header->modulus, sizeof(header->modulus)) != 0) {
+        problem = "unknown field";
+    } else {
+        uint64_t counts[CIRCUIT_SECTION_COUNT];
+        size_t elements[CIRCUIT_SECTION_COUNT];
+        for (int m = 0; m < 3; m++) {
+            counts[CIRCUIT_A_ROWS + 3 * m] = (uint64_t)header->constraint_count + 1;
+            counts[CIRCUIT_A_COLUMNS + 3 * m] = header->nonzeros[m];
+            counts[CIRCUIT_A_COEFFICIENTS + 3 * m] = header->nonzeros[m];
+            elements[CIRCUIT_A_ROWS + 3 * m] = sizeof(uint32_t);
+            elements[CIRCUIT_A_COLUMNS + 3 * m] = sizeof(uint32_t);
+            elements[CIRCUIT_A_COEFFICIENTS + 3 * m] = sizeof(uint32_t);
+        }
+        counts[CIRCUIT_COEFFICIENTS] = header->coefficient_count;
+        elements[CIRCUIT_COEFFICIENTS] = sizeof(FieldElement);
+        counts[CIRCUIT_LOCATIONS] = header->constraint_count;
+        elements[CIRCUIT_LOCATIONS] = sizeof(IRLocation);
+        counts[CIRCUIT_VARIABLE_NAMES] = header->variable_count;
+        elements[CIRCUIT_VARIABLE_NAMES] = sizeof(uint32_t);
+        counts[CIRCUIT_NAME_INDEX] = header->named_count;
+        elements[CIRCUIT_NAME_INDEX] = sizeof(uint32_t);
+        counts[CIRCUIT_NAMES] = header->sections[CIRCUIT_NAMES].size;
+        elements[CIRCUIT_NAMES] = 1;
+        for (int s = 0; s < CIRCUIT_SECTION_COUNT && !problem; s++) {
+            if (!section_valid(header, s, counts[s], elements[s])) problem = "corrupt section table";
+        }
+    }
+    if (problem) {
+        fprintf(stderr, "Error: Invalid circuit file '%s' (%s).\n", path, problem);
+        unmap_file(file);
+        return NULL;
+    }
+
+    Circuit* circuit = (Circuit*)calloc(1, sizeof(Circuit));
+    if (!circuit) {
+        unmap_file(file);
+        return NULL;
+    }
+    circuit->file = file;
+    circuit->header = header;
+    circuit->field = field;
+
+    // Pointers into the mapping; nothing is copied
+    const char* base = file->data;
+    R1CS* r1cs = &circuit->r1cs;
+    SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+    for (int m = 0; m < 3; m++) {
+        matrices[m]->row_offsets = (uint32_t*)(base + header->sections[CIRCUIT_A_ROWS + 3 * m].offset);
+        matrices[m]->columns = (uint32_t*)(base + header->sections[CIRCUIT_A_COLUMNS + 3 * m].offset);
+        matrices[m]->coefficients = (uint32_t*)(base + header->sections[CIRCUIT_A_COEFFICIENTS + 3 * m].offset);
+        matrices[m]->nonzeros = matrices[m]->capacity = header->nonzeros[m];
+    }
+    r1cs->constraint_count = r1cs->constraint_capacity = header->constraint_count;
+    r1cs->variable_count = r1cs->variable_capacity = header->variable_count;
+    r1cs->public_count = header->public_count;
+    r1cs->output_count = header->output_count;
+    r1cs->input_count = header->input_count;
+    r1cs->coefficients.values = (FieldElement*)(base + header->sections[CIRCUIT_COEFFICIENTS].offset);
+    r1cs->coefficients.count = r1cs->coefficients.capacity = header->coefficient_count;
+    r1cs->locations = (IRLocation*)(base + header->sections[CIRCUIT_LOCATIONS].offset);
+    r1cs->folded_linear = header->folded_linear;
+    r1cs->materialized = header->materialized;
+    circuit->variable_names = (const uint32_t*)(base + header->sections[CIRCUIT_VARIABLE_NAMES].offset);
+    circuit->name_index = (const uint32_t*)(base + header->sections[CIRCUIT_NAME_INDEX].offset);
+    circuit->names = base + header->sections[CIRCUIT_NAMES].offset;
+    return circuit;
+}
+
+// Unmap a loaded circuit
+void free_circuit(Circuit* circuit) {
+    if (!circuit) return;
+    unmap_file(circuit->file);
+    free(circuit);
+}
+
+// Helper to check one matrix's row offsets, columns and coefficient indices
+static const char* matrix_problem(const SparseMatrix* m, const R1CS* r1cs) {
+    if (m->row_offsets[0] != 0 || m->row_offsets[r1cs->constraint_count] != m->nonzeros) {
+        return "corrupt row offsets";
+    }
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        if (m->row_offsets[row + 1] < m->row_offsets[row]) return "corrupt row offsets";
+    }
+    for (uint32_t k = 0; k < m->nonzeros; k++) {
+        if (m->columns[k] >= r1cs->variable_count) return "column out of range";
+        if (m->coefficients[k] >= r1cs->coefficients.count) return "coefficient index out of range";
+    }
+    return NULL;
+}
+
+// Helper to check the name sections: offsets inside a NUL-terminated
+// names section, and an index of named variables
+static const char* names_problem(const Circuit* circuit) {
+    uint64_t names_size = circuit->header->sections[CIRCUIT_NAMES].size;
+    if (names_size && circuit->names[names_size - 1] != '\0') return "unterminated names";
+    for (uint32_t v = 0; v < circuit->r1cs.variable_count; v++) {
+        uint32_t offset = circuit->variable_names[v];
+        if (offset != CIRCUIT_NO_NAME && offset >= names_size) return "name offset out of range";
+    }
+    for (uint32_t k = 0; k < circuit->header->named_count; k++) {
+        uint32_t variable = circuit->name_index[k];
+        if (variable >= circuit->r1cs.variable_count || circuit->variable_names[variable] == CIRCUIT_NO_NAME) {
+            return "corrupt name index";
+        }
+    }
+    return NULL;
+}
+
+// Check everything a constraint evaluation or name lookup reads
+int circuit_validate(const Circuit* circuit, const char* path) {
+    const R1CS* r1cs = &circuit->r1cs;
+    const SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+    const char* problem = NULL;
+    for (int m = 0; m < 3 && !problem; m++) problem = matrix_problem(matrices[m], r1cs);
+    for (uint32_t k = 0; k < r1cs->coefficients.count && !problem; k++) {
+        if (!field_is_reduced(circuit->field, &r1cs->coefficients.values[k])) problem = "coefficient out of range";
+    }
+    if (!problem) problem = names_problem(circuit);
+    if (problem) {
+        fprintf(stderr, "Error: Invalid circuit file '%s' (%s).\n", path, problem);
+        return 0;
+    }
+    return 1;
+}
+
+// Binary search of the sorted name index
+uint32_t circuit_find_variable(const Circuit* circuit, const char* name) {
+    uint32_t low = 0, high = circuit->header->named_count;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        int order = strcmp(circuit_variable_name(circuit, circuit->name_index[mid]), name);
+        if (order == 0) return circuit->name_index[mid];
+        if (order < 0) low = mid + 1;
+        else high = mid;
+    }
+    return CIRCUIT_NO_NAME;
+}
+
+// Write a witness file: the header, padding, then the values
+int save_witness(const Field* field, const FieldElement* values, uint32_t variable_count, const char* path) {
+    WitnessHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, WITNESS_MAGIC, sizeof(WITNESS_MAGIC));
+    header.version = WITNESS_VERSION;
+    header.byte_order = CIRCUIT_BYTE_ORDER;
+    strncpy(header.field, field->name, sizeof(header.field) - 1);
+    memcpy(header.modulus, field->modulus, sizeof(header.modulus));
+    header.variable_count = variable_count;
+    header.values_offset = align_up(sizeof(WitnessHeader));
+    header.file_size = header.values_offset + sizeof(FieldElement) * (uint64_t)variable_count;
+
+    FileChunk chunks[3] = {
+        {&header, sizeof(WitnessHeader)},
+        {NULL, header.values_offset - sizeof(WitnessHeader)},
+        {values, sizeof(FieldElement) * (size_t)variable_count},
+    };
+    return write_file(path, chunks, 3);
+}
+
+// Map a witness file and point at its values
+Witness* load_witness(const char* path) {
+    MappedFile* file = map_file(path);
+    if (!file) {
+        fprintf(stderr, "Error: Could not read witness file '%s'.\n", path);
+        return NULL;
+    }
+
+    const WitnessHeader* header = (const WitnessHeader*)file->data;
+    const char* problem = NULL;
+    const Field* field = NULL;
+    if (file->size < sizeof(WitnessHeader) || memcmp(header->magic, WITNESS_MAGIC, sizeof(WITNESS_MAGIC)) != 0) {
+        problem = "not a witness file";
+    } else if (header->version != WITNESS_VERSION) {
+        problem = "unsupported format version";
+    } else if (header->byte_order != CIRCUIT_BYTE_ORDER) {
+        problem = "written with a different byte order";
+    } else if (header->file_size != file->size) {
+        problem = "truncated";
+    } else if (memchr(header->field, '\0', sizeof(header->field)) == NULL ||
+               !(field = field_by_name(header->field)) ||
+               memcmp(field->modulus, header->modulus, sizeof(header->modulus)) != 0) {
+        problem = "unknown field";
+    } else if (header->values_offset % CIRCUIT_ALIGNMENT != 0 || header->values_offset > header->file_size ||
+               header->file_size - header->values_offset != sizeof(FieldElement) * (uint64_t)header->variable_count) {
+        problem = "corrupt value table";
+    }
+    if (!problem) {
+        const FieldElement* values = (const FieldElement*)(file->data + header->values_offset);
+        for (uint32_t v = 0; v < header->variable_count && !problem; v++) {
+            if (!field_is_reduced(field, &values[v])) problem = "value out of range";
+        }
+    }
+    if (problem) {
+        fprintf(stderr, "Error: Invalid witness file '%s' (%s).\n", path, problem);
+        unmap_file(file);
+        return NULL;
+    }
+
+    Witness* witness = (Witness*)calloc(1, sizeof(Witness));
+    if (!witness) {
+        unmap_file(file);
+        return NULL;
+    }
+    witness->file = file;
+    witness->header = header;
+    witness->field = field;
+    witness->values = (const FieldElement*)(file->data + header->values_offset);
+    witness->variable_count = header->variable_count;
+    return witness;
+}
+
+// Unmap a loaded witness
+void free_witness(Witness* witness) {
+    if (!witness) return;
+    unmap_file(witness->file);
+    free(witness);
+}
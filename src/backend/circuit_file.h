@@ -0,0 +1,198 @@
+#ifndef CIRCUIT_FILE_H
+#define CIRCUIT_FILE_H
+
+#include "constraint_compiler.h"
+#include "../utils/file_io.h"
+
+// A compiled circuit on disk: a fixed header followed by sections that hold
+// the constraint system's arrays exactly as they are laid out in memory, so
+// a mapped file is used in place and processes loading the same circuit
+// share its pages. Integers are stored in the byte order of the machine
+// that wrote the file (checked on load); coefficients are stored in
+// Montgomery form for the field named in the header.
+#define CIRCUIT_MAGIC "ZKLCIRC"
+#define CIRCUIT_VERSION 1
+#define CIRCUIT_BYTE_ORDER 0x01020304u
+
+// Sections start on this boundary, so every array is suitably aligned for
+// direct access (and starts on its own cache line)
+#define CIRCUIT_ALIGNMENT 64
+
+// Sections of a circuit file, in file order
+typedef enum {
+    CIRCUIT_A_ROWS,          // Row offsets of A (constraint_count + 1)
+    CIRCUIT_A_COLUMNS,       // Variable of each nonzero of A
+    CIRCUIT_A_COEFFICIENTS,  // Coefficient index of each nonzero of A
+    CIRCUIT_B_ROWS,
+    CIRCUIT_B_COLUMNS,
+    CIRCUIT_B_COEFFICIENTS,
+    CIRCUIT_C_ROWS,
+    CIRCUIT_C_COLUMNS,
+    CIRCUIT_C_COEFFICIENTS,
+    CIRCUIT_COEFFICIENTS,    // Distinct coefficient values (FieldElement)
+    CIRCUIT_LOCATIONS,       // Source position of each constraint (IRLocation)
+    CIRCUIT_VARIABLE_NAMES,  // Offset of each variable's name in CIRCUIT_NAMES, or CIRCUIT_NO_NAME
+    CIRCUIT_NAME_INDEX,      // Named variables, sorted by name
+    CIRCUIT_NAMES,           // NUL-terminated names
+    CIRCUIT_SECTION_COUNT
+} CircuitSection;
+
+#define CIRCUIT_NO_NAME 0xFFFFFFFFu
+
+// Position of a section in the file
+typedef struct {
+    uint64_t offset;
+    uint64_t size;
+} CircuitExtent;
+
+// The header at the start of a circuit file
+typedef struct {
+    char magic[8];                  // CIRCUIT_MAGIC, NUL-padded
+    uint32_t version;               // CIRCUIT_VERSION
+    uint32_t byte_order;            // CIRCUIT_BYTE_ORDER as written
+    uint64_t file_size;             // Total size, to detect truncation
+    char field[16];                 // Name of the field, e.g. "bn254"
+    uint64_t modulus[FIELD_LIMBS];  // Its modulus, to detect mismatches
+    uint32_t constraint_count;
+    uint32_t variable_count;
+    uint32_t public_count;          // Public inputs and outputs
+    uint32_t input_count;
+    uint32_t nonzeros[3];           // Of A, B and C
+    uint32_t coefficient_count;
+    uint32_t named_count;           // Entries in the name index
+    uint32_t folded_linear;
+    uint32_t materialized;
+    uint32_t output_count;          // Public outputs, the last of the public variables
+    CircuitExtent sections[CIRCUIT_SECTION_COUNT];
+} CircuitHeader;
+
+// A circuit loaded from disk. r1cs points into the mapped file and must be
+// treated as read-only; it has no variable origins (the IR is not stored)
+// and its coefficient pool cannot be added to.
+typedef struct {
+    MappedFile* file;
+    const CircuitHeader* header;
+    const Field* field;             // The field the circuit is over
+    R1CS r1cs;
+    const uint32_t* variable_names; // Name offset of each variable
+    const uint32_t* name_index;     // Named variables, sorted by name
+    const char* names;
+} Circuit;
+
+// A witness on disk: a header followed, on the next section boundary, by
+// the values of a circuit's variables in Montgomery form, for checking the
+// circuit's constraints without recomputing them. Mapped and used in
+// place, like circuit files.
+#define WITNESS_MAGIC "ZKLWTNS"
+#define WITNESS_VERSION 1
+
+// The header at the start of a witness file
+typedef struct {
+    char magic[8];                  // WITNESS_MAGIC, NUL-padded
+    uint32_t version;               // WITNESS_VERSION
+    uint32_t byte_order;            // CIRCUIT_BYTE_ORDER as written
+    uint64_t file_size;             // Total size, to detect truncation
+    char field[16];                 // Name of the field the values are in
+    uint64_t modulus[FIELD_LIMBS];  // Its modulus, to detect mismatches
+    uint32_t variable_count;        // Number of values, including the constant 1
+    uint32_t reserved;
+    uint64_t values_offset;         // Where the values start
+} WitnessHeader;
+
+// A witness loaded from disk; values point into the mapped file
+typedef struct {
+    MappedFile* file;
+    const WitnessHeader* header;
+    const Field* field;
+    const FieldElement* values;
+    uint32_t variable_count;
+} Witness;
+
+// Function prototypes
+
+/**
+ * Writes a constraint system to a circuit file, naming each variable after
+ * the source variable it holds, if any.
+ *
+ * @param ctx The compilation context the system belongs to.
+ * @param program The program the system was lowered from.
+ * @param r1cs The constraint system.
+ * @param path Path of the file to write; replaced atomically.
+ * @return 0 on success, -1 on failure (errno says why).
+ */
+int save_circuit(const CompilerContext* ctx, const IRProgram* program, const R1CS* r1cs, const char* path);
+
+/**
+ * Maps a circuit file for use in place. Only the header and the section
+ * bounds are checked, so loading takes constant time; the file's contents
+ * are trusted.
+ *
+ * @param path Path of the circuit file.
+ * @return The circuit, or NULL (after printing why) if the file cannot be
+ *         read or is not a valid circuit for this machine.
+ */
+Circuit* load_circuit(const char* path);
+
+/**
+ * Unmaps a circuit returned by load_circuit.
+ */
+void free_circuit(Circuit* circuit);
+
+/**
+ * Checks the parts of a loaded circuit that load_circuit trusts, which is
+ * needed before evaluating the constraints of a file from elsewhere. The
+ * row offsets of each matrix must run from 0 to its nonzero count without
+ * decreasing. Every column must name a variable, and every coefficient
+ * index must be in the pool. Every coefficient must be below the modulus.
+ * Every name offset must fall in the NUL-terminated names section, and the
+ * name index must list only named variables. Takes time linear in the size
+ * of the system.
+ *
+ * @param circuit The circuit, as returned by load_circuit.
+ * @param path Path it was loaded from, for the message.
+ * @return 1 if the circuit is consistent, 0 (after printing why) if not.
+ */
+int circuit_validate(const Circuit* circuit, const char* path);
+
+/**
+ * Returns the name of a variable, or NULL if it has none.
+ */
+static inline const char* circuit_variable_name(const Circuit* circuit, uint32_t variable) {
+    uint32_t offset = circuit->variable_names[variable];
+    return offset == CIRCUIT_NO_NAME ? NULL : circuit->names + offset;
+}
+
+/**
+ * Finds a variable by name with a binary search of the name index.
+ *
+ * @return The variable, or CIRCUIT_NO_NAME if no variable has that name.
+ */
+uint32_t circuit_find_variable(const Circuit* circuit, const char* name);
+
+/**
+ * Writes a witness file.
+ *
+ * @param field The field the values are in.
+ * @param values The value of each variable, starting with the constant 1.
+ * @param variable_count Number of values.
+ * @param path Path of the file to write; replaced atomically.
+ * @return 0 on success, -1 on failure (errno says why).
+ */
+int save_witness(const Field* field, const FieldElement* values, uint32_t variable_count, const char* path);
+
+/**
+ * Maps a witness file for use in place, checking its header and that every
+ * value is below the field's modulus.
+ *
+ * @param path Path of the witness file.
+ * @return The witness, or NULL (after printing why) if the file cannot be
+ *         read or is not a valid witness for this machine.
+ */
+Witness* load_witness(const char* path);
+
+/**
+ * Unmaps a witness returned by load_witness.
+ */
+void free_witness(Witness* witness);
+
+#endif // CIRCUIT_FILE_H
@@ -0,0 +1,1241 @@
+#include "compile_cache.h"
+#include <setjmp.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../frontend/validator.h"
+#include "../ir/optimizer.h"
+#include "../utils/file_io.h"
+
+// A cache file is a CacheFileHeader followed by records back to back, each
+// a RecordHeader and body_size bytes of body. Files are read only by the
+// machine that wrote them, so integers are in its byte order.
+#define CACHE_MAGIC "ZKLCACHE"
+#define CACHE_VERSION 2
+#define CACHE_BYTE_ORDER 0x01020304u
+
+// Records beyond twice those in use that a file may hold before a save
+// rewrites it
+#define CACHE_COMPACT_SLACK 4096
+
+// Statements parsed at once when compiling the ones the cache lacks
+#define PARSE_WINDOW 256
+
+// Record flags
+#define RECORD_ROOT 1u          // Kept even if nothing reads the statement's result
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;        // CACHE_BYTE_ORDER as written
+    char field[16];             // Name of the field coefficients are in
+} CacheFileHeader;
+
+// A 128-bit content hash
+typedef struct {
+    uint64_t lo, hi;
+} CacheKey;
+
+// The fixed part of a record. The body holds, as LEB128 varints unless
+// noted:
+//   coefficient table: count, then each value as 32 raw bytes
+//   result: 1 + local value the statement defines, or 0
+//   export: export_count terms of (variable, coefficient, 8-byte identity)
+//   instructions: instr_count of (op * 2 + named, src1, src2, line, column)
+//   variables: variable_count origins, local value * 2 + inverse
+//   externals: external_count of (read, export term)
+//   constraints: constraint_count of (line, column, then A, B and C rows,
+//                each a term count and (variable, coefficient) terms)
+//   statistics: folded_linear, materialized
+// Values are local: 0 is the statement's first instruction. Variables are
+// 0 for the constant 1, 1 .. external_count for those the statement uses
+// from others' exports, then its own. Locations are relative to the
+// statement's first token, so records survive the statement moving.
+typedef struct {
+    CacheKey key;               // Hash of the statement's text and its reads' exports
+    CacheKey export_hash;       // Hash of the combination the statement defines
+    uint64_t checksum;          // record_checksum() of the rest of the record
+    uint32_t body_size;
+    uint32_t flags;             // RECORD_*
+    uint32_t instr_count;
+    uint32_t variable_count;    // Variables of the statement's own
+    uint32_t constraint_count;
+    uint32_t nonzeros[3];       // Of A, B and C
+    uint32_t export_count;      // Terms of the combination the statement defines
+    uint32_t external_count;    // Variables of other statements it uses
+} RecordHeader;
+
+// Coefficient codes: the common values, then the record's table entries
+enum { COEFF_ZERO, COEFF_ONE, COEFF_MINUS_ONE, COEFF_TABLE };
+
+// Operand codes are index << 2 | kind
+enum { OPERAND_LOCAL, OPERAND_READ, OPERAND_CONST, OPERAND_NONE };
+
+// A slot of the record table
+typedef struct {
+    uint64_t key;               // Low half of the record's key
+    const unsigned char* record; // NULL if the slot is empty
+} CacheSlot;
+
+struct CompileCache {
+    char* path;
+    const Field* field;
+    MappedFile* file;           // Records loaded from disk, or NULL
+    int rewrite;                // The file must be rewritten rather than appended to
+    const unsigned char** saved; // Records in the file, in order
+    uint32_t saved_count;
+    uint32_t saved_capacity;
+    Arena records;              // Records compiled since opening
+    const unsigned char** added; // Those not yet saved, in order
+    uint32_t added_count;
+    uint32_t added_capacity;
+    CacheSlot* slots;           // Open addressing table of records by key
+    uint8_t* used;              // Slots the last compilation used
+    uint32_t slot_mask;
+    uint32_t count;
+    uint32_t used_count;
+    int compiled;               // A compilation ran since opening
+};
+
+// A statement as split from the token stream
+typedef struct {
+    uint32_t first_token;
+    uint32_t token_count;
+    Symbol subject;             // Variable defined or output (SYMBOL_NONE for assertions)
+    ASTNodeType kind;
+    uint32_t read_offset;       // Variables read: reads[read_offset .. next statement's read_offset)
+    const unsigned char* record;
+    ValueId result;             // Assembled value the statement defines
+    uint32_t export_offset;     // Assembled variables of its export, in export_vars
+    const AST* ast;             // AST of its parsing window (NULL until the window is parsed)
+    uint32_t ast_index;         // Which of that AST's statements it is
+    uint8_t live;
+} Statement;
+
+// A variable a statement being compiled uses from another's export
+typedef struct {
+    uint64_t identity;
+    uint32_t read;              // Which of the statement's reads exports it
+    uint32_t term;              // Which term of that export
+} External;
+
+// A growable byte buffer
+typedef struct {
+    unsigned char* data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+// A position in a record body
+typedef struct {
+    const unsigned char* p;
+} Reader;
+
+// State for one incremental compilation
+typedef struct {
+    CompilerContext* ctx;
+    CompileCache* cache;
+    const TokenStream* stream;
+    Arena work;                 // Freed when the compilation ends
+    Statement* statements;      // count + 1; the last only ends the read lists
+    uint32_t count;
+    Symbol* reads;
+    uint32_t* definers;         // 1 + statement defining each symbol, or 0
+    FieldElement common[COEFF_TABLE]; // Values of the common coefficient codes
+
+    // Compiling statements the cache lacks
+    int compiling;              // The fields below are set up
+    IRBuilder ir;
+    ConstraintFragment fragment;
+    External* externals;
+    uint32_t external_capacity;
+    uint32_t* bound_offsets;
+    uint32_t bound_offset_capacity;
+    LinearTerm* bound_terms;
+    uint32_t bound_term_capacity;
+    uint8_t* keep;              // Instructions kept in the record
+    uint32_t keep_capacity;
+    ValueId* local;             // Their local numbers
+    uint32_t local_capacity;
+    FieldElement* table;        // Coefficient table of the record being built
+    uint32_t table_count;
+    uint32_t table_capacity;
+    ByteBuffer body;            // Body after the coefficient table
+} IncrementalBuild;
+
+// Helper to grow a heap array to hold at least needed elements
+static void* reserve(void* array, uint32_t* capacity, size_t needed, size_t element) {
+    if (needed <= *capacity) return array;
+    size_t grown = *capacity ? *capacity : 16;
+    while (grown < needed) grown *= 2;
+    array = realloc(array, grown * element);
+    if (!array || grown > UINT32_MAX) {
+        fprintf(stderr, "Error: Memory allocation failed for the compile cache.\n");
+        exit(1);
+    }
+    *capacity = (uint32_t)grown;
+    return array;
+}
+
+// Helper to make room for extra bytes in a buffer
+static void buffer_reserve(ByteBuffer* buffer, size_t extra) {
+    if (buffer->size + extra <= buffer->capacity) return;
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity < buffer->size + extra) capacity *= 2;
+    buffer->data = (unsigned char*)realloc(buffer->data, capacity);
+    if (!buffer->data) {
+        fprintf(stderr, "Error: Memory allocation failed for the compile cache.\n");
+        exit(1);
+    }
+    buffer->capacity = capacity;
+}
+
+// Helper to append raw bytes
+static void put_bytes(ByteBuffer* buffer, const void* data, size_t size) {
+    buffer_reserve(buffer, size);
+    memcpy(buffer->data + buffer->size, data, size);
+    buffer->size += size;
+}
+
+// Helper to append an unsigned LEB128 varint
+static inline void put_varint(ByteBuffer* buffer, uint32_t value) {
+    buffer_reserve(buffer, 5);
+    while (value >= 0x80) {
+        buffer->data[buffer->size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    buffer->data[buffer->size++] = (unsigned char)value;
+}
+
+// Helper to read an unsigned LEB128 varint
+static inline uint32_t get_varint(Reader* reader) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        unsigned char byte = *reader->p++;
+        if (shift < 32) value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) return value;
+    }
+}
+
+// Helper to read 8 raw bytes
+static inline uint64_t get_u64(Reader* reader) {
+    uint64_t value;
+    memcpy(&value, reader->p, sizeof(value));
+    reader->p += sizeof(value);
+    return value;
+}
+
+// Incremental 128-bit hashing of words: two multiply-rotate lanes that
+// feed each other, finished with MurmurHash3's avalanche step
+typedef struct {
+    uint64_t a, b;
+    uint64_t words;
+} Hasher;
+
+static inline uint64_t rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t fmix64(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline void hash_init(Hasher* h) {
+    h->a = 0x9E3779B97F4A7C15ull;
+    h->b = 0xC2B2AE3D27D4EB4Full;
+    h->words = 0;
+}
+
+static inline void hash_word(Hasher* h, uint64_t word) {
+    h->a = rotl64(h->a ^ (word * 0x87C37B91114253D5ull), 31) * 0x4CF5AD432745937Full + h->b;
+    h->b = rotl64(h->b ^ (word * 0x4CF5AD432745937Full), 33) * 0x87C37B91114253D5ull ^ h->a;
+    h->words++;
+}
+
+// Helper to hash a byte string, length included so strings that end in
+// zero bytes stay distinct
+static void hash_bytes(Hasher* h, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t word;
+    for (; size >= 8; bytes += 8, size -= 8) {
+        memcpy(&word, bytes, 8);
+        hash_word(h, word);
+    }
+    word = 0;
+    memcpy(&word, bytes, size);
+    hash_word(h, word);
+    hash_word(h, size);
+}
+
+static inline CacheKey hash_final(const Hasher* h) {
+    uint64_t a = h->a ^ h->words, b = h->b ^ (h->words << 32);
+    a += b;
+    b += a;
+    a = fmix64(a);
+    b = fmix64(b);
+    a += b;
+    b += a;
+    CacheKey key = {a, b};
+    return key;
+}
+
+// Helpers to read a record's header and key
+static inline void read_header(const unsigned char* record, RecordHeader* header) {
+    memcpy(header, record, sizeof(RecordHeader));
+}
+
+static inline int record_has_key(const unsigned char* record, const CacheKey* key) {
+    return memcmp(record, key, sizeof(CacheKey)) == 0;
+}
+
+static inline CacheKey record_export_hash(const unsigned char* record) {
+    CacheKey hash;
+    memcpy(&hash, record + offsetof(RecordHeader, export_hash), sizeof(CacheKey));
+    return hash;
+}
+
+// Helper to hash a record's bytes other than its checksum. Bodies are
+// decoded without bounds checks, so a record whose checksum does not match
+// is never used.
+static uint64_t record_checksum(const unsigned char* record, uint32_t body_size) {
+    const size_t after = offsetof(RecordHeader, checksum) + sizeof(uint64_t);
+    Hasher h;
+    hash_init(&h);
+    hash_bytes(&h, record, offsetof(RecordHeader, checksum));
+    hash_bytes(&h, record + after, sizeof(RecordHeader) - after + body_size);
+    return hash_final(&h).lo;
+}
+
+// A record body opened for reading: its coefficient table, its result and
+// a reader at the export section
+typedef struct {
+    const unsigned char* table;
+    uint32_t table_count;
+    ValueId result;
+    Reader reader;
+} RecordBody;
+
+static void open_body(const unsigned char* record, RecordBody* body) {
+    Reader reader = {record + sizeof(RecordHeader)};
+    body->table_count = get_varint(&reader);
+    body->table = reader.p;
+    reader.p += (size_t)body->table_count * sizeof(FieldElement);
+    uint32_t result = get_varint(&reader);
+    body->result = result ? result - 1 : IR_NO_VALUE;
+    body->reader = reader;
+}
+
+// Helper to get the value of a coefficient code
+static inline FieldElement body_coefficient(const IncrementalBuild* b, const RecordBody* body, uint32_t code) {
+    if (code < COEFF_TABLE) return b->common[code];
+    FieldElement value;
+    memcpy(&value, body->table + (size_t)(code - COEFF_TABLE) * sizeof(FieldElement), sizeof(value));
+    return value;
+}
+
+// Helper to find the slot of a key, or the empty slot where it belongs
+static uint32_t find_slot(const CompileCache* cache, const CacheKey* key) {
+    uint32_t i = (uint32_t)(key->lo >> 32) & cache->slot_mask;
+    while (cache->slots[i].record) {
+        if (cache->slots[i].key == key->lo && record_has_key(cache->slots[i].record, key)) break;
+        i = (i + 1) & cache->slot_mask;
+    }
+    return i;
+}
+
+// Helper to add a record to the table, unless one with its key is present
+static uint32_t insert_record(CompileCache* cache, const unsigned char* record) {
+    CacheKey key;
+    memcpy(&key, record, sizeof(key));
+    uint32_t i = find_slot(cache, &key);
+    if (cache->slots[i].record) return i;
+    cache->slots[i].key = key.lo;
+    cache->slots[i].record = record;
+
+    // Keep the table at most half full
+    if (++cache->count * 2 > cache->slot_mask + 1) {
+        uint32_t mask = cache->slot_mask * 2 + 1;
+        CacheSlot* slots = (CacheSlot*)calloc((size_t)mask + 1, sizeof(CacheSlot));
+        uint8_t* used = (uint8_t*)calloc((size_t)mask + 1, 1);
+        if (!slots || !used) {
+            fprintf(stderr, "Error: Memory allocation failed for the compile cache.\n");
+            exit(1);
+        }
+        for (uint32_t k = 0; k <= cache->slot_mask; k++) {
+            if (!cache->slots[k].record) continue;
+            uint32_t j = (uint32_t)(cache->slots[k].key >> 32) & mask;
+            while (slots[j].record) j = (j + 1) & mask;
+            slots[j] = cache->slots[k];
+            used[j] = cache->used[k];
+            if (k == i) i = j;
+        }
+        free(cache->slots);
+        free(cache->used);
+        cache->slots = slots;
+        cache->used = used;
+        cache->slot_mask = mask;
+    }
+    return i;
+}
+
+// Helper to load the records of a mapped cache file, skipping damaged
+// records and stopping at a truncated tail
+static void load_records(CompileCache* cache) {
+    const MappedFile* file = cache->file;
+    CacheFileHeader header;
+    if (file->size < sizeof(header)) {
+        cache->rewrite = 1;
+        return;
+    }
+    memcpy(&header, file->data, sizeof(header));
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0 || header.version != CACHE_VERSION ||
+        header.byte_order != CACHE_BYTE_ORDER ||
+        strncmp(header.field, cache->field->name, sizeof(header.field)) != 0) {
+        cache->rewrite = 1;
+        return;
+    }
+
+    size_t offset = sizeof(header);
+    while (file->size - offset >= sizeof(RecordHeader)) {
+        const unsigned char* record = (const unsigned char*)file->data + offset;
+        RecordHeader record_header;
+        read_header(record, &record_header);
+        if (record_header.body_size > file->size - offset - sizeof(RecordHeader)) break;
+        offset += sizeof(RecordHeader) + record_header.body_size;
+        if (record_checksum(record, record_header.body_size) != record_header.checksum) {
+            cache->rewrite = 1; // Leave it out of the next file
+            continue;
+        }
+        insert_record(cache, record);
+        cache->saved = (const unsigned char**)reserve(cache->saved, &cache->saved_capacity, cache->saved_count + 1,
+                                                      sizeof(const unsigned char*));
+        cache->saved[cache->saved_count++] = record;
+    }
+    if (offset != file->size) cache->rewrite = 1; // Drop the partial record rather than append after it
+}
+
+// Open a cache file and index its records
+CompileCache* compile_cache_open(const char* path, const Field* field) {
+    CompileCache* cache = (CompileCache*)calloc(1, sizeof(CompileCache));
+    size_t length = strlen(path) + 1;
+    cache->path = (char*)malloc(length);
+    cache->slot_mask = 1023;
+    cache->slots = (CacheSlot*)calloc((size_t)cache->slot_mask + 1, sizeof(CacheSlot));
+    cache->used = (uint8_t*)calloc((size_t)cache->slot_mask + 1, 1);
+    if (!cache->path || !cache->slots || !cache->used) {
+        fprintf(stderr, "Error: Memory allocation failed for the compile cache.\n");
+        exit(1);
+    }
+    memcpy(cache->path, path, length);
+    cache->field = field;
+    arena_init(&cache->records, 0);
+
+    cache->file = map_file(path);
+    if (cache->file) {
+        load_records(cache);
+    } else {
+        cache->rewrite = 1;
+    }
+    return cache;
+}
+
+// Helper to test whether a record is the one in the table and in use
+static inline int record_used(const CompileCache* cache, const unsigned char* record) {
+    CacheKey key;
+    memcpy(&key, record, sizeof(key));
+    uint32_t i = find_slot(cache, &key);
+    return cache->slots[i].record == record && cache->used[i];
+}
+
+// Helper to write the cache file from scratch: the saved records that are
+// kept, then the added ones. Records adjacent in memory (runs of the
+// mapped file) go out as one chunk.
+static int rewrite_cache(CompileCache* cache, int used_only) {
+    uint32_t total = cache->saved_count + cache->added_count;
+    uint32_t chunk_capacity = 0, chunk_count = 0, kept_capacity = 0, kept_count = 0;
+    FileChunk* chunks = (FileChunk*)reserve(NULL, &chunk_capacity, 64, sizeof(FileChunk));
+    const unsigned char** kept = (const unsigned char**)reserve(NULL, &kept_capacity, total + 1,
+                                                                sizeof(const unsigned char*));
+
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    header.version = CACHE_VERSION;
+    header.byte_order = CACHE_BYTE_ORDER;
+    strncpy(header.field, cache->field->name, sizeof(header.field) - 1);
+    chunks[chunk_count].data = &header;
+    chunks[chunk_count++].size = sizeof(header);
+
+    for (uint32_t k = 0; k < total; k++) {
+        const unsigned char* record = k < cache->saved_count ? cache->saved[k] : cache->added[k - cache->saved_count];
+        if (used_only && !record_used(cache, record)) continue;
+        RecordHeader record_header;
+        read_header(record, &record_header);
+        size_t size = sizeof(RecordHeader) + record_header.body_size;
+        kept[kept_count++] = record;
+        FileChunk* last = &chunks[chunk_count - 1];
+        if (chunk_count > 1 && (const unsigned char*)last->data + last->size == record) {
+            last->size += size;
+            continue;
+        }
+        chunks = (FileChunk*)reserve(chunks, &chunk_capacity, chunk_count + 1, sizeof(FileChunk));
+        chunks[chunk_count].data = record;
+        chunks[chunk_count++].size = size;
+    }
+
+    int status = write_file(cache->path, chunks, chunk_count);
+    free(chunks);
+    if (status != 0) {
+        free(kept);
+        return -1;
+    }
+    free(cache->saved);
+    cache->saved = kept;
+    cache->saved_count = kept_count;
+    cache->saved_capacity = kept_capacity;
+    cache->added_count = 0;
+    cache->rewrite = 0;
+    return 0;
+}
+
+// Save the added records, appending them or rewriting the file
+int compile_cache_save(CompileCache* cache) {
+    uint32_t total = cache->saved_count + cache->added_count;
+    if (cache->rewrite || (cache->compiled && total > 2 * cache->used_count + CACHE_COMPACT_SLACK)) {
+        return rewrite_cache(cache, cache->compiled);
+    }
+    if (cache->added_count == 0) return 0;
+
+    // One buffer, so the records go out with a single append
+    ByteBuffer buffer = {NULL, 0, 0};
+    for (uint32_t k = 0; k < cache->added_count; k++) {
+        RecordHeader header;
+        read_header(cache->added[k], &header);
+        put_bytes(&buffer, cache->added[k], sizeof(RecordHeader) + header.body_size);
+    }
+    int status = append_file(cache->path, buffer.data, buffer.size);
+    free(buffer.data);
+    if (status != 0) return -1;
+    cache->saved = (const unsigned char**)reserve(cache->saved, &cache->saved_capacity, total,
+                                                  sizeof(const unsigned char*));
+    memcpy(cache->saved + cache->saved_count, cache->added, sizeof(const unsigned char*) * cache->added_count);
+    cache->saved_count = total;
+    cache->added_count = 0;
+    return 0;
+}
+
+// Release a cache
+void compile_cache_close(CompileCache* cache) {
+    if (!cache) return;
+    if (cache->file) unmap_file(cache->file);
+    arena_free(&cache->records);
+    free(cache->saved);
+    free(cache->added);
+    free(cache->slots);
+    free(cache->used);
+    free(cache->path);
+    free(cache);
+}
+
+// Helper to test whether a statement starts at token t: at a keyword, or
+// at an identifier followed by '=' ('=' appears nowhere else)
+static inline int starts_statement(const Token* tokens, uint32_t t) {
+    TokenType type = tokens[t].type;
+    return type == TOKEN_KEYWORD_ASSERT || type == TOKEN_KEYWORD_INPUT || type == TOKEN_KEYWORD_PUBLIC ||
+           type == TOKEN_KEYWORD_OUTPUT || (type == TOKEN_IDENTIFIER && tokens[t + 1].type == TOKEN_ASSIGN);
+}
+
+// Helper to split the token stream into statements and check that every
+// variable is defined once before it is read. Returns 0 for anything the
+// parser or validator would reject; such programs are compiled whole, so
+// they get the usual errors.
+static int split_statements(IncrementalBuild* b) {
+    const TokenStream* stream = b->stream;
+    const Token* tokens = stream->tokens;
+    uint32_t token_count = (uint32_t)stream->count - 1; // Without the TOKEN_EOF
+    uint32_t symbol_count = b->ctx->symbols.count;
+
+    if (token_count > 0 && !starts_statement(tokens, 0)) return 0;
+    uint32_t count = 0;
+    for (uint32_t t = 0; t < token_count; t++) {
+        count += starts_statement(tokens, t);
+    }
+    b->count = count;
+    b->statements = (Statement*)arena_calloc(&b->work, (size_t)count + 1, sizeof(Statement));
+    b->definers = (uint32_t*)arena_calloc(&b->work, symbol_count, sizeof(uint32_t));
+    uint32_t* seen = (uint32_t*)arena_calloc(&b->work, symbol_count, sizeof(uint32_t));
+    uint8_t* outputs = (uint8_t*)arena_calloc(&b->work, symbol_count, sizeof(uint8_t));
+    uint32_t read_capacity = 0, read_count = 0;
+
+    uint32_t s = 0;
+    for (uint32_t t = 0; t < token_count; s++) {
+        Statement* statement = &b->statements[s];
+        statement->first_token = t;
+        statement->read_offset = read_count;
+        TokenType type = tokens[t].type;
+        uint32_t end = t + 1;
+        while (end < token_count && !starts_statement(tokens, end)) end++;
+        statement->token_count = end - t;
+
+        // What the statement defines, and where the variables it reads are
+        uint32_t first_read = end;
+        switch (type) {
+            case TOKEN_IDENTIFIER:
+                statement->kind = AST_ASSIGNMENT;
+                statement->subject = tokens[t].symbol;
+                first_read = t + 2;
+                break;
+            case TOKEN_KEYWORD_ASSERT:
+                statement->kind = AST_ASSERTION;
+                first_read = t + 1;
+                break;
+            default:
+                if (statement->token_count != 2 || tokens[t + 1].type != TOKEN_IDENTIFIER) return 0;
+                statement->subject = tokens[t + 1].symbol;
+                statement->kind = type == TOKEN_KEYWORD_INPUT ? AST_INPUT
+                                  : type == TOKEN_KEYWORD_PUBLIC ? AST_PUBLIC_INPUT : AST_OUTPUT;
+                if (statement->kind == AST_OUTPUT) first_read = t + 1;
+                break;
+        }
+        for (uint32_t k = first_read; k < end; k++) {
+            if (tokens[k].type != TOKEN_IDENTIFIER) continue;
+            Symbol name = tokens[k].symbol;
+            if (!b->definers[name]) return 0; // Undefined
+            if (seen[name] == s + 1) continue;
+            seen[name] = s + 1;
+            b->reads = (Symbol*)reserve(b->reads, &read_capacity, (size_t)read_count + 1, sizeof(Symbol));
+            b->reads[read_count++] = name;
+        }
+        if (statement->kind == AST_OUTPUT) {
+            if (outputs[statement->subject]) return 0;
+            outputs[statement->subject] = 1;
+        } else if (statement->subject != SYMBOL_NONE) {
+            if (b->definers[statement->subject]) return 0; // Redefined
+            b->definers[statement->subject] = s + 1;
+        }
+        t = end;
+    }
+    b->statements[count].read_offset = read_count;
+    return 1;
+}
+
+// Helper to compute a statement's key: its text, and the exports of the
+// statements defining what it reads
+static CacheKey statement_key(const IncrementalBuild* b, const Statement* statement) {
+    const Token* first = &b->stream->tokens[statement->first_token];
+    const Token* last = first + statement->token_count - 1;
+    Hasher h;
+    hash_init(&h);
+    hash_bytes(&h, b->stream->source + first->offset, last->offset + last->length - first->offset);
+    for (uint32_t r = statement->read_offset; r < statement[1].read_offset; r++) {
+        CacheKey export_hash = record_export_hash(b->statements[b->definers[b->reads[r]] - 1].record);
+        hash_word(&h, export_hash.lo);
+        hash_word(&h, export_hash.hi);
+    }
+    return hash_final(&h);
+}
+
+// Helper to parse the window of statements starting at s. Returns 0 if the
+// parser disagrees with the splitter about where statements end.
+static int parse_window(IncrementalBuild* b, uint32_t s) {
+    uint32_t end = s + PARSE_WINDOW < b->count ? s + PARSE_WINDOW : b->count;
+    const Token* tokens = b->stream->tokens;
+    uint32_t first = b->statements[s].first_token;
+    uint32_t last = b->statements[end - 1].first_token + b->statements[end - 1].token_count;
+
+    // The window's tokens, ended by a TOKEN_EOF where the next statement
+    // starts. The AST's positions refer to them, so they last as long as
+    // the compilation.
+    Token* window_tokens = (Token*)arena_alloc(&b->work, sizeof(Token) * ((size_t)last - first + 1));
+    memcpy(window_tokens, tokens + first, sizeof(Token) * (last - first));
+    window_tokens[last - first] = tokens[last];
+    window_tokens[last - first].type = TOKEN_EOF;
+    TokenStream window = *b->stream;
+    window.tokens = window_tokens;
+    window.count = window.capacity = last - first + 1;
+
+    const AST* ast = parse_tokens(b->ctx, &window);
+    if (ast->statement_count != end - s) return 0;
+    for (uint32_t k = s; k < end; k++) {
+        b->statements[k].ast = ast;
+        b->statements[k].ast_index = k - s;
+    }
+    return 1;
+}
+
+// Helper to find or add the external variable an export term refers to
+static uint32_t external_variable(IncrementalBuild* b, uint32_t* count, uint64_t identity, uint32_t read,
+                                  uint32_t term) {
+    for (uint32_t e = 0; e < *count; e++) {
+        if (b->externals[e].identity == identity) return 1 + e;
+    }
+    b->externals = (External*)reserve(b->externals, &b->external_capacity, (size_t)*count + 1, sizeof(External));
+    b->externals[*count].identity = identity;
+    b->externals[*count].read = read;
+    b->externals[*count].term = term;
+    return ++*count;
+}
+
+// Helper to get the code of a coefficient, adding it to the table if new
+static uint32_t coefficient_code(IncrementalBuild* b, const FieldElement* value) {
+    for (uint32_t c = 0; c < COEFF_TABLE; c++) {
+        if (field_equal(value, &b->common[c])) return c;
+    }
+    for (uint32_t k = 0; k < b->table_count; k++) {
+        if (field_equal(value, &b->table[k])) return COEFF_TABLE + k;
+    }
+    b->table = (FieldElement*)reserve(b->table, &b->table_capacity, (size_t)b->table_count + 1, sizeof(FieldElement));
+    b->table[b->table_count] = *value;
+    return COEFF_TABLE + b->table_count++;
+}
+
+// Helper to encode an operand, looking through the copies records leave out
+static uint32_t operand_code(IncrementalBuild* b, ValueId operand) {
+    const IRProgram* program = b->ir.program;
+    uint32_t reads = b->fragment.bound_count;
+    while (operand != IR_NO_VALUE && !ir_is_const(operand) && operand >= reads && !b->keep[operand]) {
+        operand = program->instrs[operand].src1;
+    }
+    if (operand == IR_NO_VALUE) return OPERAND_NONE;
+    if (ir_is_const(operand)) return coefficient_code(b, ir_constant_value(program, operand)) << 2 | OPERAND_CONST;
+    if (operand < reads) return operand << 2 | OPERAND_READ;
+    return b->local[operand] << 2 | OPERAND_LOCAL;
+}
+
+// Helper to encode a location relative to the statement's first token
+static inline void put_location(ByteBuffer* buffer, const Token* origin, const IRLocation* location) {
+    uint32_t line = (uint32_t)(location->line - origin->line);
+    put_varint(buffer, line);
+    put_varint(buffer, line ? (uint32_t)location->column : (uint32_t)(location->column - origin->column));
+}
+
+// Helper to hash the identity of a statement's own variable k
+static uint64_t own_identity(const IncrementalBuild* b, const Statement* statement, uint32_t k) {
+    const InternTable* symbols = &b->ctx->symbols;
+    Hasher h;
+    hash_init(&h);
+    hash_bytes(&h, symbol_text(symbols, statement->subject), symbol_length(symbols, statement->subject));
+    hash_word(&h, k);
+    uint64_t identity = hash_final(&h).lo;
+    return identity ? identity : 1; // 0 is the constant 1
+}
+
+// Helper to set up the state for compiling statements
+static void begin_compiling(IncrementalBuild* b) {
+    b->compiling = 1;
+    ir_builder_init(&b->ir, b->ctx, ir_program_create(b->ctx, 64));
+    constraint_fragment_init(&b->fragment);
+}
+
+// Helper to release the state for compiling statements
+static void end_compiling(IncrementalBuild* b) {
+    if (!b->compiling) return;
+    ir_builder_free(&b->ir);
+    constraint_fragment_free(&b->fragment);
+    free(b->externals);
+    free(b->bound_offsets);
+    free(b->bound_terms);
+    free(b->keep);
+    free(b->local);
+    free(b->table);
+    free(b->body.data);
+    b->compiling = 0;
+}
+
+// Compiles statement s on its own and adds its record to the cache.
+// Returns NULL if the statement could not be parsed on its own.
+static const unsigned char* compile_statement(IncrementalBuild* b, uint32_t s, const CacheKey* key) {
+    CompilerContext* ctx = b->ctx;
+    Statement* statement = &b->statements[s];
+    const Symbol* reads = b->reads + statement->read_offset;
+    uint32_t read_count = statement[1].read_offset - statement->read_offset;
+    if (!b->compiling) begin_compiling(b);
+    if (!statement->ast && !parse_window(b, s)) return NULL;
+    const AST* ast = statement->ast;
+    NodeId node = ast->statements[statement->ast_index];
+
+    // A placeholder for each variable read, then the statement
+    IRBuilder* ir = &b->ir;
+    IRProgram* program = ir->program;
+    ir_builder_reset(ir);
+    IRLocation at = {ast_line(ast, node), ast_column(ast, node)};
+    for (uint32_t j = 0; j < read_count; j++) {
+        ir_lower_input(ir, reads[j], at);
+    }
+    ir_lower_statement(ir, ast, statement->ast_index);
+
+    // Each placeholder equals the export of the statement defining it, over
+    // external variables that stand for the exports' variables
+    ConstraintFragment* fragment = &b->fragment;
+    uint32_t external_count = 0, term_count = 0;
+    b->bound_offsets = (uint32_t*)reserve(b->bound_offsets, &b->bound_offset_capacity, (size_t)read_count + 1,
+                                          sizeof(uint32_t));
+    b->bound_offsets[0] = 0;
+    for (uint32_t j = 0; j < read_count; j++) {
+        const unsigned char* definition = b->statements[b->definers[reads[j]] - 1].record;
+        RecordHeader header;
+        RecordBody body;
+        read_header(definition, &header);
+        open_body(definition, &body);
+        b->bound_terms = (LinearTerm*)reserve(b->bound_terms, &b->bound_term_capacity,
+                                              (size_t)term_count + header.export_count, sizeof(LinearTerm));
+        for (uint32_t t = 0; t < header.export_count; t++) {
+            get_varint(&body.reader); // The variable, in the definition's numbering
+            LinearTerm term;
+            term.coefficient = body_coefficient(b, &body, get_varint(&body.reader));
+            uint64_t identity = get_u64(&body.reader);
+            term.variable = identity ? external_variable(b, &external_count, identity, j, t) : R1CS_ONE;
+
+            // Keep the placeholder's terms sorted by variable
+            uint32_t k = term_count++;
+            while (k > b->bound_offsets[j] && b->bound_terms[k - 1].variable > term.variable) {
+                b->bound_terms[k] = b->bound_terms[k - 1];
+                k--;
+            }
+            b->bound_terms[k] = term;
+        }
+        b->bound_offsets[j + 1] = term_count;
+    }
+    fragment->external_count = external_count;
+    fragment->bound_count = read_count;
+    fragment->bound_offsets = b->bound_offsets;
+    fragment->bound_terms = b->bound_terms;
+    int defines = statement->kind != AST_ASSERTION && statement->kind != AST_OUTPUT;
+    fragment->result = defines ? program->count - 1 : IR_NO_VALUE;
+    compile_constraint_fragment(ctx, program, fragment);
+    const R1CS* system = &fragment->system;
+    uint32_t first_own = 1 + external_count;
+    uint32_t own_count = system->variable_count - first_own;
+
+    // Unnamed copies are left out (operands refer to what they copy),
+    // unless a variable holds one
+    b->keep = (uint8_t*)reserve(b->keep, &b->keep_capacity, program->count, sizeof(uint8_t));
+    b->local = (ValueId*)reserve(b->local, &b->local_capacity, program->count, sizeof(ValueId));
+    for (uint32_t i = read_count; i < program->count; i++) {
+        b->keep[i] = program->instrs[i].op != IR_OP_ASSIGN || program->instrs[i].name != SYMBOL_NONE;
+    }
+    for (uint32_t v = first_own; v < system->variable_count; v++) {
+        b->keep[system->variable_origins[v] & ~R1CS_INVERSE_FLAG] = 1;
+    }
+    uint32_t instr_count = 0;
+    for (uint32_t i = read_count; i < program->count; i++) {
+        if (b->keep[i]) b->local[i] = instr_count++;
+    }
+
+    // The body, after the coefficient table, which is only complete at the end
+    const Token* origin = &b->stream->tokens[statement->first_token];
+    ByteBuffer* out = &b->body;
+    RecordHeader header;
+    memset(&header, 0, sizeof(header));
+    header.key = *key;
+    header.instr_count = instr_count;
+    header.variable_count = own_count;
+    header.constraint_count = system->constraint_count;
+    header.nonzeros[0] = system->a.nonzeros;
+    header.nonzeros[1] = system->b.nonzeros;
+    header.nonzeros[2] = system->c.nonzeros;
+    header.export_count = fragment->result_count;
+    header.external_count = external_count;
+    if (statement->kind != AST_ASSIGNMENT) header.flags |= RECORD_ROOT;
+    b->table_count = 0;
+    out->size = 0;
+    put_varint(out, defines ? b->local[fragment->result] + 1 : 0);
+
+    // Export, hashed by value and by the identity of each variable
+    Hasher export_hash;
+    hash_init(&export_hash);
+    for (uint32_t t = 0; t < fragment->result_count; t++) {
+        const LinearTerm* term = &fragment->result_terms[t];
+        uint64_t identity = term->variable == R1CS_ONE ? 0
+                            : term->variable < first_own ? b->externals[term->variable - 1].identity
+                            : own_identity(b, statement, term->variable - first_own);
+        put_varint(out, term->variable);
+        put_varint(out, coefficient_code(b, &term->coefficient));
+        put_bytes(out, &identity, sizeof(identity));
+        hash_word(&export_hash, identity);
+        for (int limb = 0; limb < FIELD_LIMBS; limb++) hash_word(&export_hash, term->coefficient.limbs[limb]);
+    }
+    if (defines) header.export_hash = hash_final(&export_hash);
+
+    for (uint32_t i = read_count; i < program->count; i++) {
+        if (!b->keep[i]) continue;
+        const IRInstruction* instr = &program->instrs[i];
+        uint32_t src2 = operand_code(b, instr->src2);
+        if (instr->op == IR_OP_DIV && (src2 & 3) != OPERAND_CONST) header.flags |= RECORD_ROOT; // May fail
+        put_varint(out, (uint32_t)instr->op * 2 + (instr->name != SYMBOL_NONE));
+        put_varint(out, operand_code(b, instr->src1));
+        put_varint(out, src2);
+        put_location(out, origin, &program->locations[i]);
+    }
+    for (uint32_t v = first_own; v < system->variable_count; v++) {
+        ValueId value = system->variable_origins[v];
+        put_varint(out, b->local[value & ~R1CS_INVERSE_FLAG] * 2 + !!(value & R1CS_INVERSE_FLAG));
+    }
+    for (uint32_t e = 0; e < external_count; e++) {
+        put_varint(out, b->externals[e].read);
+        put_varint(out, b->externals[e].term);
+    }
+    const SparseMatrix* matrices[3] = {&system->a, &system->b, &system->c};
+    for (uint32_t row = 0; row < system->constraint_count; row++) {
+        put_location(out, origin, &system->locations[row]);
+        for (int m = 0; m < 3; m++) {
+            const SparseMatrix* matrix = matrices[m];
+            put_varint(out, matrix->row_offsets[row + 1] - matrix->row_offsets[row]);
+            for (uint32_t k = matrix->row_offsets[row]; k < matrix->row_offsets[row + 1]; k++) {
+                put_varint(out, matrix->columns[k]);
+                put_varint(out, coefficient_code(b, field_pool_get(&system->coefficients, matrix->coefficients[k])));
+            }
+        }
+    }
+    put_varint(out, system->folded_linear);
+    put_varint(out, system->materialized);
+
+    // Header, coefficient table and body, in the cache's arena
+    ByteBuffer table = {NULL, 0, 0};
+    put_varint(&table, b->table_count);
+    size_t table_size = table.size + (size_t)b->table_count * sizeof(FieldElement);
+    header.body_size = (uint32_t)(table_size + out->size);
+    CompileCache* cache = b->cache;
+    unsigned char* record = (unsigned char*)arena_alloc(&cache->records, sizeof(RecordHeader) + header.body_size);
+    memcpy(record, &header, sizeof(header));
+    memcpy(record + sizeof(header), table.data, table.size);
+    if (b->table_count) memcpy(record + sizeof(header) + table.size, b->table, (size_t)b->table_count * sizeof(FieldElement));
+    memcpy(record + sizeof(header) + table_size, out->data, out->size);
+    free(table.data);
+    header.checksum = record_checksum(record, header.body_size);
+    memcpy(record + offsetof(RecordHeader, checksum), &header.checksum, sizeof(header.checksum));
+
+    cache->added = (const unsigned char**)reserve(cache->added, &cache->added_capacity, (size_t)cache->added_count + 1,
+                                                  sizeof(const unsigned char*));
+    cache->added[cache->added_count++] = record;
+    return record;
+}
+
+// Helper to mark the statements that something kept depends on, working
+// back from the roots: assertions, outputs, inputs and divisions
+static uint32_t mark_live(IncrementalBuild* b) {
+    uint32_t removed = 0;
+    for (uint32_t s = b->count; s-- > 0;) {
+        Statement* statement = &b->statements[s];
+        RecordHeader header;
+        read_header(statement->record, &header);
+        if (header.flags & RECORD_ROOT) statement->live = 1;
+        if (!statement->live) {
+            removed++;
+            continue;
+        }
+        for (uint32_t r = statement->read_offset; r < statement[1].read_offset; r++) {
+            b->statements[b->definers[b->reads[r]] - 1].live = 1;
+        }
+    }
+    return removed;
+}
+
+// Helper to map a record's coefficient code to a pool index, memoized per
+// record in codes[] (UINT32_MAX until first used)
+static inline uint32_t pool_index(const IncrementalBuild* b, const RecordBody* body, FieldPool* pool,
+                                  uint32_t* codes, uint32_t code) {
+    if (codes[code] == UINT32_MAX) {
+        FieldElement value = body_coefficient(b, body, code);
+        codes[code] = field_pool_add(pool, &value);
+    }
+    return codes[code];
+}
+
+// Helper to put the live statements' records together into one program
+// and constraint system. Variables are laid out as compile_constraints
+// does: public inputs, outputs and private inputs in statement order, then
+// internal variables.
+static R1CS* assemble(IncrementalBuild* b, IRProgram** program_out) {
+    CompilerContext* ctx = b->ctx;
+    const Token* tokens = b->stream->tokens;
+    uint64_t instr_total = 0, constraint_total = 0, nonzero_totals[3] = {0, 0, 0}, variable_total = 1;
+    uint32_t publics = 0, outputs = 0, inputs = 0, export_total = 0;
+    uint32_t max_variables = 0, max_externals = 0, max_exports = 0;
+    for (uint32_t s = 0; s < b->count; s++) {
+        Statement* statement = &b->statements[s];
+        if (!statement->live) continue;
+        RecordHeader header;
+        read_header(statement->record, &header);
+        instr_total += header.instr_count;
+        constraint_total += header.constraint_count;
+        for (int m = 0; m < 3; m++) nonzero_totals[m] += header.nonzeros[m];
+        variable_total += header.variable_count;
+        statement->export_offset = export_total;
+        export_total += header.export_count;
+        if (statement->kind == AST_PUBLIC_INPUT) publics++;
+        if (statement->kind == AST_OUTPUT) outputs++;
+        if (statement->kind == AST_INPUT) inputs++;
+        if (header.variable_count > max_variables) max_variables = header.variable_count;
+        if (header.external_count > max_externals) max_externals = header.external_count;
+        if (header.export_count > max_exports) max_exports = header.export_count;
+    }
+    if (instr_total >= IR_CONST_FLAG || constraint_total >= UINT32_MAX || variable_total >= UINT32_MAX ||
+        nonzero_totals[0] > UINT32_MAX || nonzero_totals[1] > UINT32_MAX || nonzero_totals[2] > UINT32_MAX) {
+        compile_error(ctx, STAGE_CONSTRAINTS, 0, 0, "Program exceeds the constraint system size limits");
+    }
+
+    IRProgram* program = ir_program_create(ctx, (uint32_t)instr_total);
+    uint32_t nonzeros[3] = {(uint32_t)nonzero_totals[0], (uint32_t)nonzero_totals[1], (uint32_t)nonzero_totals[2]};
+    R1CS* r1cs = r1cs_create(ctx, (uint32_t)constraint_total, nonzeros, (uint32_t)variable_total);
+    r1cs->variable_origins[R1CS_ONE] = IR_NO_VALUE;
+    uint32_t next_public = 1, next_output = 1 + publics, next_input = next_output + outputs;
+    uint32_t next_internal = next_input + inputs;
+    r1cs->public_count = publics + outputs;
+    r1cs->output_count = outputs;
+    r1cs->input_count = inputs;
+    r1cs->variable_count = (uint32_t)variable_total;
+
+    uint32_t* export_vars = (uint32_t*)arena_alloc(&b->work, sizeof(uint32_t) * (export_total ? export_total : 1));
+    uint32_t* own = (uint32_t*)arena_alloc(&b->work, sizeof(uint32_t) * (max_variables + 1));
+    uint32_t* external = (uint32_t*)arena_alloc(&b->work, sizeof(uint32_t) * (max_externals + 1));
+    uint32_t* export_refs = (uint32_t*)arena_alloc(&b->work, sizeof(uint32_t) * (max_exports + 1));
+    uint32_t coefficient_capacity = 0, constant_capacity = 0;
+    uint32_t* coefficient_codes = NULL;
+    uint32_t* constant_codes = NULL;
+    SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+
+    for (uint32_t s = 0; s < b->count; s++) {
+        Statement* statement = &b->statements[s];
+        if (!statement->live) continue;
+        const Symbol* reads = b->reads + statement->read_offset;
+        const Token* origin = &tokens[statement->first_token];
+        RecordHeader header;
+        RecordBody body;
+        read_header(statement->record, &header);
+        open_body(statement->record, &body);
+        Reader* reader = &body.reader;
+        uint32_t first_own = 1 + header.external_count;
+        uint32_t ir_base = program->count;
+
+        // Coefficient and constant pool indices, resolved as they are used
+        uint32_t code_count = COEFF_TABLE + body.table_count;
+        coefficient_codes = (uint32_t*)reserve(coefficient_codes, &coefficient_capacity, code_count, sizeof(uint32_t));
+        constant_codes = (uint32_t*)reserve(constant_codes, &constant_capacity, code_count, sizeof(uint32_t));
+        memset(coefficient_codes, 0xFF, sizeof(uint32_t) * code_count);
+        memset(constant_codes, 0xFF, sizeof(uint32_t) * code_count);
+
+        for (uint32_t t = 0; t < header.export_count; t++) {
+            export_refs[t] = get_varint(reader);
+            get_varint(reader);
+            reader->p += sizeof(uint64_t);
+        }
+
+        // Instructions, with operands renumbered
+        for (uint32_t i = 0; i < header.instr_count; i++) {
+            uint32_t op = get_varint(reader);
+            IRInstruction* instr = &program->instrs[program->count];
+            instr->op = (IROpType)(op >> 1);
+            instr->name = (op & 1) ? statement->subject : SYMBOL_NONE;
+            ValueId* operands[2] = {&instr->src1, &instr->src2};
+            for (int k = 0; k < 2; k++) {
+                uint32_t code = get_varint(reader);
+                uint32_t index = code >> 2;
+                switch (code & 3) {
+                    case OPERAND_LOCAL:
+                        *operands[k] = ir_base + index;
+                        break;
+                    case OPERAND_READ:
+                        *operands[k] = b->statements[b->definers[reads[index]] - 1].result;
+                        break;
+                    case OPERAND_CONST:
+                        *operands[k] = ir_const_operand(pool_index(b, &body, &program->constants, constant_codes, index));
+                        break;
+                    default:
+                        *operands[k] = IR_NO_VALUE;
+                        break;
+                }
+            }
+            uint32_t line = get_varint(reader), column = get_varint(reader);
+            program->locations[program->count].line = origin->line + (int)line;
+            program->locations[program->count].column = line ? (int)column : origin->column + (int)column;
+            program->count++;
+        }
+
+        // The statement's variables, placed by what they hold
+        for (uint32_t k = 0; k < header.variable_count; k++) {
+            uint32_t code = get_varint(reader);
+            ValueId value = ir_base + (code >> 1);
+            uint32_t variable;
+            if (code & 1) {
+                value |= R1CS_INVERSE_FLAG;
+                variable = next_internal++;
+            } else if (program->instrs[value].op == IR_OP_PUBLIC) {
+                variable = next_public++;
+            } else if (program->instrs[value].op == IR_OP_OUTPUT) {
+                variable = next_output++;
+            } else if (program->instrs[value].op == IR_OP_INPUT) {
+                variable = next_input++;
+            } else {
+                variable = next_internal++;
+            }
+            own[k] = variable;
+            r1cs->variable_origins[variable] = value;
+        }
+        for (uint32_t e = 0; e < header.external_count; e++) {
+            uint32_t read = get_varint(reader), term = get_varint(reader);
+            external[e] = export_vars[b->statements[b->definers[reads[read]] - 1].export_offset + term];
+        }
+
+        // Constraints, each row re-sorted by the renumbered variables
+        for (uint32_t c = 0; c < header.constraint_count; c++) {
+            uint32_t row = r1cs->constraint_count;
+            uint32_t line = get_varint(reader), column = get_varint(reader);
+            r1cs->locations[row].line = origin->line + (int)line;
+            r1cs->locations[row].column = line ? (int)column : origin->column + (int)column;
+            for (int m = 0; m < 3; m++) {
+                SparseMatrix* matrix = matrices[m];
+                uint32_t n = get_varint(reader), begin = matrix->nonzeros;
+                for (uint32_t k = 0; k < n; k++) {
+                    uint32_t ref = get_varint(reader);
+                    uint32_t variable = ref == R1CS_ONE ? R1CS_ONE : ref < first_own ? external[ref - 1] : own[ref - first_own];
+                    uint32_t coefficient = pool_index(b, &body, &r1cs->coefficients, coefficient_codes, get_varint(reader));
+                    uint32_t at = matrix->nonzeros++;
+                    while (at > begin && matrix->columns[at - 1] > variable) {
+                        matrix->columns[at] = matrix->columns[at - 1];
+                        matrix->coefficients[at] = matrix->coefficients[at - 1];
+                        at--;
+                    }
+                    matrix->columns[at] = variable;
+                    matrix->coefficients[at] = coefficient;
+                }
+                matrix->row_offsets[row + 1] = matrix->nonzeros;
+            }
+            r1cs->constraint_count++;
+        }
+        r1cs->folded_linear += get_varint(reader);
+        r1cs->materialized += get_varint(reader);
+
+        statement->result = body.result == IR_NO_VALUE ? IR_NO_VALUE : ir_base + body.result;
+        for (uint32_t t = 0; t < header.export_count; t++) {
+            uint32_t ref = export_refs[t];
+            export_vars[statement->export_offset + t] = ref == R1CS_ONE ? R1CS_ONE
+                                                        : ref < first_own ? external[ref - 1] : own[ref - first_own];
+        }
+    }
+    free(coefficient_codes);
+    free(constant_codes);
+    *program_out = program;
+    return r1cs;
+}
+
+// Helper to compile a program with the whole-program pipeline
+static R1CS* compile_whole(CompilerContext* ctx, const TokenStream* stream, IRProgram** program,
+                           IncrementalStats* stats) {
+    AST* ast = parse_tokens(ctx, stream);
+    validate_program(ctx, ast);
+    *program = optimize_ir(ctx, generate_ir(ctx, ast));
+    stats->statements += ast->statement_count;
+    stats->compiled += ast->statement_count;
+    return compile_constraints(ctx, *program);
+}
+
+// Cleanup releasing an incremental compilation cut short by an error. The
+// records compiled so far are kept, but the statements' use marks are
+// incomplete, so the cache must not be compacted by them.
+static void release_build(void* arg) {
+    IncrementalBuild* b = (IncrementalBuild*)arg;
+    end_compiling(b);
+    free(b->reads);
+    arena_free(&b->work);
+    b->cache->compiled = 0;
+}
+
+// Compile a program, reusing cached statements
+R1CS* compile_incremental(CompilerContext* ctx, CompileCache* cache, const TokenStream* stream,
+                          IRProgram** program, IncrementalStats* stats) {
+    IncrementalStats local_stats;
+    if (!stats) stats = &local_stats;
+    memset(stats, 0, sizeof(IncrementalStats));
+    if (cache->field != ctx->field) return compile_whole(ctx, stream, program, stats);
+
+    // A statement with an error is reported by compiling the program whole,
+    // so the errors are those of the whole-program pipeline: parsing one
+    // statement at a time can see a different token at fault
+    jmp_buf jump;
+    jmp_buf* outer_jump = ctx->error_jump;
+    ArenaCleanup* outer_unwind = ctx->unwind;
+    uint32_t diagnostic_count = ctx->diagnostic_count;
+    if (setjmp(jump) != 0) {
+        ctx->error_jump = outer_jump;
+        ctx->unwind = outer_unwind;
+        ctx->diagnostic_count = diagnostic_count;
+        memset(stats, 0, sizeof(IncrementalStats));
+        return compile_whole(ctx, stream, program, stats);
+    }
+    ctx->error_jump = &jump;
+    ctx->unwind = NULL;
+
+    IncrementalBuild b;
+    memset(&b, 0, sizeof(b));
+    b.ctx = ctx;
+    b.cache = cache;
+    b.stream = stream;
+    arena_init(&b.work, 0);
+    ArenaCleanup cleanup;
+    context_push_cleanup(ctx, &cleanup, release_build, &b);
+    field_neg(ctx->field, &b.common[COEFF_MINUS_ONE], &ctx->field->one);
+    b.common[COEFF_ONE] = ctx->field->one;
+
+    int whole = !split_statements(&b);
+    if (!whole) {
+        cache->compiled = 1;
+        memset(cache->used, 0, (size_t)cache->slot_mask + 1);
+        cache->used_count = 0;
+    }
+
+    // Find each statement's record, compiling those the cache lacks. Keys
+    // depend on the records of earlier statements, so this goes in order.
+    for (uint32_t s = 0; s < b.count && !whole; s++) {
+        Statement* statement = &b.statements[s];
+        CacheKey key = statement_key(&b, statement);
+        uint32_t slot = find_slot(cache, &key);
+        if (cache->slots[slot].record) {
+            stats->reused++;
+        } else {
+            const unsigned char* record = compile_statement(&b, s, &key);
+            if (!record) {
+                whole = 1;
+                break;
+            }
+            slot = insert_record(cache, record);
+            stats->compiled++;
+        }
+        statement->record = cache->slots[slot].record;
+        if (!cache->used[slot]) {
+            cache->used[slot] = 1;
+            cache->used_count++;
+        }
+    }
+    end_compiling(&b);
+    if (whole) {
+        ctx->error_jump = outer_jump;
+        ctx->unwind = outer_unwind;
+        cache->compiled = 0; // The use marks are incomplete
+        free(b.reads);
+        arena_free(&b.work);
+        memset(stats, 0, sizeof(IncrementalStats));
+        return compile_whole(ctx, stream, program, stats);
+    }
+
+    stats->statements = b.count;
+    stats->removed = mark_live(&b);
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    R1CS* r1cs = assemble(&b, program);
+    count_system(ctx, r1cs);
+    PHASE_END(ctx, PHASE_CONSTRAINTS, &timer);
+    ctx->error_jump = outer_jump;
+    ctx->unwind = outer_unwind;
+    free(b.reads);
+    arena_free(&b.work);
+    TRACE(ctx, "Incremental compilation: %u statements, %u reused, %u compiled, %u removed",
+          stats->statements, stats->reused, stats->compiled, stats->removed);
+    return r1cs;
+}
@@ -0,0 +1,80 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include "constraint_compiler.h"
+
+// An on-disk store of compiled statements, for incremental compilation.
+// Each statement is compiled on its own into a record holding its IR and
+// constraint fragment, keyed by a hash of the statement's text and of what
+// the statements it reads define. A statement whose text and inputs are
+// unchanged is then assembled from its record without being parsed,
+// lowered or compiled again. Since the key covers the combinations the
+// read variables equal rather than how they were computed, an edit that
+// leaves a variable equal to the same combination does not invalidate the
+// statements that read it.
+//
+// Records live in a single file, appended to after each compilation and
+// rewritten when most of it is no longer used. A cache serves one source
+// file at a time; records of statements the last compilation did not use
+// are eventually dropped.
+typedef struct CompileCache CompileCache;
+
+// What an incremental compilation did
+typedef struct {
+    uint32_t statements;    // Statements in the program
+    uint32_t reused;        // Assembled from records found in the cache
+    uint32_t compiled;      // Compiled and added to the cache
+    uint32_t removed;       // Left out: no assertion, output or input depends on them
+} IncrementalStats;
+
+// Function prototypes
+
+/**
+ * Opens a cache file, loading its records. A missing file starts an empty
+ * cache; one with a damaged header, or written for another field, is
+ * ignored and replaced on the next save. Damaged or truncated records are
+ * dropped, and the next save rewrites the file without them.
+ *
+ * @param path Path of the cache file.
+ * @param field The field compilations using the cache are over.
+ * @return The cache.
+ */
+CompileCache* compile_cache_open(const char* path, const Field* field);
+
+/**
+ * Writes the records added since the cache was opened or last saved.
+ *
+ * @param cache The cache.
+ * @return 0 on success, -1 on failure (errno says why).
+ */
+int compile_cache_save(CompileCache* cache);
+
+/**
+ * Closes a cache without saving it.
+ */
+void compile_cache_close(CompileCache* cache);
+
+/**
+ * Compiles a tokenized program to constraints, reusing the cache's records
+ * for unchanged statements and adding records for the rest. The result is
+ * the same whether a statement is found in the cache or not, but it is
+ * not that of the whole-program pipeline: statements are lowered one at a
+ * time, so no value numbering or optimization crosses statement
+ * boundaries. Statements nothing depends on are removed as the optimizer
+ * would, and the returned IR is that of the remaining statements, so
+ * witness generation and circuit files work unchanged.
+ *
+ * Programs the statement splitter cannot handle, including invalid ones,
+ * go through the whole-program pipeline, which reports their errors.
+ *
+ * @param ctx The compilation context the tokens belong to.
+ * @param cache The cache.
+ * @param stream The program's tokens.
+ * @param program Receives the program's IR.
+ * @param stats If not NULL, receives what was reused and compiled.
+ * @return The constraint system, allocated in the context's arena.
+ */
+R1CS* compile_incremental(CompilerContext* ctx, CompileCache* cache, const TokenStream* stream,
+                          IRProgram** program, IncrementalStats* stats);
+
+#endif // COMPILE_CACHE_H
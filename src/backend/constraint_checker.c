@@ -0,0 +1,154 @@
+#include "constraint_checker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Rows evaluated together; their A and B values are multiplied in a batch
+#define CHECK_GROUP 64
+
+// Rows per thread pool task
+#define CHECK_BLOCK 4096
+
+// How a coefficient applies to its variable. Most are 1 or -1, which need
+// an addition or subtraction instead of a multiplication.
+typedef enum {
+    COEFFICIENT_OTHER,
+    COEFFICIENT_ONE,
+    COEFFICIENT_MINUS_ONE
+} CoefficientKind;
+
+// Violated rows found by one worker, in the order it found them
+typedef struct {
+    uint32_t* rows;
+    uint32_t count;
+    uint32_t capacity;
+} RowList;
+
+// State shared by the tasks of one check
+typedef struct {
+    const Field* field;
+    const R1CS* r1cs;
+    const FieldElement* witness;
+    const uint8_t* kinds;       // CoefficientKind of each pool entry
+    RowList* found;             // One list per worker
+} CheckJob;
+
+// Helper to evaluate row of a matrix against the witness
+static inline void row_value(const CheckJob* job, const SparseMatrix* m, uint32_t row, FieldElement* out) {
+    const Field* field = job->field;
+    const FieldElement* coefficients = job->r1cs->coefficients.values;
+    FieldElement sum = {{0}}, term;
+    for (uint32_t k = m->row_offsets[row]; k < m->row_offsets[row + 1]; k++) {
+        const FieldElement* value = &job->witness[m->columns[k]];
+        uint32_t coefficient = m->coefficients[k];
+        switch ((CoefficientKind)job->kinds[coefficient]) {
+            case COEFFICIENT_ONE:
+                field_add(field, &sum, &sum, value);
+                break;
+            case COEFFICIENT_MINUS_ONE:
+                field_sub(field, &sum, &sum, value);
+                break;
+            default:
+                field_mul(field, &term, &coefficients[coefficient], value);
+                field_add(field, &sum, &sum, &term);
+                break;
+        }
+    }
+    *out = sum;
+}
+
+// Helper to record a violated row in a worker's list
+static void add_row(RowList* list, uint32_t row) {
+    if (list->count == list->capacity) {
+        uint32_t capacity = list->capacity ? list->capacity * 2 : 64;
+        uint32_t* rows = (uint32_t*)realloc(list->rows, sizeof(uint32_t) * capacity);
+        if (!rows) {
+            fprintf(stderr, "Error: Memory allocation failed for constraint check.\n");
+            exit(1);
+        }
+        list->rows = rows;
+        list->capacity = capacity;
+    }
+    list->rows[list->count++] = row;
+}
+
+// Thread pool task: one block of rows, a group at a time
+static void check_block(void* arg, uint32_t task, int worker) {
+    const CheckJob* job = (const CheckJob*)arg;
+    const R1CS* r1cs = job->r1cs;
+    uint32_t begin = task * CHECK_BLOCK;
+    uint32_t end = r1cs->constraint_count - begin < CHECK_BLOCK ? r1cs->constraint_count : begin + CHECK_BLOCK;
+    FieldElement a[CHECK_GROUP], b[CHECK_GROUP], c[CHECK_GROUP];
+
+    for (uint32_t first = begin; first < end; first += CHECK_GROUP) {
+        uint32_t n = end - first < CHECK_GROUP ? end - first : CHECK_GROUP;
+        for (uint32_t i = 0; i < n; i++) {
+            row_value(job, &r1cs->a, first + i, &a[i]);
+            row_value(job, &r1cs->b, first + i, &b[i]);
+            row_value(job, &r1cs->c, first + i, &c[i]);
+        }
+        field_batch_mul(job->field, a, a, b, n);
+        for (uint32_t i = 0; i < n; i++) {
+            if (!field_equal(&a[i], &c[i])) add_row(&job->found[worker], first + i);
+        }
+    }
+}
+
+// Helper to order rows for qsort
+static int compare_rows(const void* x, const void* y) {
+    uint32_t a = *(const uint32_t*)x, b = *(const uint32_t*)y;
+    return a < b ? -1 : a > b;
+}
+
+// Check every row across the pool, then report the first violations
+uint32_t check_constraints(const Field* field, const R1CS* r1cs, ThreadPool* pool, const FieldElement* witness,
+                           ConstraintViolation* violations, uint32_t max_violations) {
+    int workers = thread_pool_size(pool);
+    uint32_t coefficient_count = r1cs->coefficients.count;
+    uint8_t* kinds = (uint8_t*)malloc(coefficient_count ? coefficient_count : 1);
+    RowList* found = (RowList*)calloc(workers, sizeof(RowList));
+    if (!kinds || !found) {
+        fprintf(stderr, "Error: Memory allocation failed for constraint check.\n");
+        exit(1);
+    }
+    FieldElement minus_one;
+    field_neg(field, &minus_one, &field->one);
+    for (uint32_t k = 0; k < coefficient_count; k++) {
+        const FieldElement* value = &r1cs->coefficients.values[k];
+        kinds[k] = field_equal(value, &field->one) ? COEFFICIENT_ONE
+                   : field_equal(value, &minus_one) ? COEFFICIENT_MINUS_ONE : COEFFICIENT_OTHER;
+    }
+
+    CheckJob job = {field, r1cs, witness, kinds, found};
+    thread_pool_run(pool, (r1cs->constraint_count + CHECK_BLOCK - 1) / CHECK_BLOCK, check_block, &job);
+
+    // Blocks finish in any order, so gather the rows and sort them
+    uint32_t total = 0;
+    for (int w = 0; w < workers; w++) total += found[w].count;
+    if (total > 0) {
+        uint32_t* rows = (uint32_t*)malloc(sizeof(uint32_t) * total);
+        if (!rows) {
+            fprintf(stderr, "Error: Memory allocation failed for constraint check.\n");
+            exit(1);
+        }
+        uint32_t count = 0;
+        for (int w = 0; w < workers; w++) {
+            memcpy(rows + count, found[w].rows, sizeof(uint32_t) * found[w].count);
+            count += found[w].count;
+        }
+        qsort(rows, total, sizeof(uint32_t), compare_rows);
+        for (uint32_t i = 0; i < total && i < max_violations; i++) {
+            ConstraintViolation* violation = &violations[i];
+            violation->constraint = rows[i];
+            row_value(&job, &r1cs->a, rows[i], &violation->a);
+            row_value(&job, &r1cs->b, rows[i], &violation->b);
+            row_value(&job, &r1cs->c, rows[i], &violation->c);
+        }
+        free(rows);
+    }
+
+    for (int w = 0; w < workers; w++) free(found[w].rows);
+    free(found);
+    free(kinds);
+    return total;
+}
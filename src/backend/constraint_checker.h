@@ -0,0 +1,35 @@
+#ifndef CONSTRAINT_CHECKER_H
+#define CONSTRAINT_CHECKER_H
+
+#include "constraint_compiler.h"
+#include "../utils/thread_pool.h"
+
+// A constraint a witness violates: (A_i . w) * (B_i . w) != (C_i . w)
+typedef struct {
+    uint32_t constraint;    // Row i
+    FieldElement a;         // A_i . w
+    FieldElement b;         // B_i . w
+    FieldElement c;         // C_i . w
+} ConstraintViolation;
+
+// Function prototypes
+
+/**
+ * Checks that a witness satisfies every constraint of a system, as a
+ * quick test before proving. Rows are split into blocks that run across
+ * the pool; each block evaluates its rows 64 at a time and multiplies
+ * their A and B values in one batch.
+ *
+ * @param field The field the system is over.
+ * @param r1cs The constraint system; in memory, or loaded from a circuit file
+ *             and checked with circuit_validate.
+ * @param pool The pool to run on.
+ * @param witness r1cs->variable_count values, starting with the constant 1.
+ * @param violations Receives the first violated constraints, in row order.
+ * @param max_violations Room in violations.
+ * @return Number of violated constraints, which may exceed max_violations.
+ */
+uint32_t check_constraints(const Field* field, const R1CS* r1cs, ThreadPool* pool, const FieldElement* witness,
+                           ConstraintViolation* violations, uint32_t max_violations);
+
+#endif // CONSTRAINT_CHECKER_H
@@ -0,0 +1,593 @@
+#include "constraint_compiler.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// A linear combination, terms sorted by variable. A combination with no
+// terms is zero; constants are multiples of R1CS_ONE.
+typedef struct {
+    const LinearTerm* terms;
+    uint32_t count;
+} LinearCombination;
+
+// Blocks of 1, 2, 4, ... 2 * R1CS_MAX_LINEAR_TERMS terms
+#define SIZE_CLASSES 7
+
+// State for lowering a program to constraints in program order. Each IR
+// value is bound to the linear combination it equals. Combinations live in
+// size-classed blocks that are recycled after the value's last use, so
+// memory is bounded by the combinations live at once rather than by the
+// program length.
+typedef struct {
+    CompilerContext* ctx;
+    Arena* work;                // Per-pass state, released when lowering ends
+    IRProgram* program;
+    R1CS* r1cs;
+    LinearTerm** blocks;        // Block holding each value's terms (NULL if none)
+    uint32_t* counts;           // Number of terms of each value
+    uint8_t* size_classes;      // Size class of each value's block
+    uint8_t* deferred;          // EQ values left as a difference for their assertion
+    LinearTerm* free_blocks[SIZE_CLASSES]; // Recycled blocks, linked through their first bytes
+    LinearTerm* scratch;        // Result being built
+    int recycle;                // Release blocks after last uses (needs the def->use indices)
+} ConstraintBuilder;
+
+// Helper to resize one of the system's heap arrays. They can reach
+// gigabytes, so they are grown with realloc (which can remap pages rather
+// than copy) and freed with the arena by release_r1cs.
+static void* grow_array(void* array, size_t capacity, size_t element) {
+    void* grown = realloc(array, element * capacity);
+    if (!grown) {
+        fprintf(stderr, "Error: Memory allocation failed for constraint system.\n");
+        exit(1);
+    }
+    return grown;
+}
+
+// Arena cleanup freeing a constraint system's heap arrays
+static void release_r1cs(void* arg) {
+    R1CS* r1cs = (R1CS*)arg;
+    SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+    for (int m = 0; m < 3; m++) {
+        free(matrices[m]->row_offsets);
+        free(matrices[m]->columns);
+        free(matrices[m]->coefficients);
+    }
+    free(r1cs->locations);
+    free(r1cs->variable_origins);
+}
+
+// Helper to allocate a variable holding the given IR value
+static uint32_t new_variable(ConstraintBuilder* cb, ValueId origin) {
+    R1CS* r1cs = cb->r1cs;
+    if (r1cs->variable_count == r1cs->variable_capacity) {
+        r1cs->variable_capacity *= 2;
+        r1cs->variable_origins = grow_array(r1cs->variable_origins, r1cs->variable_capacity, sizeof(ValueId));
+    }
+    r1cs->variable_origins[r1cs->variable_count] = origin;
+    return r1cs->variable_count++;
+}
+
+// Helper to append one row's nonzeros to a matrix
+static void append_row(ConstraintBuilder* cb, SparseMatrix* matrix, LinearCombination lc) {
+    R1CS* r1cs = cb->r1cs;
+    if ((uint64_t)matrix->nonzeros + lc.count > UINT32_MAX) {
+        compile_error(cb->ctx, STAGE_CONSTRAINTS, 0, 0, "Constraint system exceeds the nonzero limit");
+    }
+    if (matrix->nonzeros + lc.count > matrix->capacity) {
+        uint32_t capacity = matrix->capacity;
+        while (capacity < matrix->nonzeros + lc.count) capacity = capacity > UINT32_MAX / 2 ? UINT32_MAX : capacity * 2;
+        matrix->columns = grow_array(matrix->columns, capacity, sizeof(uint32_t));
+        matrix->coefficients = grow_array(matrix->coefficients, capacity, sizeof(uint32_t));
+        matrix->capacity = capacity;
+    }
+    for (uint32_t k = 0; k < lc.count; k++) {
+        matrix->columns[matrix->nonzeros] = lc.terms[k].variable;
+        matrix->coefficients[matrix->nonzeros++] = field_pool_add(&r1cs->coefficients, &lc.terms[k].coefficient);
+    }
+    matrix->row_offsets[r1cs->constraint_count + 1] = matrix->nonzeros;
+}
+
+// Helper to add the constraint a * b = c, enforcing instruction i
+static void emit_constraint(ConstraintBuilder* cb, uint32_t i, LinearCombination a, LinearCombination b,
+                            LinearCombination c) {
+    R1CS* r1cs = cb->r1cs;
+    if (r1cs->constraint_count + 1 == r1cs->constraint_capacity) {
+        uint32_t capacity = r1cs->constraint_capacity * 2;
+        SparseMatrix* matrices[3] = {&r1cs->a, &r1cs->b, &r1cs->c};
+        for (int m = 0; m < 3; m++) {
+            matrices[m]->row_offsets = grow_array(matrices[m]->row_offsets, capacity, sizeof(uint32_t));
+        }
+        r1cs->locations = grow_array(r1cs->locations, capacity, sizeof(IRLocation));
+        r1cs->constraint_capacity = capacity;
+    }
+    append_row(cb, &r1cs->a, a);
+    append_row(cb, &r1cs->b, b);
+    append_row(cb, &r1cs->c, c);
+    r1cs->locations[r1cs->constraint_count++] = cb->program->locations[i];
+}
+
+// Helper to make a one-term combination in caller-provided storage
+static inline LinearCombination single_term(LinearTerm* storage, uint32_t variable, const FieldElement* coefficient) {
+    storage->variable = variable;
+    storage->coefficient = *coefficient;
+    LinearCombination lc = {storage, 1};
+    return lc;
+}
+
+// Helper to get the combination an operand equals. Constants need
+// storage for their single term.
+static LinearCombination operand_lc(const ConstraintBuilder* cb, ValueId operand, LinearTerm* storage) {
+    if (ir_is_const(operand)) {
+        const FieldElement* value = ir_constant_value(cb->program, operand);
+        if (field_is_zero(value)) {
+            LinearCombination zero = {NULL, 0};
+            return zero;
+        }
+        return single_term(storage, R1CS_ONE, value);
+    }
+    LinearCombination lc = {cb->blocks[operand], cb->counts[operand]};
+    return lc;
+}
+
+// Helper to test whether a combination is a constant, and which
+static inline int is_constant(LinearCombination lc, FieldElement* value) {
+    if (lc.count == 0) {
+        memset(value, 0, sizeof(FieldElement));
+        return 1;
+    }
+    if (lc.count == 1 && lc.terms[0].variable == R1CS_ONE) {
+        *value = lc.terms[0].coefficient;
+        return 1;
+    }
+    return 0;
+}
+
+// Helper to compute a + scale * b into the scratch buffer, merging the
+// sorted terms and dropping those that cancel
+static LinearCombination combine(ConstraintBuilder* cb, LinearCombination a, const FieldElement* scale,
+                                 LinearCombination b) {
+    const Field* field = cb->ctx->field;
+    LinearTerm* out = cb->scratch;
+    int unit = field_equal(scale, &field->one); // Plain addition needs no products
+    uint32_t i = 0, j = 0, n = 0;
+    while (i < a.count || j < b.count) {
+        if (j == b.count || (i < a.count && a.terms[i].variable < b.terms[j].variable)) {
+            out[n++] = a.terms[i++];
+            continue;
+        }
+        FieldElement scaled = b.terms[j].coefficient;
+        if (!unit) field_mul(field, &scaled, scale, &scaled);
+        if (i < a.count && a.terms[i].variable == b.terms[j].variable) {
+            field_add(field, &scaled, &scaled, &a.terms[i++].coefficient);
+        }
+        if (!field_is_zero(&scaled)) {
+            out[n].variable = b.terms[j].variable;
+            out[n++].coefficient = scaled;
+        }
+        j++;
+    }
+    LinearCombination lc = {out, n};
+    return lc;
+}
+
+// Helper to compute scale * a into the scratch buffer
+static LinearCombination scale_lc(ConstraintBuilder* cb, LinearCombination a, const FieldElement* scale) {
+    LinearCombination zero = {NULL, 0};
+    return combine(cb, zero, scale, a);
+}
+
+// Helper to bind value i to a combination, copying it out of scratch into
+// a recycled block. Over-long combinations are replaced by a variable
+// unless allow_long is set.
+static void bind(ConstraintBuilder* cb, uint32_t i, LinearCombination lc, int allow_long) {
+    LinearTerm one, bound;
+    if (lc.count > R1CS_MAX_LINEAR_TERMS && !allow_long) {
+        // lc * 1 = w
+        uint32_t variable = new_variable(cb, i);
+        emit_constraint(cb, i, lc, single_term(&one, R1CS_ONE, &cb->ctx->field->one),
+                        single_term(&bound, variable, &cb->ctx->field->one));
+        lc = single_term(&bound, variable, &cb->ctx->field->one);
+        cb->r1cs->materialized++;
+    }
+    cb->counts[i] = lc.count;
+    if (lc.count == 0) {
+        cb->blocks[i] = NULL;
+        return;
+    }
+
+    uint8_t size_class = 0;
+    while ((1u << size_class) < lc.count) size_class++;
+    LinearTerm* block = cb->free_blocks[size_class];
+    if (block) {
+        cb->free_blocks[size_class] = *(LinearTerm**)block;
+    } else {
+        block = (LinearTerm*)arena_alloc(cb->work, sizeof(LinearTerm) << size_class);
+    }
+    memcpy(block, lc.terms, sizeof(LinearTerm) * lc.count);
+    cb->blocks[i] = block;
+    cb->size_classes[i] = size_class;
+}
+
+// Helper to return a value's block to its free list
+static inline void release(ConstraintBuilder* cb, ValueId value) {
+    LinearTerm* block = cb->blocks[value];
+    if (!block) return;
+    *(LinearTerm**)block = cb->free_blocks[cb->size_classes[value]];
+    cb->free_blocks[cb->size_classes[value]] = block;
+    cb->blocks[value] = NULL;
+}
+
+// Helper to release the operands of instruction i that it uses last
+static void release_operands(ConstraintBuilder* cb, uint32_t i) {
+    const IRProgram* program = cb->program;
+    const IRInstruction* instr = &program->instrs[i];
+    ValueId operands[2] = {instr->src1, instr->src2};
+    for (int k = 0; k < 2; k++) {
+        ValueId v = operands[k];
+        if (v == IR_NO_VALUE || ir_is_const(v) || (k == 1 && v == operands[0])) continue;
+        if (program->uses[program->use_offsets[v + 1] - 1] == i) release(cb, v);
+    }
+    if (program->use_offsets[i + 1] == program->use_offsets[i]) release(cb, i); // Never used
+}
+
+// Lowers one instruction
+static void lower_instruction(ConstraintBuilder* cb, uint32_t i) {
+    const Field* field = cb->ctx->field;
+    const IRInstruction* instr = &cb->program->instrs[i];
+    LinearTerm storage1, storage2, storage3, storage4;
+    LinearCombination lhs = {NULL, 0}, rhs = {NULL, 0};
+    FieldElement k;
+    if (instr->src1 != IR_NO_VALUE) lhs = operand_lc(cb, instr->src1, &storage1);
+    if (instr->src2 != IR_NO_VALUE) rhs = operand_lc(cb, instr->src2, &storage2);
+
+    switch (instr->op) {
+        case IR_OP_INPUT:
+        case IR_OP_PUBLIC:
+            break; // Bound to their variables up front
+
+        case IR_OP_OUTPUT:
+            // value * 1 = output, the output's variable bound up front
+            emit_constraint(cb, i, lhs, single_term(&storage3, R1CS_ONE, &field->one),
+                            operand_lc(cb, i, &storage4));
+            break;
+
+        case IR_OP_ASSIGN:
+            bind(cb, i, combine(cb, lhs, &field->one, (LinearCombination){NULL, 0}), 0);
+            break;
+
+        case IR_OP_ADD:
+        case IR_OP_SUB: {
+            FieldElement scale = field->one;
+            if (instr->op == IR_OP_SUB) field_neg(field, &scale, &scale);
+            bind(cb, i, combine(cb, lhs, &scale, rhs), 0);
+            cb->r1cs->folded_linear++;
+            break;
+        }
+
+        case IR_OP_MUL:
+            if (is_constant(lhs, &k)) {
+                bind(cb, i, scale_lc(cb, rhs, &k), 0);
+                cb->r1cs->folded_linear++;
+            } else if (is_constant(rhs, &k)) {
+                bind(cb, i, scale_lc(cb, lhs, &k), 0);
+                cb->r1cs->folded_linear++;
+            } else {
+                // lhs * rhs = w
+                uint32_t w = new_variable(cb, i);
+                emit_constraint(cb, i, lhs, rhs, single_term(&storage3, w, &field->one));
+                bind(cb, i, single_term(&storage3, w, &field->one), 0);
+            }
+            break;
+
+        case IR_OP_DIV:
+            if (is_constant(rhs, &k)) {
+                if (!field_inv(field, &k, &k)) {
+                    const IRLocation* loc = &cb->program->locations[i];
+                    compile_error(cb->ctx, STAGE_CONSTRAINTS, loc->line, loc->column, "Division by zero");
+                }
+                bind(cb, i, scale_lc(cb, lhs, &k), 0);
+                cb->r1cs->folded_linear++;
+            } else {
+                // w * rhs = lhs (unsatisfiable when rhs is zero, unless lhs is too)
+                uint32_t w = new_variable(cb, i);
+                emit_constraint(cb, i, single_term(&storage3, w, &field->one), rhs, lhs);
+                bind(cb, i, single_term(&storage3, w, &field->one), 0);
+            }
+            break;
+
+        case IR_OP_EQ: {
+            FieldElement minus_one;
+            field_neg(field, &minus_one, &field->one);
+            LinearCombination difference = combine(cb, lhs, &minus_one, rhs);
+            if (cb->deferred[i]) {
+                // Only asserted: the assertion constrains the difference directly
+                bind(cb, i, difference, 1);
+            } else if (is_constant(difference, &k)) {
+                LinearCombination zero = {NULL, 0};
+                bind(cb, i, field_is_zero(&k) ? single_term(&storage3, R1CS_ONE, &field->one) : zero, 0);
+            } else {
+                // Zero test: d * inv = 1 - out and d * out = 0 force out = (d == 0)
+                uint32_t inverse = new_variable(cb, i | R1CS_INVERSE_FLAG);
+                uint32_t out = new_variable(cb, i);
+                LinearTerm one_minus_out[2];
+                one_minus_out[0].variable = R1CS_ONE;
+                one_minus_out[0].coefficient = field->one;
+                one_minus_out[1].variable = out;
+                one_minus_out[1].coefficient = minus_one;
+                LinearCombination zero = {NULL, 0};
+                emit_constraint(cb, i, difference, single_term(&storage3, inverse, &field->one),
+                                (LinearCombination){one_minus_out, 2});
+                emit_constraint(cb, i, difference, single_term(&storage4, out, &field->one), zero);
+                bind(cb, i, single_term(&storage3, out, &field->one), 0);
+            }
+            break;
+        }
+
+        case IR_OP_ASSERT: {
+            int equality = !ir_is_const(instr->src1) && cb->deferred[instr->src1];
+            if (is_constant(lhs, &k)) {
+                // An equality must have zero difference; anything else must be non-zero
+                if (equality != field_is_zero(&k)) {
+                    const IRLocation* loc = &cb->program->locations[i];
+                    compile_error(cb->ctx, STAGE_CONSTRAINTS, loc->line, loc->column, "Assertion always fails");
+                }
+            } else if (equality) {
+                // difference * 1 = 0
+                emit_constraint(cb, i, lhs, single_term(&storage3, R1CS_ONE, &field->one), (LinearCombination){NULL, 0});
+            } else {
+                // Non-zero test: x * inv = 1
+                uint32_t inverse = new_variable(cb, i | R1CS_INVERSE_FLAG);
+                emit_constraint(cb, i, lhs, single_term(&storage3, inverse, &field->one),
+                                single_term(&storage4, R1CS_ONE, &field->one));
+            }
+            break;
+        }
+    }
+    if (cb->recycle) release_operands(cb, i);
+}
+
+// Helper to set up an empty matrix
+static void init_matrix(SparseMatrix* matrix, uint32_t rows, uint32_t nonzeros) {
+    if (nonzeros == 0) nonzeros = 1;
+    matrix->row_offsets = grow_array(NULL, rows, sizeof(uint32_t));
+    matrix->row_offsets[0] = 0;
+    matrix->columns = grow_array(NULL, nonzeros, sizeof(uint32_t));
+    matrix->coefficients = grow_array(NULL, nonzeros, sizeof(uint32_t));
+    matrix->nonzeros = 0;
+    matrix->capacity = nonzeros;
+}
+
+// Helper to give an empty system heap arrays for rows - 1 constraints and
+// the given nonzeros and variables
+static void init_system(R1CS* r1cs, uint32_t rows, const uint32_t nonzeros[3], uint32_t variables) {
+    r1cs->constraint_capacity = rows;
+    init_matrix(&r1cs->a, rows, nonzeros[0]);
+    init_matrix(&r1cs->b, rows, nonzeros[1]);
+    init_matrix(&r1cs->c, rows, nonzeros[2]);
+    r1cs->locations = grow_array(NULL, rows, sizeof(IRLocation));
+    r1cs->variable_capacity = variables ? variables : 1;
+    r1cs->variable_origins = grow_array(NULL, r1cs->variable_capacity, sizeof(ValueId));
+}
+
+// Helper to allocate the builder's per-value state
+static void init_builder(ConstraintBuilder* cb, uint32_t count) {
+    size_t slots = count ? count : 1;
+    cb->blocks = (LinearTerm**)arena_calloc(cb->work, slots, sizeof(LinearTerm*));
+    cb->counts = (uint32_t*)arena_calloc(cb->work, slots, sizeof(uint32_t));
+    cb->size_classes = (uint8_t*)arena_alloc(cb->work, slots);
+    cb->deferred = (uint8_t*)arena_calloc(cb->work, slots, sizeof(uint8_t));
+    cb->scratch = (LinearTerm*)arena_alloc(cb->work, sizeof(LinearTerm) * 2 * R1CS_MAX_LINEAR_TERMS);
+}
+
+// Helper to give public inputs, public outputs and private inputs from
+// instruction first on their variables, in that order
+static void bind_interface(ConstraintBuilder* cb, uint32_t first) {
+    const IRProgram* program = cb->program;
+    R1CS* r1cs = cb->r1cs;
+    const FieldElement* one = &cb->ctx->field->one;
+    LinearTerm storage;
+    static const IROpType interface[3] = {IR_OP_PUBLIC, IR_OP_OUTPUT, IR_OP_INPUT};
+    for (int pass = 0; pass < 3; pass++) {
+        for (uint32_t i = first; i < program->count; i++) {
+            if (program->instrs[i].op != interface[pass]) continue;
+            bind(cb, i, single_term(&storage, new_variable(cb, i), one), 0);
+            if (pass < 2) r1cs->public_count++;
+            if (pass == 1) r1cs->output_count++;
+            if (pass == 2) r1cs->input_count++;
+        }
+    }
+}
+
+// Cleanup releasing the working memory of a lowering cut short by an error
+static void release_work(void* work) {
+    arena_free((Arena*)work);
+}
+
+// Add a finished system's size to the context's statistics
+void count_system(CompilerContext* ctx, const R1CS* r1cs) {
+    STATS_COUNT(ctx, constraints, r1cs->constraint_count);
+    STATS_COUNT(ctx, variables, r1cs->variable_count);
+    STATS_COUNT(ctx, nonzeros, (uint64_t)r1cs->a.nonzeros + r1cs->b.nonzeros + r1cs->c.nonzeros);
+}
+
+// Lower a program to constraints
+R1CS* compile_constraints(CompilerContext* ctx, IRProgram* program) {
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    if (!program->uses_valid) {
+        ir_build_uses(ctx, program);
+    }
+    uint32_t count = program->count;
+
+    R1CS* r1cs = (R1CS*)arena_calloc(&ctx->arena, 1, sizeof(R1CS));
+    static const uint32_t nonzeros[3] = {4096, 4096, 4096};
+    init_system(r1cs, 1024, nonzeros, 1024);
+    field_pool_init(&r1cs->coefficients, &ctx->arena);
+    arena_add_cleanup(&ctx->arena, release_r1cs, r1cs);
+
+    ConstraintBuilder cb = {ctx};
+    Arena work;
+    arena_init(&work, 0);
+    ArenaCleanup cleanup;
+    context_push_cleanup(ctx, &cleanup, release_work, &work);
+    cb.work = &work;
+    cb.program = program;
+    cb.r1cs = r1cs;
+    cb.recycle = 1;
+    init_builder(&cb, count);
+
+    // The constant 1, then public inputs, public outputs and private inputs
+    new_variable(&cb, IR_NO_VALUE);
+    bind_interface(&cb, 0);
+
+    // Equalities whose only user is an assertion become one linear constraint
+    for (uint32_t i = 0; i < count; i++) {
+        if (program->instrs[i].op != IR_OP_EQ) continue;
+        uint32_t first = program->use_offsets[i];
+        cb.deferred[i] = program->use_offsets[i + 1] == first + 1 &&
+                         program->instrs[program->uses[first]].op == IR_OP_ASSERT;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        lower_instruction(&cb, i);
+    }
+    context_pop_cleanup(ctx, &cleanup);
+    arena_free(&work);
+    count_system(ctx, r1cs);
+    PHASE_END(ctx, PHASE_CONSTRAINTS, &timer);
+    return r1cs;
+}
+
+// Allocate a system to be filled in directly
+R1CS* r1cs_create(CompilerContext* ctx, uint32_t constraints, const uint32_t nonzeros[3], uint32_t variables) {
+    R1CS* r1cs = (R1CS*)arena_calloc(&ctx->arena, 1, sizeof(R1CS));
+    init_system(r1cs, constraints + 1, nonzeros, variables);
+    field_pool_init(&r1cs->coefficients, &ctx->arena);
+    arena_add_cleanup(&ctx->arena, release_r1cs, r1cs);
+    return r1cs;
+}
+
+// Prepare a fragment for its first use
+void constraint_fragment_init(ConstraintFragment* fragment) {
+    memset(fragment, 0, sizeof(ConstraintFragment));
+    static const uint32_t nonzeros[3] = {64, 64, 64};
+    init_system(&fragment->system, 64, nonzeros, 64);
+    arena_init(&fragment->work, 64 * 1024);
+}
+
+// Lower a fragment; unlike whole programs, nothing is recycled, as a
+// fragment is short and the def->use indices are not worth building
+void compile_constraint_fragment(CompilerContext* ctx, IRProgram* program, ConstraintFragment* fragment) {
+    R1CS* r1cs = &fragment->system;
+    uint32_t count = program->count;
+    arena_reset(&fragment->work);
+    r1cs->constraint_count = 0;
+    r1cs->variable_count = 0;
+    r1cs->public_count = r1cs->output_count = r1cs->input_count = 0;
+    r1cs->folded_linear = r1cs->materialized = 0;
+    r1cs->a.nonzeros = r1cs->b.nonzeros = r1cs->c.nonzeros = 0;
+    field_pool_init(&r1cs->coefficients, &fragment->work);
+
+    ConstraintBuilder cb = {ctx};
+    cb.work = &fragment->work;
+    cb.program = program;
+    cb.r1cs = r1cs;
+    init_builder(&cb, count);
+
+    // The constant 1 and the external variables, then the placeholders'
+    // combinations of them
+    for (uint32_t v = 0; v <= fragment->external_count; v++) {
+        new_variable(&cb, IR_NO_VALUE);
+    }
+    for (uint32_t i = 0; i < fragment->bound_count; i++) {
+        LinearCombination lc = {fragment->bound_terms + fragment->bound_offsets[i],
+                                fragment->bound_offsets[i + 1] - fragment->bound_offsets[i]};
+        bind(&cb, i, lc, 1);
+    }
+    bind_interface(&cb, fragment->bound_count);
+
+    // Deferred equalities, from use counts within the fragment
+    uint32_t* use_counts = (uint32_t*)arena_calloc(cb.work, count ? count : 1, sizeof(uint32_t));
+    ValueId* last_users = (ValueId*)arena_alloc(cb.work, sizeof(ValueId) * (count ? count : 1));
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        ValueId operands[2] = {instr->src1, instr->src2};
+        for (int k = 0; k < 2; k++) {
+            ValueId v = operands[k];
+            if (v == IR_NO_VALUE || ir_is_const(v) || (k == 1 && v == operands[0])) continue;
+            use_counts[v]++;
+            last_users[v] = i;
+        }
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        cb.deferred[i] = program->instrs[i].op == IR_OP_EQ && use_counts[i] == 1 &&
+                         program->instrs[last_users[i]].op == IR_OP_ASSERT;
+    }
+
+    for (uint32_t i = fragment->bound_count; i < count; i++) {
+        lower_instruction(&cb, i);
+    }
+    fragment->result_terms = NULL;
+    fragment->result_count = 0;
+    if (fragment->result != IR_NO_VALUE) {
+        fragment->result_terms = cb.blocks[fragment->result];
+        fragment->result_count = cb.counts[fragment->result];
+    }
+}
+
+// Release a fragment's storage
+void constraint_fragment_free(ConstraintFragment* fragment) {
+    release_r1cs(&fragment->system);
+    arena_free(&fragment->work);
+}
+
+// Print constraint system statistics
+void print_r1cs_stats(const R1CS* r1cs) {
+    uint32_t internal = r1cs->variable_count - 1 - r1cs->public_count - r1cs->input_count;
+    printf("Constraints: %u\n", r1cs->constraint_count);
+    printf("Variables: %u (1 constant, %u public inputs, %u outputs, %u private inputs, %u internal)\n",
+           r1cs->variable_count, r1cs->public_count - r1cs->output_count, r1cs->output_count, r1cs->input_count,
+           internal);
+    printf("Nonzeros: A %u, B %u, C %u\n", r1cs->a.nonzeros, r1cs->b.nonzeros, r1cs->c.nonzeros);
+    printf("Distinct coefficients: %u\n", r1cs->coefficients.count);
+    printf("Linear operations folded: %u (%u combinations bound to variables)\n",
+           r1cs->folded_linear, r1cs->materialized);
+}
+
+// Helper to print one row of a matrix as a sum of terms
+static void print_row(const CompilerContext* ctx, const R1CS* r1cs, const SparseMatrix* matrix, uint32_t row) {
+    const Field* field = ctx->field;
+    uint32_t begin = matrix->row_offsets[row], end = matrix->row_offsets[row + 1];
+    if (begin == end) printf("0");
+    for (uint32_t k = begin; k < end; k++) {
+        const FieldElement* coefficient = field_pool_get(&r1cs->coefficients, matrix->coefficients[k]);
+        FieldElement negated;
+        field_neg(field, &negated, coefficient);
+        uint64_t small;
+        char text[FIELD_DECIMAL_SIZE + 1];
+        // Show coefficients just below p as negative numbers
+        if (!field_to_u64(field, coefficient, &small) && field_to_u64(field, &negated, &small)) {
+            snprintf(text, sizeof(text), "-%llu", (unsigned long long)small);
+        } else {
+            field_to_string(field, coefficient, text, sizeof(text));
+        }
+        if (k > begin) printf(" + ");
+        if (matrix->columns[k] == R1CS_ONE) printf("%s", text);
+        else if (strcmp(text, "1") == 0) printf("w%u", matrix->columns[k]);
+        else printf("%s*w%u", text, matrix->columns[k]);
+    }
+}
+
+// Print every constraint
+void print_r1cs(const CompilerContext* ctx, const R1CS* r1cs) {
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        printf("(");
+        print_row(ctx, r1cs, &r1cs->a, row);
+        printf(") * (");
+        print_row(ctx, r1cs, &r1cs->b, row);
+        printf(") = (");
+        print_row(ctx, r1cs, &r1cs->c, row);
+        printf(")\n");
+    }
+}
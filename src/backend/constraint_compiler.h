@@ -0,0 +1,144 @@
+#ifndef CONSTRAINT_COMPILER_H
+#define CONSTRAINT_COMPILER_H
+
+#include "../ir/ir_generator.h"
+
+// Variable 0 of every constraint system is the constant 1
+#define R1CS_ONE 0
+
+// Set in a variable's origin when it holds the inverse of the quantity
+// tested by an EQ or ASSERT instruction (or 0 when that quantity is 0)
+#define R1CS_INVERSE_FLAG 0x80000000u
+
+// Longest linear combination kept symbolic. Longer sums of linear
+// operations are bound to a fresh variable with one constraint.
+#define R1CS_MAX_LINEAR_TERMS 32
+
+// One term of a linear combination: coefficient * variable
+typedef struct {
+    FieldElement coefficient;
+    uint32_t variable;
+} LinearTerm;
+
+// A sparse matrix in compressed row form. The nonzeros of row r are at
+// [row_offsets[r], row_offsets[r + 1]), sorted by variable, each with the
+// pool index of its coefficient.
+typedef struct {
+    uint32_t* row_offsets;    // constraint_count + 1 offsets
+    uint32_t* columns;        // Variable of each nonzero
+    uint32_t* coefficients;   // Coefficient pool index of each nonzero
+    uint32_t nonzeros;
+    uint32_t capacity;        // Allocated nonzeros
+} SparseMatrix;
+
+// A rank-1 constraint system: for every row i,
+// (A_i . w) * (B_i . w) = (C_i . w) over the witness vector w. Variables
+// are laid out as [1, public inputs, public outputs, private inputs,
+// internal variables].
+typedef struct {
+    SparseMatrix a, b, c;
+    uint32_t constraint_count;
+    uint32_t constraint_capacity;
+    uint32_t variable_count;      // Including the constant 1
+    uint32_t variable_capacity;
+    uint32_t public_count;        // Public inputs and outputs, variables 1 .. public_count
+    uint32_t output_count;        // Public outputs, the last output_count public variables
+    uint32_t input_count;         // Private inputs, following the public ones
+    FieldPool coefficients;       // Distinct coefficient values
+    ValueId* variable_origins;    // IR value each variable holds (see R1CS_INVERSE_FLAG)
+    IRLocation* locations;        // Source position each constraint enforces
+    uint32_t folded_linear;       // Linear IR operations folded into combinations
+    uint32_t materialized;        // Combinations bound to a variable for length
+} R1CS;
+
+// Lowering of a program fragment that uses values computed elsewhere.
+// The fragment's first bound_count instructions are placeholders (INPUT
+// instructions) for those values, each equal to a given combination of
+// variables 1 .. external_count; the fragment's own variables follow them.
+// The same fragment is reused for one program after another.
+typedef struct {
+    uint32_t external_count;        // Variables defined outside the fragment
+    uint32_t bound_count;           // Leading placeholder instructions
+    const uint32_t* bound_offsets;  // bound_count + 1 offsets into bound_terms
+    const LinearTerm* bound_terms;  // Combination of each placeholder, sorted by variable
+    ValueId result;                 // Value whose combination to report, or IR_NO_VALUE
+    R1CS system;                    // Constraints of the last fragment lowered
+    const LinearTerm* result_terms; // Combination result equals (in work)
+    uint32_t result_count;
+    Arena work;                     // Cleared by each lowering
+} ConstraintFragment;
+
+// Function prototypes
+
+/**
+ * Lowers a program to a rank-1 constraint system. Additions,
+ * subtractions, copies and multiplication or division by constants are
+ * folded into linear combinations; only products of two non-constant
+ * values, divisions by them, equality tests, assertions and outputs
+ * cost constraints. An assertion of an equality and an output each cost a
+ * single linear constraint.
+ *
+ * @param ctx The compilation context the program belongs to.
+ * @param program The program, optimized or not.
+ * @return The constraint system, allocated in the context's arena.
+ */
+R1CS* compile_constraints(CompilerContext* ctx, IRProgram* program);
+
+/**
+ * Adds a finished system's constraints, variables and nonzeros to the
+ * context's statistics, if it collects them.
+ */
+void count_system(CompilerContext* ctx, const R1CS* r1cs);
+
+/**
+ * Allocates a constraint system with exactly enough room for the given
+ * sizes, for callers that fill in the matrices themselves.
+ *
+ * @param ctx The compilation context to allocate from.
+ * @param constraints Number of constraints.
+ * @param nonzeros Nonzeros of A, B and C.
+ * @param variables Number of variables, including the constant 1.
+ * @return An empty system.
+ */
+R1CS* r1cs_create(CompilerContext* ctx, uint32_t constraints, const uint32_t nonzeros[3], uint32_t variables);
+
+/**
+ * Prepares a fragment for use. The caller then sets its inputs
+ * (external_count through result) before each lowering.
+ */
+void constraint_fragment_init(ConstraintFragment* fragment);
+
+/**
+ * Lowers a fragment the way compile_constraints lowers a whole program,
+ * except that placeholders are bound to their combinations instead of
+ * getting variables, and the constant 1 and externals take variables
+ * 0 .. external_count. The result replaces the fragment's previous system.
+ *
+ * @param ctx The compilation context the program belongs to.
+ * @param program The fragment, placeholders first.
+ * @param fragment The fragment state, with its inputs set.
+ */
+void compile_constraint_fragment(CompilerContext* ctx, IRProgram* program, ConstraintFragment* fragment);
+
+/**
+ * Releases a fragment's storage.
+ */
+void constraint_fragment_free(ConstraintFragment* fragment);
+
+/**
+ * Prints constraint, variable and nonzero counts.
+ *
+ * @param r1cs The constraint system.
+ */
+void print_r1cs_stats(const R1CS* r1cs);
+
+/**
+ * Prints every constraint as (A) * (B) = (C), naming variables w<N>.
+ * Meant for debugging small systems.
+ *
+ * @param ctx The compilation context the system belongs to.
+ * @param r1cs The constraint system.
+ */
+void print_r1cs(const CompilerContext* ctx, const R1CS* r1cs);
+
+#endif // CONSTRAINT_COMPILER_H
@@ -0,0 +1,470 @@
+#include "proof_generator.h"
+#include "../math/ntt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Limbs of a scalar prepared for digit extraction: 256 bits plus the
+// headroom the signed-digit offset carries into
+#define DIGIT_LIMBS 5
+
+// Scalars prepared per task
+#define PREPARE_CHUNK 4096
+
+// A point waiting for its bucket: the point's index and its signed digit
+typedef struct {
+    size_t point;
+    int32_t digit;
+} BucketEntry;
+
+// Workspace of one worker, sized for the job's window
+typedef struct {
+    unsigned char* buckets;     // Affine bucket sums, 2^(c-1) of them
+    unsigned char* overflow;    // Jacobian sums of additions that found their bucket busy
+    uint32_t* stamps;           // Batch that last used each bucket
+    uint32_t stamp;             // Current batch
+    void** sums;                // Buckets of the current batch
+    const void** terms;         // Points they receive (pointers into term_points)
+    unsigned char* term_points; // Copies of those points, negated for negative digits
+    BucketEntry* pending;       // Entries deferred to the next batch
+    BucketEntry* retry;         // Entries deferred from the previous batch
+    void* coordinates;          // batch_add_affine's workspace
+    unsigned char* running;     // Jacobian points for bucket reduction
+    unsigned char* total;
+} MsmScratch;
+
+// Work shared by the tasks of one msm
+typedef struct {
+    const CurveGroup* group;
+    const unsigned char* points;
+    const FieldElement* scalars;
+    uint64_t (*digits)[DIGIT_LIMBS];    // Each scalar plus the signed-digit offset
+    uint64_t offset[DIGIT_LIMBS];       // 2^(c-1) in every window
+    size_t n;
+    int window;                 // c
+    int windows;                // Windows per scalar
+    uint32_t chunks;            // Chunks of points per window
+    size_t chunk;               // Points per chunk
+    uint32_t bucket_count;      // 2^(c-1)
+    uint32_t batch_size;
+    MsmScratch* scratch;        // Workspace of each worker
+    unsigned char* partials;    // Jacobian sum of each (window, chunk) task
+} MsmJob;
+
+// Helper to allocate msm workspace, exiting on failure
+static void* msm_alloc(size_t count, size_t size) {
+    void* block = calloc(count ? count : 1, size);
+    if (!block) {
+        fprintf(stderr, "Error: Memory allocation failed for multi-scalar multiplication.\n");
+        exit(1);
+    }
+    return block;
+}
+
+// About log2(n) - 3 bits, the usual optimum for Pippenger's method
+int msm_window_size(size_t n) {
+    int bits = 0;
+    while (bits < 63 && ((size_t)1 << (bits + 1)) <= n) bits++;
+    int window = bits - 3;
+    if (window < MSM_MIN_WINDOW) window = MSM_MIN_WINDOW;
+    if (window > MSM_MAX_WINDOW) window = MSM_MAX_WINDOW;
+    return window;
+}
+
+// Helper to read the signed digit of window w. The prepared scalar is
+// k + sum(2^(c-1) * 2^(wc)), so every c-bit window of it holds its digit
+// of k plus 2^(c-1), with digits in [-2^(c-1), 2^(c-1)).
+static inline int32_t msm_digit(const uint64_t value[DIGIT_LIMBS], int w, int c) {
+    unsigned offset = (unsigned)(w * c), limb = offset / 64, shift = offset % 64;
+    uint64_t bits = value[limb] >> shift;
+    if (shift + c > 64) bits |= value[limb + 1] << (64 - shift);
+    return (int32_t)(bits & (((uint64_t)1 << c) - 1)) - ((int32_t)1 << (c - 1));
+}
+
+// Thread pool task: convert one chunk of scalars out of Montgomery form
+// and add the digit offset
+static void prepare_scalars(void* arg, uint32_t task, int worker) {
+    MsmJob* job = (MsmJob*)arg;
+    (void)worker;
+    size_t begin = (size_t)task * PREPARE_CHUNK;
+    size_t end = begin + PREPARE_CHUNK < job->n ? begin + PREPARE_CHUNK : job->n;
+    for (size_t i = begin; i < end; i++) {
+        uint64_t canonical[FIELD_LIMBS];
+        field_to_canonical(&FIELD_BN254, canonical, &job->scalars[i]);
+        unsigned __int128 carry = 0;
+        for (int k = 0; k < DIGIT_LIMBS; k++) {
+            carry += (unsigned __int128)job->offset[k] + (k < FIELD_LIMBS ? canonical[k] : 0);
+            job->digits[i][k] = (uint64_t)carry;
+            carry >>= 64;
+        }
+    }
+}
+
+// Helper to queue one point for its bucket. A bucket can take only one
+// point per batch, so a second one waits for the next batch; once that
+// queue is full it is added to the bucket's Jacobian overflow instead.
+static void enqueue_point(MsmJob* job, MsmScratch* scratch, const BucketEntry* entry,
+                          uint32_t* count, uint32_t* pending) {
+    const CurveGroup* group = job->group;
+    uint32_t bucket = (uint32_t)(entry->digit < 0 ? -entry->digit : entry->digit) - 1;
+    const void* point = job->points + entry->point * group->affine_size;
+
+    if (scratch->stamps[bucket] == scratch->stamp) {
+        if (*pending < job->batch_size) {
+            scratch->pending[(*pending)++] = *entry;
+            return;
+        }
+        void* sum = scratch->overflow + (size_t)bucket * group->jacobian_size;
+        if (entry->digit < 0) {
+            unsigned char negated[sizeof(G2Affine)];
+            group->neg_affine(negated, point);
+            group->add_mixed(sum, sum, negated);
+        } else {
+            group->add_mixed(sum, sum, point);
+        }
+        return;
+    }
+
+    scratch->stamps[bucket] = scratch->stamp;
+    scratch->sums[*count] = scratch->buckets + (size_t)bucket * group->affine_size;
+    void* term = scratch->term_points + (size_t)*count * group->affine_size;
+    if (entry->digit < 0) group->neg_affine(term, point);
+    else memcpy(term, point, group->affine_size);
+    (*count)++;
+}
+
+// Thread pool task: sum one chunk of points into buckets for one window,
+// then reduce the buckets to sum((b + 1) * bucket[b])
+static void msm_window_task(void* arg, uint32_t task, int worker) {
+    MsmJob* job = (MsmJob*)arg;
+    const CurveGroup* group = job->group;
+    MsmScratch* scratch = &job->scratch[worker];
+    int w = (int)(task / job->chunks);
+    size_t begin = (size_t)(task % job->chunks) * job->chunk;
+    size_t end = begin + job->chunk < job->n ? begin + job->chunk : job->n;
+
+    memset(scratch->buckets, 0, (size_t)job->bucket_count * group->affine_size);
+    memset(scratch->stamps, 0, (size_t)job->bucket_count * sizeof(uint32_t));
+    for (uint32_t b = 0; b < job->bucket_count; b++) {
+        group->set_infinity(scratch->overflow + (size_t)b * group->jacobian_size);
+    }
+    scratch->stamp = 0;
+
+    size_t i = begin;
+    uint32_t pending = 0;
+    while (i < end || pending > 0) {
+        scratch->stamp++;
+        uint32_t count = 0;
+
+        // Entries deferred from the last batch go first, then new points
+        BucketEntry* retry = scratch->pending;
+        scratch->pending = scratch->retry;
+        scratch->retry = retry;
+        uint32_t retries = pending;
+        pending = 0;
+        for (uint32_t r = 0; r < retries; r++) {
+            enqueue_point(job, scratch, &retry[r], &count, &pending);
+        }
+        for (; i < end && count < job->batch_size; i++) {
+            BucketEntry entry = {i, msm_digit(job->digits[i], w, job->window)};
+            if (entry.digit != 0) enqueue_point(job, scratch, &entry, &count, &pending);
+        }
+        if (count > 0) group->batch_add_affine(scratch->sums, scratch->terms, count, scratch->coordinates);
+    }
+
+    // Running sums: bucket b is added to the total b + 1 times
+    group->set_infinity(scratch->running);
+    group->set_infinity(scratch->total);
+    for (uint32_t b = job->bucket_count; b-- > 0;) {
+        group->add_mixed(scratch->running, scratch->running, scratch->buckets + (size_t)b * group->affine_size);
+        group->add(scratch->running, scratch->running, scratch->overflow + (size_t)b * group->jacobian_size);
+        group->add(scratch->total, scratch->total, scratch->running);
+    }
+    memcpy(job->partials + (size_t)task * group->jacobian_size, scratch->total, group->jacobian_size);
+}
+
+// Split the work into (window, chunk) tasks, then combine the windows
+void msm(const CurveGroup* group, ThreadPool* pool, void* out, const void* points,
+         const FieldElement* scalars, size_t n, int window) {
+    group->set_infinity(out);
+    if (n == 0) return;
+    if (window <= 0) window = msm_window_size(n);
+    if (window < MSM_MIN_WINDOW) window = MSM_MIN_WINDOW;
+    if (window > MSM_MAX_WINDOW) window = MSM_MAX_WINDOW;
+
+    MsmJob job;
+    memset(&job, 0, sizeof(job));
+    job.group = group;
+    job.points = (const unsigned char*)points;
+    job.scalars = scalars;
+    job.n = n;
+    job.window = window;
+    // Scalars are below 2^254; covering 256 bits leaves the top window
+    // room for the offset's carries
+    job.windows = (FIELD_LIMBS * 64 + window - 1) / window;
+    for (int w = 0; w < job.windows; w++) {
+        int bit = w * window + window - 1;
+        job.offset[bit / 64] |= (uint64_t)1 << (bit % 64);
+    }
+    job.bucket_count = (uint32_t)1 << (window - 1);
+    job.batch_size = job.bucket_count / 4;
+    if (job.batch_size < 1) job.batch_size = 1;
+    if (job.batch_size > MSM_BATCH_SIZE) job.batch_size = MSM_BATCH_SIZE;
+
+    // Split each window into chunks only as far as needed to give every
+    // worker a few tasks, and never below 2^c points per chunk, where the
+    // bucket reduction would dominate
+    int workers = thread_pool_size(pool);
+    uint32_t chunks = (uint32_t)((4 * workers + job.windows - 1) / job.windows);
+    size_t most_chunks = n >> window;
+    if (chunks > most_chunks) chunks = (uint32_t)most_chunks;
+    if (chunks < 1) chunks = 1;
+    job.chunk = (n + chunks - 1) / chunks;
+    job.chunks = (uint32_t)((n + job.chunk - 1) / job.chunk);
+
+    job.digits = (uint64_t(*)[DIGIT_LIMBS])msm_alloc(n, sizeof(uint64_t[DIGIT_LIMBS]));
+    thread_pool_run(pool, (uint32_t)((n + PREPARE_CHUNK - 1) / PREPARE_CHUNK), prepare_scalars, &job);
+
+    job.scratch = (MsmScratch*)msm_alloc(workers, sizeof(MsmScratch));
+    for (int k = 0; k < workers; k++) {
+        MsmScratch* scratch = &job.scratch[k];
+        scratch->buckets = (unsigned char*)msm_alloc(job.bucket_count, group->affine_size);
+        scratch->overflow = (unsigned char*)msm_alloc(job.bucket_count, group->jacobian_size);
+        scratch->stamps = (uint32_t*)msm_alloc(job.bucket_count, sizeof(uint32_t));
+        scratch->sums = (void**)msm_alloc(job.batch_size, sizeof(void*));
+        scratch->terms = (const void**)msm_alloc(job.batch_size, sizeof(void*));
+        scratch->term_points = (unsigned char*)msm_alloc(job.batch_size, group->affine_size);
+        for (uint32_t t = 0; t < job.batch_size; t++) {
+            scratch->terms[t] = scratch->term_points + (size_t)t * group->affine_size;
+        }
+        scratch->pending = (BucketEntry*)msm_alloc(job.batch_size, sizeof(BucketEntry));
+        scratch->retry = (BucketEntry*)msm_alloc(job.batch_size, sizeof(BucketEntry));
+        scratch->coordinates = msm_alloc(2 * (size_t)job.batch_size, group->coordinate_size);
+        scratch->running = (unsigned char*)msm_alloc(2, group->jacobian_size);
+        scratch->total = scratch->running + group->jacobian_size;
+    }
+    job.partials = (unsigned char*)msm_alloc((size_t)job.windows * job.chunks, group->jacobian_size);
+
+    thread_pool_run(pool, (uint32_t)job.windows * job.chunks, msm_window_task, &job);
+
+    // Horner's rule over the windows, from the top: shift by c bits, add
+    for (int w = job.windows - 1; w >= 0; w--) {
+        if (w < job.windows - 1) {
+            for (int d = 0; d < window; d++) group->dbl(out, out);
+        }
+        for (uint32_t k = 0; k < job.chunks; k++) {
+            group->add(out, out, job.partials + ((size_t)w * job.chunks + k) * group->jacobian_size);
+        }
+    }
+
+    for (int k = 0; k < workers; k++) {
+        MsmScratch* scratch = &job.scratch[k];
+        free(scratch->buckets);
+        free(scratch->overflow);
+        free(scratch->stamps);
+        free(scratch->sums);
+        free(scratch->terms);
+        free(scratch->term_points);
+        free(scratch->pending);
+        free(scratch->retry);
+        free(scratch->coordinates);
+        free(scratch->running);
+    }
+    free(job.scratch);
+    free(job.partials);
+    free(job.digits);
+}
+
+// Add up the products one by one
+void msm_naive(const CurveGroup* group, void* out, const void* points, const FieldElement* scalars, size_t n) {
+    unsigned char product[sizeof(G2Jacobian)];
+    group->set_infinity(out);
+    for (size_t i = 0; i < n; i++) {
+        uint64_t scalar[FIELD_LIMBS];
+        field_to_canonical(&FIELD_BN254, scalar, &scalars[i]);
+        group->from_affine(product, (const unsigned char*)points + i * group->affine_size);
+        group->mul(product, product, scalar);
+        group->add(out, out, product);
+    }
+}
+
+// Helper to allocate setup workspace, exiting on failure
+static void* setup_alloc(size_t count, size_t size) {
+    void* block = calloc(count ? count : 1, size);
+    if (!block) {
+        fprintf(stderr, "Error: Memory allocation failed for Groth16 setup.\n");
+        exit(1);
+    }
+    return block;
+}
+
+// Helper to multiply the generators by a scalar
+static void g1_generator_mul(G1Affine* out, const FieldElement* scalar) {
+    uint64_t k[FIELD_LIMBS];
+    G1Jacobian p;
+    field_to_canonical(&FIELD_BN254, k, scalar);
+    g1_from_affine(&p, &G1_GENERATOR);
+    g1_mul(&p, &p, k);
+    g1_to_affine(out, &p);
+}
+
+static void g2_generator_mul(G2Affine* out, const FieldElement* scalar) {
+    uint64_t k[FIELD_LIMBS];
+    G2Jacobian p;
+    field_to_canonical(&FIELD_BN254, k, scalar);
+    g2_from_affine(&p, &G2_GENERATOR);
+    g2_mul(&p, &p, k);
+    g2_to_affine(out, &p);
+}
+
+// Helper to add up the coefficients of the public columns of a matrix,
+// weighting each row by its Lagrange basis polynomial at tau
+static void sum_public_columns(const R1CS* r1cs, const SparseMatrix* matrix, const FieldElement* lagrange,
+                               FieldElement* sums) {
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        for (uint32_t k = matrix->row_offsets[row]; k < matrix->row_offsets[row + 1]; k++) {
+            uint32_t column = matrix->columns[k];
+            if (column > r1cs->public_count) continue;
+            FieldElement term;
+            field_mul(&FIELD_BN254, &term, field_pool_get(&r1cs->coefficients, matrix->coefficients[k]),
+                      &lagrange[row]);
+            field_add(&FIELD_BN254, &sums[column], &sums[column], &term);
+        }
+    }
+}
+
+// Only the public columns of the QAP matter to the verifying key. Row j of
+// the system is interpolated at w^j, so a column's polynomial at tau is
+// its coefficients weighted by L_j(tau) = (tau^n - 1) / n * w^j / (tau - w^j).
+VerifyingKey* groth16_setup(CompilerContext* ctx, const R1CS* r1cs, const Groth16Trapdoor* trapdoor,
+                            FieldElement* ic_scalars) {
+    const Field* fr = &FIELD_BN254;
+    // The key's points are on BN254, whose group order is this field; a
+    // system over any other field has no meaning there
+    if (ctx->field != fr) {
+        compile_error(ctx, STAGE_CONSTRAINTS, 0, 0, "Groth16 setup needs a circuit over %s, not %s", fr->name,
+                      ctx->field->name);
+    }
+    uint32_t publics = r1cs->public_count + 1;
+    // Each public variable also gets a row x * 0 = 0 of its own, which keeps
+    // their polynomials linearly independent
+    size_t rows = (size_t)r1cs->constraint_count + publics;
+    NttDomain* domain = ntt_domain_create(fr, ntt_log_size(rows));
+    if (!domain) return NULL;
+
+    FieldElement* lagrange = (FieldElement*)setup_alloc(3 * rows, sizeof(FieldElement));
+    FieldElement* powers = lagrange + rows;
+    FieldElement* scratch = powers + rows;
+    FieldElement power = fr->one;
+    for (size_t j = 0; j < rows; j++) {
+        powers[j] = power;
+        field_sub(fr, &lagrange[j], &trapdoor->tau, &power);
+        field_mul(fr, &power, &power, &domain->root);
+    }
+    field_batch_inv(fr, lagrange, lagrange, rows, scratch);
+    uint64_t size[FIELD_LIMBS] = {domain->size, 0, 0, 0};
+    FieldElement vanishing;
+    field_pow(fr, &vanishing, &trapdoor->tau, size);
+    field_sub(fr, &vanishing, &vanishing, &fr->one);
+    field_mul(fr, &vanishing, &vanishing, &domain->size_inverse);
+    for (size_t j = 0; j < rows; j++) {
+        field_mul(fr, &lagrange[j], &lagrange[j], &powers[j]);
+        field_mul(fr, &lagrange[j], &lagrange[j], &vanishing);
+    }
+
+    FieldElement* u = (FieldElement*)setup_alloc(3 * (size_t)publics, sizeof(FieldElement));
+    FieldElement* v = u + publics;
+    FieldElement* w = v + publics;
+    sum_public_columns(r1cs, &r1cs->a, lagrange, u);
+    sum_public_columns(r1cs, &r1cs->b, lagrange, v);
+    sum_public_columns(r1cs, &r1cs->c, lagrange, w);
+    for (uint32_t i = 0; i < publics; i++) {
+        field_add(fr, &u[i], &u[i], &lagrange[r1cs->constraint_count + i]);
+    }
+
+    VerifyingKey* key = (VerifyingKey*)arena_calloc(&ctx->arena, 1, sizeof(VerifyingKey));
+    key->public_count = r1cs->public_count;
+    key->ic = (G1Affine*)arena_alloc(&ctx->arena, sizeof(G1Affine) * publics);
+    g1_generator_mul(&key->alpha, &trapdoor->alpha);
+    g2_generator_mul(&key->beta, &trapdoor->beta);
+    g2_generator_mul(&key->gamma, &trapdoor->gamma);
+    g2_generator_mul(&key->delta, &trapdoor->delta);
+
+    // ic_i = (beta * u_i + alpha * v_i + w_i) / gamma
+    FieldElement gamma_inverse, k, t;
+    field_inv(fr, &gamma_inverse, &trapdoor->gamma);
+    for (uint32_t i = 0; i < publics; i++) {
+        field_mul(fr, &k, &trapdoor->beta, &u[i]);
+        field_mul(fr, &t, &trapdoor->alpha, &v[i]);
+        field_add(fr, &k, &k, &t);
+        field_add(fr, &k, &k, &w[i]);
+        field_mul(fr, &k, &k, &gamma_inverse);
+        g1_generator_mul(&key->ic[i], &k);
+        if (ic_scalars) ic_scalars[i] = k;
+    }
+
+    free(u);
+    free(lagrange);
+    ntt_domain_free(domain);
+    return key;
+}
+
+// Helper to draw a uniform nonzero scalar from the operating system by
+// rejection: the top limb is masked to the modulus's width first, so at
+// least half the draws are accepted. Any reduced value is a valid
+// Montgomery form, and uniform as one.
+static int random_scalar(FieldElement* out) {
+    const Field* fr = &FIELD_BN254;
+    uint64_t mask = ~0ull >> __builtin_clzll(fr->modulus[FIELD_LIMBS - 1]);
+    do {
+        if (getentropy(out->limbs, sizeof(out->limbs)) != 0) return -1;
+        out->limbs[FIELD_LIMBS - 1] &= mask;
+    } while (!field_is_reduced(fr, out) || field_is_zero(out));
+    return 0;
+}
+
+// Draw every secret independently
+int groth16_random_trapdoor(Groth16Trapdoor* out) {
+    FieldElement* secrets[5] = {&out->tau, &out->alpha, &out->beta, &out->gamma, &out->delta};
+    for (int i = 0; i < 5; i++) {
+        if (random_scalar(secrets[i]) != 0) return -1;
+    }
+    return 0;
+}
+
+// Helper to derive a nonzero scalar from a seed (splitmix64)
+static void scalar_from_seed(FieldElement* out, uint64_t seed) {
+    uint64_t z = seed + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    field_from_u64(&FIELD_BN254, out, (z ^ (z >> 31)) | 1);
+}
+
+// Pick A = a and B = b freely, then solve the verification equation
+// a * b = alpha * beta + gamma * sum(x_i * ic_i) + delta * c for c
+void groth16_simulate_proof(const Groth16Trapdoor* trapdoor, const FieldElement* ic_scalars,
+                            uint32_t public_count, const FieldElement* inputs, uint64_t seed,
+                            Groth16Proof* out) {
+    const Field* fr = &FIELD_BN254;
+    FieldElement a, b, c, sum, t;
+    scalar_from_seed(&a, 2 * seed);
+    scalar_from_seed(&b, 2 * seed + 1);
+
+    sum = ic_scalars[0];
+    for (uint32_t i = 0; i < public_count; i++) {
+        field_mul(fr, &t, &inputs[i], &ic_scalars[i + 1]);
+        field_add(fr, &sum, &sum, &t);
+    }
+    field_mul(fr, &c, &a, &b);
+    field_mul(fr, &t, &trapdoor->alpha, &trapdoor->beta);
+    field_sub(fr, &c, &c, &t);
+    field_mul(fr, &t, &trapdoor->gamma, &sum);
+    field_sub(fr, &c, &c, &t);
+    field_inv(fr, &t, &trapdoor->delta);
+    field_mul(fr, &c, &c, &t);
+
+    g1_generator_mul(&out->a, &a);
+    g2_generator_mul(&out->b, &b);
+    g1_generator_mul(&out->c, &c);
+}
@@ -0,0 +1,136 @@
+#ifndef PROOF_GENERATOR_H
+#define PROOF_GENERATOR_H
+
+#include "constraint_compiler.h"
+#include "../math/curve.h"
+#include "../utils/thread_pool.h"
+
+// Window sizes msm accepts, in bits
+#define MSM_MIN_WINDOW 2
+#define MSM_MAX_WINDOW 20
+
+// Most bucket additions msm gathers before sharing one field inversion
+#define MSM_BATCH_SIZE 512
+
+// A Groth16 proof
+typedef struct {
+    G1Affine a;
+    G2Affine b;
+    G1Affine c;
+} Groth16Proof;
+
+// What a verifier needs to check Groth16 proofs for one constraint system
+typedef struct {
+    G1Affine alpha;
+    G2Affine beta, gamma, delta;
+    uint32_t public_count;      // Public inputs and outputs
+    G1Affine* ic;               // public_count + 1 points: the constant 1, then each public variable
+} VerifyingKey;
+
+// The secrets behind a Groth16 setup. Anyone who knows them can forge
+// proofs, so they are only for development and tests.
+typedef struct {
+    FieldElement tau, alpha, beta, gamma, delta;
+} Groth16Trapdoor;
+
+// Function prototypes
+
+/**
+ * Picks the Pippenger window size for a multi-scalar multiplication of n
+ * points, balancing the n additions per window against the 2^c bucket
+ * additions needed to reduce each window.
+ *
+ * @param n Number of points.
+ * @return A window size between MSM_MIN_WINDOW and MSM_MAX_WINDOW.
+ */
+int msm_window_size(size_t n);
+
+/**
+ * Computes the multi-scalar multiplication sum(scalars[i] * points[i]) with
+ * Pippenger's bucket method. Scalars are split into signed c-bit digits,
+ * so each window needs only 2^(c-1) buckets and negative digits add the
+ * negated point. Points are added to buckets in affine form, a batch at a
+ * time with one shared inversion; the windows, and chunks of the points
+ * within each window, run as separate tasks on the pool.
+ *
+ * @param group The group, CURVE_G1 or CURVE_G2.
+ * @param pool The pool to run on.
+ * @param out Receives the result as a Jacobian point.
+ * @param points n affine points; any may be at infinity.
+ * @param scalars n scalars, elements of FIELD_BN254 (the groups' order).
+ * @param n Number of points.
+ * @param window Window size in bits, or 0 for msm_window_size(n).
+ */
+void msm(const CurveGroup* group, ThreadPool* pool, void* out, const void* points,
+         const FieldElement* scalars, size_t n, int window);
+
+/**
+ * Computes the same sum as msm one product at a time, as a reference.
+ *
+ * @param group The group, CURVE_G1 or CURVE_G2.
+ * @param out Receives the result as a Jacobian point.
+ * @param points n affine points.
+ * @param scalars n scalars, elements of FIELD_BN254.
+ * @param n Number of points.
+ */
+void msm_naive(const CurveGroup* group, void* out, const void* points, const FieldElement* scalars, size_t n);
+
+/**
+ * Derives a Groth16 verifying key for a constraint system from known
+ * secrets, evaluating its QAP at tau. Like every setup with a known
+ * trapdoor this is insecure and meant for development: it gives verifiers
+ * something to check while no ceremony output is available. The system
+ * must be over FIELD_BN254, the order of the curve's groups; any other
+ * field is reported with compile_error.
+ *
+ * @param ctx The compilation context the system belongs to.
+ * @param r1cs The constraint system.
+ * @param trapdoor The secrets.
+ * @param ic_scalars If not NULL, receives the public_count + 1 discrete
+ *                   logarithms of the key's ic points, for
+ *                   groth16_simulate_proof.
+ * @return The key, allocated in the context's arena, or NULL (after
+ *         printing why) if the system is too large for the field.
+ */
+VerifyingKey* groth16_setup(CompilerContext* ctx, const R1CS* r1cs, const Groth16Trapdoor* trapdoor,
+                            FieldElement* ic_scalars);
+
+/**
+ * Draws the secrets of a setup from the operating system's randomness.
+ * Nobody can forge proofs against a key whose secrets were discarded, but
+ * no proving key comes with it either, so for now such keys serve to
+ * generate verifiers to build and benchmark.
+ *
+ * @param out Receives the secrets.
+ * @return 0 on success, -1 if no randomness is available (errno says why).
+ */
+int groth16_random_trapdoor(Groth16Trapdoor* out);
+
+/**
+ * Produces a valid proof for any public inputs from the trapdoor alone,
+ * the way the zero-knowledge simulator does. Lets verifiers be tested and
+ * benchmarked before a prover exists.
+ *
+ * @param trapdoor The secrets the key was derived from.
+ * @param ic_scalars The discrete logarithms groth16_setup returned.
+ * @param public_count Number of public variables.
+ * @param inputs Their values.
+ * @param seed Selects one of the many proofs of the same statement.
+ * @param out Receives the proof.
+ */
+void groth16_simulate_proof(const Groth16Trapdoor* trapdoor, const FieldElement* ic_scalars,
+                            uint32_t public_count, const FieldElement* inputs, uint64_t seed,
+                            Groth16Proof* out);
+
+// Helpers to run msm on typed points
+static inline void msm_g1(ThreadPool* pool, G1Jacobian* out, const G1Affine* points,
+                          const FieldElement* scalars, size_t n) {
+    msm(&CURVE_G1, pool, out, points, scalars, n, 0);
+}
+
+static inline void msm_g2(ThreadPool* pool, G2Jacobian* out, const G2Affine* points,
+                          const FieldElement* scalars, size_t n) {
+    msm(&CURVE_G2, pool, out, points, scalars, n, 0);
+}
+
+#endif // PROOF_GENERATOR_H
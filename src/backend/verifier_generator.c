@@ -0,0 +1,329 @@
+#include "verifier_generator.h"
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Helper to allocate verifier workspace, exiting on failure
+static void* verifier_alloc(size_t count, size_t size) {
+    void* block = calloc(count ? count : 1, size);
+    if (!block) {
+        fprintf(stderr, "Error: Memory allocation failed for proof verification.\n");
+        exit(1);
+    }
+    return block;
+}
+
+// Helper to fill the fixed-base table of one point: entry 15 * w + d - 1
+// holds d * 16^w * p
+static void build_table(G1Affine* table, const G1Affine* p) {
+    G1Jacobian* multiples = (G1Jacobian*)verifier_alloc(VERIFIER_TABLE_SIZE, sizeof(G1Jacobian));
+    FieldElement* scratch = (FieldElement*)verifier_alloc(2 * VERIFIER_TABLE_SIZE, sizeof(FieldElement));
+    G1Jacobian base;
+    g1_from_affine(&base, p);
+    for (int w = 0; w < VERIFIER_WINDOWS; w++) {
+        G1Jacobian* row = multiples + 15 * w;
+        row[0] = base;
+        for (int d = 1; d < 15; d++) g1_add(&row[d], &row[d - 1], &base);
+        for (int i = 0; i < VERIFIER_WINDOW_BITS; i++) g1_double(&base, &base);
+    }
+    g1_batch_to_affine(table, multiples, VERIFIER_TABLE_SIZE, scratch);
+    free(scratch);
+    free(multiples);
+}
+
+void groth16_prepare_verifying_key(PreparedVerifyingKey* out, const VerifyingKey* key, G1Affine* tables) {
+    out->public_count = key->public_count;
+    out->ic = key->ic;
+    out->ic_tables = tables;
+    out->alpha = key->alpha;
+    if (tables) {
+        for (uint32_t i = 0; i <= key->public_count; i++) {
+            build_table(tables + (size_t)i * VERIFIER_TABLE_SIZE, &key->ic[i]);
+        }
+    }
+    pairing(&out->alpha_beta, &key->alpha, &key->beta);
+    pairing_prepare(&out->beta, &key->beta);
+    pairing_prepare(&out->gamma, &key->gamma);
+    pairing_prepare(&out->delta, &key->delta);
+}
+
+// Helper to add scalar * ic_point to acc, from the table when there is one
+static void add_ic_multiple(const PreparedVerifyingKey* key, G1Jacobian* acc, uint32_t point,
+                            const FieldElement* scalar) {
+    uint64_t k[FIELD_LIMBS];
+    field_to_canonical(&FIELD_BN254, k, scalar);
+    if (!key->ic_tables) {
+        G1Jacobian product;
+        g1_from_affine(&product, &key->ic[point]);
+        g1_mul(&product, &product, k);
+        g1_add(acc, acc, &product);
+        return;
+    }
+    const G1Affine* table = key->ic_tables + (size_t)point * VERIFIER_TABLE_SIZE;
+    for (int w = 0; w < VERIFIER_WINDOWS; w++) {
+        unsigned digit = (unsigned)(k[w / 16] >> (4 * (w % 16))) & 15;
+        if (digit) g1_add_mixed(acc, acc, &table[15 * w + digit - 1]);
+    }
+}
+
+// Helper to compute -(scale * ic_0 + sum(inputs[i] * ic_(i+1))), where a
+// NULL scale stands for 1
+static void combine_inputs(const PreparedVerifyingKey* key, G1Affine* out, const FieldElement* scale,
+                           const FieldElement* inputs) {
+    G1Jacobian acc;
+    if (scale) {
+        g1_set_infinity(&acc);
+        add_ic_multiple(key, &acc, 0, scale);
+    } else {
+        g1_from_affine(&acc, &key->ic[0]);
+    }
+    for (uint32_t i = 0; i < key->public_count; i++) add_ic_multiple(key, &acc, i + 1, &inputs[i]);
+    g1_to_affine(out, &acc);
+    g1_neg_affine(out, out);
+}
+
+// Helper to check that a proof's points are in their groups. G1 has
+// cofactor 1, so being on the curve is enough there; the twist G2 lives on
+// does not, so B must also be killed by the group order.
+static int proof_in_groups(const Groth16Proof* proof) {
+    if (!g1_is_on_curve(&proof->a) || !g1_is_on_curve(&proof->c) || !g2_is_on_curve(&proof->b)) return 0;
+    G2Jacobian b;
+    g2_from_affine(&b, &proof->b);
+    g2_mul(&b, &b, FIELD_BN254.modulus);
+    return fq2_is_zero(&b.z);
+}
+
+int groth16_verify_prepared(const PreparedVerifyingKey* key, const Groth16Proof* proof, const FieldElement* inputs) {
+    if (!proof_in_groups(proof)) return 0;
+    G1Affine p[3];
+    p[0] = proof->a;
+    combine_inputs(key, &p[1], NULL, inputs);
+    g1_neg_affine(&p[2], &proof->c);
+
+    G2Prepared b;
+    pairing_prepare(&b, &proof->b);
+    const G2Prepared* q[3] = {&b, &key->gamma, &key->delta};
+    Fq12 f;
+    pairing_miller_loop(&f, p, q, 3);
+    pairing_final_exponentiation(&f, &f);
+    return fq12_equal(&f, &key->alpha_beta);
+}
+
+int groth16_verify(const VerifyingKey* key, const Groth16Proof* proof, const FieldElement* inputs) {
+    PreparedVerifyingKey* prepared = (PreparedVerifyingKey*)verifier_alloc(1, sizeof(PreparedVerifyingKey));
+    groth16_prepare_verifying_key(prepared, key, NULL);
+    int valid = groth16_verify_prepared(prepared, proof, inputs);
+    free(prepared);
+    return valid;
+}
+
+// Helper to draw random 128-bit scalars from the operating system: the
+// batch is only sound if whoever made the proofs cannot predict them.
+// Returns 0, or -1 if the system has no randomness to give.
+static int random_scalars(uint64_t (*out)[2], size_t count) {
+    unsigned char* bytes = (unsigned char*)out;
+    size_t length = count * sizeof(out[0]);
+    for (size_t done = 0; done < length; done += 256) {
+        size_t chunk = length - done < 256 ? length - done : 256;
+        if (getentropy(bytes + done, chunk) != 0) return -1;
+    }
+    return 0;
+}
+
+// With random r_k, every proof is valid (up to 2^-128) exactly when
+//   prod e(r_k A_k, B_k) * e(-R alpha, beta) * e(-sum r_k IC_k, gamma)
+//     * e(-sum r_k C_k, delta) = 1,  R = sum r_k
+// where sum r_k IC_k = R ic_0 + sum_i (sum_k r_k x_k,i) ic_i is combined
+// as scalars first, so the inputs cost one table lookup per ic point.
+int groth16_verify_batch(const PreparedVerifyingKey* key, const Groth16Proof* proofs, const FieldElement* inputs,
+                         size_t count) {
+    const Field* fr = &FIELD_BN254;
+    if (count == 0) return 1;
+    for (size_t k = 0; k < count; k++) {
+        if (!proof_in_groups(&proofs[k])) return 0;
+    }
+
+    // Without unpredictable scalars the batch proves nothing, so fall back
+    // to checking each proof on its own
+    uint64_t (*r)[2] = (uint64_t (*)[2])verifier_alloc(count, sizeof(*r));
+    if (random_scalars(r, count) != 0) {
+        free(r);
+        for (size_t k = 0; k < count; k++) {
+            if (!groth16_verify_prepared(key, &proofs[k], inputs + k * key->public_count)) return 0;
+        }
+        return 1;
+    }
+    FieldElement* sums = (FieldElement*)verifier_alloc(key->public_count + 1, sizeof(FieldElement));
+    G1Jacobian* scaled = (G1Jacobian*)verifier_alloc(count, sizeof(G1Jacobian));
+    G1Affine* points = (G1Affine*)verifier_alloc(count, sizeof(G1Affine));
+    FieldElement* scratch = (FieldElement*)verifier_alloc(2 * count, sizeof(FieldElement));
+    G2Prepared* lines = (G2Prepared*)verifier_alloc(VERIFIER_BATCH_CHUNK, sizeof(G2Prepared));
+
+    // 2^64, to assemble each r_k as a field element
+    FieldElement shift;
+    field_from_u64(fr, &shift, 1ull << 32);
+    field_sqr(fr, &shift, &shift);
+
+    FieldElement total = {{0}}, rk, t;
+    G1Jacobian c_sum, term;
+    g1_set_infinity(&c_sum);
+    for (size_t k = 0; k < count; k++) {
+        uint64_t scalar[FIELD_LIMBS] = {r[k][0], r[k][1], 0, 0};
+        field_from_u64(fr, &rk, r[k][1]);
+        field_mul(fr, &rk, &rk, &shift);
+        field_from_u64(fr, &t, r[k][0]);
+        field_add(fr, &rk, &rk, &t);
+        field_add(fr, &total, &total, &rk);
+        const FieldElement* x = inputs + k * key->public_count;
+        for (uint32_t i = 0; i < key->public_count; i++) {
+            field_mul(fr, &t, &rk, &x[i]);
+            field_add(fr, &sums[i], &sums[i], &t);
+        }
+        g1_from_affine(&scaled[k], &proofs[k].a);
+        g1_mul(&scaled[k], &scaled[k], scalar);
+        g1_from_affine(&term, &proofs[k].c);
+        g1_mul(&term, &term, scalar);
+        g1_add(&c_sum, &c_sum, &term);
+    }
+    g1_batch_to_affine(points, scaled, count, scratch);
+
+    // The three fixed pairings
+    G1Affine p[3];
+    uint64_t scalar[FIELD_LIMBS];
+    field_to_canonical(fr, scalar, &total);
+    g1_from_affine(&term, &key->alpha);
+    g1_mul(&term, &term, scalar);
+    g1_to_affine(&p[0], &term);
+    g1_neg_affine(&p[0], &p[0]);
+    combine_inputs(key, &p[1], &total, sums);
+    g1_to_affine(&p[2], &c_sum);
+    g1_neg_affine(&p[2], &p[2]);
+    const G2Prepared* q[VERIFIER_BATCH_CHUNK] = {&key->beta, &key->gamma, &key->delta};
+    Fq12 f, part;
+    pairing_miller_loop(&f, p, q, 3);
+
+    // The proofs' pairings, a chunk of prepared B points at a time
+    for (size_t start = 0; start < count; start += VERIFIER_BATCH_CHUNK) {
+        size_t n = count - start < VERIFIER_BATCH_CHUNK ? count - start : VERIFIER_BATCH_CHUNK;
+        for (size_t k = 0; k < n; k++) {
+            pairing_prepare(&lines[k], &proofs[start + k].b);
+            q[k] = &lines[k];
+        }
+        pairing_miller_loop(&part, points + start, q, n);
+        fq12_mul(&f, &f, &part);
+    }
+    pairing_final_exponentiation(&f, &f);
+
+    free(lines);
+    free(scratch);
+    free(points);
+    free(scaled);
+    free(sums);
+    free(r);
+    return fq12_is_one(&f);
+}
+
+// Helpers to print constants as C initializers
+static void emit_field(FILE* out, const FieldElement* a) {
+    fprintf(out, "{{0x%016" PRIx64 "ull, 0x%016" PRIx64 "ull, 0x%016" PRIx64 "ull, 0x%016" PRIx64 "ull}}",
+            a->limbs[0], a->limbs[1], a->limbs[2], a->limbs[3]);
+}
+
+static void emit_fq2(FILE* out, const Fq2* a) {
+    fputc('{', out);
+    emit_field(out, &a->c0);
+    fputs(", ", out);
+    emit_field(out, &a->c1);
+    fputc('}', out);
+}
+
+static void emit_fq6(FILE* out, const Fq6* a, const char* indent) {
+    fprintf(out, "{\n%s    ", indent);
+    emit_fq2(out, &a->c0);
+    fprintf(out, ",\n%s    ", indent);
+    emit_fq2(out, &a->c1);
+    fprintf(out, ",\n%s    ", indent);
+    emit_fq2(out, &a->c2);
+    fprintf(out, "\n%s}", indent);
+}
+
+static void emit_g1(FILE* out, const G1Affine* p) {
+    fputc('{', out);
+    emit_field(out, &p->x);
+    fputs(", ", out);
+    emit_field(out, &p->y);
+    fputc('}', out);
+}
+
+static void emit_prepared(FILE* out, const G2Prepared* q, const char* what) {
+    fprintf(out, "    // Lines of %s\n    {{\n", what);
+    for (int i = 0; i < PAIRING_LINE_COUNT; i++) {
+        fputs("        {", out);
+        emit_fq2(out, &q->lines[i].c0);
+        fputs(",\n         ", out);
+        emit_fq2(out, &q->lines[i].c1);
+        fputs(",\n         ", out);
+        emit_fq2(out, &q->lines[i].c2);
+        fputs(i + 1 < PAIRING_LINE_COUNT ? "},\n" : "}\n", out);
+    }
+    fprintf(out, "    }, %d}", q->infinity);
+}
+
+// The key is prepared here and printed field by field, in Montgomery form
+// so the verifier uses the limbs as they are
+int generate_verifier(const VerifyingKey* key, const char* name, const char* const* public_names, FILE* out) {
+    uint32_t points = key->public_count + 1;
+    PreparedVerifyingKey* prepared = (PreparedVerifyingKey*)verifier_alloc(1, sizeof(PreparedVerifyingKey));
+    G1Affine* tables = (G1Affine*)verifier_alloc((size_t)points * VERIFIER_TABLE_SIZE, sizeof(G1Affine));
+    groth16_prepare_verifying_key(prepared, key, tables);
+
+    fprintf(out, "// Groth16 verifier for circuit %s, generated by zkl. Do not edit.\n", name);
+    fprintf(out, "//\n// Public inputs, in the order %s_verify takes them:\n", name);
+    for (uint32_t i = 0; i < key->public_count; i++) {
+        const char* variable = public_names ? public_names[i] : NULL;
+        fprintf(out, "//   %u: %s\n", i, variable ? variable : "(unnamed)");
+    }
+    fprintf(out, "\n#include \"backend/verifier_generator.h\"\n\n");
+    fprintf(out, "static const G1Affine %s_ic[%u] = {\n", name, points);
+    for (uint32_t i = 0; i < points; i++) {
+        fputs("    ", out);
+        emit_g1(out, &key->ic[i]);
+        fputs(i + 1 < points ? ",\n" : "\n", out);
+    }
+    fputs("};\n\n", out);
+
+    fprintf(out, "// d * 16^w * ic_i at index %d * i + 15 * w + d - 1\n", VERIFIER_TABLE_SIZE);
+    fprintf(out, "static const G1Affine %s_ic_tables[%zu] = {\n", name, (size_t)points * VERIFIER_TABLE_SIZE);
+    for (size_t i = 0; i < (size_t)points * VERIFIER_TABLE_SIZE; i++) {
+        fputs("    ", out);
+        emit_g1(out, &tables[i]);
+        fputs(i + 1 < (size_t)points * VERIFIER_TABLE_SIZE ? ",\n" : "\n", out);
+    }
+    fputs("};\n\n", out);
+
+    fprintf(out, "static const PreparedVerifyingKey %s_key = {\n", name);
+    fprintf(out, "    %u, %s_ic, %s_ic_tables,\n    ", key->public_count, name, name);
+    emit_g1(out, &prepared->alpha);
+    fputs(",\n    // e(alpha, beta)\n    {", out);
+    emit_fq6(out, &prepared->alpha_beta.c0, "    ");
+    fputs(", ", out);
+    emit_fq6(out, &prepared->alpha_beta.c1, "    ");
+    fputs("},\n", out);
+    emit_prepared(out, &prepared->beta, "beta");
+    fputs(",\n", out);
+    emit_prepared(out, &prepared->gamma, "gamma");
+    fputs(",\n", out);
+    emit_prepared(out, &prepared->delta, "delta");
+    fputs("\n};\n\n", out);
+
+    fprintf(out, "int %s_verify(const Groth16Proof* proof, const FieldElement* inputs) {\n", name);
+    fprintf(out, "    return groth16_verify_prepared(&%s_key, proof, inputs);\n}\n\n", name);
+    fprintf(out, "int %s_verify_batch(const Groth16Proof* proofs, const FieldElement* inputs, size_t count) {\n",
+            name);
+    fprintf(out, "    return groth16_verify_batch(&%s_key, proofs, inputs, count);\n}\n", name);
+
+    free(tables);
+    free(prepared);
+    return ferror(out) ? -1 : 0;
+}
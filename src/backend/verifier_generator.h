@@ -0,0 +1,99 @@
+#ifndef VERIFIER_GENERATOR_H
+#define VERIFIER_GENERATOR_H
+
+#include <stdio.h>
+#include "proof_generator.h"
+#include "../math/pairing.h"
+
+// Public inputs are combined with a fixed-base table per ic point: every
+// 4-bit window of a scalar selects one of 15 precomputed multiples, so a
+// scalar costs at most 64 mixed additions and no doublings
+#define VERIFIER_WINDOW_BITS 4
+#define VERIFIER_WINDOWS 64
+#define VERIFIER_TABLE_SIZE (VERIFIER_WINDOWS * 15)
+
+// Proofs whose G2 points a batch verification prepares at a time
+#define VERIFIER_BATCH_CHUNK 64
+
+// A verifying key with everything that does not depend on the proof
+// computed in advance: e(alpha, beta), the Miller loop lines of beta, gamma
+// and delta, and optionally the ic tables. generate_verifier emits one as
+// constant data, so a circuit's verifier starts with nothing to compute.
+typedef struct {
+    uint32_t public_count;
+    const G1Affine* ic;             // public_count + 1 points
+    const G1Affine* ic_tables;      // VERIFIER_TABLE_SIZE multiples per ic point, or NULL
+    G1Affine alpha;
+    Fq12 alpha_beta;                // e(alpha, beta)
+    G2Prepared beta, gamma, delta;
+} PreparedVerifyingKey;
+
+// Function prototypes
+
+/**
+ * Precomputes the proof-independent parts of verification.
+ *
+ * @param out Receives the prepared key; it points into key (and tables),
+ *            which must outlive it.
+ * @param key The verifying key.
+ * @param tables If not NULL, (public_count + 1) * VERIFIER_TABLE_SIZE
+ *               points to fill with the ic tables.
+ */
+void groth16_prepare_verifying_key(PreparedVerifyingKey* out, const VerifyingKey* key, G1Affine* tables);
+
+/**
+ * Verifies a proof against a prepared key: checks that the proof's points
+ * are in their groups and that
+ * e(A, B) * e(-IC, gamma) * e(-C, delta) = e(alpha, beta), where
+ * IC = ic_0 + sum(inputs[i] * ic_(i+1)).
+ *
+ * @param key The prepared key.
+ * @param proof The proof.
+ * @param inputs public_count public input and output values.
+ * @return 1 if the proof is valid, 0 otherwise.
+ */
+int groth16_verify_prepared(const PreparedVerifyingKey* key, const Groth16Proof* proof, const FieldElement* inputs);
+
+/**
+ * Verifies a proof against a plain key, preparing it first. For keys that
+ * are used more than once, prepare them, or generate a verifier.
+ */
+int groth16_verify(const VerifyingKey* key, const Groth16Proof* proof, const FieldElement* inputs);
+
+/**
+ * Verifies many proofs against the same key at once. Each proof's equation
+ * is raised to a random 128-bit power and all are multiplied together, so
+ * the fixed pairings with alpha, gamma and delta are computed once for the
+ * batch and a single final exponentiation covers every Miller loop. A
+ * batch containing an invalid proof passes with probability about 2^-128.
+ * If the system cannot supply random scalars, the proofs are verified one
+ * at a time instead, with the same result.
+ *
+ * @param key The prepared key.
+ * @param proofs count proofs.
+ * @param inputs count * public_count values, the inputs of each proof in turn.
+ * @param count Number of proofs.
+ * @return 1 if every proof is valid, 0 if any is not (verify them one at
+ *         a time to find out which).
+ */
+int groth16_verify_batch(const PreparedVerifyingKey* key, const Groth16Proof* proofs, const FieldElement* inputs,
+                         size_t count);
+
+/**
+ * Writes the C source of a verifier specialized to one verifying key. The
+ * prepared key, including e(alpha, beta), the lines of the fixed G2 points
+ * and the ic tables, is emitted as constant data, together with
+ * NAME_verify and NAME_verify_batch, which take the same arguments as
+ * groth16_verify_prepared and groth16_verify_batch without the key. The
+ * file is compiled with the zkl sources' src directory on the include path.
+ *
+ * @param key The verifying key.
+ * @param name Prefix of the emitted symbols; a C identifier.
+ * @param public_names Name of each public variable, for comments; may be
+ *                     NULL, as may any of its entries.
+ * @param out Stream to write the source to.
+ * @return 0 on success, -1 on a write error.
+ */
+int generate_verifier(const VerifyingKey* key, const char* name, const char* const* public_names, FILE* out);
+
+#endif // VERIFIER_GENERATOR_H
@@ -0,0 +1,212 @@
+#include "witness_generator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Slot holding the constant 1; the program's constants follow it
+#define SLOT_ONE 0
+
+// Work shared by the tasks of one batch
+typedef struct {
+    const CompilerContext* ctx;
+    const WitnessPlan* plan;
+    const FieldElement* inputs;
+    uint32_t count;
+    uint32_t chunk;             // Assignments per task
+    FieldElement* witnesses;
+    uint32_t* failures;
+    FieldElement** scratch;     // Workspace of each worker
+} WitnessBatch;
+
+// Precompute slots and steps
+WitnessPlan* witness_plan_create(CompilerContext* ctx, const IRProgram* program, const R1CS* r1cs) {
+    WitnessPlan* plan = (WitnessPlan*)arena_calloc(&ctx->arena, 1, sizeof(WitnessPlan));
+    plan->program = program;
+    plan->r1cs = r1cs;
+    uint32_t count = program->count;
+
+    // Constants: 1, then the program's pool
+    plan->constant_count = program->constants.count + 1;
+    plan->constants = (FieldElement*)arena_alloc(&ctx->arena, sizeof(FieldElement) * plan->constant_count);
+    plan->constants[SLOT_ONE] = ctx->field->one;
+    memcpy(plan->constants + 1, program->constants.values, sizeof(FieldElement) * program->constants.count);
+    uint32_t next_slot = plan->constant_count;
+
+    // Inputs, public first, in the order the constraint system lays them out
+    uint32_t* slots = (uint32_t*)arena_alloc(&ctx->arena, sizeof(uint32_t) * (count ? count : 1));
+    for (int pass = 0; pass < 2; pass++) {
+        IROpType op = pass == 0 ? IR_OP_PUBLIC : IR_OP_INPUT;
+        for (uint32_t i = 0; i < count; i++) {
+            if (program->instrs[i].op == op) slots[i] = next_slot++;
+        }
+    }
+    plan->input_count = next_slot - plan->constant_count;
+
+    // Steps in program order; copies and outputs just share their source's slot
+    plan->steps = (WitnessStep*)arena_alloc(&ctx->arena, sizeof(WitnessStep) * (count ? count : 1));
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        uint32_t src1 = IR_NO_VALUE, src2 = IR_NO_VALUE;
+        if (instr->src1 != IR_NO_VALUE) src1 = ir_is_const(instr->src1) ? 1 + ir_const_index(instr->src1) : slots[instr->src1];
+        if (instr->src2 != IR_NO_VALUE) src2 = ir_is_const(instr->src2) ? 1 + ir_const_index(instr->src2) : slots[instr->src2];
+
+        switch (instr->op) {
+            case IR_OP_INPUT:
+            case IR_OP_PUBLIC:
+                break;
+            case IR_OP_ASSIGN:
+            case IR_OP_OUTPUT:
+                slots[i] = src1;
+                break;
+            default: {
+                WitnessStep* step = &plan->steps[plan->step_count++];
+                step->op = instr->op;
+                step->dst = instr->op == IR_OP_ASSERT ? IR_NO_VALUE : next_slot++;
+                step->src1 = src1;
+                step->src2 = src2;
+                step->instr = i;
+                slots[i] = step->dst;
+                break;
+            }
+        }
+    }
+    plan->slot_count = next_slot;
+
+    // Where each witness variable comes from
+    plan->variable_slots = (uint32_t*)arena_alloc(&ctx->arena, sizeof(uint32_t) * r1cs->variable_count);
+    plan->inverses = (WitnessInverse*)arena_alloc(&ctx->arena, sizeof(WitnessInverse) * r1cs->variable_count);
+    plan->variable_slots[R1CS_ONE] = SLOT_ONE;
+    for (uint32_t v = 1; v < r1cs->variable_count; v++) {
+        ValueId origin = r1cs->variable_origins[v];
+        if (!(origin & R1CS_INVERSE_FLAG)) {
+            plan->variable_slots[v] = slots[origin];
+            continue;
+        }
+        // Inverse of what an EQ or ASSERT tests
+        const IRInstruction* instr = &program->instrs[origin & ~R1CS_INVERSE_FLAG];
+        WitnessInverse* inverse = &plan->inverses[plan->inverse_count++];
+        inverse->variable = v;
+        inverse->src1 = ir_is_const(instr->src1) ? 1 + ir_const_index(instr->src1) : slots[instr->src1];
+        inverse->src2 = IR_NO_VALUE;
+        if (instr->op == IR_OP_EQ) {
+            inverse->src2 = ir_is_const(instr->src2) ? 1 + ir_const_index(instr->src2) : slots[instr->src2];
+        }
+        plan->variable_slots[v] = IR_NO_VALUE;
+    }
+    return plan;
+}
+
+// Evaluate the steps for one input assignment
+uint32_t witness_generate(const CompilerContext* ctx, const WitnessPlan* plan, const FieldElement* inputs,
+                          FieldElement* witness, FieldElement* scratch) {
+    const Field* field = ctx->field;
+    FieldElement* values = scratch;
+    memcpy(values, plan->constants, sizeof(FieldElement) * plan->constant_count);
+    memcpy(values + plan->constant_count, inputs, sizeof(FieldElement) * plan->input_count);
+
+    for (uint32_t s = 0; s < plan->step_count; s++) {
+        const WitnessStep* step = &plan->steps[s];
+        const FieldElement* a = &values[step->src1];
+        switch (step->op) {
+            case IR_OP_ADD: field_add(field, &values[step->dst], a, &values[step->src2]); break;
+            case IR_OP_SUB: field_sub(field, &values[step->dst], a, &values[step->src2]); break;
+            case IR_OP_MUL: field_mul(field, &values[step->dst], a, &values[step->src2]); break;
+            case IR_OP_DIV: {
+                FieldElement inverse;
+                if (!field_inv(field, &inverse, &values[step->src2])) return step->instr;
+                field_mul(field, &values[step->dst], a, &inverse);
+                break;
+            }
+            case IR_OP_EQ:
+                if (field_equal(a, &values[step->src2])) values[step->dst] = field->one;
+                else memset(&values[step->dst], 0, sizeof(FieldElement));
+                break;
+            case IR_OP_ASSERT:
+                if (field_is_zero(a)) return step->instr;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Copy out the witness, inverting the tested quantities in one batch
+    const R1CS* r1cs = plan->r1cs;
+    for (uint32_t v = 0; v < r1cs->variable_count; v++) {
+        if (plan->variable_slots[v] != IR_NO_VALUE) witness[v] = values[plan->variable_slots[v]];
+    }
+    if (plan->inverse_count > 0) {
+        FieldElement* tested = scratch + plan->slot_count;
+        for (uint32_t k = 0; k < plan->inverse_count; k++) {
+            const WitnessInverse* inverse = &plan->inverses[k];
+            if (inverse->src2 == IR_NO_VALUE) tested[k] = values[inverse->src1];
+            else field_sub(field, &tested[k], &values[inverse->src1], &values[inverse->src2]);
+        }
+        field_batch_inv(field, tested, tested, plan->inverse_count, tested + plan->inverse_count);
+        for (uint32_t k = 0; k < plan->inverse_count; k++) {
+            witness[plan->inverses[k].variable] = tested[k];
+        }
+    }
+    return WITNESS_OK;
+}
+
+// Thread pool task: one chunk of assignments
+static void generate_chunk(void* arg, uint32_t task, int worker) {
+    WitnessBatch* batch = (WitnessBatch*)arg;
+    const WitnessPlan* plan = batch->plan;
+    uint32_t begin = task * batch->chunk;
+    uint32_t end = begin + batch->chunk < batch->count ? begin + batch->chunk : batch->count;
+    size_t width = plan->r1cs->variable_count;
+    for (uint32_t i = begin; i < end; i++) {
+        batch->failures[i] = witness_generate(batch->ctx, plan, batch->inputs + (size_t)i * plan->input_count,
+                                              batch->witnesses + i * width, batch->scratch[worker]);
+    }
+}
+
+// Split the batch into chunks and run them on the pool
+uint32_t witness_generate_batch(const CompilerContext* ctx, const WitnessPlan* plan, ThreadPool* pool,
+                                const FieldElement* inputs, uint32_t count, FieldElement* witnesses,
+                                uint32_t* failures) {
+    int workers = thread_pool_size(pool);
+    WitnessBatch batch = {ctx, plan, inputs, count, 0, witnesses, failures, NULL};
+
+    // Enough chunks per worker for stealing to even out the load
+    batch.chunk = count / ((uint32_t)workers * 16);
+    if (batch.chunk == 0) batch.chunk = 1;
+
+    batch.scratch = (FieldElement**)calloc(workers, sizeof(FieldElement*));
+    for (int w = 0; batch.scratch && w < workers; w++) {
+        batch.scratch[w] = (FieldElement*)malloc(sizeof(FieldElement) * witness_scratch_size(plan));
+    }
+    for (int w = 0; w < workers; w++) {
+        if (!batch.scratch || !batch.scratch[w]) {
+            fprintf(stderr, "Error: Memory allocation failed for witness generation.\n");
+            exit(1);
+        }
+    }
+
+    thread_pool_run(pool, (count + batch.chunk - 1) / batch.chunk, generate_chunk, &batch);
+
+    for (int w = 0; w < workers; w++) free(batch.scratch[w]);
+    free(batch.scratch);
+
+    uint32_t failed = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (failures[i] != WITNESS_OK) failed++;
+    }
+    return failed;
+}
+
+// Report each failed assignment
+void print_witness_failures(const WitnessPlan* plan, const uint32_t* failures, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (failures[i] == WITNESS_OK) continue;
+        const IRLocation* loc = &plan->program->locations[failures[i]];
+        if (plan->program->instrs[failures[i]].op == IR_OP_DIV) {
+            fprintf(stderr, "Error: Division by zero at line %d, column %d for input %u.\n",
+                    loc->line, loc->column, i);
+        } else {
+            fprintf(stderr, "Error: Assertion at line %d, column %d fails for input %u.\n",
+                    loc->line, loc->column, i);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#ifndef WITNESS_GENERATOR_H
+#define WITNESS_GENERATOR_H
+
+#include "constraint_compiler.h"
+#include "../utils/thread_pool.h"
+
+// Result of generating a witness that satisfied every assertion
+#define WITNESS_OK 0xFFFFFFFFu
+
+// One evaluation step over a flat array of value slots
+typedef struct {
+    IROpType op;        // ADD, SUB, MUL, DIV, EQ or ASSERT
+    uint32_t dst;       // Slot receiving the result (unused for ASSERT)
+    uint32_t src1;      // Operand slots
+    uint32_t src2;
+    uint32_t instr;     // IR instruction the step evaluates, for failures
+} WitnessStep;
+
+// A witness variable holding an inverse: of slot src1, or of
+// src1 - src2 when src2 is not IR_NO_VALUE (0 when that is zero)
+typedef struct {
+    uint32_t variable;
+    uint32_t src1;
+    uint32_t src2;
+} WitnessInverse;
+
+// Everything needed to compute witnesses for one circuit, worked out once
+// and shared by every evaluation. Values live in slots laid out as
+// [constants, inputs, computed values]; copies are resolved to the slot
+// they copy, so only arithmetic remains as steps.
+typedef struct {
+    const IRProgram* program;
+    const R1CS* r1cs;
+    uint32_t slot_count;
+    uint32_t constant_count;    // Slots preloaded with constants
+    FieldElement* constants;    // Their values
+    uint32_t input_count;       // Input slots (public, then private), after the constants
+    WitnessStep* steps;
+    uint32_t step_count;
+    uint32_t* variable_slots;   // Slot each witness variable is copied from (IR_NO_VALUE for inverses)
+    WitnessInverse* inverses;   // Witness variables computed as inverses
+    uint32_t inverse_count;
+} WitnessPlan;
+
+// Function prototypes
+
+/**
+ * Precomputes the evaluation order of a circuit.
+ *
+ * @param ctx The compilation context the program belongs to.
+ * @param program The program, as lowered to r1cs.
+ * @param r1cs The constraint system whose variables witnesses assign.
+ * @return The plan, allocated in the context's arena.
+ */
+WitnessPlan* witness_plan_create(CompilerContext* ctx, const IRProgram* program, const R1CS* r1cs);
+
+/**
+ * Returns the number of field elements in each witness scratch buffer.
+ */
+static inline uint32_t witness_scratch_size(const WitnessPlan* plan) {
+    return plan->slot_count + 2 * plan->inverse_count;
+}
+
+/**
+ * Computes one witness.
+ *
+ * @param ctx The compilation context (for its field).
+ * @param plan The circuit's plan.
+ * @param inputs The input values, public inputs first, in declaration order.
+ * @param witness Receives r1cs->variable_count values.
+ * @param scratch witness_scratch_size(plan) elements of workspace.
+ * @return WITNESS_OK, or the index of the IR instruction that failed: an
+ *         assertion that does not hold or a division by zero.
+ */
+uint32_t witness_generate(const CompilerContext* ctx, const WitnessPlan* plan, const FieldElement* inputs,
+                          FieldElement* witness, FieldElement* scratch);
+
+/**
+ * Computes witnesses for a batch of input assignments across a thread pool.
+ *
+ * @param ctx The compilation context (for its field).
+ * @param plan The circuit's plan.
+ * @param pool The pool to run on.
+ * @param inputs count assignments of plan->input_count values each.
+ * @param count Number of assignments.
+ * @param witnesses Receives count witnesses of r1cs->variable_count values.
+ * @param failures Receives witness_generate's result for each assignment.
+ * @return Number of assignments that failed.
+ */
+uint32_t witness_generate_batch(const CompilerContext* ctx, const WitnessPlan* plan, ThreadPool* pool,
+                                const FieldElement* inputs, uint32_t count, FieldElement* witnesses,
+                                uint32_t* failures);
+
+/**
+ * Prints the failure of each assignment that failed, with the source
+ * position of the failing assertion or division.
+ *
+ * @param plan The circuit's plan.
+ * @param failures Results from witness_generate_batch.
+ * @param count Number of assignments.
+ */
+void print_witness_failures(const WitnessPlan* plan, const uint32_t* failures, uint32_t count);
+
+#endif // WITNESS_GENERATOR_H
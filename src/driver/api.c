@@ -0,0 +1,128 @@
+#include "../../include/zkl.h"
+#include <setjmp.h>
+#include <stdlib.h>
+#include "../frontend/validator.h"
+#include "../ir/optimizer.h"
+#include "../backend/circuit_file.h"
+
+// The public stages are the compiler's, in the same order
+_Static_assert((int)ZKL_STAGE_LEXER == (int)STAGE_LEXER && (int)ZKL_STAGE_CONSTRAINTS == (int)STAGE_CONSTRAINTS,
+               "ZklStage must mirror CompileStage");
+
+struct ZklCircuit {
+    const CompilerContext* ctx;
+    IRProgram* program;
+    R1CS* r1cs;
+};
+
+struct ZklCompiler {
+    CompilerContext ctx;            // Reset, not freed, between compilations
+    ZklCircuit circuit;             // The last compilation's circuit
+    ZklDiagnostic* diagnostics;     // Its errors, in the context's arena
+    uint32_t diagnostic_count;
+};
+
+// Create a compiler with an empty context
+ZklCompiler* zkl_compiler_create(void) {
+    ZklCompiler* compiler = (ZklCompiler*)calloc(1, sizeof(ZklCompiler));
+    if (!compiler) return NULL;
+    context_init(&compiler->ctx);
+    compiler->circuit.ctx = &compiler->ctx;
+    return compiler;
+}
+
+// Free a compiler and everything it compiled
+void zkl_compiler_free(ZklCompiler* compiler) {
+    if (!compiler) return;
+    context_free(&compiler->ctx);
+    free(compiler);
+}
+
+// Helper to expose the context's diagnostics through the public type
+static void publish_diagnostics(ZklCompiler* compiler) {
+    CompilerContext* ctx = &compiler->ctx;
+    compiler->diagnostic_count = ctx->diagnostic_count;
+    compiler->diagnostics = (ZklDiagnostic*)arena_alloc(&ctx->arena, sizeof(ZklDiagnostic) *
+                                                        (ctx->diagnostic_count ? ctx->diagnostic_count : 1));
+    for (uint32_t i = 0; i < ctx->diagnostic_count; i++) {
+        const Diagnostic* diagnostic = &ctx->diagnostics[i];
+        compiler->diagnostics[i].stage = (ZklStage)diagnostic->stage;
+        compiler->diagnostics[i].line = diagnostic->line;
+        compiler->diagnostics[i].column = diagnostic->column;
+        compiler->diagnostics[i].message = diagnostic->message;
+    }
+}
+
+// Compile a program in memory through the whole pipeline
+ZklStatus zkl_compile(ZklCompiler* compiler, const char* source, size_t length, ZklCircuit** circuit) {
+    if (circuit) *circuit = NULL;
+    if (!compiler || (!source && length > 0)) return ZKL_ERROR_ARGUMENT;
+    CompilerContext* ctx = &compiler->ctx;
+    context_reset(ctx);
+    compiler->circuit.program = NULL;
+    compiler->circuit.r1cs = NULL;
+    compiler->diagnostics = NULL;
+    compiler->diagnostic_count = 0;
+
+    jmp_buf jump;
+    if (setjmp(jump) != 0) {
+        ctx->error_jump = NULL;
+        publish_diagnostics(compiler);
+        return ZKL_ERROR_SOURCE;
+    }
+    ctx->error_jump = &jump;
+    AST* ast = parse_tokens(ctx, tokenize_buffer(ctx, source ? source : "", length));
+    validate_program(ctx, ast);
+    IRProgram* program = optimize_ir(ctx, generate_ir(ctx, ast));
+    R1CS* r1cs = compile_constraints(ctx, program);
+    ctx->error_jump = NULL;
+
+    compiler->circuit.program = program;
+    compiler->circuit.r1cs = r1cs;
+    if (circuit) *circuit = &compiler->circuit;
+    return ZKL_OK;
+}
+
+// Count the last compilation's diagnostics
+uint32_t zkl_diagnostic_count(const ZklCompiler* compiler) {
+    return compiler->diagnostic_count;
+}
+
+// Look up one diagnostic
+const ZklDiagnostic* zkl_diagnostic(const ZklCompiler* compiler, uint32_t index) {
+    return index < compiler->diagnostic_count ? &compiler->diagnostics[index] : NULL;
+}
+
+// Format a diagnostic the way the zkl driver prints it
+int zkl_format_diagnostic(const ZklDiagnostic* diagnostic, const char* path, char* buffer, size_t size) {
+    Diagnostic internal = {(CompileStage)diagnostic->stage, diagnostic->line, diagnostic->column,
+                           diagnostic->message};
+    return format_diagnostic(buffer, size, path, &internal);
+}
+
+// Describe a status
+const char* zkl_status_string(ZklStatus status) {
+    switch (status) {
+        case ZKL_OK: return "success";
+        case ZKL_ERROR_SOURCE: return "source has errors";
+        case ZKL_ERROR_IO: return "could not write file";
+        case ZKL_ERROR_ARGUMENT: return "invalid argument";
+    }
+    return "unknown status";
+}
+
+// Describe a circuit
+void zkl_circuit_info(const ZklCircuit* circuit, ZklCircuitInfo* info) {
+    const R1CS* r1cs = circuit->r1cs;
+    info->constraints = r1cs->constraint_count;
+    info->variables = r1cs->variable_count;
+    info->public_inputs = r1cs->public_count - r1cs->output_count;
+    info->public_outputs = r1cs->output_count;
+    info->private_inputs = r1cs->input_count;
+}
+
+// Write a circuit file
+ZklStatus zkl_circuit_save(const ZklCircuit* circuit, const char* path) {
+    if (!circuit || !circuit->r1cs || !path) return ZKL_ERROR_ARGUMENT;
+    return save_circuit(circuit->ctx, circuit->program, circuit->r1cs, path) == 0 ? ZKL_OK : ZKL_ERROR_IO;
+}
@@ -0,0 +1,352 @@
+#include "batch.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <setjmp.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../frontend/validator.h"
+#include "../ir/optimizer.h"
+#include "../backend/circuit_file.h"
+#include "../backend/verifier_generator.h"
+#include "../utils/thread_pool.h"
+
+// A batch being compiled: workers claim files in order of decreasing size
+typedef struct {
+    const BatchOptions* options;
+    BatchFile* files;
+    const uint32_t* order;      // File indices, largest file first
+    CompilerContext* contexts;  // One per worker
+    _Atomic uint32_t next;      // Position in order of the next file to claim
+} BatchJob;
+
+// A file and its size, for sorting
+typedef struct {
+    off_t size;
+    uint32_t index;
+} SizedFile;
+
+// Helper to read the monotonic clock
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Helper to check whether a name ends with an extension
+static int has_extension(const char* name, const char* extension) {
+    size_t length = strlen(name), extension_length = strlen(extension);
+    return length > extension_length && strcmp(name + length - extension_length, extension) == 0;
+}
+
+// Helper to allocate a path of length characters starting with the first
+// prefix_length characters of prefix, exiting on failure
+static char* new_path(const char* prefix, size_t prefix_length, size_t length) {
+    char* path = (char*)malloc(length + 1);
+    if (!path) {
+        fprintf(stderr, "Error: Memory allocation failed for file name.\n");
+        exit(1);
+    }
+    memcpy(path, prefix, prefix_length);
+    path[prefix_length] = '\0';
+    return path;
+}
+
+// Helper to append a path to a source list
+static void add_source(char*** sources, uint32_t* count, char* path) {
+    char** grown = (char**)realloc(*sources, sizeof(char*) * (*count + 1));
+    if (!grown) {
+        fprintf(stderr, "Error: Memory allocation failed for source list.\n");
+        exit(1);
+    }
+    grown[(*count)++] = path;
+    *sources = grown;
+}
+
+// Helper to order names with strcmp for qsort
+static int compare_names(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Helper to order files largest first, then by position for determinism
+static int compare_sizes(const void* a, const void* b) {
+    const SizedFile* x = (const SizedFile*)a;
+    const SizedFile* y = (const SizedFile*)b;
+    if (x->size != y->size) return x->size > y->size ? -1 : 1;
+    return x->index < y->index ? -1 : x->index > y->index;
+}
+
+// Add a file, or a directory's source files
+int batch_add_sources(char*** sources, uint32_t* count, const char* path) {
+    struct stat info;
+    if (stat(path, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        // Unreadable files are reported when they are compiled
+        add_source(sources, count, new_path(path, strlen(path), strlen(path)));
+        return 0;
+    }
+
+    DIR* dir = opendir(path);
+    if (!dir) return -1;
+    uint32_t first = *count;
+    size_t path_length = strlen(path);
+    while (path_length > 1 && path[path_length - 1] == '/') path_length--;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.' || !has_extension(entry->d_name, SOURCE_EXTENSION)) continue;
+        size_t name_length = strlen(entry->d_name);
+        char* source = new_path(path, path_length, path_length + 1 + name_length);
+        source[path_length] = '/';
+        memcpy(source + path_length + 1, entry->d_name, name_length + 1);
+        add_source(sources, count, source);
+    }
+    closedir(dir);
+    qsort(*sources + first, *count - first, sizeof(char*), compare_names);
+    return 0;
+}
+
+// Derive a circuit path from a source path
+char* batch_circuit_path(const char* source, const char* output_dir) {
+    const char* name = strrchr(source, '/');
+    name = name ? name + 1 : source;
+    size_t stem = strlen(name);
+    if (has_extension(name, SOURCE_EXTENSION)) stem -= strlen(SOURCE_EXTENSION);
+
+    const char* dir = output_dir ? output_dir : source;
+    size_t dir_length = output_dir ? strlen(output_dir) : (size_t)(name - source);
+    char* path = new_path(dir, dir_length, dir_length + 1 + stem + strlen(CIRCUIT_EXTENSION));
+    if (output_dir && dir_length > 0 && path[dir_length - 1] != '/') path[dir_length++] = '/';
+    memcpy(path + dir_length, name, stem);
+    strcpy(path + dir_length + stem, CIRCUIT_EXTENSION);
+    return path;
+}
+
+// Helper to name the cache file kept next to a circuit, in the arena
+static char* cache_path(Arena* arena, const char* circuit) {
+    size_t stem = strlen(circuit);
+    if (has_extension(circuit, CIRCUIT_EXTENSION)) stem -= strlen(CIRCUIT_EXTENSION);
+    char* path = (char*)arena_alloc(arena, stem + strlen(CACHE_EXTENSION) + 1);
+    memcpy(path, circuit, stem);
+    strcpy(path + stem, CACHE_EXTENSION);
+    return path;
+}
+
+// Derive a verifier path from a circuit path
+char* batch_verifier_path(const char* circuit) {
+    size_t stem = strlen(circuit);
+    if (has_extension(circuit, CIRCUIT_EXTENSION)) stem -= strlen(CIRCUIT_EXTENSION);
+    char* path = new_path(circuit, stem, stem + strlen(VERIFIER_SUFFIX));
+    strcpy(path + stem, VERIFIER_SUFFIX);
+    return path;
+}
+
+// Helper to make the prefix of a verifier's symbols from its circuit's file
+// name, in the arena: other characters become underscores, and a name
+// that does not start with a letter gets a prefix
+static char* verifier_name(Arena* arena, const char* circuit) {
+    const char* name = strrchr(circuit, '/');
+    name = name ? name + 1 : circuit;
+    size_t length = strlen(name);
+    if (has_extension(name, CIRCUIT_EXTENSION)) length -= strlen(CIRCUIT_EXTENSION);
+    int prefix = length == 0 || !isalpha((unsigned char)name[0]);
+    char* identifier = (char*)arena_alloc(arena, length + 1 + (prefix ? strlen("circuit_") : 0));
+    char* out = identifier;
+    if (prefix) out = stpcpy(out, "circuit_");
+    for (size_t i = 0; i < length; i++) *out++ = isalnum((unsigned char)name[i]) ? name[i] : '_';
+    *out = '\0';
+    return identifier;
+}
+
+// Helper to derive a circuit's verifying key and write its verifier. Errors
+// in the setup go through compile_error; returns 0, or -1 if writing failed
+// (errno says why).
+static int write_verifier(CompilerContext* ctx, const BatchOptions* options, const IRProgram* program,
+                          const R1CS* r1cs, const char* circuit) {
+    Groth16Trapdoor trapdoor;
+    if (options->trapdoor) {
+        trapdoor = *options->trapdoor;
+    } else if (groth16_random_trapdoor(&trapdoor) != 0) {
+        return -1;
+    }
+    VerifyingKey* key = groth16_setup(ctx, r1cs, &trapdoor, NULL);
+    memset(&trapdoor, 0, sizeof(trapdoor));
+    if (!key) compile_error(ctx, STAGE_CONSTRAINTS, 0, 0, "Circuit is too large for a Groth16 setup");
+
+    // Public variables are numbered from 1, after the constant
+    const char** names = (const char**)arena_alloc(&ctx->arena, sizeof(char*) * (r1cs->public_count + 1));
+    for (uint32_t i = 0; i < r1cs->public_count; i++) {
+        ValueId origin = r1cs->variable_origins[i + 1];
+        Symbol name = program->instrs[origin].name;
+        names[i] = name == SYMBOL_NONE ? NULL : symbol_text(&ctx->symbols, name);
+    }
+
+    // Written in memory first, so the file is replaced atomically like the circuit
+    char* text = NULL;
+    size_t length = 0;
+    FILE* out = open_memstream(&text, &length);
+    if (!out) return -1;
+    int status = generate_verifier(key, verifier_name(&ctx->arena, circuit), names, out);
+    if (fclose(out) != 0) status = -1;
+    if (status == 0) {
+        char* path = batch_verifier_path(circuit);
+        FileChunk chunk = {text, length};
+        status = write_file(path, &chunk, 1);
+        free(path);
+    }
+    free(text);
+    return status;
+}
+
+// Cleanup closing a cache when an error in the source ends its compilation
+static void close_cache(void* cache) {
+    compile_cache_close((CompileCache*)cache);
+}
+
+// Helper to keep a failed file's first error once its context is reset
+static char* copy_diagnostic(const CompilerContext* ctx, const char* source) {
+    char* text = NULL;
+    int length = format_diagnostic(NULL, 0, source, &ctx->diagnostics[0]);
+    if (length >= 0 && (text = (char*)malloc((size_t)length + 1)) != NULL) {
+        format_diagnostic(text, (size_t)length + 1, source, &ctx->diagnostics[0]);
+    }
+    return text;
+}
+
+// Helper to close a file's statistics before its context is reset
+static void finish_stats(CompilerContext* ctx) {
+    if (!ctx->stats) return;
+    stats_finish(ctx->stats, &ctx->arena);
+    ctx->stats = NULL;
+}
+
+// Compile one file through the whole pipeline and write its circuit
+void compile_file(CompilerContext* ctx, const BatchOptions* options, BatchFile* file) {
+    double start = now_seconds();
+    ctx->field = options->field ? options->field : &FIELD_BN254;
+    memset(&file->stats, 0, sizeof(file->stats));
+    file->diagnostic = NULL;
+    file->constraints = file->variables = 0;
+    if (options->collect_stats) {
+        memset(&file->compile_stats, 0, sizeof(file->compile_stats));
+        ctx->stats = &file->compile_stats;
+    }
+
+    jmp_buf jump;
+    if (setjmp(jump) != 0) {
+        ctx->error_jump = NULL;
+        file->status = 1;
+        file->error = 0;
+        file->diagnostic = copy_diagnostic(ctx, file->source);
+        finish_stats(ctx);
+        context_reset(ctx);
+        file->seconds = now_seconds() - start;
+        return;
+    }
+    ctx->error_jump = &jump;
+    TokenStream* stream = tokenize_file(ctx, file->source);
+
+    IRProgram* program;
+    R1CS* r1cs;
+    if (options->incremental) {
+        char* path = cache_path(&ctx->arena, file->circuit);
+        CompileCache* cache = compile_cache_open(path, ctx->field);
+        ArenaCleanup cleanup;
+        context_push_cleanup(ctx, &cleanup, close_cache, cache);
+        r1cs = compile_incremental(ctx, cache, stream, &program, &file->stats);
+        context_pop_cleanup(ctx, &cleanup);
+        // The circuit is still right without the cache, so this only warns
+        if (compile_cache_save(cache) != 0) {
+            fprintf(stderr, "Warning: Could not save cache file '%s': %s.\n", path, strerror(errno));
+        }
+        compile_cache_close(cache);
+    } else {
+        AST* ast = parse_tokens(ctx, stream);
+        validate_program(ctx, ast);
+        program = optimize_ir(ctx, generate_ir(ctx, ast));
+        r1cs = compile_constraints(ctx, program);
+    }
+
+    ctx->error_jump = NULL;
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    file->status = save_circuit(ctx, program, r1cs, file->circuit);
+    if (file->status == 0 && options->verifier) {
+        ctx->error_jump = &jump;
+        file->status = write_verifier(ctx, options, program, r1cs, file->circuit);
+        ctx->error_jump = NULL;
+    }
+    file->error = file->status != 0 ? errno : 0;
+    PHASE_END(ctx, PHASE_WRITE, &timer);
+    file->constraints = r1cs->constraint_count;
+    file->variables = r1cs->variable_count;
+    finish_stats(ctx);
+    context_reset(ctx);
+    file->seconds = now_seconds() - start;
+}
+
+// Helper to compile the next unclaimed file; tasks and files are claimed
+// one for one, so every file is compiled exactly once
+static void compile_task(void* arg, uint32_t task, int worker) {
+    (void)task;
+    BatchJob* job = (BatchJob*)arg;
+    uint32_t position = atomic_fetch_add(&job->next, 1);
+    compile_file(&job->contexts[worker], job->options, &job->files[job->order[position]]);
+}
+
+// Compile the files on a thread pool
+void compile_batch(const BatchOptions* options, BatchFile* files, uint32_t count, BatchSummary* summary) {
+    memset(summary, 0, sizeof(*summary));
+    summary->files = count;
+    double start = now_seconds();
+
+    SizedFile* sized = (SizedFile*)malloc(sizeof(SizedFile) * (count ? count : 1));
+    uint32_t* order = (uint32_t*)malloc(sizeof(uint32_t) * (count ? count : 1));
+    if (!sized || !order) {
+        fprintf(stderr, "Error: Memory allocation failed for batch.\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        struct stat info;
+        sized[i].size = stat(files[i].source, &info) == 0 ? info.st_size : 0;
+        sized[i].index = i;
+        summary->source_bytes += (uint64_t)sized[i].size;
+    }
+    qsort(sized, count, sizeof(SizedFile), compare_sizes);
+    for (uint32_t i = 0; i < count; i++) order[i] = sized[i].index;
+    free(sized);
+
+    // More workers than files would only sit idle
+    int threads = options->threads;
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+    if ((uint32_t)threads > count) threads = count ? (int)count : 1;
+    summary->threads = threads;
+
+    BatchJob job = {options, files, order, NULL, 0};
+    job.contexts = (CompilerContext*)malloc(sizeof(CompilerContext) * threads);
+    if (!job.contexts) {
+        fprintf(stderr, "Error: Memory allocation failed for batch.\n");
+        exit(1);
+    }
+    for (int w = 0; w < threads; w++) context_init(&job.contexts[w]);
+    ThreadPool* pool = thread_pool_create(threads);
+    thread_pool_run(pool, count, compile_task, &job);
+    thread_pool_destroy(pool);
+    for (int w = 0; w < threads; w++) context_free(&job.contexts[w]);
+    free(job.contexts);
+    free(order);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (files[i].status != 0) summary->failed++;
+        summary->constraints += files[i].constraints;
+        summary->busy_seconds += files[i].seconds;
+        if (options->collect_stats) stats_merge(&summary->compile_stats, &files[i].compile_stats);
+    }
+    summary->seconds = now_seconds() - start;
+}
@@ -0,0 +1,109 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "../backend/compile_cache.h"
+#include "../backend/proof_generator.h"
+
+// Extension of source files, and of the circuit and cache files written
+// for them
+#define SOURCE_EXTENSION ".zkl"
+#define CIRCUIT_EXTENSION ".zklc"
+#define CACHE_EXTENSION ".zklcache"
+
+// Replaces CIRCUIT_EXTENSION in the name of a circuit's generated verifier
+#define VERIFIER_SUFFIX "_verifier.c"
+
+// How a batch is compiled
+typedef struct {
+    int threads;                // Workers; 0 selects the number of online CPUs
+    int incremental;            // Compile through a cache file next to each circuit
+    const Field* field;         // Field to compile over; NULL selects BN254
+    int collect_stats;          // Time each phase and count what it produced
+    int verifier;               // Also write a Groth16 verifier next to each circuit (BN254 only)
+    const Groth16Trapdoor* trapdoor; // Secrets of the verifiers' setup; NULL draws new ones for each file
+} BatchOptions;
+
+// One file of a batch and what compiling it gave
+typedef struct {
+    const char* source;         // Path of the source file
+    const char* circuit;        // Path of the circuit file to write
+    int status;                 // 0 on success, 1 if the source has errors, -1 if writing failed
+    int error;                  // errno of a failed write
+    char* diagnostic;           // The source's first error, formatted; malloc'd (free it), or NULL
+    uint32_t constraints;
+    uint32_t variables;
+    IncrementalStats stats;     // With options.incremental
+    CompileStats compile_stats; // With options.collect_stats
+    double seconds;             // Time spent on this file alone
+} BatchFile;
+
+// Totals over a batch
+typedef struct {
+    uint32_t files;
+    uint32_t failed;
+    uint64_t constraints;
+    uint64_t source_bytes;
+    int threads;                // Workers the batch ran on
+    double seconds;             // Wall-clock time of the whole batch
+    double busy_seconds;        // Sum of the per-file times
+    CompileStats compile_stats; // Sum of the files' statistics, with options.collect_stats
+} BatchSummary;
+
+// Function prototypes
+
+/**
+ * Adds a path to a list of sources: a directory contributes its files
+ * ending in SOURCE_EXTENSION, in name order (subdirectories are not
+ * searched); anything else is added as given.
+ *
+ * @param sources The list, grown with realloc; free each entry and the list.
+ * @param count Number of entries, updated.
+ * @param path A source file or a directory.
+ * @return 0 on success, -1 if the directory cannot be read (errno says why).
+ */
+int batch_add_sources(char*** sources, uint32_t* count, const char* path);
+
+/**
+ * Names the circuit file of a source: its file name with SOURCE_EXTENSION
+ * replaced by CIRCUIT_EXTENSION, in output_dir, or next to the source if
+ * output_dir is NULL.
+ *
+ * @return The path, allocated with malloc.
+ */
+char* batch_circuit_path(const char* source, const char* output_dir);
+
+/**
+ * Names the verifier of a circuit: its path with CIRCUIT_EXTENSION replaced
+ * by VERIFIER_SUFFIX.
+ *
+ * @return The path, allocated with malloc.
+ */
+char* batch_verifier_path(const char* circuit);
+
+/**
+ * Compiles a source file and writes its circuit file, and with
+ * options->verifier its verifier. The verifier's symbols are prefixed with
+ * the circuit's file name, made into a C identifier. Errors in the source
+ * fail the file (status 1) rather than ending the process.
+ *
+ * @param ctx The context to compile in; it is reset afterwards.
+ * @param options How to compile.
+ * @param file The file; receives its results.
+ */
+void compile_file(CompilerContext* ctx, const BatchOptions* options, BatchFile* file);
+
+/**
+ * Compiles many files in parallel, one per worker at a time, starting
+ * with the largest so that a big file does not finish the batch alone.
+ * Each worker compiles in its own context, reused from file to file.
+ * Files are independent, so their circuits are the same as when compiled
+ * one at a time.
+ *
+ * @param options How to compile.
+ * @param files The files; each receives its results.
+ * @param count Number of files.
+ * @param summary Receives the totals.
+ */
+void compile_batch(const BatchOptions* options, BatchFile* files, uint32_t count, BatchSummary* summary);
+
+#endif // BATCH_H
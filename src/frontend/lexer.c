@@ -1,129 +1,513 @@
 #include "lexer.h"
+#include "../utils/file_io.h"
+#include <assert.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LEXER_X86 1
+#endif
 
-// Maximum number of tokens to allocate initially
-#define MAX_TOKENS 1024
+// Number of tokens to allocate initially; the array grows geometrically
+#define INITIAL_TOKEN_CAPACITY 1024
 
-// Helper function to create a token
-Token* create_token(TokenType type, const char* value, int line, int column) {
-    Token* token = (Token*)malloc(sizeof(Token));
-    if (!token) {
-        fprintf(stderr, "Error: Memory allocation failed for token.\n");
-        exit(1);
+// Source bytes per token used to size the array up front. Most tokens are
+// followed by a separator, so this rarely needs to grow; pages that are
+// never written do not count towards resident memory.
+#define BYTES_PER_TOKEN_ESTIMATE 2
+
+// Bytes classified at a time, one bit each in a 64-bit mask
+#define SCAN_BLOCK 64
+
+// Identifiers and numbers hashed ahead of looking them up
+#define LOOKUP_AHEAD 16
+
+// What each byte can start: the lexer dispatches on these through a table
+// instead of the locale-dependent <ctype.h> functions
+typedef enum {
+    CHAR_INVALID,       // Not allowed outside of tokens
+    CHAR_BLANK,         // Space, tab, carriage return, vertical tab, form feed
+    CHAR_NEWLINE,
+    CHAR_LETTER,        // Starts an identifier or keyword
+    CHAR_DIGIT,         // Starts a number
+    CHAR_OPERATOR,      // + - * /
+    CHAR_EQUALS,        // = or the start of ==
+    CHAR_LPAREN,
+    CHAR_RPAREN
+} CharClass;
+
+static const uint8_t char_classes[256] = {
+    [' '] = CHAR_BLANK, ['\t'] = CHAR_BLANK, ['\r'] = CHAR_BLANK, ['\v'] = CHAR_BLANK, ['\f'] = CHAR_BLANK,
+    ['\n'] = CHAR_NEWLINE,
+    ['a' ... 'z'] = CHAR_LETTER, ['A' ... 'Z'] = CHAR_LETTER,
+    ['0' ... '9'] = CHAR_DIGIT,
+    ['+'] = CHAR_OPERATOR, ['-'] = CHAR_OPERATOR, ['*'] = CHAR_OPERATOR, ['/'] = CHAR_OPERATOR,
+    ['='] = CHAR_EQUALS,
+    ['('] = CHAR_LPAREN,
+    [')'] = CHAR_RPAREN,
+};
+
+// The runs the scanner finds the ends of, each a mask of a block's bytes
+typedef enum {
+    RUN_WORD,           // Letters and digits: the rest of an identifier
+    RUN_DIGITS,         // The rest of a decimal number
+    RUN_BLANKS,         // Whitespace other than newlines
+    RUN_COUNT
+} RunClass;
+
+// Sets masks[r] bit i when byte i of a SCAN_BLOCK-byte block belongs to run r
+typedef void (*BlockClassifier)(const char* block, uint64_t masks[RUN_COUNT]);
+
+// Helper to classify a block one byte at a time
+static void classify_scalar(const char* block, uint64_t masks[RUN_COUNT]) {
+    uint64_t word = 0, digits = 0, blanks = 0;
+    for (int i = 0; i < SCAN_BLOCK; i++) {
+        uint8_t c = char_classes[(unsigned char)block[i]];
+        word |= (uint64_t)(c == CHAR_LETTER || c == CHAR_DIGIT) << i;
+        digits |= (uint64_t)(c == CHAR_DIGIT) << i;
+        blanks |= (uint64_t)(c == CHAR_BLANK) << i;
     }
+    masks[RUN_WORD] = word;
+    masks[RUN_DIGITS] = digits;
+    masks[RUN_BLANKS] = blanks;
+}
+
+#ifdef LEXER_X86
+// Helper to classify a block 16 bytes at a time. Comparisons are signed,
+// so bytes of 0x80 and up fall outside every range.
+__attribute__((target("sse2")))
+static void classify_sse2(const char* block, uint64_t masks[RUN_COUNT]) {
+    uint64_t word = 0, digits = 0, blanks = 0;
+    for (int i = 0; i < SCAN_BLOCK; i += 16) {
+        __m128i c = _mm_loadu_si128((const __m128i*)(block + i));
+        __m128i folded = _mm_or_si128(c, _mm_set1_epi8(0x20)); // Lower case for letters
+        __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                       _mm_cmplt_epi8(folded, _mm_set1_epi8('z' + 1)));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i control = _mm_andnot_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n')),
+                                           _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('\t' - 1)),
+                                                         _mm_cmplt_epi8(c, _mm_set1_epi8('\r' + 1))));
+        __m128i blank = _mm_or_si128(control, _mm_cmpeq_epi8(c, _mm_set1_epi8(' ')));
+        word |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_or_si128(letter, digit)) << i;
+        digits |= (uint64_t)(uint32_t)_mm_movemask_epi8(digit) << i;
+        blanks |= (uint64_t)(uint32_t)_mm_movemask_epi8(blank) << i;
+    }
+    masks[RUN_WORD] = word;
+    masks[RUN_DIGITS] = digits;
+    masks[RUN_BLANKS] = blanks;
+}
 
+// Helper to classify a block 32 bytes at a time, as classify_sse2 does
+__attribute__((target("avx2")))
+static void classify_avx2(const char* block, uint64_t masks[RUN_COUNT]) {
+    uint64_t word = 0, digits = 0, blanks = 0;
+    for (int i = 0; i < SCAN_BLOCK; i += 32) {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(block + i));
+        __m256i folded = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+        __m256i letter = _mm256_and_si256(_mm256_cmpgt_epi8(folded, _mm256_set1_epi8('a' - 1)),
+                                          _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), folded));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        __m256i control = _mm256_andnot_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('\n')),
+                                              _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('\t' - 1)),
+                                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), c)));
+        __m256i blank = _mm256_or_si256(control, _mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')));
+        word |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(letter, digit)) << i;
+        digits |= (uint64_t)(uint32_t)_mm256_movemask_epi8(digit) << i;
+        blanks |= (uint64_t)(uint32_t)_mm256_movemask_epi8(blank) << i;
+    }
+    masks[RUN_WORD] = word;
+    masks[RUN_DIGITS] = digits;
+    masks[RUN_BLANKS] = blanks;
+}
+#endif
+
+// Keywords and the tokens they make. Add new ones here; the perfect hash
+// below is rebuilt around them.
+static const struct {
+    const char* text;
+    TokenType type;
+} keywords[] = {
+    {"assert", TOKEN_KEYWORD_ASSERT},
+    {"input", TOKEN_KEYWORD_INPUT},
+    {"public", TOKEN_KEYWORD_PUBLIC},
+    {"output", TOKEN_KEYWORD_OUTPUT},
+};
+
+#define KEYWORD_COUNT (sizeof(keywords) / sizeof(keywords[0]))
+#define KEYWORD_MAX_BITS 8
+
+// Perfect hash table of the keywords: keyword_slots[keyword_slot(word)]
+// holds 1 + the index of the only keyword that can equal the word, or 0.
+// Built once, by searching for a multiplier that separates every keyword.
+typedef struct {
+    uint8_t slots[1 << KEYWORD_MAX_BITS];
+    uint32_t lengths[KEYWORD_COUNT];
+    uint32_t multiplier;
+    uint32_t shift;             // 32 - log2 of the table size
+    size_t min_length;
+    size_t max_length;
+} KeywordTable;
+
+static KeywordTable keyword_table;
+static BlockClassifier classifier = classify_scalar;
+static LexerScan classifier_scan = LEXER_SCAN_SCALAR;
+static pthread_once_t lexer_once = PTHREAD_ONCE_INIT;
+
+// Helper to combine a word's length with its first, middle and last bytes
+static inline uint32_t keyword_key(const char* text, size_t length) {
+    return (uint32_t)length ^ (uint32_t)(unsigned char)text[0] << 8 ^ (uint32_t)(unsigned char)text[length / 2] << 16 ^
+           (uint32_t)(unsigned char)text[length - 1] << 24;
+}
+
+// Helper to find the perfect hash slot of a word
+static inline uint32_t keyword_slot(const KeywordTable* table, const char* text, size_t length) {
+    return (keyword_key(text, length) * table->multiplier) >> table->shift;
+}
+
+// Helper to build the keyword table: the smallest table, and the first
+// multiplier, under which no two keywords share a slot
+static void build_keyword_table(KeywordTable* table) {
+    table->min_length = SIZE_MAX;
+    table->max_length = 0;
+    for (size_t k = 0; k < KEYWORD_COUNT; k++) {
+        table->lengths[k] = (uint32_t)strlen(keywords[k].text);
+        if (table->lengths[k] < table->min_length) table->min_length = table->lengths[k];
+        if (table->lengths[k] > table->max_length) table->max_length = table->lengths[k];
+    }
+    uint32_t bits = 1;
+    while ((1u << bits) < 2 * KEYWORD_COUNT) bits++;
+    for (; bits <= KEYWORD_MAX_BITS; bits++) {
+        table->shift = 32 - bits;
+        for (uint32_t attempt = 0; attempt < 4096; attempt++) {
+            table->multiplier = 2654435761u + 2 * attempt; // Odd multipliers near the golden ratio
+            memset(table->slots, 0, sizeof(table->slots));
+            size_t k = 0;
+            while (k < KEYWORD_COUNT) {
+                uint8_t* slot = &table->slots[keyword_slot(table, keywords[k].text, table->lengths[k])];
+                if (*slot) break;
+                *slot = (uint8_t)(k + 1);
+                k++;
+            }
+            if (k == KEYWORD_COUNT) return;
+        }
+    }
+    assert(!"no perfect hash separates the keywords"); // The keywords are fixed, so every lexer test checks this
+}
+
+// Helper to tell a keyword from an identifier
+static inline TokenType keyword_type(const char* text, size_t length) {
+    const KeywordTable* table = &keyword_table;
+    if (length < table->min_length || length > table->max_length) return TOKEN_IDENTIFIER;
+    uint32_t k = table->slots[keyword_slot(table, text, length)];
+    if (k && table->lengths[k - 1] == length && memcmp(keywords[k - 1].text, text, length) == 0) {
+        return keywords[k - 1].type;
+    }
+    return TOKEN_IDENTIFIER;
+}
+
+// Helper to pick a block classifier, if the CPU supports it
+static int select_scan(LexerScan scan) {
+    if (scan == LEXER_SCAN_AUTO) {
+        return select_scan(LEXER_SCAN_AVX2) || select_scan(LEXER_SCAN_SSE2) || select_scan(LEXER_SCAN_SCALAR);
+    }
+    BlockClassifier chosen = NULL;
+    switch (scan) {
+        case LEXER_SCAN_SCALAR:
+            chosen = classify_scalar;
+            break;
+#ifdef LEXER_X86
+        case LEXER_SCAN_SSE2:
+            if (__builtin_cpu_supports("sse2")) chosen = classify_sse2;
+            break;
+        case LEXER_SCAN_AVX2:
+            if (__builtin_cpu_supports("avx2")) chosen = classify_avx2;
+            break;
+#endif
+        default:
+            break;
+    }
+    if (!chosen) return 0;
+    classifier = chosen;
+    classifier_scan = scan;
+    return 1;
+}
+
+// Helper to set up the keyword table and the fastest classifier the CPU runs
+static void init_lexer(void) {
+    build_keyword_table(&keyword_table);
+    select_scan(LEXER_SCAN_AUTO);
+}
+
+// Pick a block classifier
+int lexer_use_scan(LexerScan scan) {
+    pthread_once(&lexer_once, init_lexer);
+    return select_scan(scan);
+}
+
+// Name the block classifier in use
+const char* lexer_scan_name(void) {
+    pthread_once(&lexer_once, init_lexer);
+    switch (classifier_scan) {
+        case LEXER_SCAN_SSE2: return "sse2";
+        case LEXER_SCAN_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+// Scanner state: the masks of the block of input last classified. Offsets
+// only move forward, so each block is classified at most once.
+typedef struct {
+    const char* input;
+    size_t length;
+    size_t block;               // Offset of the classified block
+    size_t block_end;           // block + SCAN_BLOCK, or 0 before the first
+    uint64_t masks[RUN_COUNT];
+    BlockClassifier classify;
+} Scanner;
+
+// Helper to classify the block holding offset i. The last block is copied
+// into a buffer padded with bytes of no run, so runs stop at the input's end.
+static void classify_at(Scanner* scanner, size_t i) {
+    scanner->block = i & ~(size_t)(SCAN_BLOCK - 1);
+    scanner->block_end = scanner->block + SCAN_BLOCK;
+    if (scanner->block_end <= scanner->length) {
+        scanner->classify(scanner->input + scanner->block, scanner->masks);
+    } else {
+        char padded[SCAN_BLOCK];
+        memset(padded, 0, sizeof(padded));
+        memcpy(padded, scanner->input + scanner->block, scanner->length - scanner->block);
+        scanner->classify(padded, scanner->masks);
+    }
+}
+
+// Helper to find where the run of class run starting at offset i ends
+static inline size_t run_end(Scanner* scanner, size_t i, RunClass run) {
+    for (;;) {
+        if (i >= scanner->block_end) classify_at(scanner, i);
+        uint64_t stops = ~scanner->masks[run] >> (i - scanner->block);
+        if (stops) return i + (size_t)__builtin_ctzll(stops);
+        i = scanner->block_end;
+    }
+}
+
+// Helper function to grow the token array when it is full
+static void grow_tokens(CompilerContext* ctx, TokenStream* stream) {
+    size_t capacity = stream->capacity * 2;
+    Token* tokens = (Token*)arena_alloc(&ctx->arena, sizeof(Token) * capacity);
+    memcpy(tokens, stream->tokens, sizeof(Token) * stream->count);
+    stream->tokens = tokens;
+    stream->capacity = capacity;
+}
+
+// Helper function to add a token to the token stream
+static inline void add_token(CompilerContext* ctx, TokenStream* stream, TokenType type,
+                             size_t offset, size_t length, Symbol symbol, int line, int column) {
+    if (stream->count == stream->capacity) {
+        grow_tokens(ctx, stream);
+    }
+    Token* token = &stream->tokens[stream->count++];
     token->type = type;
-    token->value = strdup(value); // Duplicate the string value
+    token->offset = (uint32_t)offset;
+    token->length = (uint32_t)length;
+    token->symbol = symbol;
     token->line = line;
     token->column = column;
-    return token;
 }
 
-// Helper function to add a token to the token list
-void add_token(Token* tokens, int* token_count, TokenType type, const char* value, int line, int column) {
-    if (*token_count >= MAX_TOKENS) {
-        fprintf(stderr, "Error: Maximum token limit reached.\n");
-        exit(1);
+// Identifiers and numbers awaiting their symbols and constants. Each is
+// hashed and its table slot prefetched when it is found, and looked up
+// LOOKUP_AHEAD such tokens later, so the tables' cache misses overlap the
+// scanning. Lookups go in order, so symbols and constants are numbered as
+// if looked up at once.
+typedef struct {
+    size_t tokens[LOOKUP_AHEAD];
+    uint32_t hashes[LOOKUP_AHEAD];
+    FieldElement values[LOOKUP_AHEAD]; // Parsed values of numbers
+    size_t added;
+    size_t done;
+} PendingLookups;
+
+// Helper to look up the oldest pending token
+static inline void look_up_oldest(CompilerContext* ctx, TokenStream* stream, PendingLookups* pending) {
+    size_t slot = pending->done++ % LOOKUP_AHEAD;
+    Token* token = &stream->tokens[pending->tokens[slot]];
+    if (token->type == TOKEN_NUMBER) {
+        token->constant = field_pool_add_hashed(&ctx->constants, &pending->values[slot], pending->hashes[slot]);
+    } else {
+        token->symbol = intern_hashed(&ctx->symbols, stream->source + token->offset, token->length,
+                                      pending->hashes[slot]);
+    }
+}
+
+// Helper to make room for a pending token, returning its slot
+static inline size_t add_pending(CompilerContext* ctx, TokenStream* stream, PendingLookups* pending) {
+    if (pending->added - pending->done == LOOKUP_AHEAD) {
+        look_up_oldest(ctx, stream, pending);
+    }
+    size_t slot = pending->added++ % LOOKUP_AHEAD;
+    pending->tokens[slot] = stream->count - 1;
+    return slot;
+}
+
+// Helper to queue the last token added, an identifier, for interning
+static inline void defer_intern(CompilerContext* ctx, TokenStream* stream, PendingLookups* pending) {
+    size_t slot = add_pending(ctx, stream, pending);
+    const Token* token = &stream->tokens[stream->count - 1];
+    pending->hashes[slot] = intern_hash(stream->source + token->offset, token->length);
+    intern_prefetch(&ctx->symbols, pending->hashes[slot]);
+}
+
+// Helper to parse the last token added, a numeric literal, and queue it
+// for the context's constant pool. Literals of the field modulus or more
+// wrap around, as all arithmetic does.
+static inline void defer_constant(CompilerContext* ctx, TokenStream* stream, PendingLookups* pending) {
+    const Token* token = &stream->tokens[stream->count - 1];
+    FieldElement value;
+    if (!field_from_string(ctx->field, &value, stream->source + token->offset, token->length)) {
+        compile_error(ctx, STAGE_LEXER, token->line, token->column, "Invalid numeric literal '%.*s'",
+                      (int)token->length, stream->source + token->offset);
     }
-    tokens[*token_count] = *create_token(type, value, line, column);
-    (*token_count)++;
+    size_t slot = add_pending(ctx, stream, pending);
+    pending->values[slot] = value;
+    pending->hashes[slot] = field_pool_hash(&value);
+    field_pool_prefetch(&ctx->constants, pending->hashes[slot]);
+}
+
+// Helper to test for a digit of a hexadecimal literal
+static inline int is_hex_digit(char c) {
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
 }
 
 // The main lexer function
-Token* tokenize(const char* input) {
-    Token* tokens = malloc(sizeof(Token) * MAX_TOKENS); // Allocate memory for tokens
-    if (!tokens) {
-        fprintf(stderr, "Error: Memory allocation failed for tokens array.\n");
-        exit(1);
+TokenStream* tokenize_buffer(CompilerContext* ctx, const char* input, size_t length) {
+    if (length > UINT32_MAX) {
+        compile_error(ctx, STAGE_LEXER, 0, 0, "Input of %zu bytes exceeds the 4 GiB source limit", length);
     }
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    pthread_once(&lexer_once, init_lexer);
+
+    TokenStream* stream = (TokenStream*)arena_alloc(&ctx->arena, sizeof(TokenStream));
+    stream->capacity = length / BYTES_PER_TOKEN_ESTIMATE + 1;
+    if (stream->capacity < INITIAL_TOKEN_CAPACITY) stream->capacity = INITIAL_TOKEN_CAPACITY;
+    stream->tokens = (Token*)arena_alloc(&ctx->arena, sizeof(Token) * stream->capacity); // Allocate memory for tokens
+    stream->count = 0;
+    stream->source = input;
+    stream->source_length = length;
 
-    int token_count = 0; // Number of tokens generated
+    Scanner scanner = {input, length, 0, 0, {0, 0, 0}, classifier};
+    PendingLookups pending;
+    pending.added = pending.done = 0;
     int line = 1, column = 1; // Track line and column for error reporting
 
-    for (const char* p = input; *p != '\0'; ++p) {
-        // Skip whitespace
-        if (isspace(*p)) {
-            if (*p == '\n') {
+    for (size_t i = 0; i < length;) {
+        unsigned char c = (unsigned char)input[i];
+        switch ((CharClass)char_classes[c]) {
+            case CHAR_BLANK: {
+                size_t end = run_end(&scanner, i + 1, RUN_BLANKS);
+                column += (int)(end - i);
+                i = end;
+                break;
+            }
+
+            case CHAR_NEWLINE:
                 line++;
                 column = 1;
-            } else {
-                column++;
+                i++;
+                break;
+
+            case CHAR_LETTER: {
+                // Identifiers or keywords
+                size_t end = run_end(&scanner, i + 1, RUN_WORD);
+                size_t len = end - i;
+                TokenType type = keyword_type(input + i, len);
+                add_token(ctx, stream, type, i, len, SYMBOL_NONE, line, column);
+                if (type == TOKEN_IDENTIFIER) defer_intern(ctx, stream, &pending);
+                column += (int)len;
+                i = end;
+                break;
             }
-            continue;
-        }
 
-        // Handle identifiers or keywords
-        if (isalpha(*p)) {
-            const char* start = p;
-            while (isalnum(*p)) p++;
-            char* value = strndup(start, p - start); // Extract the identifier/keyword
-            TokenType type = (strcmp(value, "assert") == 0) ? TOKEN_KEYWORD_ASSERT : TOKEN_IDENTIFIER;
-            add_token(tokens, &token_count, type, value, line, column);
-            column += p - start;
-            p--; // Adjust pointer to compensate for the for loop increment
-            free(value);
-            continue;
-        }
+            case CHAR_DIGIT: {
+                size_t end;
+                if (c == '0' && i + 1 < length && (input[i + 1] | 0x20) == 'x') {
+                    end = i + 2; // Hexadecimal; rare enough to scan a byte at a time
+                    while (end < length && is_hex_digit(input[end])) end++;
+                } else {
+                    end = run_end(&scanner, i + 1, RUN_DIGITS);
+                }
+                add_token(ctx, stream, TOKEN_NUMBER, i, end - i, SYMBOL_NONE, line, column);
+                defer_constant(ctx, stream, &pending);
+                column += (int)(end - i);
+                i = end;
+                break;
+            }
 
-        // Handle numbers
-        if (isdigit(*p)) {
-            const char* start = p;
-            while (isdigit(*p)) p++;
-            char* value = strndup(start, p - start); // Extract the numeric value
-            add_token(tokens, &token_count, TOKEN_NUMBER, value, line, column);
-            column += p - start;
-            p--; // Adjust pointer
-            free(value);
-            continue;
-        }
+            case CHAR_OPERATOR:
+                add_token(ctx, stream, TOKEN_OPERATOR, i, 1, SYMBOL_NONE, line, column++);
+                i++;
+                break;
 
-        // Handle operators
-        if (*p == '+' || *p == '-' || *p == '*' || *p == '/') {
-            char op[2] = {*p, '\0'}; // Convert char to string
-            add_token(tokens, &token_count, TOKEN_OPERATOR, op, line, column++);
-            continue;
-        }
+            case CHAR_EQUALS:
+                if (i + 1 < length && input[i + 1] == '=') { // Check for ==
+                    add_token(ctx, stream, TOKEN_OPERATOR, i, 2, SYMBOL_NONE, line, column);
+                    column += 2;
+                    i += 2;
+                } else { // Single '='
+                    add_token(ctx, stream, TOKEN_ASSIGN, i, 1, SYMBOL_NONE, line, column++);
+                    i++;
+                }
+                break;
 
-        // Handle assignment operator
-        if (*p == '=') {
-            if (*(p + 1) == '=') { // Check for ==
-                add_token(tokens, &token_count, TOKEN_OPERATOR, "==", line, column);
-                p++; // Skip the second '='
-                column += 2;
-            } else { // Single '='
-                add_token(tokens, &token_count, TOKEN_ASSIGN, "=", line, column++);
-            }
-            continue;
-        }
+            case CHAR_LPAREN:
+                add_token(ctx, stream, TOKEN_LPAREN, i, 1, SYMBOL_NONE, line, column++);
+                i++;
+                break;
 
-        // Handle parentheses
-        if (*p == '(') {
-            add_token(tokens, &token_count, TOKEN_LPAREN, "(", line, column++);
-            continue;
-        }
-        if (*p == ')') {
-            add_token(tokens, &token_count, TOKEN_RPAREN, ")", line, column++);
-            continue;
+            case CHAR_RPAREN:
+                add_token(ctx, stream, TOKEN_RPAREN, i, 1, SYMBOL_NONE, line, column++);
+                i++;
+                break;
+
+            default:
+                // Handle unexpected characters
+                compile_error(ctx, STAGE_LEXER, line, column, "Unexpected character '%c'", c);
         }
+    }
 
-        // Handle unexpected characters
-        fprintf(stderr, "Error: Unexpected character '%c' at line %d, column %d.\n", *p, line, column);
-        exit(1);
+    while (pending.done < pending.added) {
+        look_up_oldest(ctx, stream, &pending);
     }
 
     // Add the EOF token to mark the end of input
-    add_token(tokens, &token_count, TOKEN_EOF, "EOF", line, column);
+    add_token(ctx, stream, TOKEN_EOF, length, 0, SYMBOL_NONE, line, column);
+    STATS_COUNT(ctx, source_bytes, length);
+    STATS_COUNT(ctx, tokens, stream->count);
+    PHASE_END(ctx, PHASE_LEX, &timer);
+
+    return stream; // Return the token stream
+}
+
+// Tokenize a NUL-terminated string
+TokenStream* tokenize(CompilerContext* ctx, const char* input) {
+    return tokenize_buffer(ctx, input, strlen(input));
+}
 
-    return tokens; // Return the array of tokens
+// Arena cleanup releasing a source mapping
+static void unmap_source(void* file) {
+    unmap_file((MappedFile*)file);
 }
 
-// Free the memory allocated for tokens
-void free_tokens(Token* tokens) {
-    for (int i = 0; tokens[i].type != TOKEN_EOF; i++) {
-        free(tokens[i].value); // Free the dynamically allocated value
+// Tokenize a memory-mapped source file
+TokenStream* tokenize_file(CompilerContext* ctx, const char* path) {
+    MappedFile* file = map_file(path);
+    if (!file) {
+        compile_error(ctx, STAGE_LEXER, 0, 0, "Could not read source file '%s'", path);
     }
-    free(tokens); // Free the token array itself
+    arena_add_cleanup(&ctx->arena, unmap_source, file); // Unmapped with the compilation
+    return tokenize_buffer(ctx, file->data, file->size);
 }
@@ -2,42 +2,117 @@
 #define LEXER_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "../utils/context.h"
 
 // Enum to represent different types of tokens
 typedef enum {
     TOKEN_IDENTIFIER,   // Variable names or keywords
-    TOKEN_NUMBER,       // Numeric constants
+    TOKEN_NUMBER,       // Numeric constants, decimal or 0x-prefixed hexadecimal
     TOKEN_OPERATOR,     // Operators (+, -, *, /)
     TOKEN_ASSIGN,       // Assignment operator (=)
     TOKEN_KEYWORD_ASSERT, // "assert" keyword
+    TOKEN_KEYWORD_INPUT,  // "input" keyword
+    TOKEN_KEYWORD_PUBLIC, // "public" keyword
+    TOKEN_KEYWORD_OUTPUT, // "output" keyword
     TOKEN_LPAREN,       // Left parenthesis '('
     TOKEN_RPAREN,       // Right parenthesis ')'
     TOKEN_EOF           // End of file/input
 } TokenType;
 
-// Struct to represent a single token
+// Struct to represent a single token. The token text is not copied; it is
+// a span into the source the token stream was built from. Identifiers are
+// also interned, and numbers parsed into the context's constant pool, so
+// later stages compare both by index.
 typedef struct {
     TokenType type;     // Type of the token
-    char* value;        // Token value as a string (e.g., "x", "42", "+")
+    uint32_t offset;    // Byte offset of the token text in the source
+    uint32_t length;    // Length of the token text in bytes
+    union {
+        Symbol symbol;      // Interned text of an identifier
+        uint32_t constant;  // Value of a number, as an index in ctx->constants
+    };
     int line;           // Line number where the token was found
     int column;         // Column number where the token starts
 } Token;
 
+// A growable array of tokens together with the source they point into.
+// The stream and its tokens live in the compilation's arena.
+typedef struct {
+    Token* tokens;          // Token array, terminated by a TOKEN_EOF
+    size_t count;           // Number of tokens, including the TOKEN_EOF
+    size_t capacity;        // Allocated capacity of the token array
+    const char* source;     // Source text the token spans refer to
+    size_t source_length;   // Length of the source text in bytes
+} TokenStream;
+
+// Byte classifiers the lexer can scan its input with
+typedef enum {
+    LEXER_SCAN_AUTO,    // The fastest the CPU supports (the default)
+    LEXER_SCAN_SCALAR,  // One byte at a time, through a table
+    LEXER_SCAN_SSE2,    // 16 bytes at a time
+    LEXER_SCAN_AVX2     // 32 bytes at a time
+} LexerScan;
+
 // Function prototypes
 
 /**
  * Tokenizes the given input string.
  * 
- * @param input The input string to tokenize.
- * @return A dynamically allocated array of tokens, terminated by a TOKEN_EOF.
+ * @param ctx The compilation context to allocate from.
+ * @param input The NUL-terminated input string to tokenize. It must outlive
+ *              the returned stream.
+ * @return A token stream terminated by a TOKEN_EOF.
+ */
+TokenStream* tokenize(CompilerContext* ctx, const char* input);
+
+/**
+ * Tokenizes a buffer of the given length. The buffer need not be
+ * NUL-terminated and must outlive the returned stream.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param input The input buffer to tokenize.
+ * @param length Length of the input in bytes.
+ * @return A token stream terminated by a TOKEN_EOF.
+ */
+TokenStream* tokenize_buffer(CompilerContext* ctx, const char* input, size_t length);
+
+/**
+ * Memory-maps a source file and tokenizes it in place. The mapping is
+ * released when the context is reset or freed.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param path Path of the source file.
+ * @return A token stream terminated by a TOKEN_EOF.
+ */
+TokenStream* tokenize_file(CompilerContext* ctx, const char* path);
+
+/**
+ * Chooses how the lexer classifies its input; every choice produces the
+ * same tokens. The choice is process-wide, so make it before tokenizing
+ * on other threads. Meant for tests and benchmarks.
+ * 
+ * @param scan The classifier to use.
+ * @return 1 if it is in use, or 0 if the CPU does not support it.
+ */
+int lexer_use_scan(LexerScan scan);
+
+/**
+ * Returns the name of the classifier in use: "scalar", "sse2" or "avx2".
  */
-Token* tokenize(const char* input);
+const char* lexer_scan_name(void);
 
 /**
- * Frees a dynamically allocated array of tokens.
+ * Returns a pointer to the text of a token inside the stream's source.
+ * The text is token->length bytes long and is not NUL-terminated.
  * 
- * @param tokens The array of tokens to free.
+ * @param stream The stream the token belongs to.
+ * @param token The token.
+ * @return Pointer to the first byte of the token text.
  */
-void free_tokens(Token* tokens);
+static inline const char* token_text(const TokenStream* stream, const Token* token) {
+    return stream->source + token->offset;
+}
 
 #endif // LEXER_H
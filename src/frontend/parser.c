@@ -3,150 +3,288 @@
 #include <stdlib.h>
 #include <string.h>
 
+// Parser state: the token stream, the current position in it, the AST
+// being built and the explicit stacks used to parse expressions without
+// recursion. The stacks are reused across expressions and only ever grow.
+typedef struct {
+    CompilerContext* ctx;       // Compilation the AST is allocated in
+    const TokenStream* stream;  // Tokens being parsed
+    const Token* current;       // Next token to consume
+    AST* ast;                   // Nodes built so far
+    NodeId* operands;           // Operand stack
+    size_t operand_count;
+    size_t operand_capacity;
+    const Token** operators;    // Operator stack; '(' tokens mark groups
+    size_t operator_count;
+    size_t operator_capacity;
+} Parser;
+
 // Forward declaration of helper functions
-static ASTNode* parse_statement(Token** current);
-static ASTNode* parse_expression(Token** current);
-static ASTNode* parse_term(Token** current);
-static ASTNode* parse_factor(Token** current);
-
-// Helper to create an AST node
-ASTNode* create_ast_node(ASTNodeType type, const char* value, ASTNode* left, ASTNode* right) {
-    ASTNode* node = (ASTNode*)malloc(sizeof(ASTNode));
-    if (!node) {
-        fprintf(stderr, "Error: Memory allocation failed for AST node.\n");
-        exit(1);
+static void parse_statement(Parser* parser);
+static void parse_expression(Parser* parser);
+
+// Binding strength of a binary operator token: '==' binds loosest, then
+// '+'/'-', then '*'/'/'. All operators are left-associative.
+static int precedence(const Parser* parser, const Token* token) {
+    if (token->type != TOKEN_OPERATOR) return 0;
+    switch (token_text(parser->stream, token)[0]) {
+        case '=': return 1;
+        case '+': case '-': return 2;
+        case '*': case '/': return 3;
+        default: return 0;
     }
-    node->type = type;
-    node->value = value ? strdup(value) : NULL;
-    node->left = left;
-    node->right = right;
-    return node;
 }
 
-// Frees an AST recursively
-void free_ast(ASTNode* node) {
-    if (!node) return;
-    free_ast(node->left);
-    free_ast(node->right);
-    if (node->value) free(node->value);
-    free(node);
+// Helper to map an operator token to its AST operator
+static ASTOperator operator_of(const Parser* parser, const Token* token) {
+    switch (token_text(parser->stream, token)[0]) {
+        case '+': return AST_OP_ADD;
+        case '-': return AST_OP_SUB;
+        case '*': return AST_OP_MUL;
+        case '/': return AST_OP_DIV;
+        case '=': return AST_OP_EQ;
+        default:
+            compile_error(parser->ctx, STAGE_PARSER, token->line, token->column, "Unsupported binary operator '%.*s'",
+                          (int)token->length, token_text(parser->stream, token));
+    }
+}
+
+// Helper to grow an arena-allocated array to twice its capacity
+static void* grow_array(CompilerContext* ctx, void* array, size_t count, size_t* capacity, size_t element) {
+    void* grown = arena_alloc(&ctx->arena, element * *capacity * 2);
+    memcpy(grown, array, element * count);
+    *capacity *= 2;
+    return grown;
+}
+
+// Helper to push an operand onto the operand stack
+static inline void push_operand(Parser* parser, NodeId node) {
+    if (parser->operand_count == parser->operand_capacity) {
+        parser->operands = grow_array(parser->ctx, parser->operands, parser->operand_count,
+                                      &parser->operand_capacity, sizeof(NodeId));
+    }
+    parser->operands[parser->operand_count++] = node;
+}
+
+// Helper to push an operator or '(' onto the operator stack
+static inline void push_operator(Parser* parser, const Token* token) {
+    if (parser->operator_count == parser->operator_capacity) {
+        parser->operators = grow_array(parser->ctx, parser->operators, parser->operator_count,
+                                       &parser->operator_capacity, sizeof(const Token*));
+    }
+    parser->operators[parser->operator_count++] = token;
+}
+
+// Helper to add a node built from the given token
+static inline NodeId add_node(Parser* parser, ASTNodeType kind, ASTOperator op, uint32_t value, const Token* origin,
+                              NodeId left) {
+    return ast_add_node(parser->ctx, parser->ast, kind, op, value, (uint32_t)(origin - parser->stream->tokens), left);
+}
+
+// Helper to pop the top operator and combine the top two operands with it.
+// The right operand is always the newest node, so only the left one is
+// recorded.
+static void reduce(Parser* parser) {
+    const Token* operator = parser->operators[--parser->operator_count];
+    parser->operand_count--; // The right operand
+    NodeId left = parser->operands[--parser->operand_count];
+    push_operand(parser, add_node(parser, AST_BINARY_OP, operator_of(parser, operator), SYMBOL_NONE, operator, left));
+}
+
+// Helper to report a token that cannot appear where it is
+static void unexpected_token(const Parser* parser, const Token* token) __attribute__((noreturn));
+static void unexpected_token(const Parser* parser, const Token* token) {
+    if (token->type == TOKEN_EOF) {
+        compile_error(parser->ctx, STAGE_PARSER, token->line, token->column, "Unexpected end of input");
+    }
+    compile_error(parser->ctx, STAGE_PARSER, token->line, token->column, "Unexpected token '%.*s'",
+                  (int)token->length, token_text(parser->stream, token));
+}
+
+// Allocate an empty AST with room for capacity nodes
+AST* ast_create(CompilerContext* ctx, const Token* tokens, uint32_t capacity) {
+    AST* ast = (AST*)arena_calloc(&ctx->arena, 1, sizeof(AST));
+    ast->capacity = capacity ? capacity : 1;
+    ast->kinds = (uint8_t*)arena_alloc(&ctx->arena, sizeof(uint8_t) * ast->capacity);
+    ast->ops = (uint8_t*)arena_alloc(&ctx->arena, sizeof(uint8_t) * ast->capacity);
+    ast->left = (NodeId*)arena_alloc(&ctx->arena, sizeof(NodeId) * ast->capacity);
+    ast->values = (Symbol*)arena_alloc(&ctx->arena, sizeof(Symbol) * ast->capacity);
+    ast->origins = (uint32_t*)arena_alloc(&ctx->arena, sizeof(uint32_t) * ast->capacity);
+    ast->statement_capacity = ast->capacity / 2 + 1;
+    ast->statements = (NodeId*)arena_alloc(&ctx->arena, sizeof(NodeId) * ast->statement_capacity);
+    ast->tokens = tokens;
+    return ast;
+}
+
+// Helper to double the node arrays of an AST
+static void grow_nodes(CompilerContext* ctx, AST* ast) {
+    if (ast->capacity >= AST_NO_NODE / 2) {
+        compile_error(ctx, STAGE_PARSER, 0, 0, "Program exceeds the AST node limit");
+    }
+    size_t capacity = ast->capacity;
+    ast->kinds = grow_array(ctx, ast->kinds, ast->count, &capacity, sizeof(uint8_t));
+    capacity = ast->capacity;
+    ast->ops = grow_array(ctx, ast->ops, ast->count, &capacity, sizeof(uint8_t));
+    capacity = ast->capacity;
+    ast->left = grow_array(ctx, ast->left, ast->count, &capacity, sizeof(NodeId));
+    capacity = ast->capacity;
+    ast->values = grow_array(ctx, ast->values, ast->count, &capacity, sizeof(uint32_t));
+    capacity = ast->capacity;
+    ast->origins = grow_array(ctx, ast->origins, ast->count, &capacity, sizeof(uint32_t));
+    ast->capacity = (uint32_t)capacity;
+}
+
+// Append a node, and statements to the statement list as well
+NodeId ast_add_node(CompilerContext* ctx, AST* ast, ASTNodeType kind, ASTOperator op, uint32_t value, uint32_t origin,
+                    NodeId left) {
+    if (ast->count == ast->capacity) grow_nodes(ctx, ast);
+    NodeId node = ast->count++;
+    ast->kinds[node] = (uint8_t)kind;
+    ast->ops[node] = (uint8_t)op;
+    ast->left[node] = left;
+    ast->values[node] = value;
+    ast->origins[node] = origin;
+    if (kind != AST_BINARY_OP && kind != AST_LITERAL && kind != AST_VARIABLE) {
+        if (ast->statement_count == ast->statement_capacity) {
+            size_t capacity = ast->statement_capacity;
+            ast->statements = grow_array(ctx, ast->statements, ast->statement_count, &capacity, sizeof(NodeId));
+            ast->statement_capacity = (uint32_t)capacity;
+        }
+        ast->statements[ast->statement_count++] = node;
+    }
+    return node;
 }
 
 // Main parser function
-ASTNode* parse_tokens(Token* tokens) {
-    Token* current = tokens; // Pointer to the current token
-    ASTNode* root = create_ast_node(AST_PROGRAM, NULL, NULL, NULL); // Root program node
-    ASTNode** program_body = &(root->left); // Link the body of the program
+AST* parse_tokens(CompilerContext* ctx, const TokenStream* stream) {
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    Parser parser = {ctx, stream, stream->tokens}; // Start at the first token
+
+    // Every node is built from a different token, and every statement
+    // takes at least two, so sizing by the tokens means the AST never grows
+    parser.ast = ast_create(ctx, stream->tokens, (uint32_t)stream->count);
+    parser.operand_capacity = 64;
+    parser.operands = (NodeId*)arena_alloc(&ctx->arena, sizeof(NodeId) * parser.operand_capacity);
+    parser.operator_capacity = 64;
+    parser.operators = (const Token**)arena_alloc(&ctx->arena, sizeof(const Token*) * parser.operator_capacity);
 
     // Parse each statement in sequence
-    while (current->type != TOKEN_EOF) {
-        ASTNode* statement = parse_statement(&current);
-        if (!*program_body) {
-            *program_body = statement; // First statement
-        } else {
-            // Append to the end of the program body (linked list)
-            ASTNode* temp = *program_body;
-            while (temp->right) temp = temp->right;
-            temp->right = statement;
-        }
+    while (parser.current->type != TOKEN_EOF) {
+        parse_statement(&parser);
     }
+    STATS_COUNT(ctx, ast_nodes, parser.ast->count);
+    PHASE_END(ctx, PHASE_PARSE, &timer);
 
-    return root;
+    return parser.ast;
 }
 
-// Parse a single statement
-static ASTNode* parse_statement(Token** current) {
-    Token* token = *current;
+// Parse a single statement, after its expression if it has one
+static void parse_statement(Parser* parser) {
+    const Token* token = parser->current;
 
     if (token->type == TOKEN_IDENTIFIER) {
         // Assignment statement: identifier = expression
-        Token* identifier = token;
-        (*current)++; // Consume identifier
-        if ((*current)->type != TOKEN_ASSIGN) {
-            fprintf(stderr, "Error: Expected '=' after variable '%s'.\n", identifier->value);
-            exit(1);
+        const Token* identifier = token;
+        parser->current++; // Consume identifier
+        if (parser->current->type != TOKEN_ASSIGN) {
+            compile_error(parser->ctx, STAGE_PARSER, parser->current->line, parser->current->column,
+                          "Expected '=' after variable '%.*s'", (int)identifier->length,
+                          token_text(parser->stream, identifier));
         }
-        (*current)++; // Consume '='
-        ASTNode* expression = parse_expression(current);
-        return create_ast_node(AST_ASSIGNMENT, identifier->value, expression, NULL);
+        parser->current++; // Consume '='
+        parse_expression(parser);
+        add_node(parser, AST_ASSIGNMENT, AST_OP_NONE, identifier->symbol, identifier, AST_NO_NODE);
+        return;
     } else if (token->type == TOKEN_KEYWORD_ASSERT) {
         // Assertion statement: assert(expression)
-        (*current)++; // Consume 'assert'
-        if ((*current)->type != TOKEN_LPAREN) {
-            fprintf(stderr, "Error: Expected '(' after 'assert'.\n");
-            exit(1);
+        parser->current++; // Consume 'assert'
+        if (parser->current->type != TOKEN_LPAREN) {
+            compile_error(parser->ctx, STAGE_PARSER, parser->current->line, parser->current->column,
+                          "Expected '(' after 'assert'");
         }
-        (*current)++; // Consume '('
-        ASTNode* expression = parse_expression(current);
-        if ((*current)->type != TOKEN_RPAREN) {
-            fprintf(stderr, "Error: Expected ')' after assertion expression.\n");
-            exit(1);
+        parser->current++; // Consume '('
+        parse_expression(parser);
+        if (parser->current->type != TOKEN_RPAREN) {
+            compile_error(parser->ctx, STAGE_PARSER, parser->current->line, parser->current->column,
+                          "Expected ')' after assertion expression");
         }
-        (*current)++; // Consume ')'
-        return create_ast_node(AST_ASSERTION, NULL, expression, NULL);
+        parser->current++; // Consume ')'
+        add_node(parser, AST_ASSERTION, AST_OP_NONE, SYMBOL_NONE, token, AST_NO_NODE);
+        return;
+    } else if (token->type == TOKEN_KEYWORD_INPUT || token->type == TOKEN_KEYWORD_PUBLIC ||
+               token->type == TOKEN_KEYWORD_OUTPUT) {
+        // Declaration: input identifier | public identifier | output identifier
+        parser->current++; // Consume 'input', 'public' or 'output'
+        const Token* identifier = parser->current;
+        if (identifier->type != TOKEN_IDENTIFIER) {
+            compile_error(parser->ctx, STAGE_PARSER, identifier->line, identifier->column,
+                          "Expected variable name after '%.*s'", (int)token->length, token_text(parser->stream, token));
+        }
+        parser->current++; // Consume identifier
+        ASTNodeType type = token->type == TOKEN_KEYWORD_INPUT ? AST_INPUT :
+                           token->type == TOKEN_KEYWORD_PUBLIC ? AST_PUBLIC_INPUT : AST_OUTPUT;
+        add_node(parser, type, AST_OP_NONE, identifier->symbol, identifier, AST_NO_NODE);
+        return;
     }
 
-    fprintf(stderr, "Error: Unexpected token '%s' at line %d, column %d.\n",
-            token->value, token->line, token->column);
-    exit(1);
+    unexpected_token(parser, token);
 }
 
-// Parse an expression (e.g., addition or subtraction)
-static ASTNode* parse_expression(Token** current) {
-    // Parse the left-hand side term
-    ASTNode* left = parse_term(current);
-
-    // Look for operators and parse the right-hand side
-    while ((*current)->type == TOKEN_OPERATOR &&
-           (strcmp((*current)->value, "+") == 0 || strcmp((*current)->value, "-") == 0 ||
-            strcmp((*current)->value, "==") == 0)) { // Include "=="
-        Token* operator = *current;
-        (*current)++; // Consume operator
-        ASTNode* right = parse_term(current);
-        left = create_ast_node(AST_BINARY_OP, operator->value, left, right);
-    }
-
-    return left;
-}
+// Parse an expression by precedence climbing over explicit operand and
+// operator stacks, so nesting depth is bounded by memory, not the C stack.
+// The expression's root is the last node added.
+static void parse_expression(Parser* parser) {
+    size_t operand_base = parser->operand_count;
+    size_t operator_base = parser->operator_count;
+    size_t open_groups = 0; // Parentheses opened inside this expression
 
-// Parse a term (e.g., multiplication or division)
-static ASTNode* parse_term(Token** current) {
-    ASTNode* left = parse_factor(current);
+    for (;;) {
+        // Expect an operand, possibly preceded by opening parentheses
+        const Token* token = parser->current;
+        if (token->type == TOKEN_LPAREN) {
+            push_operator(parser, token);
+            open_groups++;
+            parser->current++; // Consume '('
+            continue;
+        } else if (token->type == TOKEN_NUMBER) {
+            push_operand(parser, add_node(parser, AST_LITERAL, AST_OP_NONE, token->constant, token, AST_NO_NODE));
+        } else if (token->type == TOKEN_IDENTIFIER) {
+            push_operand(parser, add_node(parser, AST_VARIABLE, AST_OP_NONE, token->symbol, token, AST_NO_NODE));
+        } else {
+            unexpected_token(parser, token);
+        }
+        parser->current++; // Consume number or identifier
 
-    while ((*current)->type == TOKEN_OPERATOR && ((*current)->value[0] == '*' || (*current)->value[0] == '/')) {
-        Token* operator = *current;
-        (*current)++; // Consume operator
-        ASTNode* right = parse_factor(current);
-        left = create_ast_node(AST_BINARY_OP, operator->value, left, right);
-    }
+        // Close any groups that end here
+        while (open_groups > 0 && parser->current->type == TOKEN_RPAREN) {
+            while (parser->operators[parser->operator_count - 1]->type != TOKEN_LPAREN) {
+                reduce(parser);
+            }
+            parser->operator_count--; // Pop '('
+            open_groups--;
+            parser->current++; // Consume ')'
+        }
 
-    return left;
-}
-
-// Parse a factor (e.g., literals, variables, or parenthesized expressions)
-static ASTNode* parse_factor(Token** current) {
-    Token* token = *current;
-
-    if (token->type == TOKEN_NUMBER) {
-        (*current)++; // Consume number
-        return create_ast_node(AST_LITERAL, token->value, NULL, NULL);
-    } else if (token->type == TOKEN_IDENTIFIER) {
-        (*current)++; // Consume identifier
-        return create_ast_node(AST_VARIABLE, token->value, NULL, NULL);
-    } else if (token->type == TOKEN_LPAREN) {
-        (*current)++; // Consume '('
-        ASTNode* expression = parse_expression(current);
-        if ((*current)->type != TOKEN_RPAREN) {
-            fprintf(stderr, "Error: Expected ')' after expression.\n");
-            exit(1);
+        // Expect a binary operator, or the end of the expression
+        int prec = precedence(parser, parser->current);
+        if (prec == 0) break;
+        while (parser->operator_count > operator_base &&
+               precedence(parser, parser->operators[parser->operator_count - 1]) >= prec) {
+            reduce(parser);
         }
-        (*current)++; // Consume ')'
-        return expression;
+        push_operator(parser, parser->current);
+        parser->current++; // Consume operator
     }
 
-    fprintf(stderr, "Error: Unexpected token '%s' at line %d, column %d.\n",
-            token->value, token->line, token->column);
-    exit(1);
+    if (open_groups > 0) {
+        compile_error(parser->ctx, STAGE_PARSER, parser->current->line, parser->current->column,
+                      "Expected ')' after expression");
+    }
+    while (parser->operator_count > operator_base) {
+        reduce(parser);
+    }
+    parser->operand_count = operand_base;
 }
 
 // Helper function to print indentation
@@ -156,17 +294,56 @@ static void print_indent(int indent) {
     }
 }
 
-// Print the AST (recursive function)
-void print_ast(const ASTNode* node, int indent) {
-    if (!node) return;
+// Print each statement's nodes in pre-order: each node, then its left and
+// right operands one level deeper
+void print_ast(const CompilerContext* ctx, const AST* ast, int indent) {
+    static const char* const operators[] = {"NULL", "+", "-", "*", "/", "=="};
+    if (!ast) return;
 
-    print_indent(indent);
-    printf("Node Type: %d, Value: %s\n", node->type, node->value ? node->value : "NULL");
+    size_t capacity = 64, count = 0;
+    struct { NodeId node; int indent; }* stack = malloc(sizeof(*stack) * capacity);
+    if (!stack) {
+        fprintf(stderr, "Error: Memory allocation failed for AST traversal.\n");
+        exit(1);
+    }
 
-    // Print child nodes
-    print_ast(node->left, indent + 1);
-    print_ast(node->right, indent + 1);
+    for (uint32_t s = 0; s < ast->statement_count; s++) {
+        stack[count].node = ast->statements[s];
+        stack[count++].indent = indent;
 
-    // Print next statement (if any)
-    print_ast(node->next, indent);
-}
\ No newline at end of file
+        while (count > 0) {
+            NodeId node = stack[--count].node;
+            int depth = stack[count].indent;
+            ASTNodeType kind = ast_kind(ast, node);
+
+            char literal[96];
+            print_indent(depth);
+            printf("Node Type: %d, Value: %s\n", kind,
+                   kind == AST_BINARY_OP ? operators[ast->ops[node]]
+                   : kind == AST_LITERAL ? field_to_string(ctx->field, field_pool_get(&ctx->constants, ast->values[node]),
+                                                           literal, sizeof(literal))
+                   : ast->values[node] ? symbol_text(&ctx->symbols, ast->values[node]) : "NULL");
+
+            if (count + 2 > capacity) {
+                capacity *= 2;
+                void* grown = realloc(stack, sizeof(*stack) * capacity);
+                if (!grown) {
+                    fprintf(stderr, "Error: Memory allocation failed for AST traversal.\n");
+                    exit(1);
+                }
+                stack = grown;
+            }
+
+            // Push in reverse so the left operand is printed first
+            if (kind == AST_BINARY_OP || kind == AST_ASSIGNMENT || kind == AST_ASSERTION) {
+                stack[count].node = ast_right(ast, node);
+                stack[count++].indent = depth + 1;
+            }
+            if (kind == AST_BINARY_OP) {
+                stack[count].node = ast->left[node];
+                stack[count++].indent = depth + 1;
+            }
+        }
+    }
+    free(stack);
+}
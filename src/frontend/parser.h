@@ -5,47 +5,119 @@
 
 // Enum for different AST node types
 typedef enum {
-    AST_PROGRAM,      // Root node for the program
     AST_ASSIGNMENT,   // Assignment statement (e.g., x = 3 + 5)
     AST_ASSERTION,    // Assertion (e.g., assert(x == 8))
-    AST_BINARY_OP,    // Binary operations (+, -, *, /)
-    AST_LITERAL,      // Numeric or identifier literal
-    AST_VARIABLE      // Variable reference
+    AST_BINARY_OP,    // Binary operations (+, -, *, /, ==)
+    AST_LITERAL,      // Numeric literal
+    AST_VARIABLE,     // Variable reference
+    AST_INPUT,        // Private input declaration (e.g., input x)
+    AST_PUBLIC_INPUT, // Public input declaration (e.g., public x)
+    AST_OUTPUT        // Public output declaration (e.g., output y)
 } ASTNodeType;
 
-// Struct for an AST node
-typedef struct ASTNode {
-    ASTNodeType type;       // Type of the node
-    char* value;            // Literal value or variable name
-    struct ASTNode* left;   // Left child (e.g., LHS of an expression)
-    struct ASTNode* right;  // Right child (e.g., RHS of an expression)
-    struct ASTNode* next;   // Next statement in the sequence
-} ASTNode;
+// Operator of an AST_BINARY_OP node
+typedef enum {
+    AST_OP_NONE,      // Not a binary operation
+    AST_OP_ADD,       // +
+    AST_OP_SUB,       // -
+    AST_OP_MUL,       // *
+    AST_OP_DIV,       // /
+    AST_OP_EQ         // ==
+} ASTOperator;
+
+// Index of a node in an AST
+typedef uint32_t NodeId;
+
+#define AST_NO_NODE 0xFFFFFFFFu   // Absent child, or a node built from no token
+
+// An Abstract Syntax Tree stored as parallel arrays indexed by NodeId, in
+// the compilation's arena. Nodes are in post-order: every node follows its
+// operands, and each statement follows its expression, so walking the
+// arrays front to back visits the program in evaluation order. A binary
+// operation's right operand, and a statement's expression, is the node
+// just before it; only left operands are stored.
+typedef struct {
+    uint8_t* kinds;         // ASTNodeType of each node
+    uint8_t* ops;           // ASTOperator of each node
+    NodeId* left;           // Left operand of binary operations, else AST_NO_NODE
+    uint32_t* values;       // Variable name (a Symbol), literal (an index in ctx->constants), or SYMBOL_NONE
+    uint32_t* origins;      // Index in tokens of the token each node was built from
+    uint32_t count;         // Number of nodes
+    uint32_t capacity;      // Allocated nodes
+    NodeId* statements;     // Statement nodes in program order
+    uint32_t statement_count;
+    uint32_t statement_capacity;
+    const Token* tokens;    // Tokens the origins refer to, or NULL
+} AST;
+
+// Helpers for reading nodes
+static inline ASTNodeType ast_kind(const AST* ast, NodeId node) {
+    return (ASTNodeType)ast->kinds[node];
+}
+static inline NodeId ast_right(const AST* ast, NodeId node) {
+    (void)ast;
+    return node - 1;
+}
+static inline int ast_line(const AST* ast, NodeId node) {
+    return ast->tokens && ast->origins[node] != AST_NO_NODE ? ast->tokens[ast->origins[node]].line : 0;
+}
+static inline int ast_column(const AST* ast, NodeId node) {
+    return ast->tokens && ast->origins[node] != AST_NO_NODE ? ast->tokens[ast->origins[node]].column : 0;
+}
+
+// First node of statement index (statement ast->statements[index]): its
+// nodes are the ones from there up to the statement node itself
+static inline NodeId ast_statement_start(const AST* ast, uint32_t index) {
+    return index ? ast->statements[index - 1] + 1 : 0;
+}
 
 // Function prototypes
 
 /**
- * Parses an array of tokens and constructs an Abstract Syntax Tree.
+ * Allocates an empty AST in the compilation's arena.
  * 
- * @param tokens Array of tokens from the lexer.
- * @return Pointer to the root of the constructed AST.
+ * @param ctx The compilation context to allocate from.
+ * @param tokens Tokens the nodes' origins refer to, or NULL.
+ * @param capacity Number of nodes to make room for; the AST grows past it
+ *                 as needed.
+ * @return The AST.
  */
-ASTNode* parse_tokens(Token* tokens);
+AST* ast_create(CompilerContext* ctx, const Token* tokens, uint32_t capacity);
 
 /**
- * Frees an Abstract Syntax Tree.
+ * Appends a node. Nodes must be added in post-order: a binary operation's
+ * right operand, and a statement's expression, must be the last node added
+ * before it. Statement nodes are also appended to the statement list.
  * 
- * @param node The root node of the AST to free.
+ * @param ctx The compilation context to allocate from.
+ * @param ast The AST.
+ * @param kind The node type.
+ * @param op The operator of a binary operation, otherwise AST_OP_NONE.
+ * @param value Variable name, literal's index in ctx->constants, or SYMBOL_NONE.
+ * @param origin Index of the token whose position the node takes, or AST_NO_NODE.
+ * @param left Left operand of a binary operation, otherwise AST_NO_NODE.
+ * @return The new node.
  */
-void free_ast(ASTNode* node);
+NodeId ast_add_node(CompilerContext* ctx, AST* ast, ASTNodeType kind, ASTOperator op, uint32_t value, uint32_t origin,
+                    NodeId left);
 
+/**
+ * Parses an array of tokens and constructs an Abstract Syntax Tree.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param stream Token stream from the lexer. Its tokens must outlive the AST.
+ * @return The constructed AST.
+ */
+AST* parse_tokens(CompilerContext* ctx, const TokenStream* stream);
 
 /**
- * Prints the ast.
+ * Prints the AST, statement by statement, each node followed by its
+ * operands one level deeper.
  * 
- * @param node The root node of the AST to print 
+ * @param ctx The compilation context the AST belongs to.
+ * @param ast The AST to print.
  * @param indent The number of indentations.
  */
-void print_ast(const ASTNode* node, int indent);
+void print_ast(const CompilerContext* ctx, const AST* ast, int indent);
 
 #endif // PARSER_H
@@ -4,98 +4,180 @@
 #include <stdbool.h>
 #include <string.h>
 
-// Simple symbol table for tracking variable declarations
+// A variable definition
+typedef struct {
+    Symbol name;        // Interned variable name
+    int line;           // Position of the defining assignment
+    int column;
+} SymbolEntry;
+
+// Hash table slot: maps a name to its definition
+typedef struct {
+    Symbol key;         // SYMBOL_NONE marks an empty slot
+    uint32_t entry;     // 1-based index into entries
+} SymbolSlot;
+
+// Symbol table: an open-addressing hash table keyed by interned names over
+// the definitions in program order. Programs have a single scope.
 typedef struct SymbolTable {
-    char** symbols; // Array of variable names
-    int count;      // Number of variables
-    int capacity;   // Capacity of the array
+    CompilerContext* ctx;   // Compilation the table is allocated in
+    SymbolSlot* slots;      // Hash table, linear probing
+    uint32_t slot_bits;     // log2 of the number of slots
+    uint32_t used_slots;    // Slots holding a key
+    SymbolEntry* entries;   // Definitions in program order
+    uint32_t count;         // Number of definitions
+    uint32_t capacity;      // Capacity of the entries array
 } SymbolTable;
 
-// Initializes a symbol table
-SymbolTable* create_symbol_table() {
-    SymbolTable* table = (SymbolTable*)malloc(sizeof(SymbolTable));
+// Helper to hash a symbol into the slot table (Fibonacci hashing)
+static inline uint32_t slot_index(const SymbolTable* table, Symbol name) {
+    return (uint32_t)(name * 2654435769u) >> (32 - table->slot_bits);
+}
+
+// Initializes a symbol table sized for the expected number of names
+static SymbolTable* create_symbol_table(CompilerContext* ctx, uint32_t expected) {
+    SymbolTable* table = (SymbolTable*)arena_alloc(&ctx->arena, sizeof(SymbolTable));
+    table->ctx = ctx;
+    table->slot_bits = 4;
+    while ((1u << table->slot_bits) < expected * 2) table->slot_bits++;
+    table->slots = (SymbolSlot*)arena_calloc(&ctx->arena, 1u << table->slot_bits, sizeof(SymbolSlot));
+    table->used_slots = 0;
+    table->capacity = expected > 16 ? expected : 16;
+    table->entries = (SymbolEntry*)arena_alloc(&ctx->arena, sizeof(SymbolEntry) * table->capacity);
     table->count = 0;
-    table->capacity = 16;
-    table->symbols = (char**)malloc(sizeof(char*) * table->capacity);
     return table;
 }
 
-// Frees a symbol table
-void free_symbol_table(SymbolTable* table) {
-    for (int i = 0; i < table->count; i++) {
-        free(table->symbols[i]);
+// Helper to find the slot for a name, or the empty slot where it belongs
+static SymbolSlot* find_slot(const SymbolTable* table, Symbol name) {
+    uint32_t mask = (1u << table->slot_bits) - 1;
+    uint32_t i = slot_index(table, name);
+    while (table->slots[i].key != SYMBOL_NONE && table->slots[i].key != name) {
+        i = (i + 1) & mask;
     }
-    free(table->symbols);
-    free(table);
+    return &table->slots[i];
 }
 
-// Adds a variable to the symbol table
-void add_symbol(SymbolTable* table, const char* name) {
-    if (table->count >= table->capacity) {
-        table->capacity *= 2;
-        table->symbols = (char**)realloc(table->symbols, sizeof(char*) * table->capacity);
+// Helper to double the slot table once it is half full
+static void grow_slots(SymbolTable* table) {
+    SymbolSlot* old = table->slots;
+    uint32_t old_count = 1u << table->slot_bits;
+    table->slot_bits++;
+    table->slots = (SymbolSlot*)arena_calloc(&table->ctx->arena, 1u << table->slot_bits, sizeof(SymbolSlot));
+    for (uint32_t i = 0; i < old_count; i++) {
+        if (old[i].key != SYMBOL_NONE) {
+            *find_slot(table, old[i].key) = old[i];
+        }
     }
-    table->symbols[table->count++] = strdup(name);
 }
 
-// Checks if a variable exists in the symbol table
-bool has_symbol(const SymbolTable* table, const char* name) {
-    for (int i = 0; i < table->count; i++) {
-        if (strcmp(table->symbols[i], name) == 0) {
-            return true;
-        }
-    }
-    return false;
+// Finds the definition of a variable, or NULL
+static const SymbolEntry* lookup_symbol(const SymbolTable* table, Symbol name) {
+    const SymbolSlot* slot = find_slot(table, name);
+    return slot->entry ? &table->entries[slot->entry - 1] : NULL;
 }
 
-// Recursive AST validation function
-void validate_ast(const ASTNode* node, SymbolTable* table) {
-    if (!node) return;
+// Defines a variable. Returns the existing definition if the name is
+// already defined, otherwise NULL.
+static const SymbolEntry* define_symbol(SymbolTable* table, Symbol name, int line, int column) {
+    SymbolSlot* slot = find_slot(table, name);
+    if (slot->entry) {
+        return &table->entries[slot->entry - 1];
+    }
 
-    switch (node->type) {
-        case AST_ASSIGNMENT:
-            if (!node->value) {
-                fprintf(stderr, "Error: Assignment must have a variable name.\n");
-                exit(1);
-            }
-            validate_ast(node->left, table); // Validate the right-hand side expression
-            add_symbol(table, node->value); // Add the variable to the symbol table
-            break;
+    if (table->count == table->capacity) {
+        SymbolEntry* entries = (SymbolEntry*)arena_alloc(&table->ctx->arena, sizeof(SymbolEntry) * table->capacity * 2);
+        memcpy(entries, table->entries, sizeof(SymbolEntry) * table->count);
+        table->entries = entries;
+        table->capacity *= 2;
+    }
+    SymbolEntry* entry = &table->entries[table->count++];
+    entry->name = name;
+    entry->line = line;
+    entry->column = column;
+    slot->key = name;
+    slot->entry = table->count;
+    table->used_slots++;
 
+    if (table->used_slots * 2 > (1u << table->slot_bits)) {
+        grow_slots(table);
+    }
+    return NULL;
+}
+
+// Helper to report a variable read before any definition
+static void undefined_variable(const SymbolTable* table, const AST* ast, NodeId node) __attribute__((noreturn));
+static void undefined_variable(const SymbolTable* table, const AST* ast, NodeId node) {
+    compile_error(table->ctx, STAGE_VALIDATOR, ast_line(ast, node), ast_column(ast, node), "Undefined variable '%s'",
+                  symbol_text(&table->ctx->symbols, ast->values[node]));
+}
+
+// Validates one node. Nodes are visited in post-order, so the variables an
+// expression reads are checked before its statement defines anything.
+// outputs flags the variables already declared as outputs, by Symbol.
+static void validate_node(const AST* ast, NodeId node, SymbolTable* table, uint8_t* outputs) {
+    Symbol name = ast->values[node];
+    switch (ast_kind(ast, node)) {
+        case AST_BINARY_OP:
+        case AST_LITERAL:
         case AST_ASSERTION:
-            validate_ast(node->left, table); // Validate the assertion expression
+            // Valid once their operands are
             break;
 
-        case AST_BINARY_OP:
-            validate_ast(node->left, table); // Validate left operand
-            validate_ast(node->right, table); // Validate right operand
+        case AST_VARIABLE:
+            if (!lookup_symbol(table, name)) undefined_variable(table, ast, node);
             break;
 
-        case AST_LITERAL:
-            // Literals are always valid
+        case AST_ASSIGNMENT:
+        case AST_INPUT:
+        case AST_PUBLIC_INPUT: {
+            if (!name) {
+                compile_error(table->ctx, STAGE_VALIDATOR, ast_line(ast, node), ast_column(ast, node),
+                              "Assignment must have a variable name");
+            }
+            // Add the variable to the symbol table
+            const SymbolEntry* previous = define_symbol(table, name, ast_line(ast, node), ast_column(ast, node));
+            if (previous) {
+                compile_error(table->ctx, STAGE_VALIDATOR, ast_line(ast, node), ast_column(ast, node),
+                              "Redefinition of variable '%s' (previously defined at line %d, column %d)",
+                              symbol_text(&table->ctx->symbols, name), previous->line, previous->column);
+            }
             break;
+        }
 
-        case AST_VARIABLE:
-            if (!has_symbol(table, node->value)) {
-                fprintf(stderr, "Error: Undefined variable '%s'.\n", node->value);
-                exit(1);
+        case AST_OUTPUT:
+            // Only defined variables can be output, and each only once
+            if (!lookup_symbol(table, name)) undefined_variable(table, ast, node);
+            if (outputs[name]) {
+                compile_error(table->ctx, STAGE_VALIDATOR, ast_line(ast, node), ast_column(ast, node),
+                              "Variable '%s' is already an output", symbol_text(&table->ctx->symbols, name));
             }
+            outputs[name] = 1;
             break;
 
         default:
-            fprintf(stderr, "Error: Unsupported AST node type %d.\n", node->type);
-            exit(1);
+            compile_error(table->ctx, STAGE_VALIDATOR, ast_line(ast, node), ast_column(ast, node),
+                          "Unsupported AST node type %d", ast_kind(ast, node));
     }
 }
 
 // Entry point for validating a program
-void validate_program(const ASTNode* root) {
-    if (!root || root->type != AST_PROGRAM) {
-        fprintf(stderr, "Error: Root node must be of type AST_PROGRAM.\n");
-        exit(1);
+void validate_program(CompilerContext* ctx, const AST* ast) {
+    if (!ast) {
+        compile_error(ctx, STAGE_VALIDATOR, 0, 0, "No AST to validate");
     }
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+
+    // Every variable name has been interned, so the symbol count bounds the
+    // number of distinct names and the table never needs to rehash
+    SymbolTable* table = create_symbol_table(ctx, ctx->symbols.count);
+    uint8_t* outputs = (uint8_t*)arena_calloc(&ctx->arena, ctx->symbols.count, sizeof(uint8_t));
 
-    SymbolTable* table = create_symbol_table();
-    validate_ast(root->left, table); // Validate the program body
-    free_symbol_table(table);
+    // The nodes are in evaluation order, so one pass over them validates
+    // the program statement by statement
+    for (NodeId node = 0; node < ast->count; node++) {
+        validate_node(ast, node, table, outputs);
+    }
+    PHASE_END(ctx, PHASE_VALIDATE, &timer);
 }
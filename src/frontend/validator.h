@@ -1,13 +1,14 @@
 #ifndef VALIDATOR_H
 #define VALIDATOR_H
 
-#include "parser.h" // For ASTNode and related structures
+#include "parser.h" // For AST and related structures
 
 /**
  * Validates the Abstract Syntax Tree (AST).
  * 
- * @param root Pointer to the root of the AST.
+ * @param ctx The compilation context the AST belongs to.
+ * @param ast The AST.
  */
-void validate_program(const ASTNode* root);
+void validate_program(CompilerContext* ctx, const AST* ast);
 
 #endif // VALIDATOR_H
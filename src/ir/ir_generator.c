@@ -3,135 +3,390 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Static counter for generating sequential temporary variable names
-static int temp_var_counter = 0;
-
-// Helper to create a new IR instruction
-IRInstruction* create_ir_instruction(IROpType op, const char* dest, const char* src1, const char* src2) {
-    IRInstruction* instr = (IRInstruction*)malloc(sizeof(IRInstruction));
-    if (!instr) {
-        fprintf(stderr, "Error: Memory allocation failed for IR instruction.\n");
-        exit(1);
+// Helper to grow an arena-allocated array to hold at least one more element
+static void* grow_array(CompilerContext* ctx, void* array, size_t count, size_t* capacity, size_t element) {
+    void* grown = arena_alloc(&ctx->arena, element * *capacity * 2);
+    memcpy(grown, array, element * count);
+    *capacity *= 2;
+    return grown;
+}
+
+// Helper to test whether an operation's operands commute
+static inline int is_commutative(IROpType op) {
+    return op == IR_OP_ADD || op == IR_OP_MUL || op == IR_OP_EQ;
+}
+
+// Helper to hash a computation, independently of operand order for
+// commutative operations
+static inline uint32_t computation_hash(const IRInstruction* instr) {
+    uint64_t a = instr->src1, b = instr->src2;
+    if (is_commutative(instr->op) && a > b) {
+        uint64_t t = a;
+        a = b;
+        b = t;
     }
-    instr->op = op;
-    instr->dest = dest ? strdup(dest) : NULL;
-    instr->src1 = src1 ? strdup(src1) : NULL;
-    instr->src2 = src2 ? strdup(src2) : NULL;
-    instr->next = NULL;
-    return instr;
-}
-
-// Recursive function to generate IR from an AST node
-IRInstruction* generate_ir_from_ast(const ASTNode* node) {
-    if (!node) return NULL;
-
-    switch (node->type) {
-        case AST_PROGRAM: {
-            // Handle the root program node by iterating over child statements
-            IRInstruction* head = NULL;
-            IRInstruction* tail = NULL;
-
-            for (ASTNode* stmt = node->left; stmt != NULL; stmt = stmt->next) {
-                IRInstruction* stmt_ir = generate_ir_from_ast(stmt);
-                if (!head) {
-                    head = stmt_ir;
-                } else {
-                    tail->next = stmt_ir;
-                }
-                // Move to the end of the current IR list
-                while (tail && tail->next) {
-                    tail = tail->next;
-                }
-            }
-            return head;
+    uint64_t x = (a * 0x9E3779B97F4A7C15ull) ^ (b * 0xC2B2AE3D27D4EB4Full) ^ ((uint64_t)instr->op << 56);
+    x ^= x >> 29;
+    x *= 0xBF58476D1CE4E5B9ull;
+    return (uint32_t)(x >> 32);
+}
+
+// Helper to compare two computations
+static inline int same_computation(const IRInstruction* x, const IRInstruction* y) {
+    if (x->op != y->op) return 0;
+    if (x->src1 == y->src1 && x->src2 == y->src2) return 1;
+    return is_commutative(x->op) && x->src1 == y->src2 && x->src2 == y->src1;
+}
+
+// Initialize an empty value table
+void value_table_init(ValueTable* table, Arena* arena) {
+    table->arena = arena;
+    table->count = 0;
+    table->slot_mask = 255;
+    table->slots = (ValueId*)arena_calloc(arena, 256, sizeof(ValueId));
+}
+
+// Find a computation in the table, adding it if absent
+ValueId value_table_find_or_add(ValueTable* table, const IRProgram* program, ValueId value) {
+    const IRInstruction* instr = &program->instrs[value];
+    uint32_t i = computation_hash(instr) & table->slot_mask;
+    while (table->slots[i]) {
+        ValueId other = table->slots[i] - 1;
+        if (same_computation(&program->instrs[other], instr)) return other;
+        i = (i + 1) & table->slot_mask;
+    }
+    table->slots[i] = value + 1;
+
+    // Keep the table at most half full
+    if (++table->count * 2 > table->slot_mask + 1) {
+        uint32_t mask = table->slot_mask * 2 + 1;
+        ValueId* slots = (ValueId*)arena_calloc(table->arena, (size_t)mask + 1, sizeof(ValueId));
+        for (uint32_t k = 0; k <= table->slot_mask; k++) {
+            if (!table->slots[k]) continue;
+            uint32_t j = computation_hash(&program->instrs[table->slots[k] - 1]) & mask;
+            while (slots[j]) j = (j + 1) & mask;
+            slots[j] = table->slots[k];
         }
+        table->slots = slots;
+        table->slot_mask = mask;
+    }
+    return value;
+}
+
+// Add a constant to the pool, deduplicating by value
+ValueId ir_add_constant(CompilerContext* ctx, IRProgram* program, const FieldElement* value) {
+    (void)ctx; // The pool allocates from the arena it was created with
+    return ir_const_operand(field_pool_add(&program->constants, value));
+}
 
-        case AST_ASSIGNMENT: {
-            // Generate IR for the right-hand side expression
-            IRInstruction* rhs = generate_ir_from_ast(node->left);
-            // Create an assignment IR instruction
-            IRInstruction* assign = create_ir_instruction(IR_OP_ASSIGN, node->value, rhs->dest, NULL);
-            assign->next = rhs;
-            return assign;
+// Helper to append an instruction lowered from the given position,
+// returning the value it defines
+static ValueId emit(IRBuilder* builder, IRLocation location, IROpType op, Symbol name, ValueId src1, ValueId src2) {
+    IRProgram* program = builder->program;
+    if (program->count == program->capacity) {
+        size_t capacity = program->capacity;
+        program->instrs = grow_array(builder->ctx, program->instrs, program->count, &capacity, sizeof(IRInstruction));
+        capacity = program->capacity;
+        program->locations = grow_array(builder->ctx, program->locations, program->count, &capacity, sizeof(IRLocation));
+        program->capacity = (uint32_t)capacity;
+    }
+    if (program->count >= IR_CONST_FLAG) {
+        compile_error(builder->ctx, STAGE_IR, location.line, location.column,
+                      "Program exceeds the IR instruction limit");
+    }
+    IRInstruction* instr = &program->instrs[program->count];
+    instr->op = op;
+    instr->name = name;
+    instr->src1 = src1;
+    instr->src2 = src2;
+    program->locations[program->count] = location;
+
+    // Reuse an identical earlier computation rather than emitting it again
+    if (ir_is_pure(instr)) {
+        ValueId existing = value_table_find_or_add(&builder->expressions, program, program->count);
+        if (existing != program->count) {
+            program->hash_consed++;
+            return existing;
         }
+    }
+    return program->count++;
+}
 
-        case AST_BINARY_OP: {
-            // Map binary operator strings to IR operation types
-            IROpType op;
-            if (strcmp(node->value, "+") == 0) op = IR_OP_ADD;
-            else if (strcmp(node->value, "-") == 0) op = IR_OP_SUB;
-            else if (strcmp(node->value, "*") == 0) op = IR_OP_MUL;
-            else if (strcmp(node->value, "/") == 0) op = IR_OP_DIV;
-            else if (strcmp(node->value, "==") == 0) op = IR_OP_EQ;
-            else {
-                fprintf(stderr, "Error: Unsupported binary operator '%s'.\n", node->value);
-                exit(1);
-            }
+// Helper to get the source position of a node
+static inline IRLocation node_location(const AST* ast, NodeId node) {
+    IRLocation location = {ast_line(ast, node), ast_column(ast, node)};
+    return location;
+}
 
-            // Generate IR for left and right operands
-            IRInstruction* left = generate_ir_from_ast(node->left);
-            IRInstruction* right = generate_ir_from_ast(node->right);
+// Helper to push the result of a lowered operand
+static inline void push_value(IRBuilder* builder, ValueId value) {
+    if (builder->value_count == builder->value_capacity) {
+        builder->values = grow_array(builder->ctx, builder->values, builder->value_count,
+                                     &builder->value_capacity, sizeof(ValueId));
+    }
+    builder->values[builder->value_count++] = value;
+}
 
-            // Create a temporary variable for the result
-            char* temp = (char*)malloc(16);
-            sprintf(temp, "t%d", temp_var_counter++);
+// Helper to turn a numeric literal into a constant operand. The lexer
+// parsed it into the context's pool; the program keeps a pool of its own,
+// which the optimizer adds folded constants to.
+static inline ValueId literal_operand(IRBuilder* builder, const AST* ast, NodeId node) {
+    return ir_add_constant(builder->ctx, builder->program, field_pool_get(&builder->ctx->constants, ast->values[node]));
+}
 
-            // Create the binary operation IR instruction
-            IRInstruction* instr = create_ir_instruction(op, temp, left->dest, right->dest);
-            instr->next = left;
-            left->next = right;
-            return instr;
-        }
+// IR operation of each binary AST operator
+static const IROpType binary_ops[] = {
+    [AST_OP_ADD] = IR_OP_ADD,
+    [AST_OP_SUB] = IR_OP_SUB,
+    [AST_OP_MUL] = IR_OP_MUL,
+    [AST_OP_DIV] = IR_OP_DIV,
+    [AST_OP_EQ] = IR_OP_EQ,
+};
 
-        case AST_ASSERTION: {
-            // Generate IR for the assertion expression
-            IRInstruction* expr = generate_ir_from_ast(node->left);
-            // Create an assertion IR instruction
-            IRInstruction* assert = create_ir_instruction(IR_OP_ASSERT, NULL, expr->dest, NULL);
-            assert->next = expr;
-            return assert;
+// Helper to lower one node. Its operands were lowered just before it, so
+// their values are on top of the value stack.
+static void lower_node(IRBuilder* builder, const AST* ast, NodeId node) {
+    Symbol name = ast->values[node];
+    IRLocation location = node_location(ast, node);
+    switch (ast_kind(ast, node)) {
+        case AST_BINARY_OP: {
+            ASTOperator op = (ASTOperator)ast->ops[node];
+            if (op == AST_OP_NONE || op > AST_OP_EQ) {
+                compile_error(builder->ctx, STAGE_IR, location.line, location.column,
+                              "Unsupported binary operator %d", op);
+            }
+            // Create a temporary value for the result of the operands
+            ValueId right = builder->values[--builder->value_count];
+            ValueId left = builder->values[--builder->value_count];
+            push_value(builder, emit(builder, location, binary_ops[op], SYMBOL_NONE, left, right));
+            break;
         }
 
         case AST_LITERAL:
-        case AST_VARIABLE: {
-            // Create a temporary variable for the literal or variable value
-            char* temp = (char*)malloc(16);
-            sprintf(temp, "t%d", temp_var_counter++);
-            return create_ir_instruction(IR_OP_ASSIGN, temp, node->value, NULL);
-        }
+            // Copy the constant into a temporary
+            push_value(builder, emit(builder, location, IR_OP_ASSIGN, SYMBOL_NONE,
+                                     literal_operand(builder, ast, node), IR_NO_VALUE));
+            break;
+
+        case AST_VARIABLE:
+            // Copy the variable's current value into a temporary
+            push_value(builder, emit(builder, location, IR_OP_ASSIGN, SYMBOL_NONE, builder->variables[name],
+                                     IR_NO_VALUE));
+            break;
+
+        case AST_ASSIGNMENT:
+            // Name the value of the right-hand side expression
+            builder->variables[name] = emit(builder, location, IR_OP_ASSIGN, name,
+                                            builder->values[--builder->value_count], IR_NO_VALUE);
+            break;
+
+        case AST_ASSERTION:
+            // Assert the value of the assertion expression
+            emit(builder, location, IR_OP_ASSERT, SYMBOL_NONE, builder->values[--builder->value_count], IR_NO_VALUE);
+            break;
+
+        case AST_INPUT:
+        case AST_PUBLIC_INPUT:
+            // Inputs are values with no operands; the prover supplies them
+            builder->variables[name] = emit(builder, location,
+                                            ast_kind(ast, node) == AST_INPUT ? IR_OP_INPUT : IR_OP_PUBLIC, name,
+                                            IR_NO_VALUE, IR_NO_VALUE);
+            break;
+
+        case AST_OUTPUT:
+            // Outputs define no value anything else reads
+            emit(builder, location, IR_OP_OUTPUT, name, builder->variables[name], IR_NO_VALUE);
+            break;
 
         default:
-            fprintf(stderr, "Error: Unsupported AST node type %d.\n", node->type);
-            exit(1);
+            compile_error(builder->ctx, STAGE_IR, location.line, location.column, "Unsupported AST node type %d",
+                          ast_kind(ast, node));
     }
-    return NULL;
+}
+
+// Lower a single statement: its nodes, in order, end with the statement
+void ir_lower_statement(IRBuilder* builder, const AST* ast, uint32_t index) {
+    NodeId statement = ast->statements[index];
+    builder->value_count = 0;
+    for (NodeId node = ast_statement_start(ast, index); node <= statement; node++) {
+        lower_node(builder, ast, node);
+    }
+}
+
+// Lower an input placeholder
+void ir_lower_input(IRBuilder* builder, Symbol name, IRLocation location) {
+    builder->variables[name] = emit(builder, location, IR_OP_INPUT, name, IR_NO_VALUE, IR_NO_VALUE);
+}
+
+// Allocate an empty program with room for capacity instructions
+IRProgram* ir_program_create(CompilerContext* ctx, uint32_t capacity) {
+    IRProgram* program = (IRProgram*)arena_calloc(&ctx->arena, 1, sizeof(IRProgram));
+    program->capacity = capacity ? capacity : 1;
+    program->instrs = (IRInstruction*)arena_alloc(&ctx->arena, sizeof(IRInstruction) * program->capacity);
+    program->locations = (IRLocation*)arena_alloc(&ctx->arena, sizeof(IRLocation) * program->capacity);
+    field_pool_init(&program->constants, &ctx->arena);
+    return program;
+}
+
+// Set up a builder appending to a program
+void ir_builder_init(IRBuilder* builder, CompilerContext* ctx, IRProgram* program) {
+    memset(builder, 0, sizeof(IRBuilder));
+    builder->ctx = ctx;
+    builder->program = program;
+    builder->variables = (ValueId*)arena_alloc(&ctx->arena, sizeof(ValueId) * ctx->symbols.count);
+    memset(builder->variables, 0xFF, sizeof(ValueId) * ctx->symbols.count); // IR_NO_VALUE
+    builder->value_capacity = 64;
+    builder->values = (ValueId*)arena_alloc(&ctx->arena, sizeof(ValueId) * builder->value_capacity);
+    arena_init(&builder->arena, 0); // The hash-consing table is only needed while lowering
+    value_table_init(&builder->expressions, &builder->arena);
+}
+
+// Empty the builder's program and forget its computations
+void ir_builder_reset(IRBuilder* builder) {
+    IRProgram* program = builder->program;
+    program->count = 0;
+    program->uses_valid = 0;
+    program->hash_consed = 0;
+    field_pool_clear(&program->constants);
+    arena_reset(&builder->arena);
+    value_table_init(&builder->expressions, &builder->arena);
+}
+
+// Release a builder's working memory
+void ir_builder_free(IRBuilder* builder) {
+    arena_free(&builder->arena);
+}
+
+// Cleanup releasing a builder whose lowering was cut short by an error
+static void release_builder(void* builder) {
+    ir_builder_free((IRBuilder*)builder);
 }
 
 // Entry point for IR generation
-IRInstruction* generate_ir(const ASTNode* ast) {
-    temp_var_counter = 0; // Reset the temporary variable counter
-    return generate_ir_from_ast(ast);
+IRProgram* generate_ir(CompilerContext* ctx, const AST* ast) {
+    if (!ast) {
+        compile_error(ctx, STAGE_IR, 0, 0, "No AST to lower");
+    }
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+
+    IRProgram* program = ir_program_create(ctx, 1024);
+    IRBuilder builder;
+    ir_builder_init(&builder, ctx, program);
+    ArenaCleanup cleanup;
+    context_push_cleanup(ctx, &cleanup, release_builder, &builder);
+
+    // Lower each statement in program order
+    for (uint32_t s = 0; s < ast->statement_count; s++) {
+        ir_lower_statement(&builder, ast, s);
+    }
+    context_pop_cleanup(ctx, &cleanup);
+    ir_builder_free(&builder);
+    STATS_COUNT(ctx, ir_instructions, program->count);
+    PHASE_END(ctx, PHASE_IRGEN, &timer);
+    return program;
+}
+
+// Helper to renumber a value operand after compaction
+static inline ValueId remap_operand(ValueId operand, const ValueId* remap) {
+    return (operand == IR_NO_VALUE || ir_is_const(operand)) ? operand : remap[operand];
 }
 
-// Free IR instructions
-void free_ir(IRInstruction* ir) {
-    while (ir) {
-        IRInstruction* next = ir->next;
-        free(ir->dest);
-        free(ir->src1);
-        free(ir->src2);
-        free(ir);
-        ir = next;
+// Remove flagged instructions, sliding the rest down in place
+uint32_t ir_remove_instructions(IRProgram* program, const uint8_t* remove, ValueId* remap) {
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < program->count; i++) {
+        if (remove[i]) {
+            remap[i] = IR_NO_VALUE;
+            continue;
+        }
+        IRInstruction instr = program->instrs[i];
+        instr.src1 = remap_operand(instr.src1, remap);
+        instr.src2 = remap_operand(instr.src2, remap);
+        program->instrs[kept] = instr;
+        program->locations[kept] = program->locations[i];
+        remap[i] = kept++;
+    }
+    uint32_t removed = program->count - kept;
+    program->count = kept;
+    program->uses_valid = 0;
+    return removed;
+}
+
+// Helper to check whether an operand refers to another instruction
+static inline int is_value(ValueId operand) {
+    return operand != IR_NO_VALUE && !ir_is_const(operand);
+}
+
+// Build the def->use indices with a counting pass and a fill pass. An
+// instruction using the same value twice is listed once.
+void ir_build_uses(CompilerContext* ctx, IRProgram* program) {
+    uint32_t count = program->count;
+    uint32_t* offsets = (uint32_t*)arena_calloc(&ctx->arena, (size_t)count + 1, sizeof(uint32_t));
+
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (is_value(instr->src1)) offsets[instr->src1 + 1]++;
+        if (is_value(instr->src2) && instr->src2 != instr->src1) offsets[instr->src2 + 1]++;
+    }
+    for (uint32_t v = 0; v < count; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+
+    ValueId* uses = (ValueId*)arena_alloc(&ctx->arena, sizeof(ValueId) * offsets[count]);
+    uint32_t* fill = (uint32_t*)arena_alloc(&ctx->arena, sizeof(uint32_t) * ((size_t)count + 1));
+    memcpy(fill, offsets, sizeof(uint32_t) * ((size_t)count + 1));
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (is_value(instr->src1)) uses[fill[instr->src1]++] = i;
+        if (is_value(instr->src2) && instr->src2 != instr->src1) uses[fill[instr->src2]++] = i;
+    }
+
+    program->use_offsets = offsets;
+    program->uses = uses;
+    program->uses_valid = 1;
+}
+
+// Number temporaries in definition order, skipping named values
+uint32_t* ir_number_temporaries(const IRProgram* program) {
+    uint32_t* temp_numbers = (uint32_t*)malloc(sizeof(uint32_t) * ((size_t)program->count + 1));
+    if (!temp_numbers) {
+        fprintf(stderr, "Error: Memory allocation failed for IR printing.\n");
+        exit(1);
+    }
+    uint32_t next_temp = 0;
+    for (uint32_t i = 0; i < program->count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (instr->op != IR_OP_ASSERT && instr->name == SYMBOL_NONE) temp_numbers[i] = next_temp++;
+    }
+    return temp_numbers;
+}
+
+// Format an operand the way the string-based IR named it
+const char* ir_operand_name(const CompilerContext* ctx, const IRProgram* program, const uint32_t* temp_numbers,
+                            ValueId operand, char* buffer, size_t size) {
+    if (operand == IR_NO_VALUE) return "NULL";
+    if (ir_is_const(operand)) {
+        return field_to_string(ctx->field, ir_constant_value(program, operand), buffer, size);
+    }
+    if (program->instrs[operand].op == IR_OP_ASSERT) return "NULL";
+    if (program->instrs[operand].name != SYMBOL_NONE) {
+        return symbol_text(&ctx->symbols, program->instrs[operand].name);
     }
+    snprintf(buffer, size, "t%u", temp_numbers[operand]);
+    return buffer;
 }
 
 // Print IR instructions
-void print_ir(const IRInstruction* ir) {
-    while (ir) {
-        printf("Op: %d, Dest: %s, Src1: %s, Src2: %s\n",
-               ir->op, ir->dest ? ir->dest : "NULL",
-               ir->src1 ? ir->src1 : "NULL",
-               ir->src2 ? ir->src2 : "NULL");
-        ir = ir->next;
+void print_ir(const CompilerContext* ctx, const IRProgram* program) {
+    uint32_t* temp_numbers = ir_number_temporaries(program);
+    char dest[FIELD_DECIMAL_SIZE], src1[FIELD_DECIMAL_SIZE], src2[FIELD_DECIMAL_SIZE];
+    for (uint32_t i = 0; i < program->count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        printf("Op: %d, Dest: %s, Src1: %s, Src2: %s\n", instr->op,
+               ir_operand_name(ctx, program, temp_numbers, i, dest, sizeof(dest)),
+               ir_operand_name(ctx, program, temp_numbers, instr->src1, src1, sizeof(src1)),
+               ir_operand_name(ctx, program, temp_numbers, instr->src2, src2, sizeof(src2)));
     }
+    free(temp_numbers);
 }
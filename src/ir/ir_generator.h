@@ -1,7 +1,9 @@
 #ifndef IR_GENERATOR_H
 #define IR_GENERATOR_H
 
+#include <stdint.h>
 #include "../frontend/parser.h"
+#include "../math/field_pool.h"
 
 // Enum for IR operation types
 typedef enum {
@@ -11,40 +13,241 @@ typedef enum {
     IR_OP_MUL,     // Multiplication
     IR_OP_DIV,     // Division
     IR_OP_EQ,      // Equality check
-    IR_OP_ASSERT   // Assertion
+    IR_OP_ASSERT,  // Assertion
+    IR_OP_INPUT,   // Private input, supplied when the witness is computed
+    IR_OP_PUBLIC,  // Public input, also known to the verifier
+    IR_OP_OUTPUT   // Public output: reveals src1 to the verifier under the variable's name
 } IROpType;
 
-// Structure for a single IR instruction
-typedef struct IRInstruction {
+// An IR operand. Values are numbered by the index of the instruction that
+// defines them (the IR is in SSA form, so each is defined exactly once).
+// Operands with IR_CONST_FLAG set refer to the constant pool instead.
+typedef uint32_t ValueId;
+
+#define IR_NO_VALUE   0xFFFFFFFFu   // Absent operand
+#define IR_CONST_FLAG 0x80000000u   // Operand is a constant pool index
+
+// Helpers for encoding and decoding operands
+static inline int ir_is_const(ValueId operand) {
+    return operand != IR_NO_VALUE && (operand & IR_CONST_FLAG);
+}
+static inline uint32_t ir_const_index(ValueId operand) {
+    return operand & ~IR_CONST_FLAG;
+}
+static inline ValueId ir_const_operand(uint32_t index) {
+    return index | IR_CONST_FLAG;
+}
+
+// Structure for a single IR instruction. Instruction i defines value i.
+typedef struct {
     IROpType op;              // Operation type
-    char* dest;               // Destination variable
-    char* src1;               // Source operand 1
-    char* src2;               // Source operand 2 (if applicable)
-    struct IRInstruction* next; // Pointer to the next instruction
+    Symbol name;              // Variable this instruction assigns, or SYMBOL_NONE for temporaries
+    ValueId src1;             // Source operand 1
+    ValueId src2;             // Source operand 2 (if applicable)
 } IRInstruction;
 
+// Source position an instruction was lowered from, for diagnostics
+typedef struct {
+    int line;
+    int column;
+} IRLocation;
+
+// A program in IR: a contiguous array of instructions in program order,
+// its constant pool, and (once built) def->use indices in compressed form:
+// the users of value v are uses[use_offsets[v] .. use_offsets[v + 1]).
+typedef struct {
+    IRInstruction* instrs;    // Instructions; operands always refer backwards
+    IRLocation* locations;    // Source position of each instruction (parallel to instrs)
+    uint32_t count;
+    uint32_t capacity;
+    FieldPool constants;      // Constants referenced by the program
+    uint32_t* use_offsets;    // count + 1 offsets into uses
+    ValueId* uses;            // Instructions using each value, in program order
+    int uses_valid;           // Non-zero while use_offsets/uses match instrs
+    uint32_t hash_consed;     // Expressions generate_ir shared instead of emitting again
+    uint32_t variables_removed; // Variables the optimizer found nothing reads
+} IRProgram;
+
+// Hash table from computations (operation and operands) to the value
+// holding them, for hash-consing and value numbering. Operands of
+// commutative operations are unordered, so a * b and b * a match.
+typedef struct {
+    Arena* arena;
+    ValueId* slots;           // 1-based values (0 = empty)
+    uint32_t slot_mask;
+    uint32_t count;
+} ValueTable;
+
+// State for lowering an AST into IR in program order, one statement at a
+// time. The nodes are in post-order, so each statement is lowered by a
+// scan over its nodes with a stack of operand values.
+typedef struct {
+    CompilerContext* ctx;
+    IRProgram* program;     // Program being built
+    ValueId* variables;     // Value currently bound to each variable, by Symbol
+    ValueId* values;        // Results of lowered operands awaiting their operator
+    size_t value_count;
+    size_t value_capacity;
+    ValueTable expressions; // Pure computations emitted so far, for hash-consing
+    Arena arena;            // Holds the hash-consing table
+} IRBuilder;
+
 // Function prototypes
 
 /**
  * Generates the IR from the given AST.
  * 
- * @param ast The root of the Abstract Syntax Tree.
- * @return The head of the linked list of IR instructions.
+ * @param ctx The compilation context to allocate from.
+ * @param ast The Abstract Syntax Tree.
+ * @return The program in IR form.
+ */
+IRProgram* generate_ir(CompilerContext* ctx, const AST* ast);
+
+/**
+ * Allocates an empty program.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param capacity Number of instructions to make room for; the program
+ *                 grows past it as needed.
+ * @return The program.
+ */
+IRProgram* ir_program_create(CompilerContext* ctx, uint32_t capacity);
+
+/**
+ * Sets up a builder that appends statements to a program. Variables are
+ * indexed by Symbol, so every variable name must be interned first.
+ * 
+ * @param builder The builder to initialize.
+ * @param ctx The compilation context to allocate from.
+ * @param program The program to append to.
+ */
+void ir_builder_init(IRBuilder* builder, CompilerContext* ctx, IRProgram* program);
+
+/**
+ * Lowers one statement, appending its instructions to the builder's
+ * program. Variables it reads must have been defined by earlier statements
+ * lowered with the same builder.
+ * 
+ * @param builder The builder.
+ * @param ast The AST holding the statement.
+ * @param index Which of the AST's statements to lower.
+ */
+void ir_lower_statement(IRBuilder* builder, const AST* ast, uint32_t index);
+
+/**
+ * Lowers a private input of the named variable, as an input statement at
+ * the given position would be lowered. Program fragments use these as
+ * placeholders for values defined elsewhere.
+ * 
+ * @param builder The builder.
+ * @param name The variable.
+ * @param location Source position of the instruction.
+ */
+void ir_lower_input(IRBuilder* builder, Symbol name, IRLocation location);
+
+/**
+ * Empties the builder's program, including its constant pool, so it can
+ * be filled again. Variable bindings are kept.
+ */
+void ir_builder_reset(IRBuilder* builder);
+
+/**
+ * Releases a builder's working memory. The program is unaffected.
+ */
+void ir_builder_free(IRBuilder* builder);
+
+/**
+ * Adds a constant to a program's pool, reusing an existing entry when the
+ * value is already present.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param program The program owning the pool.
+ * @param value The constant value, an element of ctx->field.
+ * @return An operand referring to the constant.
+ */
+ValueId ir_add_constant(CompilerContext* ctx, IRProgram* program, const FieldElement* value);
+
+/**
+ * Returns the value of a constant operand.
+ */
+static inline const FieldElement* ir_constant_value(const IRProgram* program, ValueId operand) {
+    return field_pool_get(&program->constants, ir_const_index(operand));
+}
+
+/**
+ * Initializes an empty value table.
+ * 
+ * @param table The table to initialize.
+ * @param arena The arena to allocate from.
+ */
+void value_table_init(ValueTable* table, Arena* arena);
+
+/**
+ * Tests whether an instruction is a pure computation that value numbering
+ * may share: arithmetic, equality tests and unnamed copies.
+ */
+static inline int ir_is_pure(const IRInstruction* instr) {
+    return instr->op == IR_OP_ADD || instr->op == IR_OP_SUB || instr->op == IR_OP_MUL || instr->op == IR_OP_DIV ||
+           instr->op == IR_OP_EQ || (instr->op == IR_OP_ASSIGN && instr->name == SYMBOL_NONE);
+}
+
+/**
+ * Looks up the computation of a pure instruction, adding it if no earlier
+ * instruction computes the same.
+ * 
+ * @param table The table.
+ * @param program The program the table's values belong to.
+ * @param value The instruction to look up.
+ * @return The earlier value computing the same, or value itself if new.
+ */
+ValueId value_table_find_or_add(ValueTable* table, const IRProgram* program, ValueId value);
+
+/**
+ * Removes the instructions flagged in remove[] (indexed by ValueId) and
+ * renumbers the remaining values, preserving program order. No remaining
+ * instruction may use a removed value. Invalidates the def->use indices.
+ * 
+ * @param program The program to compact.
+ * @param remove Non-zero for each instruction to delete.
+ * @param remap Scratch array of program->count entries.
+ * @return Number of instructions removed.
+ */
+uint32_t ir_remove_instructions(IRProgram* program, const uint8_t* remove, ValueId* remap);
+
+/**
+ * (Re)builds the def->use indices of a program. Passes that rewrite
+ * operands must clear uses_valid or rebuild the indices.
+ * 
+ * @param ctx The compilation context to allocate from.
+ * @param program The program to index.
+ */
+void ir_build_uses(CompilerContext* ctx, IRProgram* program);
+
+/**
+ * Numbers a program's temporaries (unnamed values) in definition order, as
+ * the string-based IR named them t0, t1, ...
+ * 
+ * @param program The program.
+ * @return A malloc()ed array indexed by ValueId; the caller frees it.
  */
-IRInstruction* generate_ir(const ASTNode* ast);
+uint32_t* ir_number_temporaries(const IRProgram* program);
 
 /**
- * Frees the memory allocated for the IR instructions.
+ * Formats an operand for display: constants by value, variables by name
+ * and temporaries as t<N>, using numbers from ir_number_temporaries.
  * 
- * @param ir The head of the IR instruction list.
+ * @return Either buffer or a string owned by the context.
  */
-void free_ir(IRInstruction* ir);
+const char* ir_operand_name(const CompilerContext* ctx, const IRProgram* program, const uint32_t* temp_numbers,
+                            ValueId operand, char* buffer, size_t size);
 
 /**
- * Prints the IR instructions for debugging.
+ * Prints the IR instructions for debugging, naming values the way the
+ * string-based IR did (variables by name, temporaries as t0, t1, ...).
  * 
- * @param ir The head of the IR instruction list.
+ * @param ctx The compilation context the IR belongs to.
+ * @param program The program to print.
  */
-void print_ir(const IRInstruction* ir);
+void print_ir(const CompilerContext* ctx, const IRProgram* program);
 
 #endif // IR_GENERATOR_H
@@ -2,91 +2,876 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
 
-// Helper function to check if a string represents an integer
-int is_integer(const char* str) {
-    if (!str) return 0;
-    while (*str) {
-        if (!isdigit(*str++)) return 0;
+// Lattice of a value during constant propagation. Values start unknown,
+// may become a known constant, and drop to overdefined once they are
+// known not to be constant; they only ever move down.
+enum {
+    LATTICE_UNKNOWN,
+    LATTICE_CONSTANT,
+    LATTICE_OVERDEFINED
+};
+
+// Per-pass state for sparse constant propagation
+typedef struct {
+    CompilerContext* ctx;
+    IRProgram* program;
+    uint8_t* state;         // Lattice state of each value
+    ValueId* constant;      // Constant operand of each LATTICE_CONSTANT value
+    ValueId* worklist;      // Instructions whose inputs changed
+    uint32_t worklist_count;
+    uint8_t* queued;        // Non-zero while an instruction is on the worklist
+} PropagationState;
+
+// Helper to name an operator for diagnostics
+static const char* op_symbol(IROpType op) {
+    switch (op) {
+        case IR_OP_ADD: return "+";
+        case IR_OP_SUB: return "-";
+        case IR_OP_MUL: return "*";
+        case IR_OP_DIV: return "/";
+        case IR_OP_EQ: return "==";
+        default: return "?";
+    }
+}
+
+// Helper to read the lattice state and constant of an operand
+static inline uint8_t operand_state(const PropagationState* ps, ValueId operand, ValueId* constant) {
+    if (ir_is_const(operand)) {
+        *constant = operand;
+        return LATTICE_CONSTANT;
+    }
+    *constant = ps->constant[operand];
+    return ps->state[operand];
+}
+
+// Helper to fold a binary operation over two constants in the field
+static ValueId fold(PropagationState* ps, uint32_t i, IROpType op, ValueId lhs, ValueId rhs) {
+    const Field* field = ps->ctx->field;
+    const FieldElement* val1 = ir_constant_value(ps->program, lhs);
+    const FieldElement* val2 = ir_constant_value(ps->program, rhs);
+    FieldElement result = {{0}};
+
+    switch (op) {
+        case IR_OP_ADD: field_add(field, &result, val1, val2); break;
+        case IR_OP_SUB: field_sub(field, &result, val1, val2); break;
+        case IR_OP_MUL: field_mul(field, &result, val1, val2); break;
+        case IR_OP_DIV:
+            // Division multiplies by the field inverse
+            if (!field_inv(field, &result, val2)) {
+                const IRLocation* loc = &ps->program->locations[i];
+                compile_error(ps->ctx, STAGE_OPTIMIZER, loc->line, loc->column, "Division by zero");
+            }
+            field_mul(field, &result, val1, &result);
+            break;
+        case IR_OP_EQ:
+            if (field_equal(val1, val2)) result = field->one;
+            break;
+        default: break;
+    }
+
+    if (ps->ctx->trace) {
+        char a[FIELD_DECIMAL_SIZE], b[FIELD_DECIMAL_SIZE], c[FIELD_DECIMAL_SIZE];
+        context_trace(ps->ctx, "Folding operation %s %s %s -> %s", field_to_string(field, val1, a, sizeof(a)),
+                      op_symbol(op), field_to_string(field, val2, b, sizeof(b)),
+                      field_to_string(field, &result, c, sizeof(c)));
     }
+    return ir_add_constant(ps->ctx, ps->program, &result);
+}
+
+// Helper to evaluate one instruction over the lattice. Returns non-zero
+// if the value it defines moved down.
+static int evaluate(PropagationState* ps, uint32_t i) {
+    const IRInstruction* instr = &ps->program->instrs[i];
+    uint8_t state;
+    ValueId constant = IR_NO_VALUE;
+
+    switch (instr->op) {
+        case IR_OP_ASSIGN:
+            state = operand_state(ps, instr->src1, &constant);
+            break;
+
+        case IR_OP_ADD:
+        case IR_OP_SUB:
+        case IR_OP_MUL:
+        case IR_OP_DIV:
+        case IR_OP_EQ: {
+            ValueId lhs, rhs;
+            uint8_t left = operand_state(ps, instr->src1, &lhs);
+            uint8_t right = operand_state(ps, instr->src2, &rhs);
+            if (left == LATTICE_OVERDEFINED || right == LATTICE_OVERDEFINED) {
+                state = LATTICE_OVERDEFINED;
+            } else if (left == LATTICE_UNKNOWN || right == LATTICE_UNKNOWN) {
+                state = LATTICE_UNKNOWN;
+            } else {
+                state = LATTICE_CONSTANT;
+                constant = fold(ps, i, instr->op, lhs, rhs);
+            }
+            break;
+        }
+
+        case IR_OP_INPUT:
+        case IR_OP_PUBLIC:
+            // Inputs are only known when the witness is computed
+            state = LATTICE_OVERDEFINED;
+            break;
+
+        default:
+            // Assertions define no value
+            return 0;
+    }
+
+    if (state == ps->state[i]) return 0;
+    ps->state[i] = state;
+    ps->constant[i] = constant;
     return 1;
 }
 
-// Perform constant folding optimization
-IRInstruction* constant_folding(IRInstruction* ir) {
-    IRInstruction* current = ir;
-
-    while (current) {
-        // Check for constant binary operations
-        if ((current->op == IR_OP_ADD || current->op == IR_OP_SUB ||
-             current->op == IR_OP_MUL || current->op == IR_OP_DIV) &&
-            is_integer(current->src1) && is_integer(current->src2)) {
-            
-            // Parse constants
-            int val1 = atoi(current->src1);
-            int val2 = atoi(current->src2);
-            int result = 0;
-
-            // Perform the operation
-            switch (current->op) {
-                case IR_OP_ADD: result = val1 + val2; break;
-                case IR_OP_SUB: result = val1 - val2; break;
-                case IR_OP_MUL: result = val1 * val2; break;
-                case IR_OP_DIV: 
-                    if (val2 == 0) {
-                        fprintf(stderr, "Error: Division by zero.\n");
-                        exit(1);
-                    }
-                    result = val1 / val2; 
-                    break;
-                default: break;
+// Helper to test whether an instruction is observable from outside the
+// circuit: assertions, outputs, the inputs that make up its interface, and
+// divisions by values that may be zero, which are implicit assertions
+static inline int is_root(const IRInstruction* instr) {
+    return instr->op == IR_OP_ASSERT || instr->op == IR_OP_OUTPUT || instr->op == IR_OP_INPUT ||
+           instr->op == IR_OP_PUBLIC || (instr->op == IR_OP_DIV && !ir_is_const(instr->src2));
+}
+
+// Liveness-based dead-code elimination. Operands always refer backwards,
+// so a single reverse walk marks everything the roots depend on;
+// everything else, including assignments to variables nothing reads, would
+// only become witness variables and constraints nobody checks, and is
+// removed. Each removed variable is counted in program->variables_removed.
+// Returns the number of instructions removed.
+static uint32_t eliminate_dead_code(CompilerContext* ctx, IRProgram* program) {
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    Arena work;
+    arena_init(&work, 0);
+    uint8_t* live = (uint8_t*)arena_calloc(&work, count, sizeof(uint8_t));
+    for (uint32_t i = count; i-- > 0;) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (!live[i] && !is_root(instr)) continue;
+        live[i] = 1;
+        if (instr->src1 != IR_NO_VALUE && !ir_is_const(instr->src1)) live[instr->src1] = 1;
+        if (instr->src2 != IR_NO_VALUE && !ir_is_const(instr->src2)) live[instr->src2] = 1;
+    }
+
+    // Flip the marks into removal flags, reporting dead variables in program order
+    uint32_t removed = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        live[i] = !live[i];
+        if (!live[i]) continue;
+        removed++;
+        const IRInstruction* instr = &program->instrs[i];
+        if (instr->name == SYMBOL_NONE) continue;
+        const IRLocation* loc = &program->locations[i];
+        TRACE(ctx, "Removing variable '%s' at line %d, column %d that nothing reads",
+              symbol_text(&ctx->symbols, instr->name), loc->line, loc->column);
+        program->variables_removed++;
+    }
+
+    if (removed) {
+        ir_remove_instructions(program, live, (ValueId*)arena_alloc(&work, sizeof(ValueId) * count));
+    }
+    arena_free(&work);
+    return removed;
+}
+
+// Cleanup releasing a pass's working memory when an error cuts it short
+static void release_work(void* work) {
+    arena_free((Arena*)work);
+}
+
+// Sparse constant propagation. Every instruction is evaluated once in
+// program order; whenever a value's lattice state changes, its users are
+// requeued through the def->use indices. Each value can change at most
+// twice, so the pass is linear in instructions plus uses. Constant values
+// are then folded into ASSIGNs of the constant, their uses are rewritten
+// to the constant itself, and assertions of a constant are checked at
+// compile time and removed. Returns the number of instructions folded.
+static uint32_t constant_propagation(CompilerContext* ctx, IRProgram* program) {
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    if (!program->uses_valid) {
+        ir_build_uses(ctx, program);
+    }
+
+    // Lattice states and the worklist, released when the pass ends or
+    // folding reports an error
+    Arena work;
+    arena_init(&work, 0);
+    ArenaCleanup work_cleanup;
+    context_push_cleanup(ctx, &work_cleanup, release_work, &work);
+    PropagationState ps = {ctx, program};
+    ps.state = (uint8_t*)arena_calloc(&work, count, sizeof(uint8_t));
+    ps.queued = (uint8_t*)arena_alloc(&work, count);
+    ps.constant = (ValueId*)arena_alloc(&work, sizeof(ValueId) * count);
+    ps.worklist = (ValueId*)arena_alloc(&work, sizeof(ValueId) * count);
+
+    // Seed with every instruction, popped in program order
+    for (uint32_t i = 0; i < count; i++) {
+        ps.worklist[i] = count - 1 - i;
+    }
+    ps.worklist_count = count;
+    memset(ps.queued, 1, count);
+
+    while (ps.worklist_count > 0) {
+        uint32_t i = ps.worklist[--ps.worklist_count];
+        ps.queued[i] = 0;
+        if (!evaluate(&ps, i)) continue;
+        for (uint32_t u = program->use_offsets[i]; u < program->use_offsets[i + 1]; u++) {
+            uint32_t user = program->uses[u];
+            if (!ps.queued[user]) {
+                ps.queued[user] = 1;
+                ps.worklist[ps.worklist_count++] = user;
+            }
+        }
+    }
+
+    // Name temporaries only when someone is listening
+    uint32_t* temp_numbers = ctx->trace ? ir_number_temporaries(program) : NULL;
+    char name[FIELD_DECIMAL_SIZE], value[FIELD_DECIMAL_SIZE];
+    ArenaCleanup cleanup;
+    context_push_cleanup(ctx, &cleanup, free, temp_numbers);
+
+    // Rewrite: fold constant values and point their users at the constant
+    uint8_t* remove = ps.queued; // All zero again once the worklist drains
+    uint32_t removed = 0, folded = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* instr = &program->instrs[i];
+
+        if (instr->src1 != IR_NO_VALUE && !ir_is_const(instr->src1) && ps.state[instr->src1] == LATTICE_CONSTANT) {
+            TRACE(ctx, "Propagating constant %s to %s",
+                  ir_operand_name(ctx, program, temp_numbers, ps.constant[instr->src1], value, sizeof(value)),
+                  ir_operand_name(ctx, program, temp_numbers, i, name, sizeof(name)));
+            instr->src1 = ps.constant[instr->src1];
+        }
+        if (instr->src2 != IR_NO_VALUE && !ir_is_const(instr->src2) && ps.state[instr->src2] == LATTICE_CONSTANT) {
+            TRACE(ctx, "Propagating constant %s to %s",
+                  ir_operand_name(ctx, program, temp_numbers, ps.constant[instr->src2], value, sizeof(value)),
+                  ir_operand_name(ctx, program, temp_numbers, i, name, sizeof(name)));
+            instr->src2 = ps.constant[instr->src2];
+        }
+
+        if (ps.state[i] == LATTICE_CONSTANT) {
+            if (instr->op != IR_OP_ASSIGN) folded++;
+            instr->op = IR_OP_ASSIGN;
+            instr->src1 = ps.constant[i];
+            instr->src2 = IR_NO_VALUE;
+        } else if (instr->op == IR_OP_ASSERT && ir_is_const(instr->src1)) {
+            const IRLocation* loc = &program->locations[i];
+            if (field_is_zero(ir_constant_value(program, instr->src1))) {
+                compile_error(ctx, STAGE_OPTIMIZER, loc->line, loc->column, "Assertion always fails");
+            }
+            TRACE(ctx, "Removing assertion at line %d, column %d that always holds", loc->line, loc->column);
+            remove[i] = 1;
+            removed++;
+        }
+    }
+    context_pop_cleanup(ctx, &cleanup);
+    free(temp_numbers);
+
+    if (removed) {
+        ir_remove_instructions(program, remove, ps.worklist);
+    }
+    context_pop_cleanup(ctx, &work_cleanup);
+    arena_free(&work);
+    program->uses_valid = 0; // Operands were rewritten
+    return folded + removed;
+}
+
+
+// Most terms a linear form tracks; longer sums are left as they are
+#define LINEAR_FORM_TERMS 8
+
+// One term of a linear form: coefficient * value
+typedef struct {
+    FieldElement coefficient;
+    ValueId value;
+} FormTerm;
+
+// A value written as constant + sum of coefficient * atom, where atoms are
+// values that are not linear in others: inputs, products and quotients of
+// two non-constant values, and equality tests. Terms are sorted by value.
+typedef struct {
+    FieldElement constant;
+    uint32_t count;
+    FormTerm* terms;
+} LinearForm;
+
+// Per-pass state for merging linear chains
+typedef struct {
+    CompilerContext* ctx;
+    IRProgram* program;
+    Arena work;                 // Forms, released when the pass ends
+    LinearForm** forms;         // Form of each value (NULL for atoms)
+    FormTerm scratch[2 * LINEAR_FORM_TERMS];
+} ChainState;
+
+// Helper to get the form of an operand. Constants and atoms need storage
+// for their form and its single term.
+static const LinearForm* operand_form(const ChainState* cs, ValueId operand, LinearForm* storage, FormTerm* term) {
+    if (ir_is_const(operand)) {
+        storage->constant = *ir_constant_value(cs->program, operand);
+        storage->count = 0;
+        storage->terms = NULL;
+        return storage;
+    }
+    if (cs->forms[operand]) return cs->forms[operand];
+    memset(&storage->constant, 0, sizeof(FieldElement));
+    term->coefficient = cs->ctx->field->one;
+    term->value = operand;
+    storage->count = 1;
+    storage->terms = term;
+    return storage;
+}
+
+// Helper to compute a + scale * b into the scratch terms, merging sorted
+// terms and dropping those that cancel. Returns 0 if the result has too
+// many terms to track.
+static int combine_forms(ChainState* cs, LinearForm* out, const LinearForm* a, const FieldElement* scale,
+                         const LinearForm* b) {
+    const Field* field = cs->ctx->field;
+    int unit = field_equal(scale, &field->one); // Plain addition needs no products
+    FieldElement scaled = b->constant;
+    if (!unit) field_mul(field, &scaled, scale, &scaled);
+    field_add(field, &out->constant, &a->constant, &scaled);
+    out->terms = cs->scratch;
+    out->count = 0;
+    uint32_t i = 0, j = 0;
+    while (i < a->count || j < b->count) {
+        if (j == b->count || (i < a->count && a->terms[i].value < b->terms[j].value)) {
+            out->terms[out->count++] = a->terms[i++];
+            continue;
+        }
+        scaled = b->terms[j].coefficient;
+        if (!unit) field_mul(field, &scaled, scale, &scaled);
+        if (i < a->count && a->terms[i].value == b->terms[j].value) {
+            field_add(field, &scaled, &scaled, &a->terms[i++].coefficient);
+        }
+        if (!field_is_zero(&scaled)) {
+            out->terms[out->count].value = b->terms[j].value;
+            out->terms[out->count++].coefficient = scaled;
+        }
+        j++;
+    }
+    return out->count <= LINEAR_FORM_TERMS;
+}
+
+// Helper to rewrite instruction i to compute its form directly when the
+// form is a constant or a single scaled atom. Returns non-zero if the
+// instruction changed.
+static int rewrite_to_form(ChainState* cs, uint32_t i, const LinearForm* form) {
+    const Field* field = cs->ctx->field;
+    IRInstruction* instr = &cs->program->instrs[i];
+    IRInstruction wanted = *instr;
+    if (form->count == 0 && instr->op == IR_OP_ASSIGN && ir_is_const(instr->src1)) {
+        return 0; // Already the constant
+    } else if (form->count == 0) {
+        wanted.op = IR_OP_ASSIGN;
+        wanted.src1 = ir_add_constant(cs->ctx, cs->program, &form->constant);
+        wanted.src2 = IR_NO_VALUE;
+    } else if (form->count == 1 && field_is_zero(&form->constant)) {
+        const FormTerm* term = &form->terms[0];
+        if (field_equal(&term->coefficient, &field->one)) {
+            wanted.op = IR_OP_ASSIGN;
+            wanted.src1 = term->value;
+            wanted.src2 = IR_NO_VALUE;
+        } else {
+            ValueId k = ir_add_constant(cs->ctx, cs->program, &term->coefficient);
+            if (instr->op == IR_OP_MUL && ((instr->src1 == term->value && instr->src2 == k) ||
+                                          (instr->src1 == k && instr->src2 == term->value))) {
+                return 0;
             }
+            wanted.op = IR_OP_MUL;
+            wanted.src1 = term->value;
+            wanted.src2 = k;
+        }
+    } else {
+        return 0;
+    }
+    if (wanted.op == instr->op && wanted.src1 == instr->src1 && wanted.src2 == instr->src2) return 0;
+    const IRLocation* loc = &cs->program->locations[i];
+    TRACE(cs->ctx, "Merging linear chain at line %d, column %d into %s", loc->line, loc->column,
+          form->count == 0 ? "a constant" : wanted.op == IR_OP_ASSIGN ? "a copy" : "a scaled value");
+    *instr = wanted;
+    return 1;
+}
+
+// Merges chains of linear operations. Every value's linear form over atoms
+// is tracked in program order, so sums, differences and multiplications or
+// divisions by constants collapse however they are nested. Values whose
+// form turns out constant (x + 1 - x) become constants, so products by them
+// no longer cost a constraint; values that are a single scaled atom become
+// one multiplication by a constant. Returns the number of instructions
+// rewritten.
+static uint32_t merge_linear_chains(CompilerContext* ctx, IRProgram* program) {
+    const Field* field = ctx->field;
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    ChainState cs = {ctx, program};
+    arena_init(&cs.work, 0);
+    ArenaCleanup cleanup;
+    context_push_cleanup(ctx, &cleanup, release_work, &cs.work);
+    cs.forms = (LinearForm**)arena_calloc(&cs.work, count, sizeof(LinearForm*));
+    uint8_t* remove = (uint8_t*)arena_calloc(&cs.work, count, sizeof(uint8_t));
+    uint32_t rewritten = 0, removed = 0;
+    FieldElement minus_one;
+    field_neg(field, &minus_one, &field->one);
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* instr = &program->instrs[i];
+        // Values found constant are used as constants from here on
+        ValueId* operands[2] = {&instr->src1, &instr->src2};
+        for (int k = 0; k < 2; k++) {
+            ValueId v = *operands[k];
+            if (v != IR_NO_VALUE && !ir_is_const(v) && cs.forms[v] && cs.forms[v]->count == 0) {
+                *operands[k] = ir_add_constant(ctx, program, &cs.forms[v]->constant);
+            }
+        }
+
+        LinearForm storage1, storage2, result;
+        FormTerm term1, term2;
+        const LinearForm* lhs = NULL;
+        const LinearForm* rhs = NULL;
+        if (instr->src1 != IR_NO_VALUE) lhs = operand_form(&cs, instr->src1, &storage1, &term1);
+        if (instr->src2 != IR_NO_VALUE) rhs = operand_form(&cs, instr->src2, &storage2, &term2);
+        LinearForm zero = {{{0}}, 0, NULL};
+        int linear = 0;
 
-            // Replace operation with constant result
-            printf("Folding operation %d %s %d -> %d\n", val1, 
-                   current->op == IR_OP_ADD ? "+" :
-                   current->op == IR_OP_SUB ? "-" :
-                   current->op == IR_OP_MUL ? "*" : "/", 
-                   val2, result);
-
-            char* folded_result = (char*)malloc(16);
-            sprintf(folded_result, "%d", result);
-
-            free(current->src1);
-            free(current->src2);
-            current->src1 = folded_result;
-            current->src2 = NULL;
-            current->op = IR_OP_ASSIGN;
-        }
-
-        // Propagate constants to subsequent instructions
-        if (current->op == IR_OP_ASSIGN && is_integer(current->src1)) {
-            IRInstruction* next = current->next;
-            while (next) {
-                if (next->src1 && strcmp(next->src1, current->dest) == 0) {
-                    printf("Propagating constant %s to %s\n", current->src1, next->dest);
-                    free(next->src1);
-                    next->src1 = strdup(current->src1);
+        switch (instr->op) {
+            case IR_OP_ASSIGN:
+                linear = combine_forms(&cs, &result, lhs, &field->one, &zero);
+                break;
+            case IR_OP_ADD:
+                linear = combine_forms(&cs, &result, lhs, &field->one, rhs);
+                break;
+            case IR_OP_SUB:
+                linear = combine_forms(&cs, &result, lhs, &minus_one, rhs);
+                break;
+            case IR_OP_MUL:
+                if (lhs->count == 0) linear = combine_forms(&cs, &result, &zero, &lhs->constant, rhs);
+                else if (rhs->count == 0) linear = combine_forms(&cs, &result, &zero, &rhs->constant, lhs);
+                break;
+            case IR_OP_DIV:
+                if (rhs->count == 0) {
+                    FieldElement inverse;
+                    if (!field_inv(field, &inverse, &rhs->constant)) {
+                        const IRLocation* loc = &program->locations[i];
+                        compile_error(ctx, STAGE_OPTIMIZER, loc->line, loc->column, "Division by zero");
+                    }
+                    linear = combine_forms(&cs, &result, &zero, &inverse, lhs);
+                }
+                break;
+            case IR_OP_EQ:
+                // Decided when the difference is constant
+                if (combine_forms(&cs, &result, lhs, &minus_one, rhs) && result.count == 0) {
+                    if (field_is_zero(&result.constant)) result.constant = field->one;
+                    else memset(&result.constant, 0, sizeof(FieldElement));
+                    linear = 1;
                 }
-                if (next->src2 && strcmp(next->src2, current->dest) == 0) {
-                    printf("Propagating constant %s to %s\n", current->src1, next->dest);
-                    free(next->src2);
-                    next->src2 = strdup(current->src1);
+                break;
+            case IR_OP_ASSERT:
+                if (ir_is_const(instr->src1)) {
+                    const IRLocation* loc = &program->locations[i];
+                    if (field_is_zero(ir_constant_value(program, instr->src1))) {
+                        compile_error(ctx, STAGE_OPTIMIZER, loc->line, loc->column, "Assertion always fails");
+                    }
+                    TRACE(ctx, "Removing assertion at line %d, column %d that always holds", loc->line, loc->column);
+                    remove[i] = 1;
+                    removed++;
                 }
-                next = next->next;
+                break;
+            default:
+                break; // Inputs are atoms
+        }
+        if (!linear) continue;
+
+        rewritten += rewrite_to_form(&cs, i, &result);
+        LinearForm* form = (LinearForm*)arena_alloc(&cs.work, sizeof(LinearForm) + sizeof(FormTerm) * result.count);
+        form->constant = result.constant;
+        form->count = result.count;
+        form->terms = (FormTerm*)(form + 1);
+        memcpy(form->terms, result.terms, sizeof(FormTerm) * result.count);
+        cs.forms[i] = form;
+    }
+
+    if (removed) {
+        ir_remove_instructions(program, remove, (ValueId*)arena_alloc(&cs.work, sizeof(ValueId) * count));
+    }
+    context_pop_cleanup(ctx, &cleanup);
+    arena_free(&cs.work);
+    program->uses_valid = 0;
+    return rewritten + removed;
+}
+
+// Helper to give a copied value the copy's variable name, so the variable
+// keeps a name once the copy is gone
+static inline void inherit_name(IRProgram* program, ValueId source, Symbol name) {
+    if (name != SYMBOL_NONE && !ir_is_const(source) && program->instrs[source].name == SYMBOL_NONE) {
+        program->instrs[source].name = name;
+    }
+}
+
+// Helper to point an operand past removed copies
+static inline void resolve_alias(ValueId* operand, const ValueId* alias) {
+    if (*operand != IR_NO_VALUE && !ir_is_const(*operand) && alias[*operand] != IR_NO_VALUE) {
+        *operand = alias[*operand];
+    }
+}
+
+// Removes copies: every use of a copy is rewritten to use what it copies
+// (a value or a constant), and a copied temporary takes over the copy's
+// variable name. Besides shrinking the IR this lets the constraint compiler
+// see that an equality is only asserted (e = a == b; assert(e)), which
+// costs one constraint instead of three. Returns the number of copies
+// removed.
+static uint32_t eliminate_copies(CompilerContext* ctx, IRProgram* program) {
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    Arena work;
+    arena_init(&work, 0);
+    ValueId* alias = (ValueId*)arena_alloc(&work, sizeof(ValueId) * count);
+    uint8_t* remove = (uint8_t*)arena_calloc(&work, count, sizeof(uint8_t));
+    uint32_t removed = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* instr = &program->instrs[i];
+        resolve_alias(&instr->src1, alias);
+        resolve_alias(&instr->src2, alias);
+        alias[i] = IR_NO_VALUE;
+        if (instr->op != IR_OP_ASSIGN) continue;
+        inherit_name(program, instr->src1, instr->name);
+        alias[i] = instr->src1;
+        remove[i] = 1;
+        removed++;
+    }
+
+    if (removed) {
+        ir_remove_instructions(program, remove, alias);
+    }
+    arena_free(&work);
+    program->uses_valid = 0;
+    return removed;
+}
+
+// Helper to test whether v is an unnamed value used once, computed as a
+// non-constant value times a constant
+static int is_scaled(const IRProgram* program, const uint32_t* use_count, ValueId v, ValueId* base, ValueId* k) {
+    if (ir_is_const(v) || use_count[v] != 1) return 0;
+    const IRInstruction* instr = &program->instrs[v];
+    if (instr->op != IR_OP_MUL || instr->name != SYMBOL_NONE) return 0;
+    if (ir_is_const(instr->src2) && !ir_is_const(instr->src1)) {
+        *base = instr->src1;
+        *k = instr->src2;
+        return 1;
+    }
+    if (ir_is_const(instr->src1) && !ir_is_const(instr->src2)) {
+        *base = instr->src2;
+        *k = instr->src1;
+        return 1;
+    }
+    return 0;
+}
+
+// Folds multiplications by constants into a single coefficient: divisions
+// by constants become multiplications by the inverse, nested scalings
+// merge ((x * 3) * 5 into x * 15), and constant factors are pulled out of
+// products ((3 * x) * (5 * y) into (x * y) * 15), so equal products differ
+// only in a coefficient the constraint compiler absorbs for free.
+// Returns the number of instructions rewritten.
+static uint32_t fold_constant_multiplications(CompilerContext* ctx, IRProgram* program) {
+    const Field* field = ctx->field;
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    Arena work;
+    arena_init(&work, 0);
+    uint32_t* use_count = (uint32_t*)arena_calloc(&work, count, sizeof(uint32_t));
+    ValueId* alias = (ValueId*)arena_alloc(&work, sizeof(ValueId) * count);
+    uint8_t* remove = (uint8_t*)arena_calloc(&work, count, sizeof(uint8_t));
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (instr->src1 != IR_NO_VALUE && !ir_is_const(instr->src1)) use_count[instr->src1]++;
+        if (instr->src2 != IR_NO_VALUE && !ir_is_const(instr->src2)) use_count[instr->src2]++;
+    }
+    uint32_t rewritten = 0, removed = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* instr = &program->instrs[i];
+        resolve_alias(&instr->src1, alias);
+        resolve_alias(&instr->src2, alias);
+        alias[i] = IR_NO_VALUE;
+
+        if (instr->op == IR_OP_DIV && ir_is_const(instr->src2) && !ir_is_const(instr->src1)) {
+            FieldElement inverse;
+            if (!field_inv(field, &inverse, ir_constant_value(program, instr->src2))) continue; // Reported by the backend
+            instr->op = IR_OP_MUL;
+            instr->src2 = ir_add_constant(ctx, program, &inverse);
+            rewritten++;
+        }
+        if (instr->op != IR_OP_MUL) continue;
+
+        ValueId base1, base2, k1, k2;
+        FieldElement scale;
+        if (ir_is_const(instr->src1) != ir_is_const(instr->src2)) {
+            // x * k where x = y * k2: y * (k * k2)
+            ValueId x = ir_is_const(instr->src1) ? instr->src2 : instr->src1;
+            ValueId k = ir_is_const(instr->src1) ? instr->src1 : instr->src2;
+            if (!is_scaled(program, use_count, x, &base1, &k1)) continue;
+            field_mul(field, &scale, ir_constant_value(program, k), ir_constant_value(program, k1));
+            instr->src1 = base1;
+            remove[x] = 1;
+            removed++;
+        } else if (!ir_is_const(instr->src1)) {
+            ValueId x = instr->src1, y = instr->src2;
+            int scaled1 = is_scaled(program, use_count, x, &base1, &k1);
+            int scaled2 = x != y && is_scaled(program, use_count, y, &base2, &k2);
+            if (scaled1 && scaled2) {
+                // (x' * k1) * (y' * k2): the later of the two becomes x' * y'
+                ValueId late = x > y ? x : y, early = x > y ? y : x;
+                IRInstruction* product = &program->instrs[late];
+                product->src1 = base1;
+                product->src2 = base2;
+                field_mul(field, &scale, ir_constant_value(program, k1), ir_constant_value(program, k2));
+                instr->src1 = late;
+                remove[early] = 1;
+                removed++;
+            } else if ((scaled1 && y < x) || (scaled2 && x < y)) {
+                // (x' * k) * y, with y available where x' * k was computed
+                ValueId scaled = scaled1 ? x : y, other = scaled1 ? y : x;
+                IRInstruction* product = &program->instrs[scaled];
+                product->src1 = scaled1 ? base1 : base2;
+                product->src2 = other;
+                scale = *ir_constant_value(program, scaled1 ? k1 : k2);
+                instr->src1 = scaled;
+            } else {
+                continue;
             }
+        } else {
+            continue;
+        }
+
+        rewritten++;
+        if (field_equal(&scale, &field->one)) {
+            // The factors cancelled: this is now a copy, whose users
+            // become users of what it copies
+            inherit_name(program, instr->src1, instr->name);
+            use_count[instr->src1] += use_count[i] - 1;
+            alias[i] = instr->src1;
+            remove[i] = 1;
+            removed++;
+        } else {
+            instr->src2 = ir_add_constant(ctx, program, &scale);
+        }
+        const IRLocation* loc = &program->locations[i];
+        TRACE(ctx, "Folding constant factors into one coefficient at line %d, column %d", loc->line, loc->column);
+    }
+
+    if (removed) {
+        ir_remove_instructions(program, remove, alias);
+    }
+    arena_free(&work);
+    program->uses_valid = 0;
+    return rewritten;
+}
+
+// Global value numbering: a forward walk that maps every pure computation
+// to the first value computing it, after rewriting operands to those first
+// values. Finds what hash-consing during generation cannot, since
+// propagation and folding make new computations equal ((3 * a) * (5 * b)
+// becomes the same product as a * b). Returns the number of duplicates
+// removed.
+static uint32_t number_values(CompilerContext* ctx, IRProgram* program) {
+    uint32_t count = program->count;
+    if (count == 0) return 0;
+    Arena work;
+    arena_init(&work, 0);
+    ValueTable table;
+    value_table_init(&table, &work);
+    ValueId* alias = (ValueId*)arena_alloc(&work, sizeof(ValueId) * count);
+    uint8_t* remove = (uint8_t*)arena_calloc(&work, count, sizeof(uint8_t));
+    uint32_t removed = 0;
+
+    for (uint32_t i = 0; i < count; i++) {
+        IRInstruction* instr = &program->instrs[i];
+        resolve_alias(&instr->src1, alias);
+        resolve_alias(&instr->src2, alias);
+        alias[i] = IR_NO_VALUE;
+        if (!ir_is_pure(instr)) continue;
+        ValueId first = value_table_find_or_add(&table, program, i);
+        if (first == i) continue;
+        const IRLocation* loc = &program->locations[i];
+        TRACE(ctx, "Reusing the value from line %d, column %d at line %d, column %d",
+              program->locations[first].line, program->locations[first].column, loc->line, loc->column);
+        inherit_name(program, first, instr->name);
+        alias[i] = first;
+        remove[i] = 1;
+        removed++;
+    }
+
+    if (removed) {
+        ir_remove_instructions(program, remove, alias);
+    }
+    arena_free(&work);
+    program->uses_valid = 0;
+    return removed;
+}
+
+// Estimate the constraints of a program, instruction by instruction
+uint32_t ir_estimate_constraints(const IRProgram* program) {
+    uint32_t count = program->count, constraints = 0;
+    if (count == 0) return 0;
+    // Number of users of each value, and its last user
+    uint32_t* use_count = (uint32_t*)calloc(count, sizeof(uint32_t));
+    ValueId* last_user = (ValueId*)malloc(sizeof(ValueId) * count);
+    if (!use_count || !last_user) {
+        fprintf(stderr, "Error: Memory allocation failed for constraint estimate.\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        if (instr->src1 != IR_NO_VALUE && !ir_is_const(instr->src1)) {
+            use_count[instr->src1]++;
+            last_user[instr->src1] = i;
         }
+        if (instr->src2 != IR_NO_VALUE && !ir_is_const(instr->src2) && instr->src2 != instr->src1) {
+            use_count[instr->src2]++;
+            last_user[instr->src2] = i;
+        }
+    }
 
-        current = current->next;
+    for (uint32_t i = 0; i < count; i++) {
+        const IRInstruction* instr = &program->instrs[i];
+        int constant1 = ir_is_const(instr->src1), constant2 = ir_is_const(instr->src2);
+        switch (instr->op) {
+            case IR_OP_MUL:
+                constraints += !constant1 && !constant2;
+                break;
+            case IR_OP_DIV:
+                constraints += !constant2;
+                break;
+            case IR_OP_EQ:
+                if (constant1 && constant2) break;
+                // An equality only asserted is covered by its assertion
+                if (use_count[i] == 1 && program->instrs[last_user[i]].op == IR_OP_ASSERT) break;
+                constraints += 2;
+                break;
+            case IR_OP_ASSERT:
+                constraints += !constant1;
+                break;
+            case IR_OP_OUTPUT:
+                constraints++;
+                break;
+            default:
+                break;
+        }
     }
+    free(use_count);
+    free(last_user);
+    return constraints;
+}
+
+// An optimization pass: rewrites a program, returning how many
+// instructions it rewrote, folded or removed
+typedef uint32_t (*OptimizerPass)(CompilerContext* ctx, IRProgram* program);
+
+// Passes in the order they run. Dead code goes first, while every
+// variable still has its own instruction to report it by. Linear chains
+// are merged before copies are eliminated so the copies they leave behind
+// are removed with the others, constant factors are folded once copies no
+// longer hide single-use values, and values are numbered last to catch
+// the duplicates the other passes expose. The whole sequence runs again
+// when one of the last two changed something, as their rewrites can leave
+// new work for the earlier passes.
+static const struct {
+    const char* name;
+    OptimizerPass run;
+    int exposes;        // Changes by this pass call for another round
+} passes[] = {
+    {"dead-code", eliminate_dead_code, 0},
+    {"constant-propagation", constant_propagation, 0},
+    {"linear-chains", merge_linear_chains, 0},
+    {"copy-elimination", eliminate_copies, 0},
+    {"constant-multiplication", fold_constant_multiplications, 1},
+    {"value-numbering", number_values, 1},
+};
 
-    return ir;
+// Index of the dead-code pass, run once more after the last round
+#define DEAD_CODE_PASS 0
+
+_Static_assert(sizeof(passes) / sizeof(passes[0]) <= OPTIMIZER_MAX_PASSES && OPTIMIZER_MAX_PASSES <= STATS_MAX_PASSES,
+               "every pass needs a slot in the report and the statistics");
+
+// Helper to run pass p, adding its effect to the report. constraints holds
+// the estimate before the pass and receives the one after it.
+static uint32_t run_pass(CompilerContext* ctx, IRProgram* program, OptimizerReport* report, int p, int round,
+                         int estimate, uint32_t* constraints) {
+    PassReport* pass = &report->passes[p];
+    uint32_t instructions = program->count;
+    double start = ctx->stats ? stats_now() : 0;
+    uint32_t rewritten = passes[p].run(ctx, program);
+    if (ctx->stats) stats_add_pass(ctx->stats, p, passes[p].name, stats_now() - start);
+    uint32_t after = estimate ? ir_estimate_constraints(program) : 0;
+    pass->name = passes[p].name;
+    pass->rewritten += rewritten;
+    pass->instructions_removed += instructions - program->count;
+    pass->constraints_saved += (int32_t)(*constraints - after);
+    TRACE(ctx, "Pass %s (round %d): %u rewritten, %u instructions removed, %d constraints saved", pass->name,
+          round, rewritten, instructions - program->count, (int32_t)(*constraints - after));
+    *constraints = after;
+    return rewritten;
 }
 
+// Run every pass, measuring each one's effect
+IRProgram* optimize_ir_report(CompilerContext* ctx, IRProgram* program, OptimizerReport* report) {
+    // Estimates cost a walk over the program per pass; skip them when
+    // nobody is looking
+    OptimizerReport local;
+    PhaseTimer timer;
+    PHASE_BEGIN(ctx, &timer);
+    int estimate = report || ctx->trace;
+    if (!report) report = &local;
+    memset(report, 0, sizeof(OptimizerReport));
+    report->instructions_before = program->count;
+    report->hash_consed = program->hash_consed;
+    uint32_t variables_removed = program->variables_removed;
+    report->constraints_before = estimate ? ir_estimate_constraints(program) : 0;
 
+    uint32_t constraints = report->constraints_before;
+    report->pass_count = (int)(sizeof(passes) / sizeof(passes[0]));
+    int round = 1;
+    for (; round <= OPTIMIZER_MAX_ROUNDS; round++) {
+        int exposed = 0;
+        for (int p = 0; p < report->pass_count; p++) {
+            uint32_t rewritten = run_pass(ctx, program, report, p, round, estimate, &constraints);
+            if (passes[p].exposes && rewritten) exposed = 1;
+        }
+        if (!exposed) break;
+    }
+    // Folding can leave values behind that only fed an assertion found to
+    // always hold, or a duplicate that was merged away
+    run_pass(ctx, program, report, DEAD_CODE_PASS, round, estimate, &constraints);
+    report->variables_removed = program->variables_removed - variables_removed;
+    report->instructions_after = program->count;
+    report->constraints_after = constraints;
+    STATS_COUNT(ctx, ir_optimized, program->count);
+    PHASE_END(ctx, PHASE_OPTIMIZE, &timer);
+    return program;
+}
 
 // Main optimization function
-IRInstruction* optimize_ir(IRInstruction* ir) {
-    return constant_folding(ir);
+IRProgram* optimize_ir(CompilerContext* ctx, IRProgram* program) {
+    return optimize_ir_report(ctx, program, NULL);
+}
+
+// Print per-pass results
+void print_optimizer_report(const OptimizerReport* report) {
+    printf("Instructions: %u -> %u (%u expressions shared during generation)\n", report->instructions_before,
+           report->instructions_after, report->hash_consed);
+    printf("Estimated constraints: %u -> %u\n", report->constraints_before, report->constraints_after);
+    printf("Unread variables removed: %u\n", report->variables_removed);
+    for (int p = 0; p < report->pass_count; p++) {
+        const PassReport* pass = &report->passes[p];
+        printf("  %-24s %8u rewritten %8u removed %8d constraints saved\n", pass->name, pass->rewritten,
+               pass->instructions_removed, pass->constraints_saved);
+    }
 }
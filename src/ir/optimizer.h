@@ -3,12 +3,77 @@
 
 #include "ir_generator.h"
 
+// Most passes optimize_ir can run
+#define OPTIMIZER_MAX_PASSES 8
+
+// Most times optimize_ir runs its passes over a program
+#define OPTIMIZER_MAX_ROUNDS 3
+
+// What one optimization pass achieved, summed over all rounds
+typedef struct {
+    const char* name;                 // Pass name, e.g. "copy-elimination"
+    uint32_t instructions_removed;    // Net change in instruction count
+    uint32_t rewritten;               // Instructions the pass rewrote or folded
+    int32_t constraints_saved;        // Change in ir_estimate_constraints
+} PassReport;
+
+// Per-pass results of optimize_ir, for tracking a circuit's cost over time
+typedef struct {
+    PassReport passes[OPTIMIZER_MAX_PASSES];
+    int pass_count;
+    uint32_t instructions_before;
+    uint32_t instructions_after;
+    uint32_t hash_consed;             // Expressions generate_ir already shared
+    uint32_t variables_removed;       // Variables removed as dead code (nothing reads them)
+    uint32_t constraints_before;      // Estimated, see ir_estimate_constraints
+    uint32_t constraints_after;
+} OptimizerReport;
+
+// Function prototypes
+
 /**
  * Optimizes the given IR instructions.
- * 
- * @param ir The head of the IR instruction list.
- * @return The head of the optimized IR instruction list.
+ *
+ * @param ctx The compilation context the IR belongs to.
+ * @param program The program to optimize in place.
+ * @return The optimized program.
+ */
+IRProgram* optimize_ir(CompilerContext* ctx, IRProgram* program);
+
+/**
+ * Optimizes the given IR instructions, recording what each pass achieved.
+ * The passes run in rounds, up to OPTIMIZER_MAX_ROUNDS, until a round
+ * exposes no new work, and dead code is swept once more at the end.
+ * Everything that no assertion or output depends on is removed. Each
+ * pass's summary, and each variable removed as dead, is also sent to the
+ * context's trace sink.
+ *
+ * @param ctx The compilation context the IR belongs to.
+ * @param program The program to optimize in place.
+ * @param report Receives the per-pass results (may be NULL).
+ * @return The optimized program.
+ */
+IRProgram* optimize_ir_report(CompilerContext* ctx, IRProgram* program, OptimizerReport* report);
+
+/**
+ * Estimates the multiplication constraints a program costs, counting each
+ * instruction on its own: a product or division of two non-constant
+ * values costs one, an equality used as a value two, and an assertion one
+ * (covering the equality it tests, if that is its only use). Linear
+ * operations and operations on constants are free. The constraint
+ * compiler can only do better, by also folding linear combinations that
+ * happen to be constant.
+ *
+ * @param program The program.
+ * @return The estimated number of constraints.
+ */
+uint32_t ir_estimate_constraints(const IRProgram* program);
+
+/**
+ * Prints the per-pass results of optimize_ir_report.
+ *
+ * @param report The report.
  */
-IRInstruction* optimize_ir(IRInstruction* ir);
+void print_optimizer_report(const OptimizerReport* report);
 
 #endif // OPTIMIZER_H
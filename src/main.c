@@ -1,6 +1,311 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include "driver/batch.h"
+#include "backend/circuit_file.h"
+#include "backend/constraint_checker.h"
 
-int main() {
-    printf("Welcome to ZKL Compiler!\n");
-    return 0;
+// Compiles .zkl files, or directories of them, to circuit files in
+// parallel, or checks witnesses against a compiled circuit.
+//
+// Usage: zkl [-j threads] [-o output-dir] [--incremental] [--verifier] [--stats[=json]] [-v] <file.zkl | dir>...
+//        zkl check [-j threads] <circuit.zklc> <witness>...
+
+// Violations listed per witness by zkl check
+#define CHECK_REPORTED 10
+
+// How --stats reports
+typedef enum {
+    STATS_OFF,
+    STATS_TEXT,
+    STATS_JSON
+} StatsFormat;
+
+// Helper to print the usage message
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options] <file.zkl | directory>...\n"
+            "       %s check [-j N] <circuit" CIRCUIT_EXTENSION "> <witness>...\n"
+            "Compiles each source file to a circuit file (" CIRCUIT_EXTENSION "), or checks that\n"
+            "each witness satisfies a circuit's constraints.\n"
+            "  -j N            Compile or check on N threads (default: one per CPU)\n"
+            "  -o DIR          Write circuit files to DIR (default: next to each source)\n"
+            "  --incremental   Reuse unchanged statements through a " CACHE_EXTENSION
+            " file next to each circuit\n"
+            "  --verifier      Also write a Groth16 verifier, NAME" VERIFIER_SUFFIX ", next to each circuit\n"
+            "  --stats         Report the time and memory each phase took, and what it produced\n"
+            "  --stats=json    The same for every file, as JSON on standard output\n"
+            "  -v              Report every file\n",
+            program, program);
+}
+
+// Helper to order strings with strcmp for qsort
+static int compare_paths(const void* a, const void* b) {
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+// Helper to print a string as a JSON string
+static void print_json_string(const char* text) {
+    putchar('"');
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            printf("\\%c", *p);
+        } else if (*p < 0x20) {
+            printf("\\u%04x", *p);
+        } else {
+            putchar(*p);
+        }
+    }
+    putchar('"');
+}
+
+// Helper to report a batch's statistics as JSON: each file's, then their sum
+static void print_json_report(const BatchFile* files, uint32_t count, const BatchSummary* summary, long peak_rss) {
+    printf("{\n  \"files\": [");
+    for (uint32_t i = 0; i < count; i++) {
+        const BatchFile* file = &files[i];
+        printf("%s\n    {\n      \"source\": ", i ? "," : "");
+        print_json_string(file->source);
+        printf(",\n      \"circuit\": ");
+        print_json_string(file->circuit);
+        printf(",\n      \"status\": \"%s\",\n      \"seconds\": %.9f,\n      \"stats\": ",
+               file->status == 0 ? "ok" : file->status > 0 ? "error" : "write-error", file->seconds);
+        print_stats_json(stdout, &file->compile_stats, 6);
+        printf("\n    }");
+    }
+    printf("%s],\n  \"summary\": {\n", count ? "\n  " : "");
+    printf("    \"files\": %u,\n    \"failed\": %u,\n    \"threads\": %d,\n", summary->files, summary->failed,
+           summary->threads);
+    printf("    \"seconds\": %.9f,\n    \"busy_seconds\": %.9f,\n    \"peak_rss_bytes\": %ld,\n    \"stats\": ",
+           summary->seconds, summary->busy_seconds, peak_rss);
+    print_stats_json(stdout, &summary->compile_stats, 4);
+    printf("\n  }\n}\n");
+}
+
+// Helper to parse the argument of -j; returns -1 (after printing why) if invalid
+static int parse_threads(const char* value) {
+    char* end;
+    long threads = value ? strtol(value, &end, 10) : -1;
+    if (!value || *end || threads < 0 || threads > 1024) {
+        fprintf(stderr, "Error: -j takes a thread count from 0 to 1024.\n");
+        return -1;
+    }
+    return (int)threads;
+}
+
+// Helper to run zkl check: argv holds the arguments after "check". Returns
+// the exit status: 0 if every witness satisfies the circuit.
+static int run_check(const char* program, int argc, char** argv) {
+    int threads = 0;
+    const char* circuit_path = NULL;
+    const char** witness_paths = (const char**)malloc(sizeof(char*) * (argc ? argc : 1));
+    int witness_count = 0;
+    if (!witness_paths) {
+        fprintf(stderr, "Error: Memory allocation failed for file names.\n");
+        exit(1);
+    }
+    for (int i = 0; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "-j", 2) == 0) {
+            threads = parse_threads(arg[2] ? arg + 2 : (i + 1 < argc ? argv[++i] : NULL));
+            if (threads < 0) break;
+        } else if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(program);
+            free(witness_paths);
+            return 0;
+        } else if (arg[0] == '-' && arg[1]) {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", arg);
+            threads = -1;
+            break;
+        } else if (!circuit_path) {
+            circuit_path = arg;
+        } else {
+            witness_paths[witness_count++] = arg;
+        }
+    }
+    if (threads < 0 || witness_count == 0) {
+        if (threads >= 0) {
+            fprintf(stderr, "Error: %s.\n", circuit_path ? "No witness files given" : "No circuit file given");
+        }
+        usage(program);
+        free(witness_paths);
+        return 1;
+    }
+
+    Circuit* circuit = load_circuit(circuit_path);
+    if (!circuit || !circuit_validate(circuit, circuit_path)) {
+        free_circuit(circuit);
+        free(witness_paths);
+        return 1;
+    }
+    const R1CS* r1cs = &circuit->r1cs;
+    ThreadPool* pool = thread_pool_create(threads);
+    ConstraintViolation violations[CHECK_REPORTED];
+    int failed = 0;
+    for (int w = 0; w < witness_count; w++) {
+        const char* path = witness_paths[w];
+        Witness* witness = load_witness(path);
+        if (!witness) {
+            failed++;
+            continue;
+        }
+        if (witness->field != circuit->field || witness->variable_count != r1cs->variable_count) {
+            fprintf(stderr, "Error: Witness '%s' has %u %s values; the circuit needs %u %s values.\n", path,
+                    witness->variable_count, witness->field->name, r1cs->variable_count, circuit->field->name);
+            free_witness(witness);
+            failed++;
+            continue;
+        }
+        if (r1cs->variable_count > 0 && !field_equal(&witness->values[0], &circuit->field->one)) {
+            fprintf(stderr, "Warning: Witness '%s' does not start with the constant 1.\n", path);
+        }
+
+        uint32_t violated = check_constraints(circuit->field, r1cs, pool, witness->values, violations,
+                                              CHECK_REPORTED);
+        if (violated == 0) {
+            printf("%s: OK, %u constraints satisfied\n", path, r1cs->constraint_count);
+        } else {
+            printf("%s: %u of %u constraints violated\n", path, violated, r1cs->constraint_count);
+            for (uint32_t i = 0; i < violated && i < CHECK_REPORTED; i++) {
+                const IRLocation* location = &r1cs->locations[violations[i].constraint];
+                printf("  constraint %u at line %d, column %d\n", violations[i].constraint, location->line,
+                       location->column);
+            }
+            if (violated > CHECK_REPORTED) printf("  ... and %u more\n", violated - CHECK_REPORTED);
+            failed++;
+        }
+        free_witness(witness);
+    }
+
+    thread_pool_destroy(pool);
+    free_circuit(circuit);
+    free(witness_paths);
+    return failed ? 1 : 0;
+}
+
+// Helper to check that no two sources write the same circuit file
+static int check_distinct(const BatchFile* files, uint32_t count) {
+    const char** paths = (const char**)malloc(sizeof(char*) * (count ? count : 1));
+    if (!paths) {
+        fprintf(stderr, "Error: Memory allocation failed for file names.\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < count; i++) paths[i] = files[i].circuit;
+    qsort(paths, count, sizeof(char*), compare_paths);
+    int distinct = 1;
+    for (uint32_t i = 1; i < count; i++) {
+        if (strcmp(paths[i - 1], paths[i]) == 0) {
+            fprintf(stderr, "Error: More than one source compiles to '%s'.\n", paths[i]);
+            distinct = 0;
+        }
+    }
+    free(paths);
+    return distinct;
+}
+
+int main(int argc, char** argv) {
+    BatchOptions options = {0, 0, NULL};
+    const char* output_dir = NULL;
+    int verbose = 0;
+    StatsFormat stats = STATS_OFF;
+    char** sources = NULL;
+    uint32_t count = 0;
+
+    if (argc > 1 && strcmp(argv[1], "check") == 0) return run_check(argv[0], argc - 2, argv + 2);
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strncmp(arg, "-j", 2) == 0) {
+            options.threads = parse_threads(arg[2] ? arg + 2 : (i + 1 < argc ? argv[++i] : NULL));
+            if (options.threads < 0) return 1;
+        } else if (strcmp(arg, "-o") == 0) {
+            if (i + 1 == argc) {
+                usage(argv[0]);
+                return 1;
+            }
+            output_dir = argv[++i];
+        } else if (strcmp(arg, "--incremental") == 0) {
+            options.incremental = 1;
+        } else if (strcmp(arg, "--verifier") == 0) {
+            options.verifier = 1;
+        } else if (strcmp(arg, "--stats") == 0 || strcmp(arg, "--stats=text") == 0) {
+            stats = STATS_TEXT;
+        } else if (strcmp(arg, "--stats=json") == 0) {
+            stats = STATS_JSON;
+        } else if (strcmp(arg, "-v") == 0) {
+            verbose = 1;
+        } else if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            usage(argv[0]);
+            return 0;
+        } else if (arg[0] == '-' && arg[1]) {
+            fprintf(stderr, "Error: Unknown option '%s'.\n", arg);
+            usage(argv[0]);
+            return 1;
+        } else if (batch_add_sources(&sources, &count, arg) != 0) {
+            perror(arg);
+            return 1;
+        }
+    }
+    if (count == 0) {
+        fprintf(stderr, "Error: No source files given.\n");
+        usage(argv[0]);
+        return 1;
+    }
+
+    BatchFile* files = (BatchFile*)calloc(count, sizeof(BatchFile));
+    if (!files) {
+        fprintf(stderr, "Error: Memory allocation failed for %u files.\n", count);
+        return 1;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        files[i].source = sources[i];
+        files[i].circuit = batch_circuit_path(sources[i], output_dir);
+    }
+    if (!check_distinct(files, count)) return 1;
+    options.collect_stats = stats != STATS_OFF;
+
+    BatchSummary summary;
+    compile_batch(&options, files, count, &summary);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const BatchFile* file = &files[i];
+        if (file->status > 0) {
+            fprintf(stderr, "%s\n", file->diagnostic ? file->diagnostic : "Error: Out of memory.");
+        } else if (file->status < 0) {
+            fprintf(stderr, "Error: Could not write '%s'%s: %s.\n", file->circuit,
+                    options.verifier ? " or its verifier" : "", strerror(file->error));
+        } else if (verbose && stats != STATS_JSON) {
+            printf("%s -> %s: %u constraints, %u variables, %.3f s", file->source, file->circuit,
+                   file->constraints, file->variables, file->seconds);
+            if (options.incremental) {
+                printf("; %u of %u statements reused", file->stats.reused, file->stats.statements);
+            }
+            printf("\n");
+        }
+    }
+    // Linux reports the peak resident set in KiB
+    struct rusage usage;
+    long peak_rss = getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss * 1024L : 0;
+    if (stats == STATS_JSON) {
+        print_json_report(files, count, &summary, peak_rss);
+    } else {
+        printf("Compiled %u files (%.1f KiB, %llu constraints) in %.3f s on %d threads; "
+               "%.3f s of compilation (%.2fx)\n",
+               summary.files - summary.failed, summary.source_bytes / 1024.0,
+               (unsigned long long)summary.constraints, summary.seconds, summary.threads, summary.busy_seconds,
+               summary.seconds > 0 ? summary.busy_seconds / summary.seconds : 1.0);
+    }
+    if (stats == STATS_TEXT) {
+        print_stats(stdout, &summary.compile_stats);
+        printf("%-26s %10ld\n", "peak_rss_bytes", peak_rss);
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        free(sources[i]);
+        free((char*)files[i].circuit);
+        free(files[i].diagnostic);
+    }
+    free(sources);
+    free(files);
+    return summary.failed ? 1 : 0;
 }
@@ -0,0 +1,159 @@
+#include <string.h>
+#include "curve.h"
+
+// All coordinates are in BN254's base field
+#define FQ (&FIELD_BN254_BASE)
+
+const G1Affine G1_GENERATOR = {
+    {{0xd35d438dc58f0d9dull, 0x0a78eb28f5c70b3dull, 0x666ea36f7879462cull, 0x0e0a77c19a07df2full}}, // 1
+    {{0xa6ba871b8b1e1b3aull, 0x14f1d651eb8e167bull, 0xccdd46def0f28c58ull, 0x1c14ef83340fbe5eull}}  // 2
+};
+
+const G2Affine G2_GENERATOR = {
+    {{{0x8e83b5d102bc2026ull, 0xdceb1935497b0172ull, 0xfbb8264797811adfull, 0x19573841af96503bull}},
+     {{0xafb4737da84c6140ull, 0x6043dd5a5802d8c4ull, 0x09e950fc52a02f86ull, 0x14fef0833aea7b6bull}}},
+    {{{0x619dfa9d886be9f6ull, 0xfe7fd297f59e9b78ull, 0xff9e1a62231b7dfeull, 0x28fd7eebae9e4206ull}},
+     {{0x64095b56c71856eeull, 0xdc57f922327d3cbbull, 0x55f935be33351076ull, 0x0da4a0e693fd6482ull}}}
+};
+
+// b = 3 for G1
+static const FieldElement G1_B = {
+    {0x7a17caa950ad28d7ull, 0x1f6ac17ae15521b9ull, 0x334bea4e696bd284ull, 0x2a1f6744ce179d8eull}
+};
+
+// b' = 3 / (9 + u) for G2
+const Fq2 G2_B = {
+    {{0x3bf938e377b802a8ull, 0x020b1b273633535dull, 0x26b7edf049755260ull, 0x2514c6324384a86dull}},
+    {{0x38e7ecccd1dcff67ull, 0x65f0b37d93ce0d3eull, 0xd749d0dd22ac00aaull, 0x0141b9ce4a688d4dull}}
+};
+
+// 1 in Fq2
+static const Fq2 FQ2_ONE = {
+    {{0xd35d438dc58f0d9dull, 0x0a78eb28f5c70b3dull, 0x666ea36f7879462cull, 0x0e0a77c19a07df2full}},
+    {{0, 0, 0, 0}}
+};
+
+// Helpers to apply base field operations without naming the field
+static inline void fq_add(FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    field_add(FQ, out, a, b);
+}
+static inline void fq_sub(FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    field_sub(FQ, out, a, b);
+}
+static inline void fq_neg(FieldElement* out, const FieldElement* a) {
+    field_neg(FQ, out, a);
+}
+static inline void fq_mul(FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    field_mul(FQ, out, a, b);
+}
+static inline void fq_sqr(FieldElement* out, const FieldElement* a) {
+    field_sqr(FQ, out, a);
+}
+static inline int fq_inv(FieldElement* out, const FieldElement* a) {
+    return field_inv(FQ, out, a);
+}
+
+void fq2_add(Fq2* out, const Fq2* a, const Fq2* b) {
+    fq_add(&out->c0, &a->c0, &b->c0);
+    fq_add(&out->c1, &a->c1, &b->c1);
+}
+
+void fq2_sub(Fq2* out, const Fq2* a, const Fq2* b) {
+    fq_sub(&out->c0, &a->c0, &b->c0);
+    fq_sub(&out->c1, &a->c1, &b->c1);
+}
+
+void fq2_neg(Fq2* out, const Fq2* a) {
+    fq_neg(&out->c0, &a->c0);
+    fq_neg(&out->c1, &a->c1);
+}
+
+// Karatsuba: (a0 + a1 u)(b0 + b1 u) = (a0 b0 - a1 b1) + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) u
+void fq2_mul(Fq2* out, const Fq2* a, const Fq2* b) {
+    FieldElement t0, t1, s0, s1;
+    fq_mul(&t0, &a->c0, &b->c0);
+    fq_mul(&t1, &a->c1, &b->c1);
+    fq_add(&s0, &a->c0, &a->c1);
+    fq_add(&s1, &b->c0, &b->c1);
+    fq_mul(&s0, &s0, &s1);
+    fq_sub(&s0, &s0, &t0);
+    fq_sub(&out->c1, &s0, &t1);
+    fq_sub(&out->c0, &t0, &t1);
+}
+
+// (a0 + a1 u)^2 = (a0 + a1)(a0 - a1) + 2 a0 a1 u
+void fq2_sqr(Fq2* out, const Fq2* a) {
+    FieldElement sum, difference, product;
+    fq_add(&sum, &a->c0, &a->c1);
+    fq_sub(&difference, &a->c0, &a->c1);
+    fq_mul(&product, &a->c0, &a->c1);
+    fq_mul(&out->c0, &sum, &difference);
+    fq_add(&out->c1, &product, &product);
+}
+
+// 1 / (a0 + a1 u) = (a0 - a1 u) / (a0^2 + a1^2)
+int fq2_inv(Fq2* out, const Fq2* a) {
+    FieldElement norm, t;
+    fq_sqr(&norm, &a->c0);
+    fq_sqr(&t, &a->c1);
+    fq_add(&norm, &norm, &t);
+    if (!fq_inv(&norm, &norm)) return 0;
+    fq_mul(&out->c0, &a->c0, &norm);
+    fq_mul(&t, &a->c1, &norm);
+    fq_neg(&out->c1, &t);
+    return 1;
+}
+
+// G1, over Fq
+#define GROUP(name) g1_##name
+#define GROUP_NAME "g1"
+#define GROUP_TABLE CURVE_G1
+#define AFFINE G1Affine
+#define JACOBIAN G1Jacobian
+#define COORD FieldElement
+#define COORD_ADD fq_add
+#define COORD_SUB fq_sub
+#define COORD_MUL fq_mul
+#define COORD_SQR fq_sqr
+#define COORD_NEG fq_neg
+#define COORD_INV fq_inv
+#define COORD_IS_ZERO field_is_zero
+#define COORD_EQUAL field_equal
+#define COORD_ONE (&FIELD_BN254_BASE.one)
+#define COORD_B (&G1_B)
+#include "curve_group.h"
+#undef GROUP
+#undef GROUP_NAME
+#undef GROUP_TABLE
+#undef AFFINE
+#undef JACOBIAN
+#undef COORD
+#undef COORD_ADD
+#undef COORD_SUB
+#undef COORD_MUL
+#undef COORD_SQR
+#undef COORD_NEG
+#undef COORD_INV
+#undef COORD_IS_ZERO
+#undef COORD_EQUAL
+#undef COORD_ONE
+#undef COORD_B
+
+// G2, over Fq2
+#define GROUP(name) g2_##name
+#define GROUP_NAME "g2"
+#define GROUP_TABLE CURVE_G2
+#define AFFINE G2Affine
+#define JACOBIAN G2Jacobian
+#define COORD Fq2
+#define COORD_ADD fq2_add
+#define COORD_SUB fq2_sub
+#define COORD_MUL fq2_mul
+#define COORD_SQR fq2_sqr
+#define COORD_NEG fq2_neg
+#define COORD_INV fq2_inv
+#define COORD_IS_ZERO fq2_is_zero
+#define COORD_EQUAL fq2_equal
+#define COORD_ONE (&FQ2_ONE)
+#define COORD_B (&G2_B)
+#include "curve_group.h"
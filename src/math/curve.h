@@ -0,0 +1,164 @@
+#ifndef CURVE_H
+#define CURVE_H
+
+#include "field.h"
+
+// An element c0 + c1 * u of Fq2 = Fq[u] / (u^2 + 1), the quadratic
+// extension of BN254's base field that G2 is defined over
+typedef struct {
+    FieldElement c0;
+    FieldElement c1;
+} Fq2;
+
+// Points of BN254's G1 (y^2 = x^3 + 3 over Fq) and G2 (y^2 = x^3 + b'
+// over Fq2, with b' = 3 / (9 + u)). Coordinates are in Montgomery form.
+// Affine points use (0, 0), which is on neither curve, for the point at
+// infinity. Jacobian points (X, Y, Z) stand for (X / Z^2, Y / Z^3), and
+// are at infinity when Z is zero.
+typedef struct {
+    FieldElement x, y;
+} G1Affine;
+
+typedef struct {
+    FieldElement x, y, z;
+} G1Jacobian;
+
+typedef struct {
+    Fq2 x, y;
+} G2Affine;
+
+typedef struct {
+    Fq2 x, y, z;
+} G2Jacobian;
+
+// Generators of the two groups, of prime order FIELD_BN254's modulus
+extern const G1Affine G1_GENERATOR;
+extern const G2Affine G2_GENERATOR;
+
+// The constant b' of G2's curve
+extern const Fq2 G2_B;
+
+// The operations of one group on untyped points, for code that works on
+// either group (see msm). Outputs may alias inputs.
+typedef struct {
+    const char* name;             // "g1" or "g2"
+    size_t affine_size;           // sizeof the group's affine point
+    size_t jacobian_size;         // sizeof the group's Jacobian point
+    size_t coordinate_size;       // sizeof one coordinate, for batch_add_affine's scratch
+    void (*set_infinity)(void* out);                        // Jacobian
+    void (*from_affine)(void* out, const void* p);          // Affine to Jacobian
+    void (*add)(void* out, const void* p, const void* q);   // Jacobian + Jacobian
+    void (*add_mixed)(void* out, const void* p, const void* q); // Jacobian + affine
+    void (*dbl)(void* out, const void* p);                  // Jacobian
+    void (*neg_affine)(void* out, const void* p);
+    void (*mul)(void* out, const void* p, const uint64_t scalar[FIELD_LIMBS]); // Jacobian times integer
+    void (*batch_add_affine)(void* const* sums, const void* const* terms, size_t n, void* scratch);
+} CurveGroup;
+
+extern const CurveGroup CURVE_G1;
+extern const CurveGroup CURVE_G2;
+
+// Function prototypes
+
+// Fq2 arithmetic. Outputs may alias inputs.
+void fq2_add(Fq2* out, const Fq2* a, const Fq2* b);
+void fq2_sub(Fq2* out, const Fq2* a, const Fq2* b);
+void fq2_neg(Fq2* out, const Fq2* a);
+void fq2_mul(Fq2* out, const Fq2* a, const Fq2* b);
+void fq2_sqr(Fq2* out, const Fq2* a);
+
+/**
+ * Computes the inverse of an Fq2 element.
+ *
+ * @return Non-zero on success, 0 if a is zero (out is then left unchanged).
+ */
+int fq2_inv(Fq2* out, const Fq2* a);
+
+static inline int fq2_is_zero(const Fq2* a) {
+    return field_is_zero(&a->c0) && field_is_zero(&a->c1);
+}
+
+static inline int fq2_equal(const Fq2* a, const Fq2* b) {
+    return field_equal(&a->c0, &b->c0) && field_equal(&a->c1, &b->c1);
+}
+
+// Group operations, named after the group; the G2 versions below take the
+// same arguments with G2 points. Outputs may alias inputs.
+
+/**
+ * Tests whether an affine point is on the curve (infinity counts).
+ */
+int g1_is_on_curve(const G1Affine* p);
+
+static inline int g1_is_infinity(const G1Affine* p) {
+    return field_is_zero(&p->x) && field_is_zero(&p->y);
+}
+
+void g1_set_infinity(G1Jacobian* out);
+void g1_from_affine(G1Jacobian* out, const G1Affine* p);
+
+/**
+ * Converts a Jacobian point to affine form, with one field inversion.
+ */
+void g1_to_affine(G1Affine* out, const G1Jacobian* p);
+
+/**
+ * Converts n Jacobian points to affine form with a single field inversion.
+ *
+ * @param out Receives n affine points.
+ * @param points The points to convert.
+ * @param n Number of points.
+ * @param scratch Workspace of 2 * n field elements.
+ */
+void g1_batch_to_affine(G1Affine* out, const G1Jacobian* points, size_t n, FieldElement* scratch);
+
+void g1_add(G1Jacobian* out, const G1Jacobian* p, const G1Jacobian* q);
+void g1_add_mixed(G1Jacobian* out, const G1Jacobian* p, const G1Affine* q);
+void g1_double(G1Jacobian* out, const G1Jacobian* p);
+void g1_neg_affine(G1Affine* out, const G1Affine* p);
+
+/**
+ * Tests whether two Jacobian points are the same point.
+ */
+int g1_equal(const G1Jacobian* p, const G1Jacobian* q);
+
+/**
+ * Multiplies a point by an integer by doubling and adding. Simple and
+ * slow; msm is the fast way to compute many products.
+ *
+ * @param out Receives scalar * p.
+ * @param p The point.
+ * @param scalar The integer, little-endian.
+ */
+void g1_mul(G1Jacobian* out, const G1Jacobian* p, const uint64_t scalar[FIELD_LIMBS]);
+
+/**
+ * Adds terms[k] to sums[k] in affine form for n pairs at once, sharing
+ * one field inversion. No sum may appear twice.
+ *
+ * @param sums Points updated in place.
+ * @param terms Points added to them.
+ * @param n Number of pairs.
+ * @param scratch Workspace of 2 * n field elements.
+ */
+void g1_batch_add_affine(G1Affine* const* sums, const G1Affine* const* terms, size_t n, FieldElement* scratch);
+
+int g2_is_on_curve(const G2Affine* p);
+
+static inline int g2_is_infinity(const G2Affine* p) {
+    return fq2_is_zero(&p->x) && fq2_is_zero(&p->y);
+}
+
+void g2_set_infinity(G2Jacobian* out);
+void g2_from_affine(G2Jacobian* out, const G2Affine* p);
+void g2_to_affine(G2Affine* out, const G2Jacobian* p);
+void g2_batch_to_affine(G2Affine* out, const G2Jacobian* points, size_t n, Fq2* scratch);
+void g2_add(G2Jacobian* out, const G2Jacobian* p, const G2Jacobian* q);
+void g2_add_mixed(G2Jacobian* out, const G2Jacobian* p, const G2Affine* q);
+void g2_double(G2Jacobian* out, const G2Jacobian* p);
+void g2_neg_affine(G2Affine* out, const G2Affine* p);
+int g2_equal(const G2Jacobian* p, const G2Jacobian* q);
+void g2_mul(G2Jacobian* out, const G2Jacobian* p, const uint64_t scalar[FIELD_LIMBS]);
+void g2_batch_add_affine(G2Affine* const* sums, const G2Affine* const* terms, size_t n, Fq2* scratch);
+
+#endif // CURVE_H
@@ -0,0 +1,327 @@
+// Group arithmetic shared by G1 and G2. This is not a standalone header:
+// curve.c includes it once per group, after defining
+//   GROUP(name)         the group's function name, e.g. g1_##name
+//   GROUP_NAME          its name as a string
+//   GROUP_TABLE         the CurveGroup constant to define
+//   AFFINE, JACOBIAN    its point types
+//   COORD               the coordinate type (FieldElement or Fq2)
+//   COORD_ADD, COORD_SUB, COORD_MUL, COORD_SQR, COORD_NEG, COORD_INV,
+//   COORD_IS_ZERO, COORD_EQUAL    coordinate operations
+//   COORD_ONE, COORD_B  pointers to the coordinates 1 and b
+
+// Helper to invert n coordinates in place with one inversion (Montgomery's
+// trick); zeros are left as they are
+static void GROUP(batch_inv)(COORD* a, size_t n, COORD* scratch) {
+    COORD acc = *COORD_ONE, t;
+    for (size_t i = 0; i < n; i++) {
+        scratch[i] = acc;
+        if (!COORD_IS_ZERO(&a[i])) COORD_MUL(&acc, &acc, &a[i]);
+    }
+    COORD_INV(&acc, &acc);
+    for (size_t i = n; i-- > 0;) {
+        if (COORD_IS_ZERO(&a[i])) continue;
+        COORD_MUL(&t, &acc, &scratch[i]);
+        COORD_MUL(&acc, &acc, &a[i]);
+        a[i] = t;
+    }
+}
+
+// Check y^2 = x^3 + b
+int GROUP(is_on_curve)(const AFFINE* p) {
+    if (GROUP(is_infinity)(p)) return 1;
+    COORD lhs, rhs;
+    COORD_SQR(&lhs, &p->y);
+    COORD_SQR(&rhs, &p->x);
+    COORD_MUL(&rhs, &rhs, &p->x);
+    COORD_ADD(&rhs, &rhs, COORD_B);
+    return COORD_EQUAL(&lhs, &rhs);
+}
+
+// Any point with Z = 0
+void GROUP(set_infinity)(JACOBIAN* out) {
+    memset(out, 0, sizeof(*out));
+}
+
+// (x, y) is (x, y, 1)
+void GROUP(from_affine)(JACOBIAN* out, const AFFINE* p) {
+    if (GROUP(is_infinity)(p)) {
+        GROUP(set_infinity)(out);
+        return;
+    }
+    out->x = p->x;
+    out->y = p->y;
+    out->z = *COORD_ONE;
+}
+
+// (X / Z^2, Y / Z^3)
+void GROUP(to_affine)(AFFINE* out, const JACOBIAN* p) {
+    if (COORD_IS_ZERO(&p->z)) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    COORD zinv, zinv2;
+    COORD_INV(&zinv, &p->z);
+    COORD_SQR(&zinv2, &zinv);
+    COORD_MUL(&out->x, &p->x, &zinv2);
+    COORD_MUL(&zinv2, &zinv2, &zinv);
+    COORD_MUL(&out->y, &p->y, &zinv2);
+}
+
+// Invert every Z at once, then scale as to_affine does
+void GROUP(batch_to_affine)(AFFINE* out, const JACOBIAN* points, size_t n, COORD* scratch) {
+    for (size_t i = 0; i < n; i++) scratch[i] = points[i].z;
+    GROUP(batch_inv)(scratch, n, scratch + n);
+    for (size_t i = 0; i < n; i++) {
+        if (COORD_IS_ZERO(&scratch[i])) {
+            memset(&out[i], 0, sizeof(AFFINE));
+            continue;
+        }
+        COORD zinv2;
+        COORD_SQR(&zinv2, &scratch[i]);
+        COORD_MUL(&out[i].x, &points[i].x, &zinv2);
+        COORD_MUL(&zinv2, &zinv2, &scratch[i]);
+        COORD_MUL(&out[i].y, &points[i].y, &zinv2);
+    }
+}
+
+// Doubling for a = 0 (dbl-2009-l): 2M + 5S
+void GROUP(double)(JACOBIAN* out, const JACOBIAN* p) {
+    if (COORD_IS_ZERO(&p->z) || COORD_IS_ZERO(&p->y)) {
+        GROUP(set_infinity)(out);
+        return;
+    }
+    COORD a, b, c, d, e, f, z3;
+    COORD_SQR(&a, &p->x);
+    COORD_SQR(&b, &p->y);
+    COORD_SQR(&c, &b);
+    COORD_ADD(&d, &p->x, &b);       // D = 2 * ((X + B)^2 - A - C)
+    COORD_SQR(&d, &d);
+    COORD_SUB(&d, &d, &a);
+    COORD_SUB(&d, &d, &c);
+    COORD_ADD(&d, &d, &d);
+    COORD_ADD(&e, &a, &a);          // E = 3 * A
+    COORD_ADD(&e, &e, &a);
+    COORD_SQR(&f, &e);
+    COORD_MUL(&z3, &p->y, &p->z);   // Z3 = 2 * Y * Z
+    COORD_ADD(&out->z, &z3, &z3);
+    COORD_SUB(&out->x, &f, &d);     // X3 = F - 2 * D
+    COORD_SUB(&out->x, &out->x, &d);
+    COORD_SUB(&f, &d, &out->x);     // Y3 = E * (D - X3) - 8 * C
+    COORD_MUL(&f, &e, &f);
+    COORD_ADD(&c, &c, &c);
+    COORD_ADD(&c, &c, &c);
+    COORD_ADD(&c, &c, &c);
+    COORD_SUB(&out->y, &f, &c);
+}
+
+// Addition (add-2007-bl): 11M + 5S
+void GROUP(add)(JACOBIAN* out, const JACOBIAN* p, const JACOBIAN* q) {
+    if (COORD_IS_ZERO(&p->z)) {
+        *out = *q;
+        return;
+    }
+    if (COORD_IS_ZERO(&q->z)) {
+        *out = *p;
+        return;
+    }
+    COORD z1z1, z2z2, u1, u2, s1, s2, h, r, i, j, v, x3, y3, z3;
+    COORD_SQR(&z1z1, &p->z);
+    COORD_SQR(&z2z2, &q->z);
+    COORD_MUL(&u1, &p->x, &z2z2);
+    COORD_MUL(&u2, &q->x, &z1z1);
+    COORD_MUL(&s1, &p->y, &q->z);
+    COORD_MUL(&s1, &s1, &z2z2);
+    COORD_MUL(&s2, &q->y, &p->z);
+    COORD_MUL(&s2, &s2, &z1z1);
+    COORD_SUB(&h, &u2, &u1);
+    COORD_SUB(&r, &s2, &s1);
+    if (COORD_IS_ZERO(&h)) {
+        // Same x: the same point, or opposite points
+        if (COORD_IS_ZERO(&r)) GROUP(double)(out, p);
+        else GROUP(set_infinity)(out);
+        return;
+    }
+    COORD_ADD(&i, &h, &h);          // I = (2 * H)^2
+    COORD_SQR(&i, &i);
+    COORD_MUL(&j, &h, &i);
+    COORD_ADD(&r, &r, &r);
+    COORD_MUL(&v, &u1, &i);
+    COORD_ADD(&z3, &p->z, &q->z);   // Z3 = ((Z1 + Z2)^2 - Z1Z1 - Z2Z2) * H
+    COORD_SQR(&z3, &z3);
+    COORD_SUB(&z3, &z3, &z1z1);
+    COORD_SUB(&z3, &z3, &z2z2);
+    COORD_MUL(&z3, &z3, &h);
+    COORD_SQR(&x3, &r);             // X3 = r^2 - J - 2 * V
+    COORD_SUB(&x3, &x3, &j);
+    COORD_SUB(&x3, &x3, &v);
+    COORD_SUB(&x3, &x3, &v);
+    COORD_SUB(&y3, &v, &x3);        // Y3 = r * (V - X3) - 2 * S1 * J
+    COORD_MUL(&y3, &y3, &r);
+    COORD_MUL(&s1, &s1, &j);
+    COORD_ADD(&s1, &s1, &s1);
+    COORD_SUB(&y3, &y3, &s1);
+    out->x = x3;
+    out->y = y3;
+    out->z = z3;
+}
+
+// Mixed addition with Z2 = 1 (madd-2007-bl): 7M + 4S
+void GROUP(add_mixed)(JACOBIAN* out, const JACOBIAN* p, const AFFINE* q) {
+    if (GROUP(is_infinity)(q)) {
+        *out = *p;
+        return;
+    }
+    if (COORD_IS_ZERO(&p->z)) {
+        GROUP(from_affine)(out, q);
+        return;
+    }
+    COORD z1z1, u2, s2, h, hh, r, i, j, v, x3, y3, z3;
+    COORD_SQR(&z1z1, &p->z);
+    COORD_MUL(&u2, &q->x, &z1z1);
+    COORD_MUL(&s2, &q->y, &p->z);
+    COORD_MUL(&s2, &s2, &z1z1);
+    COORD_SUB(&h, &u2, &p->x);
+    COORD_SUB(&r, &s2, &p->y);
+    if (COORD_IS_ZERO(&h)) {
+        if (COORD_IS_ZERO(&r)) GROUP(double)(out, p);
+        else GROUP(set_infinity)(out);
+        return;
+    }
+    COORD_SQR(&hh, &h);
+    COORD_ADD(&i, &hh, &hh);        // I = 4 * HH
+    COORD_ADD(&i, &i, &i);
+    COORD_MUL(&j, &h, &i);
+    COORD_ADD(&r, &r, &r);
+    COORD_MUL(&v, &p->x, &i);
+    COORD_ADD(&z3, &p->z, &h);      // Z3 = (Z1 + H)^2 - Z1Z1 - HH
+    COORD_SQR(&z3, &z3);
+    COORD_SUB(&z3, &z3, &z1z1);
+    COORD_SUB(&z3, &z3, &hh);
+    COORD_SQR(&x3, &r);             // X3 = r^2 - J - 2 * V
+    COORD_SUB(&x3, &x3, &j);
+    COORD_SUB(&x3, &x3, &v);
+    COORD_SUB(&x3, &x3, &v);
+    COORD_SUB(&y3, &v, &x3);        // Y3 = r * (V - X3) - 2 * Y1 * J
+    COORD_MUL(&y3, &y3, &r);
+    COORD_MUL(&j, &j, &p->y);
+    COORD_ADD(&j, &j, &j);
+    COORD_SUB(&y3, &y3, &j);
+    out->x = x3;
+    out->y = y3;
+    out->z = z3;
+}
+
+// -(x, y) = (x, -y); infinity stays (0, 0)
+void GROUP(neg_affine)(AFFINE* out, const AFFINE* p) {
+    out->x = p->x;
+    COORD_NEG(&out->y, &p->y);
+}
+
+// Compare X1 * Z2^2 with X2 * Z1^2 and Y1 * Z2^3 with Y2 * Z1^3
+int GROUP(equal)(const JACOBIAN* p, const JACOBIAN* q) {
+    int infinite1 = COORD_IS_ZERO(&p->z), infinite2 = COORD_IS_ZERO(&q->z);
+    if (infinite1 || infinite2) return infinite1 && infinite2;
+    COORD z1z1, z2z2, a, b;
+    COORD_SQR(&z1z1, &p->z);
+    COORD_SQR(&z2z2, &q->z);
+    COORD_MUL(&a, &p->x, &z2z2);
+    COORD_MUL(&b, &q->x, &z1z1);
+    if (!COORD_EQUAL(&a, &b)) return 0;
+    COORD_MUL(&a, &p->y, &z2z2);
+    COORD_MUL(&a, &a, &q->z);
+    COORD_MUL(&b, &q->y, &z1z1);
+    COORD_MUL(&b, &b, &p->z);
+    return COORD_EQUAL(&a, &b);
+}
+
+// Left-to-right double-and-add
+void GROUP(mul)(JACOBIAN* out, const JACOBIAN* p, const uint64_t scalar[FIELD_LIMBS]) {
+    JACOBIAN base = *p, acc;
+    GROUP(set_infinity)(&acc);
+    for (int limb = FIELD_LIMBS - 1; limb >= 0; limb--) {
+        for (int bit = 63; bit >= 0; bit--) {
+            GROUP(double)(&acc, &acc);
+            if ((scalar[limb] >> bit) & 1) GROUP(add)(&acc, &acc, &base);
+        }
+    }
+    *out = acc;
+}
+
+// Affine addition needs lambda = (y2 - y1) / (x2 - x1), or 3x^2 / 2y when
+// doubling; the denominators of all pairs are inverted together, so each
+// addition costs about 6 multiplications instead of a Jacobian one's 11.
+// Pairs whose result needs no division (an infinite operand, or opposite
+// points) are settled in the first loop and skipped in the second.
+void GROUP(batch_add_affine)(AFFINE* const* sums, const AFFINE* const* terms, size_t n, COORD* scratch) {
+    COORD* denominators = scratch;
+    for (size_t k = 0; k < n; k++) {
+        AFFINE* s = sums[k];
+        const AFFINE* t = terms[k];
+        memset(&denominators[k], 0, sizeof(COORD));
+        if (GROUP(is_infinity)(t)) continue;
+        if (GROUP(is_infinity)(s)) {
+            *s = *t;
+        } else if (!COORD_EQUAL(&s->x, &t->x)) {
+            COORD_SUB(&denominators[k], &t->x, &s->x);
+        } else if (COORD_EQUAL(&s->y, &t->y) && !COORD_IS_ZERO(&s->y)) {
+            COORD_ADD(&denominators[k], &s->y, &s->y);
+        } else {
+            memset(s, 0, sizeof(AFFINE));
+        }
+    }
+    GROUP(batch_inv)(denominators, n, scratch + n);
+
+    for (size_t k = 0; k < n; k++) {
+        if (COORD_IS_ZERO(&denominators[k])) continue;
+        AFFINE* s = sums[k];
+        const AFFINE* t = terms[k];
+        COORD lambda, x3;
+        if (COORD_EQUAL(&s->x, &t->x)) {
+            COORD_SQR(&lambda, &s->x);
+            COORD_ADD(&x3, &lambda, &lambda);
+            COORD_ADD(&lambda, &lambda, &x3);
+        } else {
+            COORD_SUB(&lambda, &t->y, &s->y);
+        }
+        COORD_MUL(&lambda, &lambda, &denominators[k]);
+        COORD_SQR(&x3, &lambda);        // x3 = lambda^2 - x1 - x2
+        COORD_SUB(&x3, &x3, &s->x);
+        COORD_SUB(&x3, &x3, &t->x);
+        COORD_SUB(&s->x, &s->x, &x3);   // y3 = lambda * (x1 - x3) - y1
+        COORD_MUL(&s->x, &s->x, &lambda);
+        COORD_SUB(&s->y, &s->x, &s->y);
+        s->x = x3;
+    }
+}
+
+// Untyped entry points for the group's CurveGroup table
+static void GROUP(any_set_infinity)(void* out) {
+    GROUP(set_infinity)((JACOBIAN*)out);
+}
+static void GROUP(any_from_affine)(void* out, const void* p) {
+    GROUP(from_affine)((JACOBIAN*)out, (const AFFINE*)p);
+}
+static void GROUP(any_add)(void* out, const void* p, const void* q) {
+    GROUP(add)((JACOBIAN*)out, (const JACOBIAN*)p, (const JACOBIAN*)q);
+}
+static void GROUP(any_add_mixed)(void* out, const void* p, const void* q) {
+    GROUP(add_mixed)((JACOBIAN*)out, (const JACOBIAN*)p, (const AFFINE*)q);
+}
+static void GROUP(any_double)(void* out, const void* p) {
+    GROUP(double)((JACOBIAN*)out, (const JACOBIAN*)p);
+}
+static void GROUP(any_neg_affine)(void* out, const void* p) {
+    GROUP(neg_affine)((AFFINE*)out, (const AFFINE*)p);
+}
+static void GROUP(any_mul)(void* out, const void* p, const uint64_t scalar[FIELD_LIMBS]) {
+    GROUP(mul)((JACOBIAN*)out, (const JACOBIAN*)p, scalar);
+}
+static void GROUP(any_batch_add_affine)(void* const* sums, const void* const* terms, size_t n, void* scratch) {
+    GROUP(batch_add_affine)((AFFINE* const*)sums, (const AFFINE* const*)terms, n, (COORD*)scratch);
+}
+
+const CurveGroup GROUP_TABLE = {
+    GROUP_NAME, sizeof(AFFINE), sizeof(JACOBIAN), sizeof(COORD),
+    GROUP(any_set_infinity), GROUP(any_from_affine), GROUP(any_add), GROUP(any_add_mixed),
+    GROUP(any_double), GROUP(any_neg_affine), GROUP(any_mul), GROUP(any_batch_add_affine)
+};
@@ -0,0 +1,331 @@
+#include "field.h"
+#include <stdio.h>
+#include <string.h>
+
+typedef unsigned __int128 uint128_t;
+
+// Scalar field of BN254 (alt_bn128)
+const Field FIELD_BN254 = {
+    "bn254",
+    {0x43e1f593f0000001ull, 0x2833e84879b97091ull, 0xb85045b68181585dull, 0x30644e72e131a029ull},
+    {0x1bb8e645ae216da7ull, 0x53fe3ab1e35c59e3ull, 0x8c49833d53bb8085ull, 0x0216d0b17f4e44a5ull},
+    {{0xac96341c4ffffffbull, 0x36fc76959f60cd29ull, 0x666ea36f7879462eull, 0x0e0a77c19a07df2full}},
+    0xc2e1f593efffffffull
+};
+
+// Scalar field of BLS12-381
+const Field FIELD_BLS12_381 = {
+    "bls12-381",
+    {0xffffffff00000001ull, 0x53bda402fffe5bfeull, 0x3339d80809a1d805ull, 0x73eda753299d7d48ull},
+    {0xc999e990f3f29c6dull, 0x2b6cedcb87925c23ull, 0x05d314967254398full, 0x0748d9d99f59ff11ull},
+    {{0x00000001fffffffeull, 0x5884b7fa00034802ull, 0x998c4fefecbc4ff5ull, 0x1824b159acc5056full}},
+    0xfffffffeffffffffull
+};
+
+// Base field of BN254
+const Field FIELD_BN254_BASE = {
+    "bn254-base",
+    {0x3c208c16d87cfd47ull, 0x97816a916871ca8dull, 0xb85045b68181585dull, 0x30644e72e131a029ull},
+    {0xf32cfc5b538afa89ull, 0xb5e71911d44501fbull, 0x47ab1eff0a417ff6ull, 0x06d89f71cab8351full},
+    {{0xd35d438dc58f0d9dull, 0x0a78eb28f5c70b3dull, 0x666ea36f7879462cull, 0x0e0a77c19a07df2full}},
+    0x87d20782e4866389ull
+};
+
+// Look up a field by name
+const Field* field_by_name(const char* name) {
+    if (strcmp(name, "bn254") == 0) return &FIELD_BN254;
+    if (strcmp(name, "bls12-381") == 0 || strcmp(name, "bls12_381") == 0) return &FIELD_BLS12_381;
+    return NULL;
+}
+
+// Helper for t + a * b + carry, returning the low word and updating carry
+static inline uint64_t mac(uint64_t t, uint64_t a, uint64_t b, uint64_t* carry) {
+    uint128_t s = (uint128_t)a * b + t + *carry;
+    *carry = (uint64_t)(s >> 64);
+    return (uint64_t)s;
+}
+
+// Helper for a + b + carry, returning the low word and updating carry
+static inline uint64_t adc(uint64_t a, uint64_t b, uint64_t* carry) {
+    uint128_t s = (uint128_t)a + b + *carry;
+    *carry = (uint64_t)(s >> 64);
+    return (uint64_t)s;
+}
+
+// Helper for a - b - borrow, returning the low word and updating borrow
+static inline uint64_t sbb(uint64_t a, uint64_t b, uint64_t* borrow) {
+    uint128_t s = (uint128_t)a - b - *borrow;
+    *borrow = (uint64_t)(s >> 127);
+    return (uint64_t)s;
+}
+
+// Helper to subtract p from t0..t3 (plus a carry limb) if the value is at
+// least p. The result is selected with masks, so there are no branches.
+static inline void reduce_once(const Field* field, uint64_t out[FIELD_LIMBS], uint64_t t0, uint64_t t1,
+                               uint64_t t2, uint64_t t3, uint64_t carry) {
+    uint64_t borrow = 0;
+    uint64_t d0 = sbb(t0, field->modulus[0], &borrow);
+    uint64_t d1 = sbb(t1, field->modulus[1], &borrow);
+    uint64_t d2 = sbb(t2, field->modulus[2], &borrow);
+    uint64_t d3 = sbb(t3, field->modulus[3], &borrow);
+    // Keep t only if t < p, i.e. the subtraction borrowed and t did not carry
+    uint64_t keep = -(borrow & ~carry & 1);
+    out[0] = (t0 & keep) | (d0 & ~keep);
+    out[1] = (t1 & keep) | (d1 & ~keep);
+    out[2] = (t2 & keep) | (d2 & ~keep);
+    out[3] = (t3 & keep) | (d3 & ~keep);
+}
+
+// Helper for a + b mod p
+static inline void add_inline(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    uint64_t carry = 0;
+    uint64_t t0 = adc(a->limbs[0], b->limbs[0], &carry);
+    uint64_t t1 = adc(a->limbs[1], b->limbs[1], &carry);
+    uint64_t t2 = adc(a->limbs[2], b->limbs[2], &carry);
+    uint64_t t3 = adc(a->limbs[3], b->limbs[3], &carry);
+    reduce_once(field, out->limbs, t0, t1, t2, t3, carry);
+}
+
+// Helper for a - b mod p
+static inline void sub_inline(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    uint64_t borrow = 0;
+    uint64_t t0 = sbb(a->limbs[0], b->limbs[0], &borrow);
+    uint64_t t1 = sbb(a->limbs[1], b->limbs[1], &borrow);
+    uint64_t t2 = sbb(a->limbs[2], b->limbs[2], &borrow);
+    uint64_t t3 = sbb(a->limbs[3], b->limbs[3], &borrow);
+    // Add p back if the subtraction went negative
+    uint64_t mask = -borrow, carry = 0;
+    out->limbs[0] = adc(t0, field->modulus[0] & mask, &carry);
+    out->limbs[1] = adc(t1, field->modulus[1] & mask, &carry);
+    out->limbs[2] = adc(t2, field->modulus[2] & mask, &carry);
+    out->limbs[3] = adc(t3, field->modulus[3] & mask, &carry);
+}
+
+// Helper for Montgomery multiplication, a * b / 2^256 mod p, using the
+// coarsely integrated operand scanning (CIOS) method. Since the top limb
+// of p is below 2^63 - 1, the running sum fits in four limbs and the
+// product and reduction carries can be merged without a fifth limb.
+static inline void mul_inline(const Field* field, uint64_t out[FIELD_LIMBS], const uint64_t a[FIELD_LIMBS],
+                              const uint64_t b[FIELD_LIMBS]) {
+    const uint64_t p0 = field->modulus[0], p1 = field->modulus[1];
+    const uint64_t p2 = field->modulus[2], p3 = field->modulus[3];
+    const uint64_t inv = field->inv;
+    const uint64_t a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3];
+    const uint64_t b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3];
+    uint64_t t0 = 0, t1 = 0, t2 = 0, t3 = 0;
+
+#define MONTGOMERY_ROUND(bi)                             \
+    do {                                                 \
+        uint64_t product = 0, reduce = 0, m;             \
+        t0 = mac(t0, a0, (bi), &product);                \
+        m = t0 * inv;                                    \
+        mac(t0, m, p0, &reduce);                         \
+        t1 = mac(t1, a1, (bi), &product);                \
+        t0 = mac(t1, m, p1, &reduce);                    \
+        t2 = mac(t2, a2, (bi), &product);                \
+        t1 = mac(t2, m, p2, &reduce);                    \
+        t3 = mac(t3, a3, (bi), &product);                \
+        t2 = mac(t3, m, p3, &reduce);                    \
+        t3 = product + reduce;                           \
+    } while (0)
+
+    MONTGOMERY_ROUND(b0);
+    MONTGOMERY_ROUND(b1);
+    MONTGOMERY_ROUND(b2);
+    MONTGOMERY_ROUND(b3);
+#undef MONTGOMERY_ROUND
+
+    reduce_once(field, out, t0, t1, t2, t3, 0);
+}
+
+// Convert a small integer into Montgomery form
+void field_from_u64(const Field* field, FieldElement* out, uint64_t value) {
+    uint64_t plain[FIELD_LIMBS] = {value, 0, 0, 0};
+    mul_inline(field, out->limbs, plain, field->r2);
+}
+
+// Helper to map a digit character to its value, or -1
+static inline int digit_value(char c, int base) {
+    int value;
+    if (c >= '0' && c <= '9') value = c - '0';
+    else if (c >= 'a' && c <= 'f') value = c - 'a' + 10;
+    else if (c >= 'A' && c <= 'F') value = c - 'A' + 10;
+    else return -1;
+    return value < base ? value : -1;
+}
+
+// Parse a literal by gathering digits into 64-bit chunks and folding each
+// chunk in with one multiply-add
+int field_from_string(const Field* field, FieldElement* out, const char* text, size_t length) {
+    int base = 10;
+    int chunk_digits = 19; // 10^19 < 2^64
+    if (length > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        chunk_digits = 15; // Leaves room to scale by 16^15 without overflow
+        text += 2;
+        length -= 2;
+    }
+    if (length == 0) return 0;
+
+    FieldElement acc = {{0}};
+    size_t i = 0;
+    while (i < length) {
+        uint64_t chunk = 0, scale = 1;
+        for (int k = 0; k < chunk_digits && i < length; k++, i++) {
+            int digit = digit_value(text[i], base);
+            if (digit < 0) return 0;
+            chunk = chunk * base + digit;
+            scale *= base;
+        }
+        FieldElement scale_element, chunk_element;
+        field_from_u64(field, &chunk_element, chunk);
+        if (i <= (size_t)chunk_digits) { // The first chunk: nothing to scale yet
+            acc = chunk_element;
+            continue;
+        }
+        field_from_u64(field, &scale_element, scale);
+        mul_inline(field, acc.limbs, acc.limbs, scale_element.limbs);
+        add_inline(field, &acc, &acc, &chunk_element);
+    }
+    *out = acc;
+    return 1;
+}
+
+// Convert out of Montgomery form by multiplying with plain 1
+void field_to_canonical(const Field* field, uint64_t out[FIELD_LIMBS], const FieldElement* a) {
+    static const uint64_t plain_one[FIELD_LIMBS] = {1, 0, 0, 0};
+    mul_inline(field, out, a->limbs, plain_one);
+}
+
+// Format as decimal by repeatedly dividing the canonical value by 10^19
+char* field_to_string(const Field* field, const FieldElement* a, char* buffer, size_t size) {
+    const uint64_t chunk_base = 10000000000000000000ull; // 10^19
+    uint64_t value[FIELD_LIMBS];
+    uint64_t chunks[5]; // 2^256 < 10^95
+    int chunk_count = 0;
+    field_to_canonical(field, value, a);
+
+    do {
+        uint64_t remainder = 0;
+        for (int j = FIELD_LIMBS - 1; j >= 0; j--) {
+            uint128_t current = ((uint128_t)remainder << 64) | value[j];
+            value[j] = (uint64_t)(current / chunk_base);
+            remainder = (uint64_t)(current % chunk_base);
+        }
+        chunks[chunk_count++] = remainder;
+    } while (value[0] | value[1] | value[2] | value[3]);
+
+    // Most significant chunk without padding, the rest zero-padded
+    char digits[FIELD_DECIMAL_SIZE];
+    int used = snprintf(digits, sizeof(digits), "%llu", (unsigned long long)chunks[chunk_count - 1]);
+    for (int k = chunk_count - 2; k >= 0; k--) {
+        used += snprintf(digits + used, sizeof(digits) - used, "%019llu", (unsigned long long)chunks[k]);
+    }
+    snprintf(buffer, size, "%s", digits);
+    return buffer;
+}
+
+// Return the canonical value if it fits in 64 bits
+int field_to_u64(const Field* field, const FieldElement* a, uint64_t* value) {
+    uint64_t canonical[FIELD_LIMBS];
+    field_to_canonical(field, canonical, a);
+    if (canonical[1] | canonical[2] | canonical[3]) return 0;
+    *value = canonical[0];
+    return 1;
+}
+
+// Add two elements
+void field_add(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    add_inline(field, out, a, b);
+}
+
+// Subtract two elements
+void field_sub(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    sub_inline(field, out, a, b);
+}
+
+// Negate an element
+void field_neg(const Field* field, FieldElement* out, const FieldElement* a) {
+    static const FieldElement zero = {{0}};
+    sub_inline(field, out, &zero, a);
+}
+
+// Multiply two elements
+void field_mul(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b) {
+    mul_inline(field, out->limbs, a->limbs, b->limbs);
+}
+
+// Square an element
+void field_sqr(const Field* field, FieldElement* out, const FieldElement* a) {
+    mul_inline(field, out->limbs, a->limbs, a->limbs);
+}
+
+// Left-to-right square-and-multiply exponentiation
+void field_pow(const Field* field, FieldElement* out, const FieldElement* a, const uint64_t exponent[FIELD_LIMBS]) {
+    FieldElement base = *a;
+    FieldElement result = field->one;
+    for (int j = FIELD_LIMBS - 1; j >= 0; j--) {
+        for (int bit = 63; bit >= 0; bit--) {
+            mul_inline(field, result.limbs, result.limbs, result.limbs);
+            if ((exponent[j] >> bit) & 1) {
+                mul_inline(field, result.limbs, result.limbs, base.limbs);
+            }
+        }
+    }
+    *out = result;
+}
+
+// Invert by Fermat's little theorem: a^(p-2) = a^-1
+int field_inv(const Field* field, FieldElement* out, const FieldElement* a) {
+    if (field_is_zero(a)) return 0;
+    uint64_t exponent[FIELD_LIMBS];
+    memcpy(exponent, field->modulus, sizeof(exponent));
+    exponent[0] -= 2; // No modulus has a low limb below 2
+    field_pow(field, out, a, exponent);
+    return 1;
+}
+
+// Element-wise addition over arrays
+void field_batch_add(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        add_inline(field, &out[i], &a[i], &b[i]);
+    }
+}
+
+// Element-wise multiplication over arrays
+void field_batch_mul(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        mul_inline(field, out[i].limbs, a[i].limbs, b[i].limbs);
+    }
+}
+
+// Montgomery's trick: invert the product of all elements once, then peel
+// off each inverse with two multiplications
+size_t field_batch_inv(const Field* field, FieldElement* out, const FieldElement* a, size_t n, FieldElement* scratch) {
+    FieldElement acc = field->one;
+    size_t zeros = 0;
+
+    // scratch[i] = product of the non-zero elements before i
+    for (size_t i = 0; i < n; i++) {
+        scratch[i] = acc;
+        if (field_is_zero(&a[i])) {
+            zeros++;
+        } else {
+            mul_inline(field, acc.limbs, acc.limbs, a[i].limbs);
+        }
+    }
+
+    field_inv(field, &acc, &acc);
+
+    // Walk back: acc holds the inverse of the product of elements up to i
+    for (size_t i = n; i-- > 0;) {
+        FieldElement element = a[i];
+        if (field_is_zero(&element)) {
+            memset(&out[i], 0, sizeof(FieldElement));
+            continue;
+        }
+        mul_inline(field, out[i].limbs, acc.limbs, scratch[i].limbs);
+        mul_inline(field, acc.limbs, acc.limbs, element.limbs);
+    }
+    return zeros;
+}
@@ -0,0 +1,151 @@
+#ifndef FIELD_H
+#define FIELD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Number of 64-bit limbs in a field element
+#define FIELD_LIMBS 4
+
+// Longest decimal rendering of a 256-bit element, including the terminator
+#define FIELD_DECIMAL_SIZE 80
+
+// An element of a prime field below 2^256, stored little-endian in
+// Montgomery form (x * 2^256 mod p). Use field_from_* and field_to_* to
+// convert; compare elements with field_equal.
+typedef struct {
+    uint64_t limbs[FIELD_LIMBS];
+} FieldElement;
+
+// Parameters of a prime field with a 4-limb modulus. Multiplication
+// relies on the top limb of the modulus being below 2^63 - 1, which holds
+// for the scalar fields of all pairing-friendly curves in use.
+typedef struct {
+    const char* name;               // Short name, e.g. "bn254"
+    uint64_t modulus[FIELD_LIMBS];  // p, little-endian
+    uint64_t r2[FIELD_LIMBS];       // 2^512 mod p, for conversion into Montgomery form
+    FieldElement one;               // 2^256 mod p, the Montgomery form of 1
+    uint64_t inv;                   // -p^-1 mod 2^64
+} Field;
+
+// Scalar fields of the supported curves
+extern const Field FIELD_BN254;
+extern const Field FIELD_BLS12_381;
+
+// Base field of BN254, over which its curve points are defined
+extern const Field FIELD_BN254_BASE;
+
+// Function prototypes
+
+/**
+ * Looks up a supported field by name ("bn254" or "bls12-381").
+ *
+ * @param name The field name.
+ * @return The field, or NULL if the name is unknown.
+ */
+const Field* field_by_name(const char* name);
+
+/**
+ * Converts a small integer into a field element.
+ */
+void field_from_u64(const Field* field, FieldElement* out, uint64_t value);
+
+/**
+ * Parses a decimal or 0x-prefixed hexadecimal literal into a field
+ * element. Values of p or more are reduced modulo p.
+ *
+ * @param field The field.
+ * @param out Receives the element.
+ * @param text The literal (need not be NUL-terminated).
+ * @param length Length of the literal.
+ * @return Non-zero on success, 0 if the literal contains an invalid digit.
+ */
+int field_from_string(const Field* field, FieldElement* out, const char* text, size_t length);
+
+/**
+ * Converts an element out of Montgomery form into its canonical integer
+ * value in [0, p), little-endian.
+ */
+void field_to_canonical(const Field* field, uint64_t out[FIELD_LIMBS], const FieldElement* a);
+
+/**
+ * Formats an element as a decimal integer in [0, p).
+ *
+ * @param field The field.
+ * @param a The element.
+ * @param buffer Receives the digits; FIELD_DECIMAL_SIZE bytes always suffice.
+ * @param size Size of buffer.
+ * @return buffer.
+ */
+char* field_to_string(const Field* field, const FieldElement* a, char* buffer, size_t size);
+
+/**
+ * Returns the canonical value of an element if it fits in 64 bits.
+ *
+ * @return Non-zero if the value fits, in which case *value receives it.
+ */
+int field_to_u64(const Field* field, const FieldElement* a, uint64_t* value);
+
+// Element-wise arithmetic. Outputs may alias inputs.
+void field_add(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b);
+void field_sub(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b);
+void field_neg(const Field* field, FieldElement* out, const FieldElement* a);
+void field_mul(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b);
+void field_sqr(const Field* field, FieldElement* out, const FieldElement* a);
+
+/**
+ * Raises an element to a power given as a little-endian 256-bit integer.
+ */
+void field_pow(const Field* field, FieldElement* out, const FieldElement* a, const uint64_t exponent[FIELD_LIMBS]);
+
+/**
+ * Computes the multiplicative inverse of an element.
+ *
+ * @return Non-zero on success, 0 if a is zero (out is then left unchanged).
+ */
+int field_inv(const Field* field, FieldElement* out, const FieldElement* a);
+
+/**
+ * Computes out[i] = a[i] + b[i] for n elements. Outputs may alias inputs.
+ */
+void field_batch_add(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b, size_t n);
+
+/**
+ * Computes out[i] = a[i] * b[i] for n elements. Outputs may alias inputs.
+ */
+void field_batch_mul(const Field* field, FieldElement* out, const FieldElement* a, const FieldElement* b, size_t n);
+
+/**
+ * Inverts n elements with a single field inversion (Montgomery's trick).
+ * Zero elements have no inverse and are mapped to zero.
+ *
+ * @param field The field.
+ * @param out Receives the inverses; may alias a.
+ * @param a The elements to invert.
+ * @param n Number of elements.
+ * @param scratch Workspace of n elements, distinct from out and a.
+ * @return Number of zero elements encountered.
+ */
+size_t field_batch_inv(const Field* field, FieldElement* out, const FieldElement* a, size_t n, FieldElement* scratch);
+
+// Helper to test an element for zero (zero is zero in Montgomery form too)
+static inline int field_is_zero(const FieldElement* a) {
+    return (a->limbs[0] | a->limbs[1] | a->limbs[2] | a->limbs[3]) == 0;
+}
+
+// Helper to test that an element is below the modulus, as every routine
+// here assumes; for elements read from files
+static inline int field_is_reduced(const Field* field, const FieldElement* a) {
+    for (int i = FIELD_LIMBS - 1; i >= 0; i--) {
+        if (a->limbs[i] != field->modulus[i]) return a->limbs[i] < field->modulus[i];
+    }
+    return 0;
+}
+
+// Helper to compare two elements; both are kept fully reduced
+static inline int field_equal(const FieldElement* a, const FieldElement* b) {
+    return ((a->limbs[0] ^ b->limbs[0]) | (a->limbs[1] ^ b->limbs[1]) |
+            (a->limbs[2] ^ b->limbs[2]) | (a->limbs[3] ^ b->limbs[3])) == 0;
+}
+
+#endif // FIELD_H
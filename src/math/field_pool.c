@@ -0,0 +1,59 @@
+#include "field_pool.h"
+#include <string.h>
+
+// Initialize an empty pool
+void field_pool_init(FieldPool* pool, Arena* arena) {
+    pool->arena = arena;
+    pool->count = 0;
+    pool->capacity = 64;
+    pool->values = (FieldElement*)arena_alloc(arena, sizeof(FieldElement) * pool->capacity);
+    pool->slot_mask = 127;
+    pool->slots = (FieldPoolSlot*)arena_calloc(arena, 128, sizeof(FieldPoolSlot));
+}
+
+// Empty the pool without releasing its storage
+void field_pool_clear(FieldPool* pool) {
+    memset(pool->slots, 0, sizeof(FieldPoolSlot) * ((size_t)pool->slot_mask + 1));
+    pool->count = 0;
+}
+
+// Add an element to the pool, deduplicating by value
+uint32_t field_pool_add(FieldPool* pool, const FieldElement* value) {
+    return field_pool_add_hashed(pool, value, field_pool_hash(value));
+}
+
+// Add an element whose hash is known
+uint32_t field_pool_add_hashed(FieldPool* pool, const FieldElement* value, uint32_t hash) {
+    uint32_t i = hash & pool->slot_mask;
+    while (pool->slots[i].index) {
+        if (pool->slots[i].hash == hash && field_equal(&pool->values[pool->slots[i].index - 1], value)) {
+            return pool->slots[i].index - 1;
+        }
+        i = (i + 1) & pool->slot_mask;
+    }
+
+    if (pool->count == pool->capacity) {
+        FieldElement* grown = (FieldElement*)arena_alloc(pool->arena, sizeof(FieldElement) * pool->capacity * 2);
+        memcpy(grown, pool->values, sizeof(FieldElement) * pool->count);
+        pool->values = grown;
+        pool->capacity *= 2;
+    }
+    pool->values[pool->count] = *value;
+    pool->slots[i].index = ++pool->count;
+    pool->slots[i].hash = hash;
+
+    // Keep the table at most half full
+    if (pool->count * 2 > pool->slot_mask + 1) {
+        uint32_t mask = pool->slot_mask * 2 + 1;
+        FieldPoolSlot* slots = (FieldPoolSlot*)arena_calloc(pool->arena, (size_t)mask + 1, sizeof(FieldPoolSlot));
+        for (uint32_t k = 0; k <= pool->slot_mask; k++) {
+            if (!pool->slots[k].index) continue;
+            uint32_t j = pool->slots[k].hash & mask;
+            while (slots[j].index) j = (j + 1) & mask;
+            slots[j] = pool->slots[k];
+        }
+        pool->slots = slots;
+        pool->slot_mask = mask;
+    }
+    return pool->count - 1;
+}
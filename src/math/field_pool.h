@@ -0,0 +1,88 @@
+#ifndef FIELD_POOL_H
+#define FIELD_POOL_H
+
+#include "field.h"
+#include "../utils/arena.h"
+
+// Hash table slot of a pool. The hash is kept next to the index so probes
+// can skip other elements without loading them.
+typedef struct {
+    uint32_t index;           // 1-based pool index (0 = empty)
+    uint32_t hash;            // field_pool_hash of the element
+} FieldPoolSlot;
+
+// Deduplicated, append-only pool of field elements, referenced by 32-bit
+// index. Used for literals, IR constants and constraint coefficients, where
+// the same few values (0, 1, -1, small literals) recur millions of times.
+typedef struct {
+    Arena* arena;             // Arena the pool grows in
+    FieldElement* values;     // Elements, indexed by pool index
+    uint32_t count;
+    uint32_t capacity;
+    FieldPoolSlot* slots;     // Hash table of the elements
+    uint32_t slot_mask;
+} FieldPool;
+
+// Function prototypes
+
+/**
+ * Initializes an empty pool.
+ * 
+ * @param pool The pool to initialize.
+ * @param arena The arena to allocate from.
+ */
+void field_pool_init(FieldPool* pool, Arena* arena);
+
+/**
+ * Adds an element to a pool, reusing an existing entry when the value is
+ * already present.
+ * 
+ * @param pool The pool.
+ * @param value The element.
+ * @return The element's pool index.
+ */
+uint32_t field_pool_add(FieldPool* pool, const FieldElement* value);
+
+/**
+ * Hashes an element the way a pool does.
+ */
+static inline uint32_t field_pool_hash(const FieldElement* value) {
+    uint64_t x = value->limbs[0] ^ (value->limbs[1] * 0xC2B2AE3D27D4EB4Full) ^
+                 (value->limbs[2] * 0x165667B19E3779F9ull) ^ (value->limbs[3] * 0xFF51AFD7ED558CCDull);
+    x *= 0x9E3779B97F4A7C15ull;
+    return (uint32_t)(x >> 32);
+}
+
+/**
+ * Like field_pool_add(), for an element whose field_pool_hash() is already
+ * known. Callers adding many elements can hash and field_pool_prefetch()
+ * each one a few elements ahead, so the lookups overlap their cache misses.
+ * 
+ * @param pool The pool.
+ * @param value The element.
+ * @param hash field_pool_hash(value).
+ * @return The element's pool index.
+ */
+uint32_t field_pool_add_hashed(FieldPool* pool, const FieldElement* value, uint32_t hash);
+
+/**
+ * Starts loading the slot an element with the given hash would be found
+ * at. Only a hint; the pool may grow before the element is added.
+ */
+static inline void field_pool_prefetch(const FieldPool* pool, uint32_t hash) {
+    __builtin_prefetch(&pool->slots[hash & pool->slot_mask]);
+}
+
+/**
+ * Empties a pool, keeping its storage for reuse.
+ */
+void field_pool_clear(FieldPool* pool);
+
+/**
+ * Returns the element at a pool index.
+ */
+static inline const FieldElement* field_pool_get(const FieldPool* pool, uint32_t index) {
+    return &pool->values[index];
+}
+
+#endif // FIELD_POOL_H
@@ -0,0 +1,326 @@
+#include "ntt.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Side of the square tiles a transpose moves at a time (16 x 16 elements
+// is 8 KB, well inside L1 with the destination tile)
+#define TRANSPOSE_TILE 16
+
+// Elements per task in the element-wise passes
+#define NTT_CHUNK 4096
+
+// A transpose of a rows x columns matrix into a columns x rows one
+typedef struct {
+    const FieldElement* source;
+    FieldElement* destination;
+    size_t rows;
+    size_t columns;
+} TransposeJob;
+
+// Transforms of every row of a matrix
+typedef struct {
+    const NttDomain* domain;
+    FieldElement* values;
+    uint32_t log_length;        // Of each row
+    int twist;                  // Multiply element k of row r by w^(rk) afterwards
+} RowJob;
+
+// Multiplication of values[i] by factor * ratio^i (or just factor)
+typedef struct {
+    const Field* field;
+    FieldElement* values;
+    size_t count;
+    FieldElement factor;
+    FieldElement ratio;
+    int geometric;
+} ScaleJob;
+
+// Helper to allocate transform workspace, exiting on failure
+static void* ntt_alloc(size_t count) {
+    void* block = malloc((count ? count : 1) * sizeof(FieldElement));
+    if (!block) {
+        fprintf(stderr, "Error: Memory allocation failed for number-theoretic transform.\n");
+        exit(1);
+    }
+    return block;
+}
+
+// Helper to shift a 256-bit integer right by one bit
+static void shift_right(uint64_t value[FIELD_LIMBS]) {
+    for (int k = 0; k < FIELD_LIMBS; k++) {
+        value[k] = (value[k] >> 1) | (k + 1 < FIELD_LIMBS ? value[k + 1] << 63 : 0);
+    }
+}
+
+// Smallest log2 of a power of two >= count
+uint32_t ntt_log_size(size_t count) {
+    uint32_t log_size = 0;
+    while (((size_t)1 << log_size) < count) log_size++;
+    return log_size;
+}
+
+// Find a root of unity from a quadratic non-residue, then tabulate powers
+NttDomain* ntt_domain_create(const Field* field, uint32_t log_size) {
+    // p - 1 = q * 2^s with q odd (p is odd, so the low limb cannot borrow)
+    uint64_t q[FIELD_LIMBS], half[FIELD_LIMBS];
+    memcpy(q, field->modulus, sizeof(q));
+    q[0] -= 1;
+    memcpy(half, q, sizeof(half));
+    shift_right(half);
+    uint32_t s = 0;
+    while ((q[0] & 1) == 0) {
+        shift_right(q);
+        s++;
+    }
+    if (log_size > s) {
+        fprintf(stderr, "Error: Field %s has no domain of 2^%u points (at most 2^%u).\n", field->name, log_size, s);
+        return NULL;
+    }
+
+    NttDomain* domain = (NttDomain*)calloc(1, sizeof(NttDomain));
+    if (!domain) {
+        fprintf(stderr, "Error: Memory allocation failed for number-theoretic transform.\n");
+        exit(1);
+    }
+    domain->field = field;
+    domain->log_size = log_size;
+    domain->size = (size_t)1 << log_size;
+    domain->block_log = NTT_BLOCK_LOG;
+
+    // A non-residue g has g^((p-1)/2) = -1, so g^q has order exactly 2^s.
+    // g also shifts the coset, so it must not itself lie in the domain.
+    FieldElement g, t, minus_one;
+    field_neg(field, &minus_one, &field->one);
+    for (uint64_t candidate = 2;; candidate++) {
+        field_from_u64(field, &g, candidate);
+        field_pow(field, &t, &g, half);
+        if (!field_equal(&t, &minus_one)) continue;
+        t = g;
+        for (uint32_t k = 0; k < log_size; k++) field_sqr(field, &t, &t);
+        if (!field_equal(&t, &field->one)) break;
+    }
+    domain->coset_shift = g;
+    field_inv(field, &domain->coset_shift_inverse, &g);
+    field_pow(field, &domain->root, &g, q);
+    for (uint32_t k = log_size; k < s; k++) field_sqr(field, &domain->root, &domain->root);
+    field_from_u64(field, &t, domain->size);
+    field_inv(field, &domain->size_inverse, &t);
+
+    // The last stage uses w^j; every earlier one every other entry of the next
+    size_t size = domain->size;
+    domain->twiddles = (FieldElement*)ntt_alloc(size);
+    if (size > 1) {
+        FieldElement* last = domain->twiddles + size / 2;
+        last[0] = field->one;
+        for (size_t j = 1; j < size / 2; j++) field_mul(field, &last[j], &last[j - 1], &domain->root);
+        for (size_t h = size / 4; h >= 1; h /= 2) {
+            for (size_t j = 0; j < h; j++) domain->twiddles[h + j] = domain->twiddles[2 * h + 2 * j];
+        }
+    }
+    return domain;
+}
+
+void ntt_domain_free(NttDomain* domain) {
+    if (!domain) return;
+    free(domain->twiddles);
+    free(domain);
+}
+
+// Helper to permute 2^log_length elements into bit-reversed order
+static void bit_reverse(FieldElement* values, size_t length) {
+    for (size_t i = 1, j = 0; i < length; i++) {
+        size_t bit = length >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            FieldElement t = values[i];
+            values[i] = values[j];
+            values[j] = t;
+        }
+    }
+}
+
+// Transform 2^log_length contiguous elements in place: bit reversal, then
+// decimation-in-time butterflies. Stages are fused in pairs (radix 4), so
+// the data is swept half as often; an odd stage count starts with one
+// radix-2 stage. Each stage reads its twiddles contiguously.
+static void ntt_kernel(const NttDomain* domain, FieldElement* a, uint32_t log_length) {
+    const Field* field = domain->field;
+    size_t length = (size_t)1 << log_length;
+    bit_reverse(a, length);
+
+    size_t h = 1;
+    if (log_length & 1) {
+        for (size_t k = 0; k < length; k += 2) {
+            FieldElement u = a[k];
+            field_add(field, &a[k], &u, &a[k + 1]);
+            field_sub(field, &a[k + 1], &u, &a[k + 1]);
+        }
+        h = 2;
+    }
+    for (; h < length; h *= 4) {
+        const FieldElement* w1 = domain->twiddles + h;          // Stage h: w_2h^j
+        const FieldElement* w2 = domain->twiddles + 2 * h;      // Stage 2h: w_4h^j and w_4h^(j+h)
+        for (size_t k = 0; k < length; k += 4 * h) {
+            for (size_t j = 0; j < h; j++) {
+                FieldElement* x = a + k + j;
+                FieldElement t1, t3, a0, a1, a2, a3;
+                field_mul(field, &t1, &w1[j], &x[h]);
+                field_mul(field, &t3, &w1[j], &x[3 * h]);
+                field_add(field, &a0, &x[0], &t1);
+                field_sub(field, &a1, &x[0], &t1);
+                field_add(field, &a2, &x[2 * h], &t3);
+                field_sub(field, &a3, &x[2 * h], &t3);
+                field_mul(field, &a2, &w2[j], &a2);
+                field_mul(field, &a3, &w2[j + h], &a3);
+                field_add(field, &x[0], &a0, &a2);
+                field_sub(field, &x[2 * h], &a0, &a2);
+                field_add(field, &x[h], &a1, &a3);
+                field_sub(field, &x[3 * h], &a1, &a3);
+            }
+        }
+    }
+}
+
+// Thread pool task: transpose one band of TRANSPOSE_TILE rows, a tile at a time
+static void transpose_band(void* arg, uint32_t task, int worker) {
+    TransposeJob* job = (TransposeJob*)arg;
+    (void)worker;
+    size_t r0 = (size_t)task * TRANSPOSE_TILE;
+    size_t r1 = r0 + TRANSPOSE_TILE < job->rows ? r0 + TRANSPOSE_TILE : job->rows;
+    for (size_t c0 = 0; c0 < job->columns; c0 += TRANSPOSE_TILE) {
+        size_t c1 = c0 + TRANSPOSE_TILE < job->columns ? c0 + TRANSPOSE_TILE : job->columns;
+        for (size_t r = r0; r < r1; r++) {
+            for (size_t c = c0; c < c1; c++) {
+                job->destination[c * job->rows + r] = job->source[r * job->columns + c];
+            }
+        }
+    }
+}
+
+// Helper to transpose a rows x columns matrix across the pool
+static void transpose(ThreadPool* pool, FieldElement* destination, const FieldElement* source,
+                      size_t rows, size_t columns) {
+    TransposeJob job = {source, destination, rows, columns};
+    thread_pool_run(pool, (uint32_t)((rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE), transpose_band, &job);
+}
+
+// Thread pool task: transform one row, then apply the four-step twiddles
+static void transform_row(void* arg, uint32_t task, int worker) {
+    RowJob* job = (RowJob*)arg;
+    const Field* field = job->domain->field;
+    (void)worker;
+    size_t length = (size_t)1 << job->log_length;
+    FieldElement* row = job->values + (size_t)task * length;
+    ntt_kernel(job->domain, row, job->log_length);
+    if (job->twist && task > 0) {
+        const FieldElement* step = &job->domain->twiddles[job->domain->size / 2 + task];  // w^task
+        FieldElement factor = *step;
+        for (size_t k = 1; k < length; k++) {
+            field_mul(field, &row[k], &row[k], &factor);
+            field_mul(field, &factor, &factor, step);
+        }
+    }
+}
+
+// Thread pool task: scale one chunk of values
+static void scale_chunk(void* arg, uint32_t task, int worker) {
+    ScaleJob* job = (ScaleJob*)arg;
+    (void)worker;
+    size_t begin = (size_t)task * NTT_CHUNK;
+    size_t end = begin + NTT_CHUNK < job->count ? begin + NTT_CHUNK : job->count;
+    FieldElement factor = job->factor;
+    if (job->geometric) {
+        uint64_t exponent[FIELD_LIMBS] = {begin, 0, 0, 0};
+        FieldElement power;
+        field_pow(job->field, &power, &job->ratio, exponent);
+        field_mul(job->field, &factor, &factor, &power);
+    }
+    for (size_t i = begin; i < end; i++) {
+        field_mul(job->field, &job->values[i], &job->values[i], &factor);
+        if (job->geometric) field_mul(job->field, &factor, &factor, &job->ratio);
+    }
+}
+
+// Helper to multiply values[i] by factor * ratio^i (ratio NULL for 1)
+static void scale(const NttDomain* domain, ThreadPool* pool, FieldElement* values,
+                  const FieldElement* factor, const FieldElement* ratio) {
+    ScaleJob job = {domain->field, values, domain->size, *factor, ratio ? *ratio : domain->field->one, ratio != NULL};
+    thread_pool_run(pool, (uint32_t)((domain->size + NTT_CHUNK - 1) / NTT_CHUNK), scale_chunk, &job);
+}
+
+// Thread pool task: swap values[i] and values[size - i] for one chunk of i
+static void reverse_chunk(void* arg, uint32_t task, int worker) {
+    ScaleJob* job = (ScaleJob*)arg;
+    (void)worker;
+    size_t begin = 1 + (size_t)task * NTT_CHUNK;
+    size_t end = begin + NTT_CHUNK < (job->count + 1) / 2 ? begin + NTT_CHUNK : (job->count + 1) / 2;
+    for (size_t i = begin; i < end; i++) {
+        FieldElement t = job->values[i];
+        job->values[i] = job->values[job->count - i];
+        job->values[job->count - i] = t;
+    }
+}
+
+// Transform in natural order. Up to 2^block_log elements fit in cache and
+// are transformed directly. Longer transforms use the four-step method on
+// the elements as an R x C matrix (n = R * C, row-major): R-point
+// transforms of every column, a twist by w^(rc), C-point transforms of
+// every row, then a transpose. Transposing first makes the columns
+// contiguous too, so every sub-transform runs on cache-resident rows,
+// and the rows are spread across the pool. With a single worker the
+// direct transform is used at every size: the field multiplications, not
+// memory traffic, bound it, so the transposes and twist would not pay.
+static void ntt_transform(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    if ((int)domain->log_size <= domain->block_log || thread_pool_size(pool) == 1) {
+        ntt_kernel(domain, values, domain->log_size);
+        return;
+    }
+    uint32_t log_rows = domain->log_size / 2, log_columns = domain->log_size - log_rows;
+    size_t rows = (size_t)1 << log_rows, columns = (size_t)1 << log_columns;
+    FieldElement* scratch = (FieldElement*)ntt_alloc(domain->size);
+
+    transpose(pool, scratch, values, rows, columns);
+    RowJob job = {domain, scratch, log_rows, 1};
+    thread_pool_run(pool, (uint32_t)columns, transform_row, &job);
+    transpose(pool, values, scratch, columns, rows);
+    job.values = values;
+    job.log_length = log_columns;
+    job.twist = 0;
+    thread_pool_run(pool, (uint32_t)rows, transform_row, &job);
+    transpose(pool, scratch, values, rows, columns);
+
+    memcpy(values, scratch, domain->size * sizeof(FieldElement));
+    free(scratch);
+}
+
+// Helper to reverse values[1 .. size - 1], which turns a forward transform
+// into an inverse one up to the factor 1 / size (w^-ij = w^(i(size - j)))
+static void reverse_tail(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    ScaleJob job = {domain->field, values, domain->size, domain->field->one, domain->field->one, 0};
+    size_t swaps = (domain->size - 1) / 2;
+    if (swaps > 0) thread_pool_run(pool, (uint32_t)((swaps + NTT_CHUNK - 1) / NTT_CHUNK), reverse_chunk, &job);
+}
+
+void ntt_forward(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    ntt_transform(domain, pool, values);
+}
+
+void ntt_inverse(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    ntt_transform(domain, pool, values);
+    reverse_tail(domain, pool, values);
+    scale(domain, pool, values, &domain->size_inverse, NULL);
+}
+
+// f(g * w^i) is the transform of the coefficients scaled by g^i
+void ntt_coset_forward(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    scale(domain, pool, values, &domain->field->one, &domain->coset_shift);
+    ntt_transform(domain, pool, values);
+}
+
+void ntt_coset_inverse(const NttDomain* domain, ThreadPool* pool, FieldElement* values) {
+    ntt_transform(domain, pool, values);
+    reverse_tail(domain, pool, values);
+    scale(domain, pool, values, &domain->size_inverse, &domain->coset_shift_inverse);
+}
@@ -0,0 +1,78 @@
+#ifndef NTT_H
+#define NTT_H
+
+#include "field.h"
+#include "../utils/thread_pool.h"
+
+// Transforms longer than 2^NTT_BLOCK_LOG elements (2 MB) run on more than
+// one worker use the cache-blocked four-step layout by default
+#define NTT_BLOCK_LOG 16
+
+// A domain of 2^log_size points for number-theoretic transforms: the
+// subgroup generated by a primitive 2^log_size-th root of unity, and its
+// coset shifted by an element outside it.
+typedef struct {
+    const Field* field;
+    uint32_t log_size;
+    size_t size;
+    int block_log;                      // Transforms above 2^block_log use the four-step layout
+    FieldElement root;                  // w, of order size
+    FieldElement size_inverse;          // 1 / size
+    FieldElement coset_shift;           // g, the coset is g * w^i
+    FieldElement coset_shift_inverse;
+    FieldElement* twiddles;             // w_2h^j at index h + j, for each stage h = 1, 2, 4, .. size / 2
+} NttDomain;
+
+// Function prototypes
+
+/**
+ * Returns the smallest log_size whose domain holds count points.
+ */
+uint32_t ntt_log_size(size_t count);
+
+/**
+ * Creates a domain of 2^log_size points and precomputes its twiddles.
+ *
+ * @param field The field.
+ * @param log_size Log2 of the number of points.
+ * @return The domain, or NULL (after printing why) if the field has no
+ *         root of unity of that order.
+ */
+NttDomain* ntt_domain_create(const Field* field, uint32_t log_size);
+
+/**
+ * Frees a domain returned by ntt_domain_create.
+ */
+void ntt_domain_free(NttDomain* domain);
+
+/**
+ * Evaluates a polynomial on the domain: values[i] becomes
+ * sum(values[j] * w^(ij)). Coefficients and evaluations are both in
+ * natural order.
+ *
+ * @param domain The domain.
+ * @param pool The pool to run on.
+ * @param values domain->size coefficients, replaced by the evaluations.
+ */
+void ntt_forward(const NttDomain* domain, ThreadPool* pool, FieldElement* values);
+
+/**
+ * Interpolates evaluations on the domain back into coefficients; the
+ * inverse of ntt_forward.
+ */
+void ntt_inverse(const NttDomain* domain, ThreadPool* pool, FieldElement* values);
+
+/**
+ * Evaluates a polynomial on the coset: values[i] becomes its value at
+ * g * w^i. Provers use this to divide by the vanishing polynomial, which
+ * is zero on the domain but not on the coset.
+ */
+void ntt_coset_forward(const NttDomain* domain, ThreadPool* pool, FieldElement* values);
+
+/**
+ * Interpolates evaluations on the coset back into coefficients; the
+ * inverse of ntt_coset_forward.
+ */
+void ntt_coset_inverse(const NttDomain* domain, ThreadPool* pool, FieldElement* values);
+
+#endif // NTT_H
@@ -0,0 +1,461 @@
+#include <string.h>
+#include "pairing.h"
+
+// All coordinates are in BN254's base field
+#define FQ (&FIELD_BN254_BASE)
+
+// The ate loop count 6x + 2 (x = 4965661367192848881) in non-adjacent
+// form, least significant digit first
+#define ATE_LOOP_LENGTH 66
+static const int8_t ATE_LOOP_NAF[ATE_LOOP_LENGTH] = {
+    0, 0, 0, 1, 0, 1, 0, -1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, -1, 0, 0, 0, 1, 0, -1, 0, 0, 0, 0, -1, 0, 0,
+    1, 0, -1, 0, 0, 1, 0, 0, 0, 0, 0, -1, 0, 0, -1, 0, 1, 0, -1, 0, 0, 0, -1, 0, -1, 0, 0, 0, 1, 0, -1, 0, 1
+};
+
+// 1 / 2
+static const FieldElement TWO_INVERSE = {
+    {0x87bee7d24f060572ull, 0xd0fd2add2f1c6ae5ull, 0x8f5f7492fcfd4f44ull, 0x1f37631a3d9cbfacull}
+};
+
+// (9 + u)^((p - 1) / 3) and (9 + u)^((p - 1) / 2), which map the
+// Frobenius endomorphism of Fq12 onto the twist: pi(x, y) = (conj(x) * X,
+// conj(y) * Y)
+static const Fq2 FROBENIUS_TWIST_X = {
+    {{0xb5773b104563ab30ull, 0x347f91c8a9aa6454ull, 0x7a007127242e0991ull, 0x1956bcd8118214ecull}},
+    {{0x6e849f1ea0aa4757ull, 0xaa1c7b6d89f89141ull, 0xb6e713cdfae0ca3aull, 0x26694fbb4e82ebc3ull}}
+};
+static const Fq2 FROBENIUS_TWIST_Y = {
+    {{0xe4bbdd0c2936b629ull, 0xbb30f162e133bacbull, 0x31a9d1b6f9645366ull, 0x253570bea500f8ddull}},
+    {{0xa1d77ce45ffe77c7ull, 0x07affd117826d1dbull, 0x6d16bd27bb7edc6bull, 0x2c87200285defeccull}}
+};
+
+// (9 + u)^(i (p^2 - 1) / 6) for i = 1 .. 5, all in Fq: raising to the
+// power p^2 multiplies the coefficient of w^i by them
+static const FieldElement FROBENIUS2[5] = {
+    {{0xca8d800500fa1bf2ull, 0xf0c5d61468b39769ull, 0x0e201271ad0d4418ull, 0x04290f65bad856e6ull}},
+    {{0x3350c88e13e80b9cull, 0x7dce557cdb5e56b9ull, 0x6001b4b8b615564aull, 0x2682e617020217e0ull}},
+    {{0x68c3488912edefaaull, 0x8d087f6872aabf4full, 0x51e1a24709081231ull, 0x2259d6b14729c0faull}},
+    {{0x71930c11d782e155ull, 0xa6bb947cffbe3323ull, 0xaa303344d4741444ull, 0x2c3b3f0d26594943ull}},
+    {{0x08cfc388c494f1abull, 0x19b315148d1373d4ull, 0x584e90fdcb6c0213ull, 0x09e1685bdf2f8849ull}}
+};
+
+// (p^4 - p^2 + 1) / r, the hard part of the final exponentiation
+#define HARD_EXPONENT_LIMBS 12
+static const uint64_t HARD_EXPONENT[HARD_EXPONENT_LIMBS] = {
+    0xe81bb482ccdf42b1ull, 0x5abf5cc4f49c36d4ull, 0xf1154e7e1da014fdull, 0xdcc7b44c87cdbacfull,
+    0xaaa441e3954bcf8aull, 0x6b887d56d5095f23ull, 0x79581e16f3fd90c6ull, 0x3b1b1355d189227dull,
+    0x4e529a5861876f6bull, 0x6c0eb522d5b12278ull, 0x331ec15183177fafull, 0x01baaa710b0759adull
+};
+
+// A G2 point in homogeneous projective coordinates (X / Z, Y / Z), used
+// while computing lines
+typedef struct {
+    Fq2 x, y, z;
+} G2Projective;
+
+// Helper to multiply an Fq2 element by an Fq element
+static void fq2_scale(Fq2* out, const Fq2* a, const FieldElement* s) {
+    field_mul(FQ, &out->c0, &a->c0, s);
+    field_mul(FQ, &out->c1, &a->c1, s);
+}
+
+// Helper to multiply by the non-residue 9 + u: (9 c0 - c1) + (c0 + 9 c1) u
+static void fq2_mul_by_xi(Fq2* out, const Fq2* a) {
+    Fq2 nine;
+    fq2_add(&nine, a, a);
+    fq2_add(&nine, &nine, &nine);
+    fq2_add(&nine, &nine, &nine);
+    fq2_add(&nine, &nine, a);
+    FieldElement c0;
+    field_sub(FQ, &c0, &nine.c0, &a->c1);
+    field_add(FQ, &out->c1, &nine.c1, &a->c0);
+    out->c0 = c0;
+}
+
+// Helper to conjugate an Fq2 element, which raises it to the power p
+static void fq2_conjugate(Fq2* out, const Fq2* a) {
+    out->c0 = a->c0;
+    field_neg(FQ, &out->c1, &a->c1);
+}
+
+static void fq6_add(Fq6* out, const Fq6* a, const Fq6* b) {
+    fq2_add(&out->c0, &a->c0, &b->c0);
+    fq2_add(&out->c1, &a->c1, &b->c1);
+    fq2_add(&out->c2, &a->c2, &b->c2);
+}
+
+static void fq6_sub(Fq6* out, const Fq6* a, const Fq6* b) {
+    fq2_sub(&out->c0, &a->c0, &b->c0);
+    fq2_sub(&out->c1, &a->c1, &b->c1);
+    fq2_sub(&out->c2, &a->c2, &b->c2);
+}
+
+static void fq6_neg(Fq6* out, const Fq6* a) {
+    fq2_neg(&out->c0, &a->c0);
+    fq2_neg(&out->c1, &a->c1);
+    fq2_neg(&out->c2, &a->c2);
+}
+
+// Karatsuba over three coefficients, reducing v^3 to 9 + u
+static void fq6_mul(Fq6* out, const Fq6* a, const Fq6* b) {
+    Fq2 t0, t1, t2, s, u, c0, c1, c2;
+    fq2_mul(&t0, &a->c0, &b->c0);
+    fq2_mul(&t1, &a->c1, &b->c1);
+    fq2_mul(&t2, &a->c2, &b->c2);
+
+    fq2_add(&s, &a->c1, &a->c2);            // c0 = ((a1 + a2)(b1 + b2) - t1 - t2) xi + t0
+    fq2_add(&u, &b->c1, &b->c2);
+    fq2_mul(&c0, &s, &u);
+    fq2_sub(&c0, &c0, &t1);
+    fq2_sub(&c0, &c0, &t2);
+    fq2_mul_by_xi(&c0, &c0);
+    fq2_add(&c0, &c0, &t0);
+
+    fq2_add(&s, &a->c0, &a->c1);            // c1 = (a0 + a1)(b0 + b1) - t0 - t1 + xi t2
+    fq2_add(&u, &b->c0, &b->c1);
+    fq2_mul(&c1, &s, &u);
+    fq2_sub(&c1, &c1, &t0);
+    fq2_sub(&c1, &c1, &t1);
+    fq2_mul_by_xi(&s, &t2);
+    fq2_add(&c1, &c1, &s);
+
+    fq2_add(&s, &a->c0, &a->c2);            // c2 = (a0 + a2)(b0 + b2) - t0 - t2 + t1
+    fq2_add(&u, &b->c0, &b->c2);
+    fq2_mul(&c2, &s, &u);
+    fq2_sub(&c2, &c2, &t0);
+    fq2_sub(&c2, &c2, &t2);
+    fq2_add(&c2, &c2, &t1);
+
+    out->c0 = c0;
+    out->c1 = c1;
+    out->c2 = c2;
+}
+
+// Multiply by v: (a0, a1, a2) v = (xi a2, a0, a1)
+static void fq6_mul_by_v(Fq6* out, const Fq6* a) {
+    Fq2 t;
+    fq2_mul_by_xi(&t, &a->c2);
+    out->c2 = a->c1;
+    out->c1 = a->c0;
+    out->c0 = t;
+}
+
+// Multiply by the sparse element b0 + b1 v
+static void fq6_mul_by_01(Fq6* out, const Fq6* a, const Fq2* b0, const Fq2* b1) {
+    Fq2 t0, t1, s, u, c0, c1, c2;
+    fq2_mul(&t0, &a->c0, b0);
+    fq2_mul(&t1, &a->c1, b1);
+
+    fq2_mul(&c0, &a->c2, b1);               // c0 = xi a2 b1 + a0 b0
+    fq2_mul_by_xi(&c0, &c0);
+    fq2_add(&c0, &c0, &t0);
+
+    fq2_add(&s, b0, b1);                    // c1 = (b0 + b1)(a0 + a1) - a0 b0 - a1 b1
+    fq2_add(&u, &a->c0, &a->c1);
+    fq2_mul(&c1, &s, &u);
+    fq2_sub(&c1, &c1, &t0);
+    fq2_sub(&c1, &c1, &t1);
+
+    fq2_mul(&c2, &a->c2, b0);               // c2 = a2 b0 + a1 b1
+    fq2_add(&c2, &c2, &t1);
+
+    out->c0 = c0;
+    out->c1 = c1;
+    out->c2 = c2;
+}
+
+// Inverse via the adjugate: the determinant is in Fq2
+static int fq6_inv(Fq6* out, const Fq6* a) {
+    Fq2 t0, t1, t2, s, det;
+    fq2_sqr(&t0, &a->c0);                   // t0 = a0^2 - xi a1 a2
+    fq2_mul(&s, &a->c1, &a->c2);
+    fq2_mul_by_xi(&s, &s);
+    fq2_sub(&t0, &t0, &s);
+    fq2_sqr(&t1, &a->c2);                   // t1 = xi a2^2 - a0 a1
+    fq2_mul_by_xi(&t1, &t1);
+    fq2_mul(&s, &a->c0, &a->c1);
+    fq2_sub(&t1, &t1, &s);
+    fq2_sqr(&t2, &a->c1);                   // t2 = a1^2 - a0 a2
+    fq2_mul(&s, &a->c0, &a->c2);
+    fq2_sub(&t2, &t2, &s);
+
+    fq2_mul(&det, &a->c2, &t1);             // det = a0 t0 + xi (a2 t1 + a1 t2)
+    fq2_mul(&s, &a->c1, &t2);
+    fq2_add(&det, &det, &s);
+    fq2_mul_by_xi(&det, &det);
+    fq2_mul(&s, &a->c0, &t0);
+    fq2_add(&det, &det, &s);
+    if (!fq2_inv(&det, &det)) return 0;
+
+    fq2_mul(&out->c0, &t0, &det);
+    fq2_mul(&out->c1, &t1, &det);
+    fq2_mul(&out->c2, &t2, &det);
+    return 1;
+}
+
+void fq12_set_one(Fq12* out) {
+    memset(out, 0, sizeof(*out));
+    out->c0.c0.c0 = FIELD_BN254_BASE.one;
+}
+
+// (a0 + a1 w)(b0 + b1 w) = (a0 b0 + a1 b1 v) + ((a0 + a1)(b0 + b1) - a0 b0 - a1 b1) w
+void fq12_mul(Fq12* out, const Fq12* a, const Fq12* b) {
+    Fq6 t0, t1, s, u;
+    fq6_mul(&t0, &a->c0, &b->c0);
+    fq6_mul(&t1, &a->c1, &b->c1);
+    fq6_add(&s, &a->c0, &a->c1);
+    fq6_add(&u, &b->c0, &b->c1);
+    fq6_mul(&s, &s, &u);
+    fq6_sub(&s, &s, &t0);
+    fq6_sub(&out->c1, &s, &t1);
+    fq6_mul_by_v(&t1, &t1);
+    fq6_add(&out->c0, &t0, &t1);
+}
+
+// (a0 + a1 w)^2 = ((a0 + a1)(a0 + a1 v) - a0 a1 - a0 a1 v) + 2 a0 a1 w
+void fq12_sqr(Fq12* out, const Fq12* a) {
+    Fq6 product, s, u;
+    fq6_mul(&product, &a->c0, &a->c1);
+    fq6_add(&s, &a->c0, &a->c1);
+    fq6_mul_by_v(&u, &a->c1);
+    fq6_add(&u, &a->c0, &u);
+    fq6_mul(&s, &s, &u);
+    fq6_sub(&s, &s, &product);
+    fq6_mul_by_v(&u, &product);
+    fq6_sub(&out->c0, &s, &u);
+    fq6_add(&out->c1, &product, &product);
+}
+
+int fq12_equal(const Fq12* a, const Fq12* b) {
+    return memcmp(a, b, sizeof(Fq12)) == 0;  // Coefficients are kept fully reduced
+}
+
+int fq12_is_one(const Fq12* a) {
+    Fq12 one;
+    fq12_set_one(&one);
+    return fq12_equal(a, &one);
+}
+
+// (a0 + a1 w)^-1 = (a0 - a1 w) / (a0^2 - a1^2 v)
+static int fq12_inv(Fq12* out, const Fq12* a) {
+    Fq6 t0, t1;
+    fq6_mul(&t0, &a->c0, &a->c0);
+    fq6_mul(&t1, &a->c1, &a->c1);
+    fq6_mul_by_v(&t1, &t1);
+    fq6_sub(&t0, &t0, &t1);
+    if (!fq6_inv(&t0, &t0)) return 0;
+    fq6_mul(&out->c0, &a->c0, &t0);
+    fq6_mul(&t1, &a->c1, &t0);
+    fq6_neg(&out->c1, &t1);
+    return 1;
+}
+
+// Helper to conjugate over Fq6, which raises an element to the power p^6
+static void fq12_conjugate(Fq12* out, const Fq12* a) {
+    out->c0 = a->c0;
+    fq6_neg(&out->c1, &a->c1);
+}
+
+// Raise to the power p^2. The coefficients of w^0 .. w^5 are a.c0.c0,
+// a.c1.c0, a.c0.c1, a.c1.c1, a.c0.c2 and a.c1.c2, and Fq2 is fixed by p^2.
+static void fq12_frobenius2(Fq12* out, const Fq12* a) {
+    out->c0.c0 = a->c0.c0;
+    fq2_scale(&out->c1.c0, &a->c1.c0, &FROBENIUS2[0]);
+    fq2_scale(&out->c0.c1, &a->c0.c1, &FROBENIUS2[1]);
+    fq2_scale(&out->c1.c1, &a->c1.c1, &FROBENIUS2[2]);
+    fq2_scale(&out->c0.c2, &a->c0.c2, &FROBENIUS2[3]);
+    fq2_scale(&out->c1.c2, &a->c1.c2, &FROBENIUS2[4]);
+}
+
+// Multiply f by the sparse line value c0 + c3 w + c4 v w
+static void fq12_mul_by_034(Fq12* f, const Fq2* c0, const Fq2* c3, const Fq2* c4) {
+    Fq6 a, b, e;
+    fq2_mul(&a.c0, &f->c0.c0, c0);
+    fq2_mul(&a.c1, &f->c0.c1, c0);
+    fq2_mul(&a.c2, &f->c0.c2, c0);
+    fq6_mul_by_01(&b, &f->c1, c3, c4);
+
+    Fq2 s;
+    fq2_add(&s, c0, c3);
+    fq6_add(&e, &f->c0, &f->c1);
+    fq6_mul_by_01(&e, &e, &s, c4);
+    fq6_sub(&e, &e, &a);
+    fq6_sub(&f->c1, &e, &b);
+    fq6_mul_by_v(&b, &b);
+    fq6_add(&f->c0, &a, &b);
+}
+
+// Fixed 4-bit windows, from the most significant
+void fq12_pow(Fq12* out, const Fq12* a, const uint64_t* exponent, size_t limbs) {
+    Fq12 table[16], acc;
+    fq12_set_one(&table[0]);
+    for (int d = 1; d < 16; d++) fq12_mul(&table[d], &table[d - 1], a);
+    fq12_set_one(&acc);
+    for (size_t k = limbs; k-- > 0;) {
+        for (int shift = 60; shift >= 0; shift -= 4) {
+            fq12_sqr(&acc, &acc);
+            fq12_sqr(&acc, &acc);
+            fq12_sqr(&acc, &acc);
+            fq12_sqr(&acc, &acc);
+            unsigned digit = (unsigned)(exponent[k] >> shift) & 15;
+            if (digit) fq12_mul(&acc, &acc, &table[digit]);
+        }
+    }
+    *out = acc;
+}
+
+// Doubling step on the twist in homogeneous coordinates, returning the
+// tangent line at the old point
+static void doubling_step(G2Projective* r, LineCoefficients* line) {
+    Fq2 a, b, c, e, f, g, h, i, j, e2;
+    fq2_mul(&a, &r->x, &r->y);              // a = X Y / 2
+    fq2_scale(&a, &a, &TWO_INVERSE);
+    fq2_sqr(&b, &r->y);
+    fq2_sqr(&c, &r->z);
+    fq2_add(&e, &c, &c);                    // e = 3 b' Z^2
+    fq2_add(&e, &e, &c);
+    fq2_mul(&e, &e, &G2_B);
+    fq2_add(&f, &e, &e);                    // f = 3 e
+    fq2_add(&f, &f, &e);
+    fq2_add(&g, &b, &f);                    // g = (b + f) / 2
+    fq2_scale(&g, &g, &TWO_INVERSE);
+    fq2_add(&h, &r->y, &r->z);              // h = (Y + Z)^2 - b - c
+    fq2_sqr(&h, &h);
+    fq2_sub(&h, &h, &b);
+    fq2_sub(&h, &h, &c);
+    fq2_sub(&i, &e, &b);
+    fq2_sqr(&j, &r->x);
+    fq2_sqr(&e2, &e);
+
+    fq2_sub(&r->x, &b, &f);                 // X = a (b - f)
+    fq2_mul(&r->x, &r->x, &a);
+    fq2_sqr(&r->y, &g);                     // Y = g^2 - 3 e^2
+    fq2_sub(&r->y, &r->y, &e2);
+    fq2_sub(&r->y, &r->y, &e2);
+    fq2_sub(&r->y, &r->y, &e2);
+    fq2_mul(&r->z, &b, &h);                 // Z = b h
+
+    fq2_neg(&line->c0, &h);
+    fq2_add(&line->c1, &j, &j);
+    fq2_add(&line->c1, &line->c1, &j);
+    line->c2 = i;
+}
+
+// Addition step: r += q, returning the line through both
+static void addition_step(G2Projective* r, const G2Affine* q, LineCoefficients* line) {
+    Fq2 theta, lambda, c, d, e, f, g, h, t;
+    fq2_mul(&theta, &q->y, &r->z);          // theta = Y - y Z
+    fq2_sub(&theta, &r->y, &theta);
+    fq2_mul(&lambda, &q->x, &r->z);         // lambda = X - x Z
+    fq2_sub(&lambda, &r->x, &lambda);
+    fq2_sqr(&c, &theta);
+    fq2_sqr(&d, &lambda);
+    fq2_mul(&e, &lambda, &d);
+    fq2_mul(&f, &r->z, &c);
+    fq2_mul(&g, &r->x, &d);
+    fq2_add(&h, &e, &f);                    // h = e + f - 2 g
+    fq2_sub(&h, &h, &g);
+    fq2_sub(&h, &h, &g);
+
+    fq2_mul(&r->x, &lambda, &h);            // X = lambda h
+    fq2_sub(&t, &g, &h);                    // Y = theta (g - h) - e Y
+    fq2_mul(&t, &t, &theta);
+    fq2_mul(&r->y, &e, &r->y);
+    fq2_sub(&r->y, &t, &r->y);
+    fq2_mul(&r->z, &r->z, &e);              // Z = Z e
+
+    line->c0 = lambda;
+    fq2_neg(&line->c1, &theta);
+    fq2_mul(&t, &theta, &q->x);             // c2 = theta x - lambda y
+    fq2_mul(&line->c2, &lambda, &q->y);
+    fq2_sub(&line->c2, &t, &line->c2);
+}
+
+// Helper to apply the Frobenius endomorphism to a point on the twist
+static void twist_frobenius(G2Affine* out, const G2Affine* q) {
+    fq2_conjugate(&out->x, &q->x);
+    fq2_mul(&out->x, &out->x, &FROBENIUS_TWIST_X);
+    fq2_conjugate(&out->y, &q->y);
+    fq2_mul(&out->y, &out->y, &FROBENIUS_TWIST_Y);
+}
+
+// Walk the loop count as the Miller loop will, recording each line
+void pairing_prepare(G2Prepared* out, const G2Affine* q) {
+    memset(out, 0, sizeof(*out));
+    if (g2_is_infinity(q)) {
+        out->infinity = 1;
+        return;
+    }
+    G2Projective r = {q->x, q->y, {FIELD_BN254_BASE.one, {{0}}}};
+    G2Affine minus_q;
+    g2_neg_affine(&minus_q, q);
+    int k = 0;
+    for (int i = ATE_LOOP_LENGTH - 2; i >= 0; i--) {
+        doubling_step(&r, &out->lines[k++]);
+        if (ATE_LOOP_NAF[i] == 1) addition_step(&r, q, &out->lines[k++]);
+        else if (ATE_LOOP_NAF[i] == -1) addition_step(&r, &minus_q, &out->lines[k++]);
+    }
+    // Lines through pi(Q) and -pi^2(Q)
+    G2Affine q1, q2;
+    twist_frobenius(&q1, q);
+    twist_frobenius(&q2, &q1);
+    fq2_neg(&q2.y, &q2.y);
+    addition_step(&r, &q1, &out->lines[k++]);
+    addition_step(&r, &q2, &out->lines[k++]);
+}
+
+// Helper to multiply f by a line evaluated at p
+static void evaluate_line(Fq12* f, const LineCoefficients* line, const G1Affine* p) {
+    Fq2 c0, c1;
+    fq2_scale(&c0, &line->c0, &p->y);
+    fq2_scale(&c1, &line->c1, &p->x);
+    fq12_mul_by_034(f, &c0, &c1, &line->c2);
+}
+
+void pairing_miller_loop(Fq12* out, const G1Affine* p, const G2Prepared* const* q, size_t n) {
+    Fq12 f;
+    fq12_set_one(&f);
+    int k = 0;
+    for (int i = ATE_LOOP_LENGTH - 2; i >= 0; i--) {
+        if (i != ATE_LOOP_LENGTH - 2) fq12_sqr(&f, &f);
+        for (size_t j = 0; j < n; j++) {
+            if (!q[j]->infinity && !g1_is_infinity(&p[j])) evaluate_line(&f, &q[j]->lines[k], &p[j]);
+        }
+        k++;
+        if (ATE_LOOP_NAF[i] != 0) {
+            for (size_t j = 0; j < n; j++) {
+                if (!q[j]->infinity && !g1_is_infinity(&p[j])) evaluate_line(&f, &q[j]->lines[k], &p[j]);
+            }
+            k++;
+        }
+    }
+    for (; k < PAIRING_LINE_COUNT; k++) {
+        for (size_t j = 0; j < n; j++) {
+            if (!q[j]->infinity && !g1_is_infinity(&p[j])) evaluate_line(&f, &q[j]->lines[k], &p[j]);
+        }
+    }
+    *out = f;
+}
+
+// Easy part f^((p^6 - 1)(p^2 + 1)) with a conjugation, an inversion and a
+// Frobenius map, then the hard part by plain exponentiation
+void pairing_final_exponentiation(Fq12* out, const Fq12* f) {
+    Fq12 t, inverse;
+    if (!fq12_inv(&inverse, f)) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    fq12_conjugate(&t, f);
+    fq12_mul(&t, &t, &inverse);
+    fq12_frobenius2(&inverse, &t);
+    fq12_mul(&t, &t, &inverse);
+    fq12_pow(out, &t, HARD_EXPONENT, HARD_EXPONENT_LIMBS);
+}
+
+void pairing(Fq12* out, const G1Affine* p, const G2Affine* q) {
+    G2Prepared prepared;
+    const G2Prepared* prepared_q = &prepared;
+    pairing_prepare(&prepared, q);
+    pairing_miller_loop(out, p, &prepared_q, 1);
+    pairing_final_exponentiation(out, out);
+}
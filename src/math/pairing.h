@@ -0,0 +1,84 @@
+#ifndef PAIRING_H
+#define PAIRING_H
+
+#include "curve.h"
+
+// The optimal ate pairing on BN254, e: G1 x G2 -> GT, where GT is a
+// subgroup of Fq12. Fq12 is built as a tower:
+//   Fq6  = Fq2[v] / (v^3 - (9 + u))
+//   Fq12 = Fq6[w] / (w^2 - v)
+typedef struct {
+    Fq2 c0, c1, c2;
+} Fq6;
+
+typedef struct {
+    Fq6 c0, c1;
+} Fq12;
+
+// Lines the Miller loop evaluates for each G2 point: one per doubling,
+// one per nonzero digit of the loop count, and two final ones
+#define PAIRING_LINE_COUNT 88
+
+// Coefficients of one line, evaluated at a G1 point (x, y) as the sparse
+// Fq12 element c0 * y + c1 * x * w + c2 * v * w
+typedef struct {
+    Fq2 c0, c1, c2;
+} LineCoefficients;
+
+// A G2 point with the lines of its Miller loop computed in advance. They
+// depend only on the G2 point, so a fixed point (e.g. of a verification
+// key) is prepared once and then paired with any G1 point for the cost of
+// evaluating the lines.
+typedef struct {
+    LineCoefficients lines[PAIRING_LINE_COUNT];
+    int infinity;                   // The point is at infinity (every pairing is 1)
+} G2Prepared;
+
+// Function prototypes
+
+// Fq12 arithmetic. Outputs may alias inputs.
+void fq12_set_one(Fq12* out);
+void fq12_mul(Fq12* out, const Fq12* a, const Fq12* b);
+void fq12_sqr(Fq12* out, const Fq12* a);
+int fq12_equal(const Fq12* a, const Fq12* b);
+int fq12_is_one(const Fq12* a);
+
+/**
+ * Raises an Fq12 element to the power of an integer.
+ *
+ * @param out Receives a^exponent.
+ * @param a The element.
+ * @param exponent The integer, little-endian.
+ * @param limbs Number of 64-bit limbs in exponent.
+ */
+void fq12_pow(Fq12* out, const Fq12* a, const uint64_t* exponent, size_t limbs);
+
+/**
+ * Computes the Miller loop lines of a G2 point.
+ */
+void pairing_prepare(G2Prepared* out, const G2Affine* q);
+
+/**
+ * Computes the product of the Miller loops of n pairs, sharing the Fq12
+ * squarings between them. The result is a pairing product only after
+ * pairing_final_exponentiation.
+ *
+ * @param out Receives the product.
+ * @param p The G1 points; pairs with a point at infinity are skipped.
+ * @param q The prepared G2 points.
+ * @param n Number of pairs.
+ */
+void pairing_miller_loop(Fq12* out, const G1Affine* p, const G2Prepared* const* q, size_t n);
+
+/**
+ * Raises a Miller loop result to the power (p^12 - 1) / r, mapping it
+ * into GT. A product of Miller loops needs only one final exponentiation.
+ */
+void pairing_final_exponentiation(Fq12* out, const Fq12* f);
+
+/**
+ * Computes the pairing of one pair of points.
+ */
+void pairing(Fq12* out, const G1Affine* p, const G2Affine* q);
+
+#endif // PAIRING_H
@@ -0,0 +1,126 @@
+#include "arena.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (1 << 20)
+#define ARENA_ALIGNMENT 8
+
+// Helper to round a size up to the arena alignment
+static inline size_t align_up(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// Helper to obtain a new block large enough for size bytes. Oversized
+// requests get a dedicated block linked behind the current one, so the
+// space left in the current block is not wasted.
+static ArenaBlock* new_block(Arena* arena, size_t size) {
+    size_t block_size = size > arena->block_size ? size : arena->block_size;
+    ArenaBlock* block = (ArenaBlock*)malloc(sizeof(ArenaBlock) + block_size);
+    if (!block) {
+        fprintf(stderr, "Error: Memory allocation failed for arena block.\n");
+        exit(1);
+    }
+    block->size = block_size;
+    block->used = 0;
+    if (arena->head && size > arena->block_size / 4) {
+        block->next = arena->head->next;
+        arena->head->next = block;
+    } else {
+        block->next = arena->head;
+        arena->head = block;
+    }
+    arena->blocks++;
+    arena->reserved += block_size;
+    return block;
+}
+
+// Initialize an empty arena
+void arena_init(Arena* arena, size_t block_size) {
+    arena->head = NULL;
+    arena->cleanups = NULL;
+    arena->block_size = block_size ? align_up(block_size) : ARENA_DEFAULT_BLOCK_SIZE;
+    arena->allocations = 0;
+    arena->bytes = 0;
+    arena->blocks = 0;
+    arena->reserved = 0;
+}
+
+// Bump-allocate size bytes
+void* arena_alloc(Arena* arena, size_t size) {
+    size = align_up(size ? size : 1);
+    ArenaBlock* block = arena->head;
+    if (!block || block->size - block->used < size) {
+        block = new_block(arena, size);
+    }
+    void* ptr = block->data + block->used;
+    block->used += size;
+    arena->allocations++;
+    arena->bytes += size;
+    return ptr;
+}
+
+// Allocate zeroed memory
+void* arena_calloc(Arena* arena, size_t count, size_t size) {
+    void* ptr = arena_alloc(arena, count * size);
+    memset(ptr, 0, count * size);
+    return ptr;
+}
+
+// Copy a string into the arena
+char* arena_strndup(Arena* arena, const char* text, size_t length) {
+    char* copy = (char*)arena_alloc(arena, length + 1);
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// Register a cleanup to run on reset
+void arena_add_cleanup(Arena* arena, void (*fn)(void* arg), void* arg) {
+    ArenaCleanup* cleanup = (ArenaCleanup*)arena_alloc(arena, sizeof(ArenaCleanup));
+    cleanup->fn = fn;
+    cleanup->arg = arg;
+    cleanup->next = arena->cleanups;
+    arena->cleanups = cleanup;
+}
+
+// Helper to run and forget all registered cleanups
+static void run_cleanups(Arena* arena) {
+    for (ArenaCleanup* cleanup = arena->cleanups; cleanup; cleanup = cleanup->next) {
+        cleanup->fn(cleanup->arg);
+    }
+    arena->cleanups = NULL;
+}
+
+// Release all allocations but keep the oldest block for reuse
+void arena_reset(Arena* arena) {
+    run_cleanups(arena);
+    ArenaBlock* block = arena->head;
+    while (block && block->next) {
+        ArenaBlock* next = block->next;
+        arena->reserved -= block->size;
+        free(block);
+        arena->blocks--;
+        block = next;
+    }
+    if (block) block->used = 0;
+    arena->head = block;
+    arena->allocations = 0;
+    arena->bytes = 0;
+}
+
+// Release all allocations and blocks
+void arena_free(Arena* arena) {
+    run_cleanups(arena);
+    ArenaBlock* block = arena->head;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->blocks = 0;
+    arena->reserved = 0;
+    arena->allocations = 0;
+    arena->bytes = 0;
+}
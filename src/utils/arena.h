@@ -0,0 +1,82 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// A block of arena memory; allocations are carved from data[] in order
+typedef struct ArenaBlock {
+    struct ArenaBlock* next;    // Previously filled block
+    size_t size;                // Usable bytes in data[]
+    size_t used;                // Bytes handed out so far
+    char data[];
+} ArenaBlock;
+
+// A function run when the arena is reset (e.g. to unmap a source file)
+typedef struct ArenaCleanup {
+    struct ArenaCleanup* next;
+    void (*fn)(void* arg);
+    void* arg;
+} ArenaCleanup;
+
+// A bump allocator: everything allocated from it is released at once
+typedef struct {
+    ArenaBlock* head;           // Block currently being filled
+    ArenaCleanup* cleanups;     // Cleanups to run on reset, newest first
+    size_t block_size;          // Default size of newly allocated blocks
+    size_t allocations;         // Number of arena_alloc calls
+    size_t bytes;               // Bytes handed out by arena_alloc
+    size_t blocks;              // Number of blocks obtained from malloc
+    size_t reserved;            // Bytes of those blocks
+} Arena;
+
+// Function prototypes
+
+/**
+ * Initializes an empty arena.
+ * 
+ * @param arena The arena to initialize.
+ * @param block_size Size of each block requested from malloc; 0 selects
+ *                   the default of 1 MiB.
+ */
+void arena_init(Arena* arena, size_t block_size);
+
+/**
+ * Allocates size bytes aligned to 8 bytes. Never returns NULL.
+ * 
+ * @param arena The arena to allocate from.
+ * @param size Number of bytes to allocate.
+ * @return Pointer to uninitialized memory owned by the arena.
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/**
+ * Allocates zeroed memory for count elements of the given size.
+ */
+void* arena_calloc(Arena* arena, size_t count, size_t size);
+
+/**
+ * Copies length bytes of text into the arena and NUL-terminates the copy.
+ */
+char* arena_strndup(Arena* arena, const char* text, size_t length);
+
+/**
+ * Registers a function to run when the arena is reset or freed.
+ */
+void arena_add_cleanup(Arena* arena, void (*fn)(void* arg), void* arg);
+
+/**
+ * Releases everything allocated from the arena and runs its cleanups. The
+ * first block is kept so the arena can be reused without touching malloc.
+ * 
+ * @param arena The arena to reset.
+ */
+void arena_reset(Arena* arena);
+
+/**
+ * Releases everything allocated from the arena, including all blocks.
+ * 
+ * @param arena The arena to free.
+ */
+void arena_free(Arena* arena);
+
+#endif // ARENA_H
@@ -0,0 +1,87 @@
+#include "context.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Initialize a compilation context
+void context_init(CompilerContext* ctx) {
+    arena_init(&ctx->arena, 0);
+    intern_init(&ctx->symbols, &ctx->arena);
+    field_pool_init(&ctx->constants, &ctx->arena);
+    ctx->field = &FIELD_BN254;
+    ctx->trace = NULL;
+    ctx->trace_user = NULL;
+    ctx->error_jump = NULL;
+    ctx->unwind = NULL;
+    ctx->diagnostics = NULL;
+    ctx->diagnostic_count = 0;
+    ctx->diagnostic_capacity = 0;
+    ctx->stats = NULL;
+}
+
+// Reset a context for the next compilation
+void context_reset(CompilerContext* ctx) {
+    arena_reset(&ctx->arena);
+    intern_clear(&ctx->symbols);
+    field_pool_init(&ctx->constants, &ctx->arena); // Its storage went with the arena
+    ctx->unwind = NULL;
+    ctx->diagnostics = NULL;
+    ctx->diagnostic_count = 0;
+    ctx->diagnostic_capacity = 0;
+}
+
+// Free a compilation context
+void context_free(CompilerContext* ctx) {
+    intern_free(&ctx->symbols);
+    arena_free(&ctx->arena);
+}
+
+// Format a trace message and pass it to the sink
+void context_trace(const CompilerContext* ctx, const char* format, ...) {
+    char message[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+    ctx->trace(ctx->trace_user, message);
+}
+
+// Record an error, unwind and return to the caller's handler
+void compile_error(CompilerContext* ctx, CompileStage stage, int line, int column, const char* format, ...) {
+    char message[512];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (ctx->diagnostic_count == ctx->diagnostic_capacity) {
+        uint32_t capacity = ctx->diagnostic_capacity ? ctx->diagnostic_capacity * 2 : 4;
+        Diagnostic* grown = (Diagnostic*)arena_alloc(&ctx->arena, sizeof(Diagnostic) * capacity);
+        if (ctx->diagnostic_count) memcpy(grown, ctx->diagnostics, sizeof(Diagnostic) * ctx->diagnostic_count);
+        ctx->diagnostics = grown;
+        ctx->diagnostic_capacity = capacity;
+    }
+    Diagnostic* diagnostic = &ctx->diagnostics[ctx->diagnostic_count++];
+    diagnostic->stage = stage;
+    diagnostic->line = line;
+    diagnostic->column = column;
+    diagnostic->message = arena_strndup(&ctx->arena, message, strlen(message));
+
+    while (ctx->unwind) {
+        ArenaCleanup* cleanup = ctx->unwind;
+        ctx->unwind = cleanup->next;
+        cleanup->fn(cleanup->arg);
+    }
+    if (ctx->error_jump) longjmp(*ctx->error_jump, 1);
+    print_diagnostic(stderr, NULL, diagnostic);
+    exit(1);
+}
+
+// Register a cleanup for compile_error to run
+void context_push_cleanup(CompilerContext* ctx, ArenaCleanup* cleanup, void (*fn)(void* arg), void* arg) {
+    cleanup->fn = fn;
+    cleanup->arg = arg;
+    cleanup->next = ctx->unwind;
+    ctx->unwind = cleanup;
+}
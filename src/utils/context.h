@@ -0,0 +1,122 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <setjmp.h>
+#include "arena.h"
+#include "error_handling.h"
+#include "intern.h"
+#include "stats.h"
+#include "../math/field_pool.h"
+
+// State owned by a single compilation. Tokens, AST nodes, symbol tables and
+// IR instructions are all allocated from the arena. Identifiers are
+// interned once and shared by every stage as Symbols; literals are parsed
+// once into a pool of field elements and shared by index.
+// Arithmetic is over the context's prime field (BN254's scalar field unless
+// the caller picks another).
+//
+// An error in the program ends the compilation through compile_error. If
+// the caller installed a jump buffer in error_jump, the error is recorded
+// in diagnostics and control returns to the caller's setjmp; otherwise it
+// is printed and the process exits. A function installing a jump buffer
+// saves error_jump and unwind, and clears unwind so an error only runs
+// the cleanups pushed after it; it restores both when it is done.
+typedef struct {
+    Arena arena;            // Owns every allocation of the compilation
+    InternTable symbols;    // Interned identifiers
+    FieldPool constants;    // Values of the program's literals, in ctx->field
+    const Field* field;     // Prime field the program computes over
+    void (*trace)(void* user, const char* message); // Optional sink for pass diagnostics
+    void* trace_user;       // Passed back to the trace sink
+    jmp_buf* error_jump;    // Where compile_error returns to, or NULL to exit
+    ArenaCleanup* unwind;   // Run by compile_error, newest first (see context_push_cleanup)
+    Diagnostic* diagnostics; // Errors of the current compilation, in the arena
+    uint32_t diagnostic_count;
+    uint32_t diagnostic_capacity;
+    CompileStats* stats;    // Optional phase timings and counters, added to by each stage
+} CompilerContext;
+
+// Emits a diagnostic to the context's trace sink. The arguments are only
+// evaluated and formatted when a sink is installed.
+#define TRACE(ctx, ...) \
+    do { if ((ctx)->trace) context_trace((ctx), __VA_ARGS__); } while (0)
+
+// Times a phase into the context's statistics, if it collects them. With
+// statistics off, each costs a single branch.
+#define PHASE_BEGIN(ctx, timer) \
+    do { if ((ctx)->stats) stats_begin(&(ctx)->arena, (timer)); } while (0)
+#define PHASE_END(ctx, phase, timer) \
+    do { if ((ctx)->stats) stats_end((ctx)->stats, &(ctx)->arena, (phase), (timer)); } while (0)
+
+// Adds n to one of the context's statistics counters, if it collects them
+#define STATS_COUNT(ctx, counter, n) \
+    do { if ((ctx)->stats) (ctx)->stats->counter += (n); } while (0)
+
+// Function prototypes
+
+/**
+ * Initializes a compilation context.
+ * 
+ * @param ctx The context to initialize.
+ */
+void context_init(CompilerContext* ctx);
+
+/**
+ * Discards everything produced by the current compilation so the context
+ * can be reused for another one.
+ * 
+ * @param ctx The context to reset.
+ */
+void context_reset(CompilerContext* ctx);
+
+/**
+ * Formats a message and passes it to the context's trace sink. Use the
+ * TRACE macro instead so disabled tracing costs a single branch.
+ */
+void context_trace(const CompilerContext* ctx, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/**
+ * Reports an error in the program and ends the compilation: the error is
+ * added to the context's diagnostics, the cleanups pushed with
+ * context_push_cleanup are run, and control passes to ctx->error_jump
+ * (with setjmp returning 1). Without a jump buffer the error is printed
+ * and the process exits.
+ *
+ * @param ctx The compilation's context.
+ * @param stage The stage reporting the error.
+ * @param line Line the error refers to, or 0 if none.
+ * @param column Column the error refers to, or 0 if none.
+ * @param format printf format of the message.
+ */
+void compile_error(CompilerContext* ctx, CompileStage stage, int line, int column, const char* format, ...)
+    __attribute__((noreturn, format(printf, 5, 6)));
+
+/**
+ * Registers a function that compile_error runs if it is called before the
+ * matching context_pop_cleanup, for functions holding memory outside the
+ * arena while they call code that can report errors. Cleanups nest: pop
+ * them in the reverse order they were pushed.
+ *
+ * @param ctx The compilation's context.
+ * @param cleanup Storage for the registration, usually on the caller's stack.
+ * @param fn Function to run.
+ * @param arg Passed to fn.
+ */
+void context_push_cleanup(CompilerContext* ctx, ArenaCleanup* cleanup, void (*fn)(void* arg), void* arg);
+
+/**
+ * Removes the most recently pushed cleanup without running it.
+ */
+static inline void context_pop_cleanup(CompilerContext* ctx, ArenaCleanup* cleanup) {
+    ctx->unwind = cleanup->next;
+}
+
+/**
+ * Releases all memory held by a compilation context.
+ * 
+ * @param ctx The context to free.
+ */
+void context_free(CompilerContext* ctx);
+
+#endif // CONTEXT_H
@@ -0,0 +1,30 @@
+#include "error_handling.h"
+
+// Name a stage
+const char* stage_name(CompileStage stage) {
+    switch (stage) {
+        case STAGE_LEXER: return "lexer";
+        case STAGE_PARSER: return "parser";
+        case STAGE_VALIDATOR: return "validator";
+        case STAGE_IR: return "IR generator";
+        case STAGE_OPTIMIZER: return "optimizer";
+        case STAGE_CONSTRAINTS: return "constraint compiler";
+    }
+    return "compiler";
+}
+
+// Format a diagnostic into a buffer
+int format_diagnostic(char* buffer, size_t size, const char* path, const Diagnostic* diagnostic) {
+    if (diagnostic->line > 0) {
+        return snprintf(buffer, size, "%s%s%d:%d: error: %s", path ? path : "", path ? ":" : "", diagnostic->line,
+                        diagnostic->column, diagnostic->message);
+    }
+    return snprintf(buffer, size, "%s%serror: %s", path ? path : "", path ? ": " : "", diagnostic->message);
+}
+
+// Print a diagnostic on its own line
+void print_diagnostic(FILE* out, const char* path, const Diagnostic* diagnostic) {
+    char line[1024];
+    format_diagnostic(line, sizeof(line), path, diagnostic);
+    fprintf(out, "%s\n", line);
+}
@@ -0,0 +1,49 @@
+#ifndef ERROR_HANDLING_H
+#define ERROR_HANDLING_H
+
+#include <stdio.h>
+
+// The compiler stage that reported a diagnostic
+typedef enum {
+    STAGE_LEXER,
+    STAGE_PARSER,
+    STAGE_VALIDATOR,
+    STAGE_IR,
+    STAGE_OPTIMIZER,
+    STAGE_CONSTRAINTS
+} CompileStage;
+
+// An error found in a program, with the source position it refers to
+typedef struct {
+    CompileStage stage;     // Stage that found the error
+    int line;               // 1-based line, or 0 if the error has no position
+    int column;             // 1-based column, or 0 if the error has no position
+    const char* message;    // What is wrong, e.g. "Undefined variable 'x'"
+} Diagnostic;
+
+// Function prototypes
+
+/**
+ * Returns the name of a stage, e.g. "parser".
+ */
+const char* stage_name(CompileStage stage);
+
+/**
+ * Prints a diagnostic as "path:line:column: error: message", leaving out
+ * the path if it is NULL and the position if the diagnostic has none.
+ *
+ * @param out Stream to print to.
+ * @param path Name of the source file, or NULL.
+ * @param diagnostic The diagnostic.
+ */
+void print_diagnostic(FILE* out, const char* path, const Diagnostic* diagnostic);
+
+/**
+ * Formats a diagnostic the way print_diagnostic prints it, without the
+ * newline, truncating it to fit.
+ *
+ * @return The length of the full text, as snprintf returns.
+ */
+int format_diagnostic(char* buffer, size_t size, const char* path, const Diagnostic* diagnostic);
+
+#endif // ERROR_HANDLING_H
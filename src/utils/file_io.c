@@ -0,0 +1,143 @@
+#include "file_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Reads the whole of fd into a heap buffer (fallback for unmappable files)
+static int read_fully(int fd, MappedFile* file) {
+    size_t capacity = 4096, size = 0;
+    char* buffer = malloc(capacity);
+    if (!buffer) return -1;
+
+    for (;;) {
+        if (size == capacity) {
+            capacity *= 2;
+            char* grown = realloc(buffer, capacity);
+            if (!grown) {
+                free(buffer);
+                return -1;
+            }
+            buffer = grown;
+        }
+        ssize_t n = read(fd, buffer + size, capacity - size);
+        if (n < 0) {
+            free(buffer);
+            return -1;
+        }
+        if (n == 0) break;
+        size += (size_t)n;
+    }
+
+    file->data = buffer;
+    file->size = size;
+    file->mapped = 0;
+    return 0;
+}
+
+// Map a file read-only into memory
+MappedFile* map_file(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    MappedFile* file = (MappedFile*)malloc(sizeof(MappedFile));
+    if (!file) {
+        close(fd);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            file->data = data;
+            file->size = (size_t)st.st_size;
+            file->mapped = 1;
+            close(fd);
+            return file;
+        }
+    }
+
+    if (read_fully(fd, file) != 0) {
+        free(file);
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+    return file;
+}
+
+// Release a mapped file
+void unmap_file(MappedFile* file) {
+    if (!file) return;
+    if (file->mapped) {
+        munmap((void*)file->data, file->size);
+    } else {
+        free((void*)file->data);
+    }
+    free(file);
+}
+
+// Helper to write all of a buffer, retrying short writes
+static int write_fully(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        data += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// Write a file from chunks via a temporary file
+int write_file(const char* path, const FileChunk* chunks, size_t count) {
+    static const char zeros[4096];
+    size_t length = strlen(path) + 32;
+    char* temp = malloc(length);
+    if (!temp) return -1;
+    snprintf(temp, length, "%s.tmp%ld", path, (long)getpid());
+
+    int fd = open(temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        free(temp);
+        return -1;
+    }
+    int status = 0;
+    for (size_t i = 0; i < count && status == 0; i++) {
+        if (chunks[i].data) {
+            status = write_fully(fd, chunks[i].data, chunks[i].size);
+            continue;
+        }
+        for (size_t left = chunks[i].size; left > 0 && status == 0;) {
+            size_t n = left < sizeof(zeros) ? left : sizeof(zeros);
+            status = write_fully(fd, zeros, n);
+            left -= n;
+        }
+    }
+    if (close(fd) != 0) status = -1;
+    if (status == 0 && rename(temp, path) != 0) status = -1;
+    if (status != 0) {
+        int saved = errno;
+        unlink(temp);
+        errno = saved;
+    }
+    free(temp);
+    return status;
+}
+
+// Append to a file through an O_APPEND descriptor
+int append_file(const char* path, const void* data, size_t size) {
+    int fd = open(path, O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) return -1;
+    int status = write_fully(fd, (const char*)data, size);
+    if (close(fd) != 0) status = -1;
+    return status;
+}
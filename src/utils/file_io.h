@@ -0,0 +1,61 @@
+#ifndef FILE_IO_H
+#define FILE_IO_H
+
+#include <stddef.h>
+
+// A read-only view of a file's contents
+typedef struct {
+    const char* data;   // File contents (not NUL-terminated)
+    size_t size;        // Size of the contents in bytes
+    int mapped;         // Non-zero if data is an mmap()ed region
+} MappedFile;
+
+// A piece of a file being written
+typedef struct {
+    const void* data;   // Bytes to write, or NULL for that many zero bytes
+    size_t size;        // Size of the piece in bytes
+} FileChunk;
+
+// Function prototypes
+
+/**
+ * Maps a file read-only into memory. Regular files are mmap()ed; anything
+ * that cannot be mapped (pipes, empty files) is read into a heap buffer.
+ * 
+ * @param path Path of the file to open.
+ * @return The mapped file, or NULL if the file could not be read.
+ */
+MappedFile* map_file(const char* path);
+
+/**
+ * Releases a file previously returned by map_file.
+ * 
+ * @param file The mapped file to release.
+ */
+void unmap_file(MappedFile* file);
+
+/**
+ * Writes a file from a sequence of chunks. The chunks go to a temporary
+ * file next to path, which is renamed over path once complete, so other
+ * processes never map a partially written file.
+ * 
+ * @param path Path of the file to write.
+ * @param chunks The pieces of the file, in order.
+ * @param count Number of chunks.
+ * @return 0 on success, -1 on failure (errno says why).
+ */
+int write_file(const char* path, const FileChunk* chunks, size_t count);
+
+/**
+ * Appends bytes to the end of a file, creating the file if it does not
+ * exist. A process that dies mid-write can leave a partial tail behind,
+ * so readers must tolerate one.
+ * 
+ * @param path Path of the file to append to.
+ * @param data Bytes to append.
+ * @param size Number of bytes.
+ * @return 0 on success, -1 on failure (errno says why).
+ */
+int append_file(const char* path, const void* data, size_t size);
+
+#endif // FILE_IO_H
@@ -0,0 +1,115 @@
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INITIAL_SLOTS 1024
+
+// FNV-1a hash of a string
+uint32_t intern_hash(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Initialize an intern table
+void intern_init(InternTable* table, Arena* arena) {
+    table->arena = arena;
+    table->entry_capacity = INITIAL_SLOTS / 2;
+    table->entries = (InternEntry*)malloc(sizeof(InternEntry) * table->entry_capacity);
+    table->slots = (InternSlot*)calloc(INITIAL_SLOTS, sizeof(InternSlot));
+    if (!table->entries || !table->slots) {
+        fprintf(stderr, "Error: Memory allocation failed for intern table.\n");
+        exit(1);
+    }
+    table->slot_mask = INITIAL_SLOTS - 1;
+    table->entries[0].text = NULL; // Reserve SYMBOL_NONE
+    table->entries[0].length = 0;
+    table->entries[0].hash = 0;
+    table->count = 1;
+}
+
+// Free the index of an intern table
+void intern_free(InternTable* table) {
+    free(table->entries);
+    free(table->slots);
+    table->entries = NULL;
+    table->slots = NULL;
+    table->count = 0;
+}
+
+// Forget all symbols
+void intern_clear(InternTable* table) {
+    memset(table->slots, 0, sizeof(InternSlot) * ((size_t)table->slot_mask + 1));
+    table->count = 1;
+}
+
+// Helper to double the hash table and reinsert every symbol
+static void grow_slots(InternTable* table) {
+    uint32_t mask = table->slot_mask * 2 + 1;
+    InternSlot* slots = (InternSlot*)calloc((size_t)mask + 1, sizeof(InternSlot));
+    if (!slots) {
+        fprintf(stderr, "Error: Memory allocation failed for intern table.\n");
+        exit(1);
+    }
+    for (uint32_t old = 0; old <= table->slot_mask; old++) {
+        if (table->slots[old].symbol == SYMBOL_NONE) continue;
+        uint32_t i = table->slots[old].hash & mask;
+        while (slots[i].symbol) i = (i + 1) & mask;
+        slots[i] = table->slots[old];
+    }
+    free(table->slots);
+    table->slots = slots;
+    table->slot_mask = mask;
+}
+
+// Look up or add a string
+Symbol intern(InternTable* table, const char* text, size_t length) {
+    return intern_hashed(table, text, length, intern_hash(text, length));
+}
+
+// Look up or add a string whose hash is known
+Symbol intern_hashed(InternTable* table, const char* text, size_t length, uint32_t hash) {
+    uint32_t i = hash & table->slot_mask;
+
+    // Linear probing; the table is kept at most half full
+    while (table->slots[i].symbol) {
+        if (table->slots[i].hash == hash) {
+            const InternEntry* entry = &table->entries[table->slots[i].symbol];
+            if (entry->length == length && memcmp(entry->text, text, length) == 0) {
+                return table->slots[i].symbol;
+            }
+        }
+        i = (i + 1) & table->slot_mask;
+    }
+
+    if (table->count == table->entry_capacity) {
+        table->entry_capacity *= 2;
+        InternEntry* entries = (InternEntry*)realloc(table->entries, sizeof(InternEntry) * table->entry_capacity);
+        if (!entries) {
+            fprintf(stderr, "Error: Memory allocation failed for intern table.\n");
+            exit(1);
+        }
+        table->entries = entries;
+    }
+
+    Symbol symbol = table->count++;
+    table->entries[symbol].text = arena_strndup(table->arena, text, length);
+    table->entries[symbol].length = (uint32_t)length;
+    table->entries[symbol].hash = hash;
+    table->slots[i].symbol = symbol;
+    table->slots[i].hash = hash;
+
+    if (table->count * 2 > table->slot_mask + 1) {
+        grow_slots(table);
+    }
+    return symbol;
+}
+
+// Intern a NUL-terminated string
+Symbol intern_cstr(InternTable* table, const char* text) {
+    return intern(table, text, strlen(text));
+}
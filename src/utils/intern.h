@@ -0,0 +1,111 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+// Handle of an interned string. Equal strings have equal handles, so names
+// and literals compare with ==. SYMBOL_NONE is never a valid handle.
+typedef uint32_t Symbol;
+
+#define SYMBOL_NONE 0
+
+// Interned string storage entry
+typedef struct {
+    const char* text;   // NUL-terminated copy of the string (in the arena)
+    uint32_t length;    // Length of the string in bytes
+    uint32_t hash;      // Cached hash of the string
+} InternEntry;
+
+// Hash table slot. The hash is kept next to the symbol so probes can skip
+// other strings without loading their entries.
+typedef struct {
+    uint32_t symbol;    // Symbol in the slot (SYMBOL_NONE = empty)
+    uint32_t hash;      // Hash of the symbol's string
+} InternSlot;
+
+// A table mapping strings to small integer handles
+typedef struct {
+    Arena* arena;           // Arena holding the string bytes
+    InternEntry* entries;   // Entries indexed by symbol; entries[0] is unused
+    uint32_t count;         // Number of entries, including the unused one
+    uint32_t entry_capacity;
+    InternSlot* slots;      // Open-addressing hash table of symbols
+    uint32_t slot_mask;     // Number of slots minus one (power of two)
+} InternTable;
+
+// Function prototypes
+
+/**
+ * Initializes an intern table whose strings are stored in the given arena.
+ */
+void intern_init(InternTable* table, Arena* arena);
+
+/**
+ * Releases the table's index. String bytes are released with the arena.
+ */
+void intern_free(InternTable* table);
+
+/**
+ * Forgets every interned string, keeping the index allocated. Must be
+ * paired with a reset of the arena holding the strings.
+ */
+void intern_clear(InternTable* table);
+
+/**
+ * Returns the handle for the given string, adding it if necessary.
+ * 
+ * @param table The intern table.
+ * @param text The string (need not be NUL-terminated).
+ * @param length Length of the string in bytes.
+ * @return The symbol for the string.
+ */
+Symbol intern(InternTable* table, const char* text, size_t length);
+
+/**
+ * Hashes a string the way the intern table does.
+ */
+uint32_t intern_hash(const char* text, size_t length);
+
+/**
+ * Like intern(), for a string whose intern_hash() is already known.
+ * Callers interning many strings can hash and intern_prefetch() each one
+ * a few strings ahead, so the table lookups overlap their cache misses.
+ * 
+ * @param table The intern table.
+ * @param text The string (need not be NUL-terminated).
+ * @param length Length of the string in bytes.
+ * @param hash intern_hash(text, length).
+ * @return The symbol for the string.
+ */
+Symbol intern_hashed(InternTable* table, const char* text, size_t length, uint32_t hash);
+
+/**
+ * Starts loading the slot a string with the given hash would be found at.
+ * Only a hint; the table may grow before the string is interned.
+ */
+static inline void intern_prefetch(const InternTable* table, uint32_t hash) {
+    __builtin_prefetch(&table->slots[hash & table->slot_mask]);
+}
+
+/**
+ * Interns a NUL-terminated string.
+ */
+Symbol intern_cstr(InternTable* table, const char* text);
+
+/**
+ * Returns the NUL-terminated text of a symbol, or NULL for SYMBOL_NONE.
+ */
+static inline const char* symbol_text(const InternTable* table, Symbol symbol) {
+    return symbol == SYMBOL_NONE ? NULL : table->entries[symbol].text;
+}
+
+/**
+ * Returns the length in bytes of a symbol's text.
+ */
+static inline uint32_t symbol_length(const InternTable* table, Symbol symbol) {
+    return table->entries[symbol].length;
+}
+
+#endif // INTERN_H
@@ -0,0 +1,146 @@
+#include "stats.h"
+#include <stddef.h>
+#include <time.h>
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "lex", "parse", "validate", "irgen", "optimize", "constraints", "write",
+};
+
+// Read the monotonic clock
+double stats_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Name a phase
+const char* phase_name(CompilePhase phase) {
+    return phase < PHASE_COUNT ? PHASE_NAMES[phase] : "unknown";
+}
+
+// Start timing a phase
+void stats_begin(const Arena* arena, PhaseTimer* timer) {
+    timer->allocations = arena->allocations;
+    timer->bytes = arena->bytes;
+    timer->start = stats_now();
+}
+
+// Add a phase's time and arena use
+void stats_end(CompileStats* stats, const Arena* arena, CompilePhase phase, const PhaseTimer* timer) {
+    PhaseStats* p = &stats->phases[phase];
+    p->seconds += stats_now() - timer->start;
+    p->allocations += arena->allocations - timer->allocations;
+    p->bytes += arena->bytes - timer->bytes;
+}
+
+// Add an optimizer pass's time
+void stats_add_pass(CompileStats* stats, int pass, const char* name, double seconds) {
+    stats->pass_seconds[pass] += seconds;
+    stats->pass_names[pass] = name;
+    if (pass >= stats->pass_count) stats->pass_count = pass + 1;
+}
+
+// End a compilation
+void stats_finish(CompileStats* stats, const Arena* arena) {
+    stats->compilations++;
+    stats->allocations += arena->allocations;
+    stats->bytes += arena->bytes;
+    stats->blocks += arena->blocks;
+    if (arena->reserved > stats->peak_bytes) stats->peak_bytes = arena->reserved;
+}
+
+// Sum two sets of statistics
+void stats_merge(CompileStats* total, const CompileStats* stats) {
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        total->phases[p].seconds += stats->phases[p].seconds;
+        total->phases[p].allocations += stats->phases[p].allocations;
+        total->phases[p].bytes += stats->phases[p].bytes;
+    }
+    for (int p = 0; p < stats->pass_count; p++) {
+        if (stats->pass_names[p]) stats_add_pass(total, p, stats->pass_names[p], stats->pass_seconds[p]);
+    }
+    total->compilations += stats->compilations;
+    total->source_bytes += stats->source_bytes;
+    total->tokens += stats->tokens;
+    total->ast_nodes += stats->ast_nodes;
+    total->ir_instructions += stats->ir_instructions;
+    total->ir_optimized += stats->ir_optimized;
+    total->constraints += stats->constraints;
+    total->variables += stats->variables;
+    total->nonzeros += stats->nonzeros;
+    total->allocations += stats->allocations;
+    total->bytes += stats->bytes;
+    total->blocks += stats->blocks;
+    if (stats->peak_bytes > total->peak_bytes) total->peak_bytes = stats->peak_bytes;
+}
+
+// Counters in the order they are printed
+static const struct {
+    const char* name;
+    size_t offset;
+} COUNTERS[] = {
+    {"compilations", offsetof(CompileStats, compilations)},
+    {"source_bytes", offsetof(CompileStats, source_bytes)},
+    {"tokens", offsetof(CompileStats, tokens)},
+    {"ast_nodes", offsetof(CompileStats, ast_nodes)},
+    {"ir_instructions", offsetof(CompileStats, ir_instructions)},
+    {"ir_optimized", offsetof(CompileStats, ir_optimized)},
+    {"constraints", offsetof(CompileStats, constraints)},
+    {"variables", offsetof(CompileStats, variables)},
+    {"nonzeros", offsetof(CompileStats, nonzeros)},
+    {"allocations", offsetof(CompileStats, allocations)},
+    {"bytes", offsetof(CompileStats, bytes)},
+    {"blocks", offsetof(CompileStats, blocks)},
+    {"peak_bytes", offsetof(CompileStats, peak_bytes)},
+};
+
+#define COUNTER_COUNT (sizeof(COUNTERS) / sizeof(COUNTERS[0]))
+
+// Helper to read counter i
+static unsigned long long counter_value(const CompileStats* stats, size_t i) {
+    return *(const uint64_t*)((const char*)stats + COUNTERS[i].offset);
+}
+
+// Print statistics as a table
+void print_stats(FILE* out, const CompileStats* stats) {
+    double total = 0;
+    for (int p = 0; p < PHASE_COUNT; p++) total += stats->phases[p].seconds;
+    fprintf(out, "%-26s %10s %6s %12s %14s\n", "Phase", "Seconds", "Share", "Allocations", "Bytes");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const PhaseStats* phase = &stats->phases[p];
+        fprintf(out, "%-26s %10.6f %5.1f%% %12llu %14llu\n", PHASE_NAMES[p], phase->seconds,
+                total > 0 ? phase->seconds / total * 100 : 0.0, (unsigned long long)phase->allocations,
+                (unsigned long long)phase->bytes);
+        if (p != PHASE_OPTIMIZE) continue;
+        for (int q = 0; q < stats->pass_count; q++) {
+            if (stats->pass_names[q]) fprintf(out, "  %-24s %10.6f\n", stats->pass_names[q], stats->pass_seconds[q]);
+        }
+    }
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        fprintf(out, "%-26s %10llu\n", COUNTERS[i].name, counter_value(stats, i));
+    }
+}
+
+// Print statistics as JSON
+void print_stats_json(FILE* out, const CompileStats* stats, int indent) {
+    fprintf(out, "{\n%*s\"phases\": {", indent + 2, "");
+    for (int p = 0; p < PHASE_COUNT; p++) {
+        const PhaseStats* phase = &stats->phases[p];
+        fprintf(out, "%s\n%*s\"%s\": {\"seconds\": %.9f, \"allocations\": %llu, \"bytes\": %llu}", p ? "," : "",
+                indent + 4, "", PHASE_NAMES[p], phase->seconds, (unsigned long long)phase->allocations,
+                (unsigned long long)phase->bytes);
+    }
+    fprintf(out, "\n%*s},\n%*s\"passes\": {", indent + 2, "", indent + 2, "");
+    int first = 1;
+    for (int q = 0; q < stats->pass_count; q++) {
+        if (!stats->pass_names[q]) continue;
+        fprintf(out, "%s\n%*s\"%s\": {\"seconds\": %.9f}", first ? "" : ",", indent + 4, "", stats->pass_names[q],
+                stats->pass_seconds[q]);
+        first = 0;
+    }
+    fprintf(out, "%s%*s},\n%*s\"counters\": {", first ? "" : "\n", first ? 0 : indent + 2, "", indent + 2, "");
+    for (size_t i = 0; i < COUNTER_COUNT; i++) {
+        fprintf(out, "%s\n%*s\"%s\": %llu", i ? "," : "", indent + 4, "", COUNTERS[i].name, counter_value(stats, i));
+    }
+    fprintf(out, "\n%*s}\n%*s}", indent + 2, "", indent, "");
+}
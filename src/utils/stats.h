@@ -0,0 +1,120 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "arena.h"
+
+// Phases of a compilation, timed separately
+typedef enum {
+    PHASE_LEX,
+    PHASE_PARSE,
+    PHASE_VALIDATE,
+    PHASE_IRGEN,
+    PHASE_OPTIMIZE,
+    PHASE_CONSTRAINTS,
+    PHASE_WRITE,
+    PHASE_COUNT
+} CompilePhase;
+
+// Most optimizer passes timed separately
+#define STATS_MAX_PASSES 8
+
+// Time and arena use of one phase
+typedef struct {
+    double seconds;
+    uint64_t allocations;       // Arena allocations made in the phase
+    uint64_t bytes;             // Arena bytes handed out in the phase
+} PhaseStats;
+
+// What compilations cost, phase by phase. A context fills in the
+// statistics its stats field points to, adding to what is there, so one
+// CompileStats can sum up many compilations (see stats_merge).
+typedef struct {
+    PhaseStats phases[PHASE_COUNT];
+    double pass_seconds[STATS_MAX_PASSES];      // Each optimizer pass, over all its rounds
+    const char* pass_names[STATS_MAX_PASSES];
+    int pass_count;
+    uint64_t compilations;
+    uint64_t source_bytes;
+    uint64_t tokens;                // Including the end of input
+    uint64_t ast_nodes;
+    uint64_t ir_instructions;       // Generated, before optimization
+    uint64_t ir_optimized;          // Left after optimization
+    uint64_t constraints;
+    uint64_t variables;
+    uint64_t nonzeros;              // Of A, B and C together
+    uint64_t allocations;           // Arena allocations of whole compilations
+    uint64_t bytes;                 // Arena bytes of whole compilations
+    uint64_t blocks;                // Arena blocks obtained from malloc
+    uint64_t peak_bytes;            // Most arena memory one compilation held
+} CompileStats;
+
+// Where a phase started, for stats_end
+typedef struct {
+    double start;
+    size_t allocations;
+    size_t bytes;
+} PhaseTimer;
+
+// Function prototypes
+
+/**
+ * Returns the monotonic clock in seconds.
+ */
+double stats_now(void);
+
+/**
+ * Returns the name of a phase, e.g. "parse".
+ */
+const char* phase_name(CompilePhase phase);
+
+/**
+ * Starts timing a phase. Use the PHASE_BEGIN macro of context.h instead so
+ * disabled statistics cost a single branch.
+ *
+ * @param arena The compilation's arena, whose use is measured.
+ * @param timer Receives the starting point.
+ */
+void stats_begin(const Arena* arena, PhaseTimer* timer);
+
+/**
+ * Adds the time and arena use since stats_begin to a phase.
+ */
+void stats_end(CompileStats* stats, const Arena* arena, CompilePhase phase, const PhaseTimer* timer);
+
+/**
+ * Adds time spent in an optimizer pass.
+ *
+ * @param stats The statistics.
+ * @param pass Index of the pass, below STATS_MAX_PASSES.
+ * @param name Name of the pass; must outlive the statistics.
+ * @param seconds Time the pass took.
+ */
+void stats_add_pass(CompileStats* stats, int pass, const char* name, double seconds);
+
+/**
+ * Ends a compilation, adding the arena's totals. Call it before the
+ * context is reset.
+ */
+void stats_finish(CompileStats* stats, const Arena* arena);
+
+/**
+ * Adds one set of statistics to another; peak memory is the larger of the
+ * two.
+ */
+void stats_merge(CompileStats* total, const CompileStats* stats);
+
+/**
+ * Prints statistics as a table.
+ */
+void print_stats(FILE* out, const CompileStats* stats);
+
+/**
+ * Prints statistics as a JSON object with "phases", "passes" and
+ * "counters" members, indented by the given number of spaces after its
+ * first line.
+ */
+void print_stats_json(FILE* out, const CompileStats* stats, int indent);
+
+#endif // STATS_H
@@ -0,0 +1,199 @@
+#include "thread_pool.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+// The tasks a worker has left, as a packed [begin, end) pair so the owner
+// (taking from the front) and thieves (taking from the back) can both
+// claim tasks with a single compare-and-swap. Padded to a cache line so
+// workers don't contend on each other's ranges.
+typedef struct {
+    _Atomic uint64_t range;
+    char padding[64 - sizeof(uint64_t)];
+} WorkerRange;
+
+struct ThreadPool {
+    int size;                   // Workers, including the calling thread
+    pthread_t* threads;         // Helper threads (size - 1)
+    WorkerRange* ranges;        // Remaining tasks of each worker
+    pthread_mutex_t lock;
+    pthread_cond_t start;       // Signalled when a batch is posted
+    pthread_cond_t done;        // Signalled when the last helper finishes
+    uint64_t generation;        // Incremented for every batch
+    int active;                 // Helpers still working on the current batch
+    int shutdown;
+    ThreadPoolTask task;        // Current batch
+    void* arg;
+};
+
+// Helpers for packing ranges
+static inline uint64_t pack(uint32_t begin, uint32_t end) {
+    return ((uint64_t)begin << 32) | end;
+}
+static inline uint32_t range_begin(uint64_t range) {
+    return (uint32_t)(range >> 32);
+}
+static inline uint32_t range_end(uint64_t range) {
+    return (uint32_t)range;
+}
+
+// Helper to claim the next task of a worker's own range
+static int take_own(WorkerRange* own, uint32_t* task) {
+    uint64_t range = atomic_load(&own->range);
+    while (range_begin(range) < range_end(range)) {
+        if (atomic_compare_exchange_weak(&own->range, &range, pack(range_begin(range) + 1, range_end(range)))) {
+            *task = range_begin(range);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Helper to move the back half of the fullest other range into ours
+static int steal(ThreadPool* pool, int worker) {
+    for (;;) {
+        int victim = -1;
+        uint32_t most = 0;
+        for (int w = 0; w < pool->size; w++) {
+            uint64_t range = atomic_load(&pool->ranges[w].range);
+            uint32_t left = range_end(range) - range_begin(range);
+            if (w != worker && range_begin(range) < range_end(range) && left > most) {
+                most = left;
+                victim = w;
+            }
+        }
+        if (victim < 0) return 0; // Nothing left anywhere
+
+        uint64_t range = atomic_load(&pool->ranges[victim].range);
+        uint32_t begin = range_begin(range), end = range_end(range);
+        if (begin >= end) continue;
+        uint32_t split = end - (end - begin + 1) / 2;
+        if (atomic_compare_exchange_strong(&pool->ranges[victim].range, &range, pack(begin, split))) {
+            // Our range is empty, so no thief touches it until we publish this
+            atomic_store(&pool->ranges[worker].range, pack(split, end));
+            return 1;
+        }
+    }
+}
+
+// Run tasks until none are left in any range
+static void work(ThreadPool* pool, int worker) {
+    uint32_t task;
+    do {
+        while (take_own(&pool->ranges[worker], &task)) {
+            pool->task(pool->arg, task, worker);
+        }
+    } while (steal(pool, worker));
+}
+
+// Helper thread: wait for a batch, work on it, report completion
+static void* helper_main(void* arg) {
+    ThreadPool* pool = (ThreadPool*)((void**)arg)[0];
+    int worker = (int)(intptr_t)((void**)arg)[1];
+    free(arg);
+
+    uint64_t seen = 0;
+    pthread_mutex_lock(&pool->lock);
+    for (;;) {
+        while (pool->generation == seen && !pool->shutdown) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        if (pool->shutdown) break;
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        work(pool, worker);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->active == 0) pthread_cond_signal(&pool->done);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+// Start the helper threads
+ThreadPool* thread_pool_create(int threads) {
+    if (threads <= 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cpus > 0 ? (int)cpus : 1;
+    }
+
+    ThreadPool* pool = (ThreadPool*)calloc(1, sizeof(ThreadPool));
+    void* ranges = NULL;
+    if (!pool || posix_memalign(&ranges, 64, sizeof(WorkerRange) * threads) != 0) {
+        fprintf(stderr, "Error: Memory allocation failed for thread pool.\n");
+        exit(1);
+    }
+    pool->size = threads;
+    pool->ranges = (WorkerRange*)ranges;
+    for (int w = 0; w < threads; w++) atomic_init(&pool->ranges[w].range, 0);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    pool->threads = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+    for (int w = 1; w < threads; w++) {
+        void** arg = (void**)malloc(sizeof(void*) * 2);
+        if (!pool->threads || !arg) {
+            fprintf(stderr, "Error: Memory allocation failed for thread pool.\n");
+            exit(1);
+        }
+        arg[0] = pool;
+        arg[1] = (void*)(intptr_t)w;
+        if (pthread_create(&pool->threads[w - 1], NULL, helper_main, arg) != 0) {
+            fprintf(stderr, "Error: Could not start worker thread %d.\n", w);
+            exit(1);
+        }
+    }
+    return pool;
+}
+
+// Report the number of workers
+int thread_pool_size(const ThreadPool* pool) {
+    return pool->size;
+}
+
+// Split the tasks evenly, wake the helpers and work alongside them
+void thread_pool_run(ThreadPool* pool, uint32_t count, ThreadPoolTask task, void* arg) {
+    if (count == 0) return;
+    pool->task = task;
+    pool->arg = arg;
+    for (int w = 0; w < pool->size; w++) {
+        uint32_t begin = (uint32_t)((uint64_t)count * w / pool->size);
+        uint32_t end = (uint32_t)((uint64_t)count * (w + 1) / pool->size);
+        atomic_store(&pool->ranges[w].range, pack(begin, end));
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->active = pool->size - 1;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->active > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Stop and join the helpers
+void thread_pool_destroy(ThreadPool* pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+    for (int w = 1; w < pool->size; w++) {
+        pthread_join(pool->threads[w - 1], NULL);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+    free(pool->threads);
+    free(pool->ranges);
+    free(pool);
+}
@@ -0,0 +1,48 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdint.h>
+
+// A fixed set of worker threads that run batches of independent tasks.
+// Each batch's task indices are split into one contiguous range per
+// worker; a worker that runs out steals half of the largest remaining
+// range of another, so uneven tasks still keep every thread busy.
+typedef struct ThreadPool ThreadPool;
+
+// A task function: runs task number `task` on worker `worker`
+// (0 <= worker < thread_pool_size), e.g. to index per-worker scratch.
+typedef void (*ThreadPoolTask)(void* arg, uint32_t task, int worker);
+
+// Function prototypes
+
+/**
+ * Starts a thread pool. The thread calling thread_pool_run takes part as
+ * worker 0, so threads - 1 helper threads are started.
+ * 
+ * @param threads Number of workers; 0 selects the number of online CPUs.
+ * @return The pool. Exits on failure.
+ */
+ThreadPool* thread_pool_create(int threads);
+
+/**
+ * Returns the number of workers in a pool.
+ */
+int thread_pool_size(const ThreadPool* pool);
+
+/**
+ * Runs tasks 0 .. count - 1 across the pool and waits for all of them.
+ * Tasks may run in any order and concurrently with each other.
+ * 
+ * @param pool The pool.
+ * @param count Number of tasks.
+ * @param task Function run once per task.
+ * @param arg Passed to every call of task.
+ */
+void thread_pool_run(ThreadPool* pool, uint32_t count, ThreadPoolTask task, void* arg);
+
+/**
+ * Stops the pool's threads and frees it.
+ */
+void thread_pool_destroy(ThreadPool* pool);
+
+#endif // THREAD_POOL_H
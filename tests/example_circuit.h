@@ -0,0 +1,55 @@
+#ifndef EXAMPLE_CIRCUIT_H
+#define EXAMPLE_CIRCUIT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "../src/backend/verifier_generator.h"
+
+// The circuit whose verifier tests/gen_verifier generates, shared with the
+// programs that link the generated verifier so they agree on the key. Its
+// public variables are y, k and the output w.
+#define EXAMPLE_SOURCE "public y\npublic k\ninput x\nz = x * x * x + k * x\nassert(z == y)\nw = z * k\noutput w"
+#define EXAMPLE_PUBLIC_COUNT 3
+
+static const char* const EXAMPLE_PUBLIC_NAMES[EXAMPLE_PUBLIC_COUNT] = {"y", "k", "w"};
+
+// Helper to compile the example and derive its key from a fixed trapdoor
+static inline VerifyingKey* example_setup(CompilerContext* ctx, Groth16Trapdoor* trapdoor,
+                                          FieldElement ic_scalars[EXAMPLE_PUBLIC_COUNT + 1]) {
+    AST* ast = parse_tokens(ctx, tokenize(ctx, EXAMPLE_SOURCE));
+    validate_program(ctx, ast);
+    IRProgram* program = generate_ir(ctx, ast);
+    optimize_ir(ctx, program);
+    R1CS* r1cs = compile_constraints(ctx, program);
+    if (r1cs->public_count != EXAMPLE_PUBLIC_COUNT) {
+        fprintf(stderr, "Error: Example circuit has %u public variables.\n", r1cs->public_count);
+        exit(1);
+    }
+    field_from_u64(&FIELD_BN254, &trapdoor->tau, 0x5eed0001d15c0ull);
+    field_from_u64(&FIELD_BN254, &trapdoor->alpha, 0xa1fa);
+    field_from_u64(&FIELD_BN254, &trapdoor->beta, 0xbe7a);
+    field_from_u64(&FIELD_BN254, &trapdoor->gamma, 0x6a33a);
+    field_from_u64(&FIELD_BN254, &trapdoor->delta, 0xde17a);
+    return groth16_setup(ctx, r1cs, trapdoor, ic_scalars);
+}
+
+// Helper to make the public values of the statement with witness x:
+// y = x^3 + k x and w = y k
+static inline void example_inputs(FieldElement inputs[EXAMPLE_PUBLIC_COUNT], uint64_t x, uint64_t k) {
+    FieldElement fx, t;
+    field_from_u64(&FIELD_BN254, &fx, x);
+    field_from_u64(&FIELD_BN254, &inputs[1], k);
+    field_sqr(&FIELD_BN254, &t, &fx);
+    field_mul(&FIELD_BN254, &t, &t, &fx);
+    field_mul(&FIELD_BN254, &inputs[0], &inputs[1], &fx);
+    field_add(&FIELD_BN254, &inputs[0], &inputs[0], &t);
+    field_mul(&FIELD_BN254, &inputs[2], &inputs[0], &inputs[1]);
+}
+
+// The verifier tests/gen_verifier generates for it
+int example_verify(const Groth16Proof* proof, const FieldElement* inputs);
+int example_verify_batch(const Groth16Proof* proofs, const FieldElement* inputs, size_t count);
+
+#endif // EXAMPLE_CIRCUIT_H
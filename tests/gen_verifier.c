@@ -0,0 +1,32 @@
+#include "example_circuit.h"
+
+// Writes the specialized verifier of the example circuit, which
+// tests/test_verifier and bench/bench_verifier link against.
+//
+// Usage: gen_verifier <output.c>
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output.c>\n", argv[0]);
+        return 1;
+    }
+    CompilerContext ctx;
+    context_init(&ctx);
+    Groth16Trapdoor trapdoor;
+    VerifyingKey* key = example_setup(&ctx, &trapdoor, NULL);
+
+    FILE* out = fopen(argv[1], "w");
+    if (!out) {
+        perror(argv[1]);
+        return 1;
+    }
+    int status = generate_verifier(key, "example", EXAMPLE_PUBLIC_NAMES, out);
+    if (fclose(out) != 0) status = -1;
+    if (status != 0) {
+        fprintf(stderr, "Error: Could not write %s.\n", argv[1]);
+        remove(argv[1]);
+        return 1;
+    }
+    context_free(&ctx);
+    return 0;
+}
@@ -0,0 +1,20 @@
+#ifndef R1CS_EVAL_H
+#define R1CS_EVAL_H
+
+#include "../src/backend/constraint_compiler.h"
+
+// Reference evaluation of constraint rows for the tests: one multiply per
+// nonzero, no shortcuts, so it can check the optimized evaluators.
+
+// Helper to evaluate one row of a matrix against a witness
+static inline FieldElement dot(const Field* field, const R1CS* r1cs, const SparseMatrix* m, uint32_t row,
+                               const FieldElement* witness) {
+    FieldElement sum = {{0}}, term;
+    for (uint32_t k = m->row_offsets[row]; k < m->row_offsets[row + 1]; k++) {
+        field_mul(field, &term, field_pool_get(&r1cs->coefficients, m->coefficients[k]), &witness[m->columns[k]]);
+        field_add(field, &sum, &sum, &term);
+    }
+    return sum;
+}
+
+#endif // R1CS_EVAL_H
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../include/zkl.h"
+#include "../src/backend/circuit_file.h"
+
+static int failures = 0;
+
+static const char* SOURCE =
+    "public y\n"
+    "input a\n"
+    "input b\n"
+    "s = a + b\n"
+    "p = s * a\n"
+    "assert(p == y)\n"
+    "output p\n";
+
+// Helper to compile a program and check it has the given size
+static ZklCircuit* expect_circuit(ZklCompiler* compiler, const char* source, uint32_t constraints) {
+    ZklCircuit* circuit = NULL;
+    ZklStatus status = zkl_compile(compiler, source, strlen(source), &circuit);
+    if (status != ZKL_OK || !circuit || zkl_diagnostic_count(compiler) != 0) {
+        printf("FAILED: compiling a valid program gave '%s'\n", zkl_status_string(status));
+        failures++;
+        return NULL;
+    }
+    ZklCircuitInfo info;
+    zkl_circuit_info(circuit, &info);
+    if (info.constraints != constraints) {
+        printf("FAILED: %u constraints, expected %u\n", info.constraints, constraints);
+        failures++;
+    }
+    return circuit;
+}
+
+// Helper to compile a program with an error and check the diagnostic
+static void expect_error(ZklCompiler* compiler, const char* source, ZklStage stage, const char* expected) {
+    ZklCircuit* circuit = (ZklCircuit*)1;
+    ZklStatus status = zkl_compile(compiler, source, strlen(source), &circuit);
+    const ZklDiagnostic* diagnostic = zkl_diagnostic(compiler, 0);
+    char text[256] = "";
+    if (diagnostic) zkl_format_diagnostic(diagnostic, "test.zkl", text, sizeof(text));
+    if (status != ZKL_ERROR_SOURCE || circuit != NULL || zkl_diagnostic_count(compiler) != 1 || !diagnostic ||
+        diagnostic->stage != stage || strcmp(text, expected) != 0 || zkl_diagnostic(compiler, 1) != NULL) {
+        printf("FAILED: got '%s' from stage %d, expected '%s' from stage %d\n", text,
+               diagnostic ? (int)diagnostic->stage : -1, expected, stage);
+        failures++;
+    }
+}
+
+int main() {
+    ZklCompiler* compiler = zkl_compiler_create();
+
+    // A valid program, described and saved
+    ZklCircuit* circuit = expect_circuit(compiler, SOURCE, 3);
+    if (circuit) {
+        ZklCircuitInfo info;
+        zkl_circuit_info(circuit, &info);
+        printf("valid: %u constraints, %u variables, %u public, %u outputs, %u private\n", info.constraints,
+               info.variables, info.public_inputs, info.public_outputs, info.private_inputs);
+        if (info.public_inputs != 1 || info.public_outputs != 1 || info.private_inputs != 2) {
+            printf("FAILED: wrong circuit interface\n");
+            failures++;
+        }
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/test_api_%ld.zklc", (long)getpid());
+        Circuit* saved = NULL;
+        if (zkl_circuit_save(circuit, path) != ZKL_OK || !(saved = load_circuit(path)) ||
+            saved->header->constraint_count != info.constraints) {
+            printf("FAILED: could not save and reload the circuit\n");
+            failures++;
+        }
+        if (saved) free_circuit(saved);
+        remove(path);
+        if (zkl_circuit_save(circuit, "/nonexistent/circuit.zklc") != ZKL_ERROR_IO) {
+            printf("FAILED: saving to a missing directory succeeded\n");
+            failures++;
+        }
+    }
+
+    // Each stage's errors come back with their position, and the process
+    // carries on
+    expect_error(compiler, "input a\nb = a $ 2\n", ZKL_STAGE_LEXER, "test.zkl:2:7: error: Unexpected character '$'");
+    expect_error(compiler, "input a\nb = a * \n", ZKL_STAGE_PARSER, "test.zkl:3:1: error: Unexpected end of input");
+    expect_error(compiler, "input a\nb = a * (a + 1\noutput b\n", ZKL_STAGE_PARSER,
+                 "test.zkl:3:1: error: Expected ')' after expression");
+    expect_error(compiler, "input a\nb = a * c\n", ZKL_STAGE_VALIDATOR,
+                 "test.zkl:2:9: error: Undefined variable 'c'");
+    expect_error(compiler, "input a\nb = a / (2 - 2)\noutput b\n", ZKL_STAGE_OPTIMIZER,
+                 "test.zkl:2:7: error: Division by zero");
+    expect_error(compiler, "input a\nassert(1 == 2)\n", ZKL_STAGE_OPTIMIZER,
+                 "test.zkl:2:1: error: Assertion always fails");
+    printf("errors: every stage reported its error's position\n");
+
+    // The compiler is as good as new after an error, and over many
+    // compilations
+    for (int i = 0; i < 1000; i++) {
+        if (!expect_circuit(compiler, SOURCE, 3)) break;
+        expect_error(compiler, "input a\nb = a * c\n", ZKL_STAGE_VALIDATOR,
+                     "test.zkl:2:9: error: Undefined variable 'c'");
+        if (failures) break;
+    }
+    printf("reuse: 2000 compilations alternating with errors\n");
+
+    // Misuse is reported rather than crashing
+    if (zkl_compile(NULL, SOURCE, strlen(SOURCE), &circuit) != ZKL_ERROR_ARGUMENT || circuit != NULL ||
+        zkl_compile(compiler, NULL, 1, NULL) != ZKL_ERROR_ARGUMENT ||
+        zkl_circuit_save(NULL, "x") != ZKL_ERROR_ARGUMENT) {
+        printf("FAILED: NULL arguments were accepted\n");
+        failures++;
+    }
+    zkl_compiler_free(compiler);
+    zkl_compiler_free(NULL);
+
+    if (failures) {
+        printf("%d API checks failed\n", failures);
+        return 1;
+    }
+    printf("All API checks passed!\n");
+    return 0;
+}
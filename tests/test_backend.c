@@ -0,0 +1,125 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "../src/backend/constraint_compiler.h"
+#include "r1cs_eval.h"
+
+static int failures = 0;
+
+// Helper to compile source text to constraints, optionally optimizing first
+static R1CS* compile(CompilerContext* ctx, const char* code, int optimize) {
+    AST* ast = parse_tokens(ctx, tokenize(ctx, code));
+    validate_program(ctx, ast);
+    IRProgram* ir = generate_ir(ctx, ast);
+    if (optimize) optimize_ir(ctx, ir);
+    return compile_constraints(ctx, ir);
+}
+
+// Helper to count the constraints a witness (given as small integers) violates
+static int violated(const CompilerContext* ctx, const R1CS* r1cs, const uint64_t* values) {
+    FieldElement* witness = malloc(sizeof(FieldElement) * r1cs->variable_count);
+    for (uint32_t v = 0; v < r1cs->variable_count; v++) field_from_u64(ctx->field, &witness[v], values[v]);
+    int count = 0;
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        FieldElement a = dot(ctx->field, r1cs, &r1cs->a, row, witness);
+        FieldElement b = dot(ctx->field, r1cs, &r1cs->b, row, witness);
+        FieldElement c = dot(ctx->field, r1cs, &r1cs->c, row, witness);
+        field_mul(ctx->field, &a, &a, &b);
+        if (!field_equal(&a, &c)) count++;
+    }
+    free(witness);
+    return count;
+}
+
+// Helper to check the shape of a constraint system
+static void expect(const char* name, const R1CS* r1cs, uint32_t constraints, uint32_t variables) {
+    printf("%s: %u constraints, %u variables\n", name, r1cs->constraint_count, r1cs->variable_count);
+    if (r1cs->constraint_count != constraints || r1cs->variable_count != variables) {
+        printf("FAILED: expected %u constraints, %u variables\n", constraints, variables);
+        failures++;
+    }
+}
+
+int main() {
+    CompilerContext ctx;
+    context_init(&ctx);
+
+    // One product; the sum, scaling and asserted equality are linear.
+    // Variables: 1, y (public), x, x * x.
+    const char* code = "input x\npublic y\nz = x * x + 3 * x - y\nassert(z == 5)";
+    for (int optimize = 0; optimize < 2; optimize++) {
+        R1CS* r1cs = compile(&ctx, code, optimize);
+        expect(optimize ? "polynomial (optimized)" : "polynomial", r1cs, 2, 4);
+        print_r1cs(&ctx, r1cs);
+        print_r1cs_stats(r1cs);
+        uint64_t good[] = {1, 5, 2, 4}, bad[] = {1, 6, 2, 4};
+        if (r1cs->public_count != 1 || r1cs->input_count != 1 ||
+            violated(&ctx, r1cs, good) != 0 || violated(&ctx, r1cs, bad) != 1) {
+            printf("FAILED: witness check\n");
+            failures++;
+        }
+        context_reset(&ctx);
+    }
+
+    // An equality that is used as a value needs the zero-test gadget, and
+    // asserting a plain value needs a non-zero test. Variables: 1, a, the
+    // inverse and result of the test, and the inverse for the assertion.
+    R1CS* r1cs = compile(&ctx, "input a\nb = a == 3\nassert(b)", 0);
+    expect("\nequality", r1cs, 3, 5);
+    print_r1cs(&ctx, r1cs);
+    uint64_t equal[] = {1, 3, 0, 1, 1};
+    if (violated(&ctx, r1cs, equal) != 0) {
+        printf("FAILED: equality witness\n");
+        failures++;
+    }
+    context_reset(&ctx);
+
+    // Division by a variable: c * b = a
+    r1cs = compile(&ctx, "input a\ninput b\nc = a / b\nd = c / 4", 0);
+    expect("\ndivision", r1cs, 1, 4);
+    print_r1cs(&ctx, r1cs);
+    context_reset(&ctx);
+
+    // An asserted equality behind a copy costs one constraint once the
+    // optimizer removes the copy, instead of a zero test and a non-zero test
+    const char* copied = "input a\ninput b\ne = a * b == 5\nassert(e)";
+    expect("\ncopied equality", compile(&ctx, copied, 0), 4, 7);
+    context_reset(&ctx);
+    expect("copied equality (optimized)", compile(&ctx, copied, 1), 2, 4);
+    context_reset(&ctx);
+
+    // An output is a public variable bound to its value by one linear
+    // constraint. Variables: 1, y (public output), x, x * x.
+    r1cs = compile(&ctx, "input x\ny = x * x + 1\noutput y", 1);
+    expect("\noutput", r1cs, 2, 4);
+    print_r1cs(&ctx, r1cs);
+    uint64_t squared[] = {1, 10, 3, 9}, wrong[] = {1, 9, 3, 9};
+    if (r1cs->public_count != 1 || r1cs->output_count != 1 || r1cs->input_count != 1 ||
+        violated(&ctx, r1cs, squared) != 0 || violated(&ctx, r1cs, wrong) != 1) {
+        printf("FAILED: output witness\n");
+        failures++;
+    }
+    context_reset(&ctx);
+
+    // A sum longer than R1CS_MAX_LINEAR_TERMS is bound to a variable once
+    char sum[2048];
+    size_t used = 0;
+    for (int i = 0; i < 40; i++) used += snprintf(sum + used, sizeof(sum) - used, "input x%d\n", i);
+    used += snprintf(sum + used, sizeof(sum) - used, "s = x0");
+    for (int i = 1; i < 40; i++) used += snprintf(sum + used, sizeof(sum) - used, " + x%d", i);
+    snprintf(sum + used, sizeof(sum) - used, "\nassert(s * s == 1)");
+    r1cs = compile(&ctx, sum, 0);
+    expect("\nlong sum", r1cs, 3, 43);
+    print_r1cs_stats(r1cs);
+    context_reset(&ctx);
+
+    context_free(&ctx);
+    if (failures) {
+        printf("%d backend checks failed\n", failures);
+        return 1;
+    }
+    printf("All backend checks passed!\n");
+    return 0;
+}
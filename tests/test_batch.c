@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "../src/driver/batch.h"
+#include "../src/utils/file_io.h"
+#include "example_circuit.h"
+
+#define FILES 6
+
+static int failures = 0;
+
+// Helper to write a source file: a chain of `length` products, so the
+// files differ in size and constraints
+static void write_source(const char* path, int length) {
+    FILE* file = fopen(path, "w");
+    fprintf(file, "public y\ninput x\nv0 = x * x + 1\n");
+    for (int i = 1; i < length; i++) fprintf(file, "v%d = v%d * x + %d\n", i, i - 1, i);
+    fprintf(file, "assert(v%d == y)\noutput v%d\n", length - 1, length - 1);
+    fclose(file);
+}
+
+// Helper to check that two files have the same contents
+static int same_file(const char* x, const char* y) {
+    MappedFile* a = map_file(x);
+    MappedFile* b = map_file(y);
+    int same = a && b && a->size == b->size && memcmp(a->data, b->data, a->size) == 0;
+    if (a) unmap_file(a);
+    if (b) unmap_file(b);
+    return same;
+}
+
+// Helper to check one derived circuit path
+static void expect_path(const char* source, const char* output_dir, const char* expected) {
+    char* path = batch_circuit_path(source, output_dir);
+    if (strcmp(path, expected) != 0) {
+        printf("FAILED: %s in %s gives %s, expected %s\n", source, output_dir ? output_dir : "(none)", path,
+               expected);
+        failures++;
+    }
+    free(path);
+}
+
+// Helper to compile every file of a batch and check none failed
+static void run(const BatchOptions* options, BatchFile* files, uint32_t count, const char* what) {
+    BatchSummary summary;
+    compile_batch(options, files, count, &summary);
+    uint32_t reused = 0;
+    for (uint32_t i = 0; i < count; i++) reused += files[i].stats.reused;
+    printf("%s: %u files, %llu constraints on %d threads, %u statements reused\n", what, summary.files,
+           (unsigned long long)summary.constraints, summary.threads, reused);
+    if (summary.failed != 0 || summary.files != count) {
+        printf("FAILED: %s: %u of %u files failed\n", what, summary.failed, count);
+        failures++;
+    }
+}
+
+int main() {
+    char dir[64], serial_dir[80], text[128];
+    snprintf(dir, sizeof(dir), "/tmp/test_batch_%ld", (long)getpid());
+    snprintf(serial_dir, sizeof(serial_dir), "%s/serial", dir);
+    mkdir(dir, 0700);
+    mkdir(serial_dir, 0700);
+
+    // Sources of different sizes, named out of size order, next to files
+    // the driver must skip
+    static const int lengths[FILES] = {3, 40, 1, 200, 12, 75};
+    for (int i = 0; i < FILES; i++) {
+        char path[128];
+        snprintf(path, sizeof(path), "%s/circuit%d.zkl", dir, i);
+        write_source(path, lengths[i]);
+    }
+    snprintf(text, sizeof(text), "%s/notes.txt", dir);
+    fclose(fopen(text, "w"));
+
+    char** sources = NULL;
+    uint32_t count = 0;
+    if (batch_add_sources(&sources, &count, dir) != 0 || count != FILES) {
+        printf("FAILED: found %u sources in %s, expected %d\n", count, dir, FILES);
+        return 1;
+    }
+    for (uint32_t i = 1; i < count; i++) {
+        if (strcmp(sources[i - 1], sources[i]) >= 0) {
+            printf("FAILED: sources are not in name order\n");
+            failures++;
+        }
+    }
+
+    expect_path("a/b/c.zkl", NULL, "a/b/c.zklc");
+    expect_path("c.zkl", NULL, "c.zklc");
+    expect_path("a/c.zkl", "out", "out/c.zklc");
+    expect_path("a/c", "out/", "out/c.zklc");
+
+    // Compile in parallel, then one file at a time elsewhere; every
+    // circuit must come out the same
+    BatchFile files[FILES], serial[FILES];
+    memset(files, 0, sizeof(files));
+    memset(serial, 0, sizeof(serial));
+    for (uint32_t i = 0; i < count; i++) {
+        files[i].source = serial[i].source = sources[i];
+        files[i].circuit = batch_circuit_path(sources[i], NULL);
+        serial[i].circuit = batch_circuit_path(sources[i], serial_dir);
+    }
+    BatchOptions options = {4, 0, NULL};
+    run(&options, files, count, "parallel");
+    options.threads = 1;
+    run(&options, serial, count, "serial");
+    for (uint32_t i = 0; i < count; i++) {
+        if (!same_file(files[i].circuit, serial[i].circuit) || files[i].constraints != serial[i].constraints) {
+            printf("FAILED: %s differs between parallel and serial compilation\n", sources[i]);
+            failures++;
+        }
+    }
+
+    // Incremental compilation: with the caches left by a first batch, a
+    // second reuses every statement and writes the same circuits as a
+    // batch starting without caches
+    options.threads = 3;
+    options.incremental = 1;
+    run(&options, files, count, "incremental");
+    run(&options, serial, count, "incremental");
+    run(&options, serial, count, "incremental, cached");
+    uint32_t statements = 0, reused = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        statements += serial[i].stats.statements;
+        reused += serial[i].stats.reused;
+        if (!same_file(files[i].circuit, serial[i].circuit)) {
+            printf("FAILED: %s differs between incremental compilations\n", sources[i]);
+            failures++;
+        }
+    }
+    if (reused != statements || statements == 0) {
+        printf("FAILED: %u of %u statements reused\n", reused, statements);
+        failures++;
+    }
+
+    // Statistics count what each file produced and add up over the batch,
+    // whichever way the files were compiled
+    options.collect_stats = 1;
+    for (int incremental = 0; incremental <= 1; incremental++) {
+        options.incremental = incremental;
+        BatchSummary summary;
+        compile_batch(&options, files, count, &summary);
+        const CompileStats* total = &summary.compile_stats;
+        uint64_t constraints = 0;
+        for (uint32_t i = 0; i < count; i++) {
+            constraints += files[i].compile_stats.constraints;
+            if (files[i].compile_stats.constraints != files[i].constraints || files[i].compile_stats.tokens == 0) {
+                printf("FAILED: %s: statistics count %llu constraints, expected %u\n", sources[i],
+                       (unsigned long long)files[i].compile_stats.constraints, files[i].constraints);
+                failures++;
+            }
+        }
+        printf("stats%s: %llu tokens, %llu AST nodes, %llu constraints, %.6f s parsing, peak %llu bytes\n",
+               incremental ? " (incremental)" : "", (unsigned long long)total->tokens,
+               (unsigned long long)total->ast_nodes, (unsigned long long)total->constraints,
+               total->phases[PHASE_PARSE].seconds, (unsigned long long)total->peak_bytes);
+        if (total->compilations != count || constraints != summary.constraints ||
+            total->constraints != summary.constraints || total->source_bytes != summary.source_bytes ||
+            total->phases[PHASE_LEX].seconds <= 0 || total->phases[PHASE_CONSTRAINTS].seconds <= 0 ||
+            total->phases[PHASE_WRITE].seconds <= 0 || total->peak_bytes == 0 || total->allocations == 0) {
+            printf("FAILED: batch statistics do not add up\n");
+            failures++;
+        }
+        if (!incremental && (total->pass_count == 0 || total->ast_nodes == 0 || total->ir_optimized == 0 ||
+                             total->ir_optimized > total->ir_instructions)) {
+            printf("FAILED: missing front-end statistics\n");
+            failures++;
+        }
+    }
+    options.collect_stats = 0;
+
+    // A source with an error fails its file alone, with the error's position
+    FILE* broken = fopen(sources[1], "a");
+    fprintf(broken, "w = v0 * undefined\n");
+    fclose(broken);
+    options.incremental = 0;
+    BatchSummary summary;
+    compile_batch(&options, files, count, &summary);
+    printf("broken: %u of %u files failed: %s\n", summary.failed, summary.files,
+           files[1].diagnostic ? files[1].diagnostic : "(no diagnostic)");
+    if (summary.failed != 1 || files[1].status != 1 || !files[1].diagnostic ||
+        !strstr(files[1].diagnostic, "circuit1.zkl:45:10: error: Undefined variable 'undefined'")) {
+        printf("FAILED: expected only the broken file to fail, at its undefined variable\n");
+        failures++;
+    }
+    free(files[1].diagnostic);
+
+    // So does an error caught by the incremental compiler
+    options.incremental = 1;
+    compile_batch(&options, files, count, &summary);
+    if (summary.failed != 1 || files[1].status != 1 || !files[1].diagnostic) {
+        printf("FAILED: expected only the broken file to fail incrementally\n");
+        failures++;
+    }
+    free(files[1].diagnostic);
+    write_source(sources[1], lengths[1]);
+
+    // A circuit that cannot be written fails its file alone
+    free((char*)files[0].circuit);
+    files[0].circuit = batch_circuit_path(sources[0], "/nonexistent");
+    options.incremental = 0;
+    compile_batch(&options, files, count, &summary);
+    printf("unwritable: %u of %u files failed\n", summary.failed, summary.files);
+    if (summary.failed != 1 || files[0].status == 0 || files[1].status != 0) {
+        printf("FAILED: expected only the unwritable file to fail\n");
+        failures++;
+    }
+
+    // With --verifier, the example compiled through the driver with its
+    // fixed secrets gets the same verifier gen_verifier writes, which
+    // test_verifier builds and runs
+    char example_path[128], verifier_path[160];
+    snprintf(example_path, sizeof(example_path), "%s/example.zkl", dir);
+    FILE* example = fopen(example_path, "w");
+    fputs(EXAMPLE_SOURCE, example);
+    fclose(example);
+    CompilerContext ctx;
+    context_init(&ctx);
+    Groth16Trapdoor trapdoor;
+    example_setup(&ctx, &trapdoor, NULL);
+    context_free(&ctx);
+    BatchFile example_file = {example_path, batch_circuit_path(example_path, NULL)};
+    snprintf(verifier_path, sizeof(verifier_path), "%s/example" VERIFIER_SUFFIX, dir);
+    char* derived = batch_verifier_path(example_file.circuit);
+    if (strcmp(derived, verifier_path) != 0) {
+        printf("FAILED: verifier path %s, expected %s\n", derived, verifier_path);
+        failures++;
+    }
+    free(derived);
+    BatchOptions verifier_options = {1, 0, NULL};
+    verifier_options.verifier = 1;
+    verifier_options.trapdoor = &trapdoor;
+    run(&verifier_options, &example_file, 1, "verifier");
+    if (!same_file(verifier_path, "tests/example_verifier.c")) {
+        printf("FAILED: %s differs from tests/example_verifier.c\n", verifier_path);
+        failures++;
+    }
+
+    // Fresh secrets give another key for the same circuit
+    verifier_options.trapdoor = NULL;
+    run(&verifier_options, &example_file, 1, "verifier, random setup");
+    MappedFile* generated = map_file(verifier_path);
+    if (!generated || same_file(verifier_path, "tests/example_verifier.c") ||
+        generated->size < 40 || memcmp(generated->data, "// Groth16 verifier for circuit example,", 40) != 0) {
+        printf("FAILED: random setup did not write a different verifier\n");
+        failures++;
+    }
+    if (generated) unmap_file(generated);
+
+    // Groth16 keys live on BN254, so a circuit over another field fails
+    verifier_options.field = &FIELD_BLS12_381;
+    compile_batch(&verifier_options, &example_file, 1, &summary);
+    printf("verifier over bls12-381: %s\n", example_file.diagnostic ? example_file.diagnostic : "(no diagnostic)");
+    if (summary.failed != 1 || example_file.status != 1 || !example_file.diagnostic ||
+        !strstr(example_file.diagnostic, "bn254")) {
+        printf("FAILED: expected a verifier over bls12-381 to fail\n");
+        failures++;
+    }
+    free(example_file.diagnostic);
+    remove(verifier_path);
+    remove(example_file.circuit);
+    remove(example_path);
+    free((char*)example_file.circuit);
+
+    for (uint32_t i = 0; i < count; i++) {
+        char cache[128];
+        remove(files[i].circuit);
+        remove(serial[i].circuit);
+        snprintf(cache, sizeof(cache), "%.*s" CACHE_EXTENSION,
+                 (int)(strlen(serial[i].circuit) - strlen(CIRCUIT_EXTENSION)), serial[i].circuit);
+        remove(cache);
+        snprintf(cache, sizeof(cache), "%.*s" CACHE_EXTENSION,
+                 (int)(strlen(sources[i]) - strlen(SOURCE_EXTENSION)), sources[i]);
+        remove(cache);
+        snprintf(cache, sizeof(cache), "%.*s" CIRCUIT_EXTENSION,
+                 (int)(strlen(sources[i]) - strlen(SOURCE_EXTENSION)), sources[i]);
+        remove(cache);
+        remove(sources[i]);
+        free(sources[i]);
+        free((char*)files[i].circuit);
+        free((char*)serial[i].circuit);
+    }
+    free(sources);
+    remove(text);
+    rmdir(serial_dir);
+    rmdir(dir);
+    if (failures) {
+        printf("%d batch checks failed\n", failures);
+        return 1;
+    }
+    printf("All batch checks passed!\n");
+    return 0;
+}
@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "../src/backend/circuit_file.h"
+#include "../src/backend/constraint_checker.h"
+#include "../src/backend/witness_generator.h"
+#include "r1cs_eval.h"
+
+#define MAX_VIOLATIONS 8
+
+static int failures = 0;
+
+// Helper to compile source text to a witness plan
+static WitnessPlan* plan(CompilerContext* ctx, const char* code) {
+    AST* ast = parse_tokens(ctx, tokenize(ctx, code));
+    validate_program(ctx, ast);
+    IRProgram* ir = generate_ir(ctx, ast);
+    optimize_ir(ctx, ir);
+    return witness_plan_create(ctx, ir, compile_constraints(ctx, ir));
+}
+
+// Helper to compute a witness from small integer inputs (caller frees)
+static FieldElement* generate(const CompilerContext* ctx, const WitnessPlan* p, const uint64_t* values) {
+    FieldElement* inputs = malloc(sizeof(FieldElement) * (p->input_count ? p->input_count : 1));
+    FieldElement* witness = malloc(sizeof(FieldElement) * p->r1cs->variable_count);
+    FieldElement* scratch = malloc(sizeof(FieldElement) * witness_scratch_size(p));
+    for (uint32_t i = 0; i < p->input_count; i++) field_from_u64(ctx->field, &inputs[i], values[i]);
+    if (witness_generate(ctx, p, inputs, witness, scratch) != WITNESS_OK) {
+        printf("FAILED: could not compute the witness\n");
+        failures++;
+    }
+    free(inputs);
+    free(scratch);
+    return witness;
+}
+
+// Helper to write a copy of a file with one 32-bit word replaced
+static void write_patched(const char* source, const char* path, uint64_t offset, uint32_t word) {
+    MappedFile* file = map_file(source);
+    char* copy = malloc(file->size);
+    memcpy(copy, file->data, file->size);
+    memcpy(copy + offset, &word, sizeof(word));
+    FileChunk chunk = {copy, file->size};
+    write_file(path, &chunk, 1);
+    free(copy);
+    unmap_file(file);
+}
+
+// Helper to check that a circuit with one word of a section replaced loads
+// but fails validation
+static void expect_invalid(const char* name, const char* source, const char* path, CircuitSection section,
+                           uint32_t index, uint32_t word) {
+    Circuit* circuit = load_circuit(source);
+    uint64_t offset = circuit->header->sections[section].offset + sizeof(uint32_t) * (uint64_t)index;
+    free_circuit(circuit);
+    write_patched(source, path, offset, word);
+    circuit = load_circuit(path);
+    int valid = circuit && circuit_validate(circuit, path);
+    printf("%s: %s\n", name, valid ? "accepted" : "rejected");
+    if (valid) {
+        printf("FAILED: corrupt circuit passed validation\n");
+        failures++;
+    }
+    free_circuit(circuit);
+}
+
+// Helper to run the checker on a pool and compare it against evaluating
+// every row directly; returns the number of violations
+static uint32_t check(const Field* field, const R1CS* r1cs, ThreadPool* pool, const FieldElement* witness) {
+    ConstraintViolation violations[MAX_VIOLATIONS];
+    uint32_t violated = check_constraints(field, r1cs, pool, witness, violations, MAX_VIOLATIONS);
+    uint32_t expected = 0;
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        FieldElement a = dot(field, r1cs, &r1cs->a, row, witness);
+        FieldElement b = dot(field, r1cs, &r1cs->b, row, witness);
+        FieldElement c = dot(field, r1cs, &r1cs->c, row, witness);
+        FieldElement product;
+        field_mul(field, &product, &a, &b);
+        if (field_equal(&product, &c)) continue;
+        if (expected < MAX_VIOLATIONS) {
+            const ConstraintViolation* v = &violations[expected];
+            if (expected >= violated || v->constraint != row || !field_equal(&v->a, &a) ||
+                !field_equal(&v->b, &b) || !field_equal(&v->c, &c)) {
+                printf("FAILED: violation %u should be constraint %u\n", expected, row);
+                failures++;
+            }
+        }
+        expected++;
+    }
+    if (violated != expected) {
+        printf("FAILED: %u violations reported, %u expected\n", violated, expected);
+        failures++;
+    }
+    return violated;
+}
+
+int main() {
+    CompilerContext ctx;
+    context_init(&ctx);
+    ThreadPool* single = thread_pool_create(1);
+    ThreadPool* pool = thread_pool_create(4);
+    char circuit_path[64], witness_path[64];
+    snprintf(circuit_path, sizeof(circuit_path), "/tmp/test_check_%ld.zklc", (long)getpid());
+    snprintf(witness_path, sizeof(witness_path), "/tmp/test_check_%ld.wtns", (long)getpid());
+
+    // z = x^2 + 3x - y must be 5. Inputs are (y, x) since public inputs
+    // come first.
+    WitnessPlan* p = plan(&ctx, "public y\ninput x\nz = x * x + 3 * x - y\nassert(z == 5)\nq = 10 / x");
+    const R1CS* r1cs = p->r1cs;
+    uint64_t values[2] = {4 * 4 + 3 * 4 - 5, 4};
+    FieldElement* witness = generate(&ctx, p, values);
+    uint32_t violated = check(ctx.field, r1cs, single, witness);
+    printf("polynomial: %u constraints, %u violated\n", r1cs->constraint_count, violated);
+    if (violated != 0) {
+        printf("FAILED: a generated witness violates its constraints\n");
+        failures++;
+    }
+
+    // Corrupting the public input breaks the constraint that uses it: the
+    // linear z folds into the assertion on line 4
+    field_add(ctx.field, &witness[1], &witness[1], &ctx.field->one);
+    ConstraintViolation violations[MAX_VIOLATIONS];
+    violated = check_constraints(ctx.field, r1cs, pool, witness, violations, MAX_VIOLATIONS);
+    check(ctx.field, r1cs, pool, witness);
+    printf("corrupted y: %u violated", violated);
+    for (uint32_t i = 0; i < violated && i < MAX_VIOLATIONS; i++) {
+        const IRLocation* location = &r1cs->locations[violations[i].constraint];
+        printf(", constraint %u at %d:%d", violations[i].constraint, location->line, location->column);
+    }
+    printf("\n");
+    if (violated == 0 || r1cs->locations[violations[0].constraint].line != 4) {
+        printf("FAILED: corrupted input was not traced to its use\n");
+        failures++;
+    }
+
+    // A circuit and witness saved to disk check the same as in memory
+    if (save_circuit(&ctx, p->program, r1cs, circuit_path) != 0 ||
+        save_witness(ctx.field, witness, r1cs->variable_count, witness_path) != 0) {
+        printf("FAILED: could not write the circuit or witness\n");
+        return 1;
+    }
+    Circuit* circuit = load_circuit(circuit_path);
+    Witness* loaded = load_witness(witness_path);
+    if (!circuit || !loaded || loaded->field != circuit->field || loaded->variable_count != r1cs->variable_count ||
+        memcmp(loaded->values, witness, sizeof(FieldElement) * r1cs->variable_count) != 0) {
+        printf("FAILED: witness file round trip\n");
+        return 1;
+    }
+    uint32_t from_disk = check(circuit->field, &circuit->r1cs, pool, loaded->values);
+    printf("from disk: %u violated\n", from_disk);
+    if (from_disk != violated) {
+        printf("FAILED: loaded circuit checks differently\n");
+        failures++;
+    }
+    if (!circuit_validate(circuit, circuit_path)) {
+        printf("FAILED: saved circuit failed validation\n");
+        failures++;
+    }
+    free_witness(loaded);
+    free_circuit(circuit);
+
+    // Matrix entries are only checked by circuit_validate, and out of range
+    // ones must be caught before the checker reads through them
+    char damaged[64];
+    snprintf(damaged, sizeof(damaged), "/tmp/test_check_%ld.bad", (long)getpid());
+    expect_invalid("column out of range", circuit_path, damaged, CIRCUIT_A_COLUMNS, 0, 0x7fffffff);
+    expect_invalid("column past the last variable", circuit_path, damaged, CIRCUIT_B_COLUMNS, 0,
+                   r1cs->variable_count);
+    expect_invalid("coefficient index out of range", circuit_path, damaged, CIRCUIT_C_COEFFICIENTS, 0,
+                   r1cs->coefficients.count);
+    expect_invalid("first row offset", circuit_path, damaged, CIRCUIT_A_ROWS, 0, 1);
+    expect_invalid("decreasing row offsets", circuit_path, damaged, CIRCUIT_A_ROWS, 1, 0xffffffff);
+    expect_invalid("last row offset", circuit_path, damaged, CIRCUIT_B_ROWS, r1cs->constraint_count,
+                   r1cs->b.nonzeros + 1);
+    expect_invalid("coefficient above the modulus", circuit_path, damaged, CIRCUIT_COEFFICIENTS, FIELD_LIMBS * 2 - 1,
+                   0xffffffff);
+    expect_invalid("name offset out of range", circuit_path, damaged, CIRCUIT_VARIABLE_NAMES, 1, 0x7fffffff);
+    expect_invalid("name index out of range", circuit_path, damaged, CIRCUIT_NAME_INDEX, 0, r1cs->variable_count);
+    expect_invalid("name index of an unnamed variable", circuit_path, damaged, CIRCUIT_NAME_INDEX, 0, 0);
+
+    // Names must end in a NUL, or looking one up reads past the section
+    circuit = load_circuit(circuit_path);
+    const CircuitExtent* names = &circuit->header->sections[CIRCUIT_NAMES];
+    uint64_t names_end = names->offset + names->size;
+    free_circuit(circuit);
+    write_patched(circuit_path, damaged, names_end - sizeof(uint32_t), 0x41414141);
+    circuit = load_circuit(damaged);
+    int valid = circuit && circuit_validate(circuit, damaged);
+    printf("unterminated names: %s\n", valid ? "accepted" : "rejected");
+    if (valid) {
+        printf("FAILED: corrupt circuit passed validation\n");
+        failures++;
+    }
+    free_circuit(circuit);
+
+    // Witness values must be reduced: the modulus itself is rejected
+    FieldElement modulus;
+    memcpy(modulus.limbs, ctx.field->modulus, sizeof(modulus.limbs));
+    FieldElement saved = witness[r1cs->variable_count - 1];
+    witness[r1cs->variable_count - 1] = modulus;
+    save_witness(ctx.field, witness, r1cs->variable_count, damaged);
+    witness[r1cs->variable_count - 1] = saved;
+    loaded = load_witness(damaged);
+    printf("witness value equal to the modulus: %s\n", loaded ? "loaded" : "rejected");
+    if (loaded) {
+        printf("FAILED: unreduced witness value was loaded\n");
+        failures++;
+        free_witness(loaded);
+    }
+    unlink(damaged);
+
+    // A circuit file is not a witness file
+    loaded = load_witness(circuit_path);
+    if (loaded) {
+        printf("FAILED: circuit file loaded as a witness\n");
+        failures++;
+        free_witness(loaded);
+    }
+    unlink(circuit_path);
+    unlink(witness_path);
+    free(witness);
+    context_reset(&ctx);
+
+    // Enough rows for several blocks, so violations from different workers
+    // must come back in row order
+    size_t capacity = 64 + 40 * 20000;
+    char* code = malloc(capacity);
+    size_t length = snprintf(code, capacity, "input x\nv0 = x\n");
+    for (int i = 1; i <= 20000; i++) {
+        length += snprintf(code + length, capacity - length, "v%d = v%d * x + %d\n", i, i - 1, i % 7);
+    }
+    snprintf(code + length, capacity - length, "output v20000\n");
+    p = plan(&ctx, code);
+    free(code);
+    r1cs = p->r1cs;
+    values[0] = 3;
+    witness = generate(&ctx, p, values);
+    for (uint32_t v = 5; v < r1cs->variable_count; v += 997) {
+        field_add(ctx.field, &witness[v], &witness[v], &ctx.field->one);
+    }
+    uint32_t one_thread = check(ctx.field, r1cs, single, witness);
+    uint32_t four_threads = check(ctx.field, r1cs, pool, witness);
+    printf("\nchain: %u constraints, %u violated on 1 thread, %u on 4\n", r1cs->constraint_count, one_thread,
+           four_threads);
+    if (one_thread == 0 || one_thread != four_threads) {
+        printf("FAILED: thread counts disagree\n");
+        failures++;
+    }
+    free(witness);
+
+    thread_pool_destroy(single);
+    thread_pool_destroy(pool);
+    context_free(&ctx);
+    if (failures) {
+        printf("%d check checks failed\n", failures);
+        return 1;
+    }
+    printf("All check checks passed!\n");
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "../src/backend/circuit_file.h"
+
+static int failures = 0;
+
+// Helper to compile source text to constraints
+static R1CS* compile(CompilerContext* ctx, const char* code, IRProgram** program) {
+    AST* ast = parse_tokens(ctx, tokenize(ctx, code));
+    validate_program(ctx, ast);
+    *program = generate_ir(ctx, ast);
+    optimize_ir(ctx, *program);
+    return compile_constraints(ctx, *program);
+}
+
+// Helper to compare one matrix of two systems
+static int same_matrix(const SparseMatrix* x, const SparseMatrix* y, uint32_t rows) {
+    return x->nonzeros == y->nonzeros &&
+           memcmp(x->row_offsets, y->row_offsets, sizeof(uint32_t) * (rows + 1)) == 0 &&
+           memcmp(x->columns, y->columns, sizeof(uint32_t) * x->nonzeros) == 0 &&
+           memcmp(x->coefficients, y->coefficients, sizeof(uint32_t) * x->nonzeros) == 0;
+}
+
+// Helper to check that loading a damaged copy of a file fails
+static void expect_rejected(const char* name, const char* source, const char* path, size_t size, size_t offset,
+                            char byte) {
+    MappedFile* file = map_file(source);
+    char* copy = malloc(file->size);
+    memcpy(copy, file->data, file->size);
+    if (offset < size) copy[offset] = byte;
+    FileChunk chunk = {copy, size};
+    write_file(path, &chunk, 1);
+    Circuit* circuit = load_circuit(path);
+    printf("%s: %s\n", name, circuit ? "loaded" : "rejected");
+    if (circuit) {
+        printf("FAILED: damaged file was loaded\n");
+        failures++;
+        free_circuit(circuit);
+    }
+    free(copy);
+    unmap_file(file);
+}
+
+int main() {
+    CompilerContext ctx;
+    context_init(&ctx);
+    char path[64], damaged[64];
+    snprintf(path, sizeof(path), "/tmp/test_circuit_%ld.zklc", (long)getpid());
+    snprintf(damaged, sizeof(damaged), "/tmp/test_circuit_%ld.bad", (long)getpid());
+
+    IRProgram* program;
+    R1CS* r1cs = compile(&ctx, "public y\ninput x\nz = x * x + 3 * x - y\nw = z == 5\nassert(w)\nv = z * z\nassert(v)",
+                       &program);
+    if (save_circuit(&ctx, program, r1cs, path) != 0) {
+        printf("FAILED: could not write %s\n", path);
+        return 1;
+    }
+
+    // Round trip: every array comes back unchanged
+    Circuit* circuit = load_circuit(path);
+    if (!circuit) {
+        printf("FAILED: could not load %s\n", path);
+        return 1;
+    }
+    const R1CS* loaded = &circuit->r1cs;
+    printf("round trip: %u constraints, %u variables, %llu bytes, field %s\n", loaded->constraint_count,
+           loaded->variable_count, (unsigned long long)circuit->file->size, circuit->field->name);
+    print_r1cs_stats(loaded);
+    if (loaded->constraint_count != r1cs->constraint_count || loaded->variable_count != r1cs->variable_count ||
+        loaded->public_count != 1 || loaded->input_count != 1 || circuit->field != ctx.field ||
+        !same_matrix(&loaded->a, &r1cs->a, r1cs->constraint_count) ||
+        !same_matrix(&loaded->b, &r1cs->b, r1cs->constraint_count) ||
+        !same_matrix(&loaded->c, &r1cs->c, r1cs->constraint_count) ||
+        loaded->coefficients.count != r1cs->coefficients.count ||
+        memcmp(loaded->coefficients.values, r1cs->coefficients.values,
+               sizeof(FieldElement) * r1cs->coefficients.count) != 0 ||
+        memcmp(loaded->locations, r1cs->locations, sizeof(IRLocation) * r1cs->constraint_count) != 0) {
+        printf("FAILED: loaded system differs\n");
+        failures++;
+    }
+
+    // Symbol map: inputs and variables bound to named values keep their
+    // names (z is folded into a linear combination, so it has no variable)
+    for (uint32_t v = 0; v < loaded->variable_count; v++) {
+        const char* name = circuit_variable_name(circuit, v);
+        printf("w%u: %s\n", v, name ? name : "-");
+    }
+    if (circuit_find_variable(circuit, "y") != 1 || circuit_find_variable(circuit, "x") != 2 ||
+        circuit_find_variable(circuit, "v") == CIRCUIT_NO_NAME ||
+        circuit_find_variable(circuit, "nope") != CIRCUIT_NO_NAME) {
+        printf("FAILED: name lookup\n");
+        failures++;
+    }
+    free_circuit(circuit);
+
+    // Damaged files are rejected without reading past the header
+    MappedFile* file = map_file(path);
+    size_t size = file->size;
+    unmap_file(file);
+    expect_rejected("truncated", path, damaged, size - 1, size, 0);
+    expect_rejected("bad magic", path, damaged, size, 0, 'X');
+    expect_rejected("bad version", path, damaged, size, offsetof(CircuitHeader, version), 9);
+    expect_rejected("bad section", path, damaged, size,
+                    offsetof(CircuitHeader, sections) + sizeof(CircuitExtent) * CIRCUIT_NAMES, 1);
+    if (load_circuit("/nonexistent/circuit.zklc")) failures++;
+
+    // An output's name belongs to its public variable, not the product it reveals
+    context_reset(&ctx);
+    r1cs = compile(&ctx, "input x\ny = x * x\noutput y", &program);
+    circuit = save_circuit(&ctx, program, r1cs, path) == 0 ? load_circuit(path) : NULL;
+    if (!circuit || circuit->r1cs.output_count != 1 || circuit->r1cs.public_count != 1 ||
+        circuit_find_variable(circuit, "y") != 1 || circuit_variable_name(circuit, 3) != NULL) {
+        printf("FAILED: output naming\n");
+        failures++;
+    }
+    if (circuit) free_circuit(circuit);
+
+    unlink(path);
+    unlink(damaged);
+    context_free(&ctx);
+    if (failures) {
+        printf("%d circuit file checks failed\n", failures);
+        return 1;
+    }
+    printf("All circuit file checks passed!\n");
+    return 0;
+}
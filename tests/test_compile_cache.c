@@ -0,0 +1,224 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../src/backend/compile_cache.h"
+#include "../src/backend/witness_generator.h"
+#include "r1cs_eval.h"
+
+static int failures = 0;
+
+// A circuit touching every statement kind: inputs (y, a, b, c), a chain
+// of products, a division, a zero test and an unread variable
+static const char* SOURCE =
+    "public y\n"
+    "input a\n"
+    "input b\n"
+    "input c\n"
+    "s = a + b\n"
+    "p = s * c\n"
+    "q = p * p + 2 * a\n"
+    "r = q / c\n"
+    "unused = a * b * c\n"
+    "z = r == y\n"
+    "assert(q - 7 * a)\n"
+    "output z\n"
+    "output r\n";
+
+// Helper to compile source text through the cache
+static R1CS* compile(CompilerContext* ctx, const char* path, const char* source, IRProgram** program,
+                     IncrementalStats* stats) {
+    CompileCache* cache = compile_cache_open(path, ctx->field);
+    R1CS* r1cs = compile_incremental(ctx, cache, tokenize(ctx, source), program, stats);
+    if (compile_cache_save(cache) != 0) {
+        printf("FAILED: could not save %s\n", path);
+        failures++;
+    }
+    compile_cache_close(cache);
+    printf("%u statements: %u reused, %u compiled, %u removed; %u constraints, %u variables\n", stats->statements,
+           stats->reused, stats->compiled, stats->removed, r1cs->constraint_count, r1cs->variable_count);
+    return r1cs;
+}
+
+// Helper to generate a witness for inputs (y, a, b, c) and check that it
+// satisfies every constraint; returns the last output's value
+static uint64_t check_witness(const CompilerContext* ctx, const IRProgram* program, const R1CS* r1cs,
+                              const uint64_t values[4]) {
+    WitnessPlan* plan = witness_plan_create((CompilerContext*)ctx, program, r1cs);
+    FieldElement inputs[4];
+    for (int i = 0; i < 4; i++) field_from_u64(ctx->field, &inputs[i], values[i]);
+    FieldElement* witness = calloc(r1cs->variable_count, sizeof(FieldElement));
+    FieldElement* scratch = malloc(sizeof(FieldElement) * witness_scratch_size(plan));
+    uint64_t output = 0;
+    if (witness_generate(ctx, plan, inputs, witness, scratch) != WITNESS_OK) {
+        printf("FAILED: witness generation failed\n");
+        failures++;
+    } else {
+        for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+            FieldElement a = dot(ctx->field, r1cs, &r1cs->a, row, witness);
+            FieldElement b = dot(ctx->field, r1cs, &r1cs->b, row, witness);
+            FieldElement c = dot(ctx->field, r1cs, &r1cs->c, row, witness);
+            field_mul(ctx->field, &a, &a, &b);
+            if (!field_equal(&a, &c)) {
+                printf("FAILED: constraint %u (line %d) is violated\n", row, r1cs->locations[row].line);
+                failures++;
+            }
+        }
+        field_to_u64(ctx->field, &witness[r1cs->public_count], &output);
+    }
+    free(witness);
+    free(scratch);
+    return output;
+}
+
+// Helper to compare two constraint systems entry by entry
+static int same_system(const R1CS* x, const R1CS* y) {
+    if (x->constraint_count != y->constraint_count || x->variable_count != y->variable_count ||
+        x->public_count != y->public_count || x->input_count != y->input_count) {
+        return 0;
+    }
+    const SparseMatrix* xm[3] = {&x->a, &x->b, &x->c};
+    const SparseMatrix* ym[3] = {&y->a, &y->b, &y->c};
+    for (int m = 0; m < 3; m++) {
+        if (xm[m]->nonzeros != ym[m]->nonzeros ||
+            memcmp(xm[m]->row_offsets, ym[m]->row_offsets, sizeof(uint32_t) * (x->constraint_count + 1)) != 0 ||
+            memcmp(xm[m]->columns, ym[m]->columns, sizeof(uint32_t) * xm[m]->nonzeros) != 0) {
+            return 0;
+        }
+        for (uint32_t k = 0; k < xm[m]->nonzeros; k++) {
+            if (!field_equal(field_pool_get(&x->coefficients, xm[m]->coefficients[k]),
+                             field_pool_get(&y->coefficients, ym[m]->coefficients[k]))) {
+                return 0;
+            }
+        }
+    }
+    for (uint32_t row = 0; row < x->constraint_count; row++) {
+        if (x->locations[row].line != y->locations[row].line || x->locations[row].column != y->locations[row].column) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Helper to check one compilation's counts
+static void expect(const char* what, const IncrementalStats* stats, uint32_t reused, uint32_t compiled,
+                   uint32_t removed) {
+    if (stats->reused != reused || stats->compiled != compiled || stats->removed != removed) {
+        printf("FAILED: %s: expected %u reused, %u compiled, %u removed\n", what, reused, compiled, removed);
+        failures++;
+    }
+}
+
+int main() {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/test_compile_cache_%ld.zklcache", (long)getpid());
+    unlink(path);
+    CompilerContext cold, warm;
+    context_init(&cold);
+    context_init(&warm);
+    IRProgram *cold_program, *warm_program;
+    IncrementalStats stats;
+
+    // a = 1, b = 2, c = 3: s = 3, p = 9, q = 83, r = 83 / 3; q - 7a = 76 is non-zero
+    const uint64_t values[4] = {5, 1, 2, 3};
+
+    // An empty cache compiles every statement; the unread one is dropped
+    printf("cold cache: ");
+    R1CS* cold_r1cs = compile(&cold, path, SOURCE, &cold_program, &stats);
+    expect("cold cache", &stats, 0, 13, 1);
+    check_witness(&cold, cold_program, cold_r1cs, values);
+
+    // A warm cache reuses every statement and gives the same system
+    printf("warm cache: ");
+    R1CS* warm_r1cs = compile(&warm, path, SOURCE, &warm_program, &stats);
+    expect("warm cache", &stats, 13, 0, 1);
+    if (!same_system(cold_r1cs, warm_r1cs) || warm_program->count != cold_program->count) {
+        printf("FAILED: warm compilation differs from cold\n");
+        failures++;
+    }
+    context_reset(&warm);
+
+    // Changing q recompiles it and what reads it, but r = q / c stays the
+    // same variable, so what reads r is reused
+    printf("edited q: ");
+    char* edited = strdup(SOURCE);
+    memcpy(strstr(edited, "2 * a"), "3 * a", 5);
+    warm_r1cs = compile(&warm, path, edited, &warm_program, &stats);
+    expect("edited q", &stats, 10, 3, 1);
+    check_witness(&warm, warm_program, warm_r1cs, values);
+    context_reset(&warm);
+
+    // Commuting a product leaves p the same variable, so nothing that
+    // reads it is recompiled
+    printf("commuted p: ");
+    memcpy(strstr(edited, "s * c"), "c * s", 5);
+    warm_r1cs = compile(&warm, path, edited, &warm_program, &stats);
+    expect("commuted p", &stats, 12, 1, 1);
+    check_witness(&warm, warm_program, warm_r1cs, values);
+    context_reset(&warm);
+
+    // Moving statements (here, a blank line at the top) only shifts locations
+    printf("moved: ");
+    size_t length = strlen(edited);
+    char* moved = malloc(length + 2);
+    moved[0] = '\n';
+    memcpy(moved + 1, edited, length + 1);
+    warm_r1cs = compile(&warm, path, moved, &warm_program, &stats);
+    expect("moved", &stats, 13, 0, 1);
+    if (warm_r1cs->locations[0].line != 7) {
+        printf("FAILED: first constraint at line %d, expected 7\n", warm_r1cs->locations[0].line);
+        failures++;
+    }
+    context_reset(&warm);
+
+    // Reading the unused variable keeps it
+    printf("output unused: ");
+    char* extended = malloc(length + 32);
+    snprintf(extended, length + 32, "%soutput unused\n", edited);
+    warm_r1cs = compile(&warm, path, extended, &warm_program, &stats);
+    expect("output unused", &stats, 13, 1, 0);
+    check_witness(&warm, warm_program, warm_r1cs, values);
+    context_reset(&warm);
+
+    // A damaged byte in the last record's body drops only that record
+    FILE* file = fopen(path, "r+b");
+    fseek(file, -3, SEEK_END);
+    int byte = fgetc(file);
+    fseek(file, -3, SEEK_END);
+    fputc(byte ^ 0x40, file);
+    fclose(file);
+    printf("damaged: ");
+    warm_r1cs = compile(&warm, path, extended, &warm_program, &stats);
+    expect("damaged", &stats, 13, 1, 0);
+    check_witness(&warm, warm_program, warm_r1cs, values);
+    context_reset(&warm);
+
+    // A cache cut off mid-record loses only that record
+    file = fopen(path, "r+b");
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    if (truncate(path, size - 3) != 0) {
+        printf("FAILED: could not truncate %s\n", path);
+        failures++;
+    }
+    printf("truncated: ");
+    warm_r1cs = compile(&warm, path, extended, &warm_program, &stats);
+    expect("truncated", &stats, 13, 1, 0);
+    printf("rewritten: ");
+    warm_r1cs = compile(&warm, path, extended, &warm_program, &stats);
+    expect("rewritten", &stats, 14, 0, 0);
+
+    unlink(path);
+    free(edited);
+    free(moved);
+    free(extended);
+    context_free(&cold);
+    context_free(&warm);
+    if (failures) {
+        printf("%d compile cache checks failed\n", failures);
+        return 1;
+    }
+    printf("All compile cache checks passed!\n");
+    return 0;
+}
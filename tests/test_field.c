@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <string.h>
+#include "../src/math/field.h"
+
+// Expected values computed independently with arbitrary-precision integers
+#define A "123456789012345678901234567890"
+#define B "987654321098765432109876543210"
+#define A_TIMES_B "121932631137021795226185032733622923332237463801111263526900"
+
+static int failures = 0;
+
+// Helper to parse a literal, failing the test on invalid input
+static FieldElement parse(const Field* field, const char* text) {
+    FieldElement e;
+    if (!field_from_string(field, &e, text, strlen(text))) {
+        printf("FAILED: could not parse '%s'\n", text);
+        failures++;
+    }
+    return e;
+}
+
+// Helper to compare an element against its expected decimal value
+static void expect(const Field* field, const char* what, const FieldElement* e, const char* expected) {
+    char buffer[FIELD_DECIMAL_SIZE];
+    field_to_string(field, e, buffer, sizeof(buffer));
+    printf("%s %s = %s\n", field->name, what, buffer);
+    if (strcmp(buffer, expected) != 0) {
+        printf("FAILED: expected %s\n", expected);
+        failures++;
+    }
+}
+
+static void test_field(const Field* field, const char* a_over_b, const char* minus_two, const char* two_255) {
+    FieldElement a = parse(field, A), b = parse(field, B), r;
+
+    field_mul(field, &r, &a, &b);
+    expect(field, "a * b", &r, A_TIMES_B);
+
+    field_inv(field, &r, &b);
+    field_mul(field, &r, &a, &r);
+    expect(field, "a / b", &r, a_over_b);
+
+    FieldElement three, five;
+    field_from_u64(field, &three, 3);
+    field_from_u64(field, &five, 5);
+    field_sub(field, &r, &three, &five);
+    expect(field, "3 - 5", &r, minus_two);
+    field_add(field, &r, &r, &five);
+    expect(field, "3 - 5 + 5", &r, "3");
+
+    // The modulus itself wraps to zero, and hex literals parse like decimal
+    char modulus[FIELD_DECIMAL_SIZE];
+    field_neg(field, &r, &field->one);
+    field_add(field, &r, &r, &field->one);
+    expect(field, "-1 + 1", &r, "0");
+    field_neg(field, &r, &field->one);
+    field_to_string(field, &r, modulus, sizeof(modulus));
+    modulus[strlen(modulus) - 1]++; // p - 1 ends in 6 or 2, so no carry
+    r = parse(field, modulus);
+    expect(field, "p", &r, "0");
+    r = parse(field, "0x8000000000000000000000000000000000000000000000000000000000000000");
+    expect(field, "2^255", &r, two_255);
+
+    // Batch inversion agrees with single inversions and maps zero to zero
+    FieldElement values[5], inverses[5], scratch[5];
+    for (int i = 0; i < 5; i++) field_from_u64(field, &values[i], (uint64_t)i * 1000003);
+    size_t zeros = field_batch_inv(field, inverses, values, 5, scratch);
+    if (zeros != 1 || !field_is_zero(&inverses[0])) {
+        printf("FAILED: batch inversion of zero\n");
+        failures++;
+    }
+    for (int i = 1; i < 5; i++) {
+        field_inv(field, &r, &values[i]);
+        if (!field_equal(&r, &inverses[i])) {
+            printf("FAILED: batch inverse %d differs\n", i);
+            failures++;
+        }
+    }
+    if (field_inv(field, &r, &values[0])) {
+        printf("FAILED: zero was inverted\n");
+        failures++;
+    }
+}
+
+int main() {
+    test_field(&FIELD_BN254,
+               "4385587386376456271236459922521110006472451529826839339253980542172357730977",
+               "21888242871839275222246405745257275088548364400416034343698204186575808495615",
+               "14119558874979547267292681013829403749538263531988213332332383630804947828734");
+    test_field(&FIELD_BLS12_381,
+               "35275400988426393170843532131382492504976292327056669892310128774672708665364",
+               "52435875175126190479447740508185965837690552500527637822603658699938581184511",
+               "5460169443531907232337751996157988088944439832292644197125133304017983635455");
+
+    if (failures) {
+        printf("%d field checks failed\n", failures);
+        return 1;
+    }
+    printf("All field checks passed!\n");
+    return 0;
+}
@@ -8,26 +8,28 @@ int main() {
     printf("Input Code:\n%s\n\n", code);
 
     // Lexical Analysis
-    Token* tokens = tokenize(code);
+    CompilerContext ctx;
+    context_init(&ctx);
+    TokenStream* tokens = tokenize(&ctx, code);
     printf("Tokens:\n");
-    for (int i = 0; tokens[i].type != TOKEN_EOF; i++) {
-        printf("Type: %d, Value: '%s', Line: %d, Column: %d\n",
-               tokens[i].type, tokens[i].value, tokens[i].line, tokens[i].column);
+    for (size_t i = 0; tokens->tokens[i].type != TOKEN_EOF; i++) {
+        const Token* token = &tokens->tokens[i];
+        printf("Type: %d, Value: '%.*s', Line: %d, Column: %d\n",
+               token->type, (int)token->length, token_text(tokens, token), token->line, token->column);
     }
 
     // Parsing
-    ASTNode* ast = parse_tokens(tokens);
+    AST* ast = parse_tokens(&ctx, tokens);
     printf("\nAbstract Syntax Tree:\n");
-    print_ast(ast, 0);
+    print_ast(&ctx, ast, 0);
 
     // Validation
     printf("\nValidating AST...\n");
-    validate_program(ast);
+    validate_program(&ctx, ast);
     printf("Validation successful!\n");
 
     // Free resources
-    free_ast(ast);
-    free_tokens(tokens);
+    context_free(&ctx);
 
     return 0;
     
@@ -1,27 +1,182 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
 #include "../src/frontend/parser.h"
 #include "../src/ir/ir_generator.h"
 #include "../src/ir/optimizer.h"
 
+// Trace sink printing optimizer diagnostics
+static void print_trace(void* user, const char* message) {
+    (void)user;
+    printf("%s\n", message);
+}
+
+// Compiles and optimizes code in a child process, returning its exit status
+static int optimize_in_child(const char* code) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        CompilerContext ctx;
+        context_init(&ctx);
+        optimize_ir(&ctx, generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx, code))));
+        exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
 int main() {
     // Input code (parsed into AST)
-    const char* code = "x = 3 + 6\nassert(x == 8)";
-    Token* tokens = tokenize(code);
-    ASTNode* ast = parse_tokens(tokens);
+    const char* code = "x = 3 + 6\nassert(x == 9)";
+    CompilerContext ctx;
+    context_init(&ctx);
+    ctx.trace = print_trace;
+    TokenStream* tokens = tokenize(&ctx, code);
+    AST* ast = parse_tokens(&ctx, tokens);
 
     // Generate IR
-    IRInstruction* ir = generate_ir(ast);
+    IRProgram* ir = generate_ir(&ctx, ast);
     printf("Generated IR:\n");
-    print_ir(ir);
+    print_ir(&ctx, ir);
 
     // Optimize IR
-    IRInstruction* optimized_ir = optimize_ir(ir);
+    IRProgram* optimized_ir = optimize_ir(&ctx, ir);
     printf("\nOptimized IR:\n");
-    print_ir(optimized_ir);
+    print_ir(&ctx, optimized_ir);
+    for (uint32_t i = 0; i < optimized_ir->count; i++) {
+        if (optimized_ir->instrs[i].op != IR_OP_ASSIGN || !ir_is_const(optimized_ir->instrs[i].src1)) {
+            printf("FAILED: instruction %u was not folded to a constant\n", i);
+            return 1;
+        }
+    }
+
+    // An assertion that folds to false is rejected at compile time
+    printf("\nassert(3 + 6 == 8):\n");
+    if (optimize_in_child("x = 3 + 6\nassert(x == 8)") != 1) {
+        printf("FAILED: false assertion was not rejected\n");
+        return 1;
+    }
+
+    // Arithmetic is over the field: division multiplies by the inverse and
+    // subtraction wraps modulo p
+    context_reset(&ctx);
+    ctx.trace = NULL;
+    optimize_ir(&ctx, generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx,
+        "h = 7 / 2\nassert(h * 2 == 7)\nn = 3 - 5\nassert(n + 5 == 3)"))));
+
+    // Literals are parsed once, by the lexer: decimal and hexadecimal
+    // spellings of a value share a constant, 254-bit values survive intact
+    // and the modulus itself wraps to zero
+    context_reset(&ctx);
+    const char* big = "21888242871839275222246405745257275088548364400416034343698204186575808495616";
+    char source[512], text[96];
+    snprintf(source, sizeof(source),
+             "m = 0x30644e72e131a029b85045b68181585d2833e84879b9709143e1f593f0000001\nq = %s\n"
+             "assert(m == 0)\nassert(q + 1 == m)\nassert(0x10 == 16)", big);
+    tokens = tokenize(&ctx, source);
+    const Token* t = tokens->tokens;
+    if (t[2].constant != t[10].constant || t[22].constant != t[24].constant || ctx.constants.count != 4 ||
+        strcmp(field_to_string(ctx.field, field_pool_get(&ctx.constants, t[5].constant), text, sizeof(text)), big)) {
+        printf("FAILED: literals were not parsed into shared constants\n");
+        return 1;
+    }
+    optimize_ir(&ctx, generate_ir(&ctx, parse_tokens(&ctx, tokens)));
+    printf("\nHexadecimal and 254-bit literals: %u constants\n", ctx.constants.count);
+
+    // SSA structure: repeated literals share a pool entry, repeated
+    // expressions (here the copy of a) are emitted once, and the def->use
+    // indices list every reader of a value
+    context_reset(&ctx);
+    ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx, "a = 2 * 7\nb = a + 1\nc = a * b * 7")));
+    ir_build_uses(&ctx, ir);
+    printf("\nSSA IR (%u instructions, %u constants, %u shared):\n", ir->count, ir->constants.count, ir->hash_consed);
+    print_ir(&ctx, ir);
+    ValueId a = 3, copy = 4; // t0 = 2, t1 = 7, t2 = t0 * t1, a = t2, t3 = a
+    if (ir->constants.count != 3 || ir->instrs[a].name == SYMBOL_NONE || ir->hash_consed != 2 ||
+        ir->use_offsets[a + 1] - ir->use_offsets[a] != 1 || ir->use_offsets[copy + 1] - ir->use_offsets[copy] != 2) {
+        printf("FAILED: unexpected constant pool, sharing or def->use indices\n");
+        return 1;
+    }
+
+    // Value numbering sees through operand order and through rewrites:
+    // after folding, all three products are a * b, and the next round of
+    // passes proves the assertion
+    context_reset(&ctx);
+    ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx,
+        "input a\ninput b\nx = a * b\ny = b * a\nz = (2 * a) * (3 * b)\nassert(x + y == z / 3)\noutput z")));
+    OptimizerReport report;
+    optimize_ir_report(&ctx, ir, &report);
+    printf("\nValue-numbered IR:\n");
+    print_ir(&ctx, ir);
+    print_optimizer_report(&report);
+    uint32_t products = 0, assertions = 0;
+    for (uint32_t i = 0; i < ir->count; i++) {
+        products += ir->instrs[i].op == IR_OP_MUL && !ir_is_const(ir->instrs[i].src1) && !ir_is_const(ir->instrs[i].src2);
+        assertions += ir->instrs[i].op == IR_OP_ASSERT;
+    }
+    if (products != 1 || assertions != 0 || report.hash_consed == 0 || report.passes[5].rewritten == 0) {
+        printf("FAILED: products were not shared\n");
+        return 1;
+    }
+
+    // Constraint-minimizing passes: the copy hiding an asserted equality
+    // goes, (a + 1 - a) * b is just b, and the constant factors of
+    // (3 * a) * (5 * b) come out as one coefficient, leaving a * b to share
+    context_reset(&ctx);
+    ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx,
+        "input a\ninput b\ne = a * b == 5\nassert(e)\nk = (a + 1 - a) * b\nz = (3 * a) * (5 * b)\n"
+        "output k\noutput z")));
+    optimize_ir_report(&ctx, ir, &report);
+    printf("\nConstraint-minimized IR:\n");
+    print_ir(&ctx, ir);
+    print_optimizer_report(&report);
+    products = 0;
+    for (uint32_t i = 0; i < ir->count; i++) {
+        const IRInstruction* instr = &ir->instrs[i];
+        if (instr->op == IR_OP_MUL && !ir_is_const(instr->src1) && !ir_is_const(instr->src2)) {
+            products++;
+            if (ir->instrs[instr->src1].op == IR_OP_MUL || ir->instrs[instr->src2].op == IR_OP_MUL) {
+                printf("FAILED: constant factor left inside a product\n");
+                return 1;
+            }
+        }
+    }
+    // Literals start out as copies, so even 3 * a counts until constants
+    // are propagated; each output costs one
+    if (report.constraints_before != 10 || report.constraints_after != 4 || report.passes[1].constraints_saved != 2 ||
+        report.passes[2].constraints_saved != 1 || report.passes[3].constraints_saved != 2 ||
+        report.passes[5].constraints_saved != 1 || products != 1) {
+        printf("FAILED: unexpected constraint savings\n");
+        return 1;
+    }
+
+    // Dead code: nothing asserted or output depends on unused, w or y * y,
+    // so they go; the unused input c stays part of the circuit's interface
+    context_reset(&ctx);
+    ir = generate_ir(&ctx, parse_tokens(&ctx, tokenize(&ctx,
+        "input a\ninput b\ninput c\nx = a * b\nunused = x * a\ny = x + 1\nw = y * y\noutput y")));
+    optimize_ir_report(&ctx, ir, &report);
+    printf("\nDead-code-eliminated IR:\n");
+    print_ir(&ctx, ir);
+    print_optimizer_report(&report);
+    uint32_t inputs = 0, outputs = 0;
+    products = 0;
+    for (uint32_t i = 0; i < ir->count; i++) {
+        const IRInstruction* instr = &ir->instrs[i];
+        inputs += instr->op == IR_OP_INPUT;
+        outputs += instr->op == IR_OP_OUTPUT;
+        products += instr->op == IR_OP_MUL;
+    }
+    if (report.variables_removed != 2 || report.passes[0].instructions_removed == 0 || inputs != 3 ||
+        outputs != 1 || products != 1) {
+        printf("FAILED: dead code was not removed\n");
+        return 1;
+    }
 
     // Free resources
-    free_ir(ir);
-    free_tokens(tokens);
-    free_ast(ast);
+    context_free(&ctx);
     return 0;
 }
@@ -1,16 +1,109 @@
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
 #include "../src/frontend/lexer.h"
 
+// Compares two token streams field by field
+static int same_tokens(const TokenStream* a, const TokenStream* b) {
+    if (a->count != b->count) return 0;
+    for (size_t i = 0; i < a->count; i++) {
+        const Token* x = &a->tokens[i];
+        const Token* y = &b->tokens[i];
+        if (x->type != y->type || x->offset != y->offset || x->length != y->length || x->symbol != y->symbol ||
+            x->line != y->line || x->column != y->column) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 int main() {
     const char* code = "x = 3 + 5\nassert(x == 8)";
-    Token* tokens = tokenize(code);
+    CompilerContext ctx;
+    context_init(&ctx);
+    TokenStream* tokens = tokenize(&ctx, code);
 
     printf("Tokens:\n");
-    for (int i = 0; tokens[i].type != TOKEN_EOF; i++) {
-        printf("Type: %d, Value: '%s', Line: %d, Column: %d\n",
-               tokens[i].type, tokens[i].value, tokens[i].line, tokens[i].column);
+    for (size_t i = 0; tokens->tokens[i].type != TOKEN_EOF; i++) {
+        const Token* token = &tokens->tokens[i];
+        printf("Type: %d, Value: '%.*s', Line: %d, Column: %d\n",
+               token->type, (int)token->length, token_text(tokens, token), token->line, token->column);
+    }
+
+    // Both occurrences of 'x' share one interned symbol
+    if (tokens->tokens[0].symbol != tokens->tokens[7].symbol) {
+        printf("FAILED: identifier 'x' was interned twice\n");
+        return 1;
+    }
+
+    context_reset(&ctx); // Release the tokens after use
+
+    // A program far larger than the initial token capacity
+    const int statements = 10000;
+    size_t size = (size_t)statements * 32;
+    char* big = malloc(size);
+    size_t used = 0;
+    for (int i = 0; i < statements; i++) {
+        used += snprintf(big + used, size - used, "v%d = %d * (v%d + 1)\n", i, i, i);
+    }
+    tokens = tokenize_buffer(&ctx, big, used);
+    printf("\nLarge input: %zu bytes, %zu tokens\n", used, tokens->count);
+    if (tokens->count != (size_t)statements * 9 + 1 ||
+        tokens->tokens[tokens->count - 1].type != TOKEN_EOF ||
+        tokens->tokens[tokens->count - 2].line != statements) {
+        printf("FAILED: unexpected token count or position\n");
+        return 1;
+    }
+    context_reset(&ctx);
+    free(big);
+
+    // Keywords only match whole words
+    tokens = tokenize(&ctx, "inputs input assert1 assert publicx public output outputs");
+    TokenType expected[] = {TOKEN_IDENTIFIER, TOKEN_KEYWORD_INPUT, TOKEN_IDENTIFIER, TOKEN_KEYWORD_ASSERT,
+                            TOKEN_IDENTIFIER, TOKEN_KEYWORD_PUBLIC, TOKEN_KEYWORD_OUTPUT, TOKEN_IDENTIFIER, TOKEN_EOF};
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        if (tokens->tokens[i].type != expected[i]) {
+            printf("FAILED: token %zu has type %d, expected %d\n", i, tokens->tokens[i].type, expected[i]);
+            return 1;
+        }
+    }
+    context_reset(&ctx);
+
+    // Every classifier the CPU supports yields the same tokens, with runs
+    // crossing block boundaries and the input ending mid-block
+    size_t mixed_size = 1 << 16;
+    char* mixed = malloc(mixed_size);
+    used = 0;
+    for (int i = 0; used + 128 < mixed_size; i++) {
+        used += snprintf(mixed + used, mixed_size - used, "%*s%s%d\t=\r%0*d +%s(%d)==x%d\n", i % 37, "",
+                         i % 5 ? "input" : "assert", i, i % 61 + 1, i, i % 3 ? " " : "", i * 7919, i);
+    }
+    lexer_use_scan(LEXER_SCAN_SCALAR);
+    TokenStream* reference = tokenize_buffer(&ctx, mixed, used);
+    const LexerScan scans[] = {LEXER_SCAN_SSE2, LEXER_SCAN_AVX2};
+    for (size_t i = 0; i < sizeof(scans) / sizeof(scans[0]); i++) {
+        if (!lexer_use_scan(scans[i])) continue;
+        for (size_t cut = used - 130; cut <= used; cut++) {
+            TokenStream* scalar = cut == used ? reference : NULL;
+            if (!scalar) {
+                lexer_use_scan(LEXER_SCAN_SCALAR);
+                scalar = tokenize_buffer(&ctx, mixed, cut);
+                lexer_use_scan(scans[i]);
+            }
+            if (!same_tokens(scalar, tokenize_buffer(&ctx, mixed, cut))) {
+                printf("FAILED: %s tokens differ from scalar tokens on %zu bytes\n", lexer_scan_name(), cut);
+                return 1;
+            }
+        }
+        printf("%s scan matches scalar scan on %zu tokens\n", lexer_scan_name(), reference->count);
     }
+    lexer_use_scan(LEXER_SCAN_AUTO);
+    context_reset(&ctx);
+    free(mixed);
 
-    free_tokens(tokens); // Free the tokens after use
+    // Memory-mapped source file
+    tokens = tokenize_file(&ctx, "examples/example1.zkl");
+    printf("examples/example1.zkl: %zu tokens\n", tokens->count);
+    context_free(&ctx);
     return 0;
 }
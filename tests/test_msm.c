@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/backend/proof_generator.h"
+
+static int failures = 0;
+
+// Helper to report one check
+static void check(const char* what, int ok) {
+    printf("%s: %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// Helper to compare two Jacobian points of either group
+static int same_point(const CurveGroup* group, const void* p, const void* q) {
+    return group == &CURVE_G1 ? g1_equal((const G1Jacobian*)p, (const G1Jacobian*)q)
+                              : g2_equal((const G2Jacobian*)p, (const G2Jacobian*)q);
+}
+
+// Helper to make a pseudo-random scalar of full width
+static FieldElement random_scalar(uint64_t* state) {
+    FieldElement scalar, limb, shift;
+    field_from_u64(&FIELD_BN254, &scalar, 0);
+    field_from_u64(&FIELD_BN254, &shift, 1);
+    for (int k = 0; k < 64; k++) field_add(&FIELD_BN254, &shift, &shift, &shift);  // 2^64
+    for (int k = 0; k < FIELD_LIMBS; k++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        field_from_u64(&FIELD_BN254, &limb, *state);
+        field_mul(&FIELD_BN254, &scalar, &scalar, &shift);
+        field_add(&FIELD_BN254, &scalar, &scalar, &limb);
+    }
+    return scalar;
+}
+
+// Helper to make n affine points with repeats, opposite pairs and points
+// at infinity among them: multiples of the generator up to 13
+static void* make_points(const CurveGroup* group, size_t n) {
+    size_t size = group->affine_size;
+    unsigned char* multiples = (unsigned char*)malloc(13 * size);
+    unsigned char* points = (unsigned char*)malloc(n * size);
+    if (group == &CURVE_G1) {
+        G1Jacobian jacobian[13];
+        FieldElement scratch[26];
+        g1_from_affine(&jacobian[0], &G1_GENERATOR);
+        for (int k = 1; k < 13; k++) g1_add_mixed(&jacobian[k], &jacobian[k - 1], &G1_GENERATOR);
+        g1_batch_to_affine((G1Affine*)multiples, jacobian, 13, scratch);
+    } else {
+        G2Jacobian jacobian[13];
+        Fq2 scratch[26];
+        g2_from_affine(&jacobian[0], &G2_GENERATOR);
+        for (int k = 1; k < 13; k++) g2_add_mixed(&jacobian[k], &jacobian[k - 1], &G2_GENERATOR);
+        g2_batch_to_affine((G2Affine*)multiples, jacobian, 13, scratch);
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (i % 11 == 5) memset(points + i * size, 0, size);
+        else if (i % 17 == 3 && i > 0) group->neg_affine(points + i * size, points + (i - 1) * size);
+        else memcpy(points + i * size, multiples + (i * 7 % 13) * size, size);
+    }
+    free(multiples);
+    return points;
+}
+
+// Helper to check msm against the naive sum
+static void check_msm(const CurveGroup* group, ThreadPool* pool, size_t n, int window, int equal_scalars) {
+    void* points = make_points(group, n);
+    FieldElement* scalars = (FieldElement*)malloc(n * sizeof(FieldElement));
+    uint64_t state = 0x9e3779b97f4a7c15ull + n;
+    FieldElement same = random_scalar(&state);
+    for (size_t i = 0; i < n; i++) {
+        if (equal_scalars) scalars[i] = same;
+        else if (i % 9 == 0) field_from_u64(&FIELD_BN254, &scalars[i], 0);
+        else if (i % 9 == 1) field_neg(&FIELD_BN254, &scalars[i], &FIELD_BN254.one);
+        else if (i % 9 == 2) scalars[i] = FIELD_BN254.one;
+        else scalars[i] = random_scalar(&state);
+    }
+    G2Jacobian fast, slow;  // Large enough for either group
+    msm(group, pool, &fast, points, scalars, n, window);
+    msm_naive(group, &slow, points, scalars, n);
+
+    char what[96];
+    snprintf(what, sizeof(what), "%s msm of %zu points, window %d%s", group->name, n,
+             window ? window : msm_window_size(n), equal_scalars ? ", equal scalars" : "");
+    check(what, same_point(group, &fast, &slow));
+    free(points);
+    free(scalars);
+}
+
+int main() {
+    ThreadPool* pool = thread_pool_create(4);
+    uint64_t order[FIELD_LIMBS];
+    memcpy(order, FIELD_BN254.modulus, sizeof(order));
+
+    // The generators lie on their curves and have the scalar field's order
+    G1Jacobian g1, a1, b1, c1;
+    g1_from_affine(&g1, &G1_GENERATOR);
+    check("g1 generator on curve", g1_is_on_curve(&G1_GENERATOR));
+    g1_mul(&a1, &g1, order);
+    check("g1 r * G is infinity", field_is_zero(&a1.z));
+    G2Jacobian g2, a2, b2, c2;
+    g2_from_affine(&g2, &G2_GENERATOR);
+    check("g2 generator on curve", g2_is_on_curve(&G2_GENERATOR));
+    g2_mul(&a2, &g2, order);
+    check("g2 r * G is infinity", fq2_is_zero(&a2.z));
+
+    // Doubling, addition and mixed addition agree; scalars distribute
+    g1_double(&a1, &g1);
+    g1_add(&b1, &g1, &g1);
+    g1_add_mixed(&c1, &g1, &G1_GENERATOR);
+    check("g1 2G three ways", g1_equal(&a1, &b1) && g1_equal(&a1, &c1));
+    g2_double(&a2, &g2);
+    g2_add(&b2, &g2, &g2);
+    g2_add_mixed(&c2, &g2, &G2_GENERATOR);
+    check("g2 2G three ways", g2_equal(&a2, &b2) && g2_equal(&a2, &c2));
+
+    uint64_t a[FIELD_LIMBS] = {123456789, 0, 0, 1}, b[FIELD_LIMBS] = {987654321, 5, 0, 0};
+    uint64_t sum[FIELD_LIMBS] = {123456789 + 987654321, 5, 0, 1};
+    G1Affine affine1;
+    g1_mul(&a1, &g1, a);
+    g1_mul(&b1, &g1, b);
+    g1_add(&a1, &a1, &b1);
+    g1_mul(&c1, &g1, sum);
+    g1_to_affine(&affine1, &c1);
+    check("g1 (a + b)G = aG + bG", g1_equal(&a1, &c1) && g1_is_on_curve(&affine1));
+    G2Affine affine2;
+    g2_mul(&a2, &g2, a);
+    g2_mul(&b2, &g2, b);
+    g2_add(&a2, &a2, &b2);
+    g2_mul(&c2, &g2, sum);
+    g2_to_affine(&affine2, &c2);
+    check("g2 (a + b)G = aG + bG", g2_equal(&a2, &c2) && g2_is_on_curve(&affine2));
+
+    // P + (-P) and P + P through the batched affine addition
+    G1Affine x = G1_GENERATOR, y = G1_GENERATOR, z = G1_GENERATOR, minus;
+    g1_neg_affine(&minus, &G1_GENERATOR);
+    G1Affine* sums[3] = {&x, &y, &z};
+    const G1Affine* terms[3] = {&minus, &G1_GENERATOR, &affine1};
+    FieldElement scratch[6];
+    g1_batch_add_affine(sums, terms, 3, scratch);
+    g1_from_affine(&b1, &y);
+    g1_add_mixed(&c1, &g1, &affine1);
+    g1_from_affine(&a1, &z);
+    check("g1 batch affine addition", g1_is_infinity(&x) && g1_is_on_curve(&z) && g1_equal(&a1, &c1));
+    g1_double(&c1, &g1);
+    check("g1 batch affine doubling", g1_equal(&b1, &c1));
+
+    // msm matches the naive sum for small and odd sizes and all windows
+    check_msm(&CURVE_G1, pool, 0, 0, 0);
+    check_msm(&CURVE_G1, pool, 1, 0, 0);
+    check_msm(&CURVE_G1, pool, 40, 2, 0);
+    check_msm(&CURVE_G1, pool, 300, 0, 0);
+    check_msm(&CURVE_G1, pool, 300, 5, 0);
+    check_msm(&CURVE_G1, pool, 300, 8, 1);
+    check_msm(&CURVE_G1, pool, 1000, 11, 0);
+    check_msm(&CURVE_G2, pool, 1, 0, 0);
+    check_msm(&CURVE_G2, pool, 100, 3, 0);
+    check_msm(&CURVE_G2, pool, 100, 6, 1);
+    check_msm(&CURVE_G2, pool, 200, 0, 0);
+    thread_pool_destroy(pool);
+
+    // A wide pool splits each window into chunks of points
+    pool = thread_pool_create(16);
+    check_msm(&CURVE_G1, pool, 2000, 8, 0);
+    check_msm(&CURVE_G2, pool, 600, 6, 0);
+    thread_pool_destroy(pool);
+
+    if (failures) {
+        printf("%d msm checks failed\n", failures);
+        return 1;
+    }
+    printf("All msm checks passed!\n");
+    return 0;
+}
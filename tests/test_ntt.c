@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/math/ntt.h"
+
+static int failures = 0;
+
+// Helper to report one check
+static void check(const char* what, int ok) {
+    printf("%s: %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// Helper to evaluate a polynomial at x with Horner's rule
+static FieldElement evaluate(const Field* field, const FieldElement* coefficients, size_t n, const FieldElement* x) {
+    FieldElement sum = {{0}};
+    for (size_t j = n; j-- > 0;) {
+        field_mul(field, &sum, &sum, x);
+        field_add(field, &sum, &sum, &coefficients[j]);
+    }
+    return sum;
+}
+
+// Helper to fill n pseudo-random elements
+static void fill(const Field* field, FieldElement* values, size_t n, uint64_t seed) {
+    for (size_t i = 0; i < n; i++) {
+        field_from_u64(field, &values[i], seed + i * 0x9E3779B97F4A7C15ull);
+        field_mul(field, &values[i], &values[i], &values[i]); // Spread values over the whole field
+    }
+}
+
+// Helper to compare a transform of f against evaluations at shift * w^i
+// for the given indices, or all of them (a naive DFT) when every is 1
+static int matches(const NttDomain* domain, const FieldElement* f, const FieldElement* values,
+                   const FieldElement* shift, size_t every) {
+    const Field* field = domain->field;
+    for (size_t i = 0; i < domain->size; i += every) {
+        uint64_t exponent[FIELD_LIMBS] = {i, 0, 0, 0};
+        FieldElement x;
+        field_pow(field, &x, &domain->root, exponent);
+        field_mul(field, &x, &x, shift);
+        FieldElement expected = evaluate(field, f, domain->size, &x);
+        if (!field_equal(&expected, &values[i])) return 0;
+    }
+    return 1;
+}
+
+// Helper to check all four transforms of one domain
+static void check_domain(const Field* field, ThreadPool* pool, uint32_t log_size, int block_log, size_t every) {
+    NttDomain* domain = ntt_domain_create(field, log_size);
+    if (block_log >= 0) domain->block_log = block_log;
+    size_t n = domain->size;
+    FieldElement* f = (FieldElement*)malloc(n * sizeof(FieldElement));
+    FieldElement* values = (FieldElement*)malloc(n * sizeof(FieldElement));
+    fill(field, f, n, log_size + 1);
+
+    // w has order exactly n
+    FieldElement t = domain->root;
+    for (uint32_t k = 0; k < log_size; k++) field_sqr(field, &t, &t);
+    int ok = field_equal(&t, &field->one);
+    if (log_size > 0) {
+        t = domain->root;
+        for (uint32_t k = 1; k < log_size; k++) field_sqr(field, &t, &t);
+        ok = ok && !field_equal(&t, &field->one);
+    }
+
+    memcpy(values, f, n * sizeof(FieldElement));
+    ntt_forward(domain, pool, values);
+    ok = ok && matches(domain, f, values, &field->one, every);
+    ntt_inverse(domain, pool, values);
+    ok = ok && memcmp(values, f, n * sizeof(FieldElement)) == 0;
+
+    ntt_coset_forward(domain, pool, values);
+    ok = ok && matches(domain, f, values, &domain->coset_shift, every);
+    ntt_coset_inverse(domain, pool, values);
+    ok = ok && memcmp(values, f, n * sizeof(FieldElement)) == 0;
+
+    char what[96];
+    snprintf(what, sizeof(what), "%s 2^%u%s", field->name, log_size,
+             (int)log_size > domain->block_log ? " four-step" : "");
+    check(what, ok);
+    free(f);
+    free(values);
+    ntt_domain_free(domain);
+}
+
+int main() {
+    ThreadPool* pool = thread_pool_create(4);
+
+    // Against a naive DFT: every size up to 2^9, odd and even stage counts
+    for (uint32_t log_size = 0; log_size <= 9; log_size++) check_domain(&FIELD_BN254, pool, log_size, -1, 1);
+    check_domain(&FIELD_BLS12_381, pool, 7, -1, 1);
+    check_domain(&FIELD_BLS12_381, pool, 8, -1, 1);
+
+    // The four-step layout, forced onto small square and oblong matrices
+    check_domain(&FIELD_BN254, pool, 8, 2, 1);
+    check_domain(&FIELD_BN254, pool, 9, 2, 1);
+    check_domain(&FIELD_BLS12_381, pool, 7, 3, 1);
+
+    // The default four-step threshold, checked at every 4099th point
+    check_domain(&FIELD_BN254, pool, NTT_BLOCK_LOG + 1, -1, 4099);
+
+    // Domains beyond the field's two-adicity (2^28 for BN254) are refused
+    NttDomain* domain = ntt_domain_create(&FIELD_BN254, 29);
+    check("bn254 2^29 refused", domain == NULL);
+    check("ntt_log_size", ntt_log_size(1) == 0 && ntt_log_size(2) == 1 && ntt_log_size(1000) == 10 &&
+          ntt_log_size(1024) == 10 && ntt_log_size(1025) == 11);
+
+    thread_pool_destroy(pool);
+    if (failures) {
+        printf("%d ntt checks failed\n", failures);
+        return 1;
+    }
+    printf("All ntt checks passed!\n");
+    return 0;
+}
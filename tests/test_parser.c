@@ -1,18 +1,83 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "../src/frontend/lexer.h"
 #include "../src/frontend/parser.h"
+#include "../src/frontend/validator.h"
+#include "../src/ir/ir_generator.h"
 
-
+// Parses code and prints its AST
+static void show(CompilerContext* ctx, const char* code) {
+    TokenStream* tokens = tokenize(ctx, code);
+    AST* ast = parse_tokens(ctx, tokens);
+    printf("%s\n", code);
+    print_ast(ctx, ast, 0);
+    printf("\n");
+}
 
 int main() {
     const char* code = "x = 3 + 5\nassert(x == 8)";
-    Token* tokens = tokenize(code);
+    CompilerContext ctx;
+    context_init(&ctx);
+    TokenStream* tokens = tokenize(&ctx, code);
 
-    ASTNode* ast = parse_tokens(tokens);
+    AST* ast = parse_tokens(&ctx, tokens);
     printf("Abstract Syntax Tree:\n");
-    print_ast(ast, 0);
+    print_ast(&ctx, ast, 0);
+
+    // Precedence and associativity
+    printf("\nPrecedence:\n");
+    show(&ctx, "y = 1 + 2 * 3 - 4 / 2");
+    show(&ctx, "assert(1 + 2 == (3 - 0) * 1)");
+
+    // Nodes are laid out in post-order, operands before their operators
+    ast = parse_tokens(&ctx, tokenize(&ctx, "y = 1 + 2 * 3 - 4 / 2"));
+    NodeId root = ast_right(ast, ast->statements[0]);
+    if (ast->count != 10 || root != 8 || ast->ops[root] != AST_OP_SUB || ast->ops[ast->left[root]] != AST_OP_ADD ||
+        ast->ops[ast_right(ast, root)] != AST_OP_DIV || ast->ops[ast->left[ast->left[root]]] != AST_OP_NONE ||
+        ast_line(ast, root) != 1 || ast_column(ast, root) != 15) {
+        printf("FAILED: unexpected AST layout\n");
+        return 1;
+    }
+
+    // Pathological nesting: a million parentheses around one literal
+    const int depth = 1000000;
+    char* nested = malloc(depth * 2 + 16);
+    size_t used = sprintf(nested, "z = ");
+    memset(nested + used, '(', depth);
+    used += depth;
+    nested[used++] = '7';
+    memset(nested + used, ')', depth);
+    used += depth;
+    nested[used] = '\0';
+    ast = parse_tokens(&ctx, tokenize(&ctx, nested));
+    if (ast->count != 2 || ast->statement_count != 1 || ast_kind(ast, ast->statements[0]) != AST_ASSIGNMENT ||
+        ast_kind(ast, ast_right(ast, ast->statements[0])) != AST_LITERAL) {
+        printf("FAILED: nested parentheses did not collapse to a literal\n");
+        return 1;
+    }
+    printf("Parsed %d nested parentheses\n", depth);
+
+    // Pathological nesting of operators: 1 + (1 + (1 + ... ))
+    const int chain = 200000;
+    char* right_nested = malloc(chain * 6 + 16);
+    used = sprintf(right_nested, "w = ");
+    for (int i = 0; i < chain; i++) used += sprintf(right_nested + used, "1 + (");
+    right_nested[used++] = '1';
+    memset(right_nested + used, ')', chain);
+    right_nested[used + chain] = '\0';
+    ast = parse_tokens(&ctx, tokenize(&ctx, right_nested));
+    validate_program(&ctx, ast);
+    size_t instructions = generate_ir(&ctx, ast)->count;
+    // One addition per level; every literal 1 shares a single copy
+    if (instructions != (size_t)chain + 2) {
+        printf("FAILED: expected %d IR instructions, got %zu\n", chain + 2, instructions);
+        return 1;
+    }
+    printf("Parsed, validated and lowered a %d-deep operator chain\n", chain);
 
-    free_ast(ast);
-    free_tokens(tokens);
+    free(nested);
+    free(right_nested);
+    context_free(&ctx);
     return 0;
 }
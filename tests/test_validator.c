@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../src/frontend/lexer.h"
+#include "../src/frontend/parser.h"
+#include "../src/frontend/validator.h"
+
+// Validates code in a child process and returns its exit status, so that
+// programs the validator rejects (with exit(1)) can be tested too
+static int validate_in_child(const char* code) {
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        CompilerContext ctx;
+        context_init(&ctx);
+        TokenStream* tokens = tokenize(&ctx, code);
+        validate_program(&ctx, parse_tokens(&ctx, tokens));
+        context_free(&ctx);
+        exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+int main() {
+    struct {
+        const char* code;
+        int expected;
+    } cases[] = {
+        {"x = 3 + 5\nassert(x == 8)", 0},
+        {"a = 1\nb = a * 2\nc = b + a\nassert(c == 3)", 0},
+        {"a = 1\nb = c + a", 1},        // Undefined variable in a later statement
+        {"a = 1\nb = 2\na = b", 1},     // Redefinition
+        {"a = a + 1", 1},               // Use before definition
+        {"input a\nb = a * a\noutput b", 0},
+        {"input a\noutput c", 1},       // Output of an undefined variable
+        {"input a\noutput a\noutput a", 1}, // Output declared twice
+    };
+
+    int failures = 0;
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("Validating:\n%s\n", cases[i].code);
+        int status = validate_in_child(cases[i].code);
+        printf("-> exit status %d (expected %d)\n\n", status, cases[i].expected);
+        if (status != cases[i].expected) failures++;
+    }
+
+    if (failures) {
+        printf("FAILED: %d case(s)\n", failures);
+        return 1;
+    }
+    printf("All validator cases passed!\n");
+    return 0;
+}
@@ -0,0 +1,141 @@
+#include <setjmp.h>
+#include <string.h>
+#include "example_circuit.h"
+
+static int failures = 0;
+
+// Helper to report one check
+static void check(const char* what, int ok) {
+    printf("%s: %s\n", what, ok ? "ok" : "FAILED");
+    if (!ok) failures++;
+}
+
+// Helper to multiply the generators by small integers
+static G1Affine g1_small(uint64_t k) {
+    uint64_t scalar[FIELD_LIMBS] = {k, 0, 0, 0};
+    G1Jacobian p;
+    G1Affine out;
+    g1_from_affine(&p, &G1_GENERATOR);
+    g1_mul(&p, &p, scalar);
+    g1_to_affine(&out, &p);
+    return out;
+}
+
+static G2Affine g2_small(uint64_t k) {
+    uint64_t scalar[FIELD_LIMBS] = {k, 0, 0, 0};
+    G2Jacobian p;
+    G2Affine out;
+    g2_from_affine(&p, &G2_GENERATOR);
+    g2_mul(&p, &p, scalar);
+    g2_to_affine(&out, &p);
+    return out;
+}
+
+static void check_pairing(void) {
+    Fq12 e, e_ab, expected, t;
+    G1Affine p = g1_small(1), p6 = g1_small(6), minus_p6;
+    G2Affine q = g2_small(1), q7 = g2_small(7);
+    pairing(&e, &p, &q);
+    check("e(P, Q) != 1", !fq12_is_one(&e));
+    fq12_pow(&t, &e, FIELD_BN254.modulus, FIELD_LIMBS);
+    check("e(P, Q)^r == 1", fq12_is_one(&t));
+
+    // e(6P, 7Q) = e(P, Q)^42 = e(42P, Q)
+    uint64_t exponent = 42;
+    pairing(&e_ab, &p6, &q7);
+    fq12_pow(&expected, &e, &exponent, 1);
+    check("e(6P, 7Q) == e(P, Q)^42", fq12_equal(&e_ab, &expected));
+    G1Affine p42 = g1_small(42);
+    pairing(&expected, &p42, &q);
+    check("e(6P, 7Q) == e(42P, Q)", fq12_equal(&e_ab, &expected));
+
+    // A shared Miller loop with one final exponentiation: e(6P, 7Q) e(-6P, 7Q) = 1
+    G2Prepared prepared;
+    pairing_prepare(&prepared, &q7);
+    g1_neg_affine(&minus_p6, &p6);
+    G1Affine points[2] = {p6, minus_p6};
+    const G2Prepared* lines[2] = {&prepared, &prepared};
+    pairing_miller_loop(&e, points, lines, 2);
+    pairing_final_exponentiation(&e, &e);
+    check("e(6P, 7Q) e(-6P, 7Q) == 1", fq12_is_one(&e));
+}
+
+int main() {
+    check_pairing();
+
+    CompilerContext ctx;
+    context_init(&ctx);
+    Groth16Trapdoor trapdoor;
+    FieldElement ic_scalars[EXAMPLE_PUBLIC_COUNT + 1];
+    VerifyingKey* key = example_setup(&ctx, &trapdoor, ic_scalars);
+
+    enum { PROOFS = 5 };
+    Groth16Proof proofs[PROOFS];
+    FieldElement inputs[PROOFS][EXAMPLE_PUBLIC_COUNT];
+    for (int k = 0; k < PROOFS; k++) {
+        example_inputs(inputs[k], 3 + k, 11 * k + 1);
+        groth16_simulate_proof(&trapdoor, ic_scalars, EXAMPLE_PUBLIC_COUNT, inputs[k], k, &proofs[k]);
+    }
+
+    // The generic verifier
+    check("generic: valid proof", groth16_verify(key, &proofs[0], inputs[0]));
+    check("generic: inputs of another proof", !groth16_verify(key, &proofs[0], inputs[1]));
+    Groth16Proof forged = proofs[0];
+    forged.c = proofs[1].c;
+    check("generic: forged proof", !groth16_verify(key, &forged, inputs[0]));
+    forged = proofs[0];
+    field_add(&FIELD_BN254_BASE, &forged.a.y, &forged.a.y, &FIELD_BN254_BASE.one);
+    check("generic: point off the curve", !groth16_verify(key, &forged, inputs[0]));
+
+    // Prepared with ic tables, and the generated verifier
+    PreparedVerifyingKey* prepared = malloc(sizeof(PreparedVerifyingKey));
+    G1Affine* tables = malloc(sizeof(G1Affine) * (EXAMPLE_PUBLIC_COUNT + 1) * VERIFIER_TABLE_SIZE);
+    groth16_prepare_verifying_key(prepared, key, tables);
+    int all = 1, generated = 1;
+    for (int k = 0; k < PROOFS; k++) {
+        all &= groth16_verify_prepared(prepared, &proofs[k], inputs[k]);
+        generated &= example_verify(&proofs[k], inputs[k]);
+    }
+    check("prepared: valid proofs", all);
+    check("prepared: inputs of another proof", !groth16_verify_prepared(prepared, &proofs[1], inputs[2]));
+    check("generated: valid proofs", generated);
+    check("generated: inputs of another proof", !example_verify(&proofs[2], inputs[3]));
+    check("generated: forged proof", !example_verify(&forged, inputs[0]));
+
+    // Batches, where one bad proof spoils the batch
+    check("batch: valid proofs", example_verify_batch(proofs, inputs[0], PROOFS));
+    check("batch: empty", example_verify_batch(proofs, inputs[0], 0));
+    check("batch: prepared key", groth16_verify_batch(prepared, proofs, inputs[0], PROOFS));
+    FieldElement swapped[PROOFS][EXAMPLE_PUBLIC_COUNT];
+    memcpy(swapped, inputs, sizeof(inputs));
+    swapped[3][2] = inputs[4][2];
+    check("batch: wrong input", !example_verify_batch(proofs, swapped[0], PROOFS));
+    Groth16Proof mixed[PROOFS];
+    memcpy(mixed, proofs, sizeof(proofs));
+    mixed[1].b = proofs[2].b;
+    check("batch: forged proof", !example_verify_batch(mixed, inputs[0], PROOFS));
+
+    // A circuit over another field has no key on BN254
+    context_reset(&ctx);
+    ctx.field = &FIELD_BLS12_381;
+    jmp_buf jump;
+    int rejected = setjmp(jump) != 0;
+    if (!rejected) {
+        ctx.error_jump = &jump;
+        Groth16Trapdoor other;
+        example_setup(&ctx, &other, NULL);
+    }
+    ctx.error_jump = NULL;
+    check("setup: circuit over bls12-381", rejected && ctx.diagnostic_count == 1 &&
+                                           strstr(ctx.diagnostics[0].message, "bn254"));
+
+    free(tables);
+    free(prepared);
+    context_free(&ctx);
+    if (failures) {
+        printf("%d verifier checks failed\n", failures);
+        return 1;
+    }
+    printf("All verifier checks passed!\n");
+    return 0;
+}
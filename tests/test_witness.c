@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../src/frontend/validator.h"
+#include "../src/ir/optimizer.h"
+#include "../src/backend/witness_generator.h"
+#include "r1cs_eval.h"
+
+#define BATCH 100
+
+static int failures = 0;
+
+// Helper to compile source text to a witness plan
+static WitnessPlan* plan(CompilerContext* ctx, const char* code) {
+    AST* ast = parse_tokens(ctx, tokenize(ctx, code));
+    validate_program(ctx, ast);
+    IRProgram* ir = generate_ir(ctx, ast);
+    optimize_ir(ctx, ir);
+    return witness_plan_create(ctx, ir, compile_constraints(ctx, ir));
+}
+
+// Helper to count the constraints a witness violates
+static int violated(const CompilerContext* ctx, const R1CS* r1cs, const FieldElement* witness) {
+    int count = 0;
+    for (uint32_t row = 0; row < r1cs->constraint_count; row++) {
+        FieldElement a = dot(ctx->field, r1cs, &r1cs->a, row, witness);
+        FieldElement b = dot(ctx->field, r1cs, &r1cs->b, row, witness);
+        FieldElement c = dot(ctx->field, r1cs, &r1cs->c, row, witness);
+        field_mul(ctx->field, &a, &a, &b);
+        if (!field_equal(&a, &c)) count++;
+    }
+    return count;
+}
+
+// Helper to run a batch on a pool and compare it against one-at-a-time
+// generation; returns the batch's failures array (caller frees)
+static uint32_t* run_batch(const CompilerContext* ctx, const WitnessPlan* p, ThreadPool* pool,
+                           const FieldElement* inputs, uint32_t count, uint32_t expect_failed) {
+    uint32_t width = p->r1cs->variable_count;
+    FieldElement* witnesses = calloc((size_t)count * width, sizeof(FieldElement));
+    FieldElement* single = calloc(width, sizeof(FieldElement));
+    FieldElement* scratch = malloc(sizeof(FieldElement) * witness_scratch_size(p));
+    uint32_t* result = malloc(sizeof(uint32_t) * count);
+
+    uint32_t failed = witness_generate_batch(ctx, p, pool, inputs, count, witnesses, result);
+    printf("%u of %u assignments failed\n", failed, count);
+    if (failed != expect_failed) {
+        printf("FAILED: expected %u failures\n", expect_failed);
+        failures++;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t status = witness_generate(ctx, p, inputs + (size_t)i * p->input_count, single, scratch);
+        if (status != result[i]) {
+            printf("FAILED: assignment %u differs from single generation\n", i);
+            failures++;
+        } else if (status == WITNESS_OK) {
+            if (memcmp(single, witnesses + (size_t)i * width, sizeof(FieldElement) * width) != 0 ||
+                violated(ctx, p->r1cs, single) != 0) {
+                printf("FAILED: witness %u does not satisfy the constraints\n", i);
+                failures++;
+            }
+        }
+    }
+    free(witnesses);
+    free(single);
+    free(scratch);
+    return result;
+}
+
+int main() {
+    CompilerContext ctx;
+    context_init(&ctx);
+    ThreadPool* pool = thread_pool_create(4);
+
+    // z = x^2 + 3x - y must be 5, and x must not be zero. Inputs are
+    // (y, x) since public inputs come first.
+    WitnessPlan* p = plan(&ctx, "public y\ninput x\nz = x * x + 3 * x - y\nassert(z == 5)\nq = 10 / x");
+    printf("polynomial: %u inputs, %u steps, %u slots\n", p->input_count, p->step_count, p->slot_count);
+    FieldElement inputs[BATCH * 2];
+    for (uint32_t i = 0; i < BATCH; i++) {
+        FieldElement five;
+        field_from_u64(ctx.field, &five, 5);
+        field_from_u64(ctx.field, &inputs[2 * i + 1], i);
+        field_from_u64(ctx.field, &inputs[2 * i], (uint64_t)i * i + 3 * i);
+        field_sub(ctx.field, &inputs[2 * i], &inputs[2 * i], &five);
+    }
+    // Assignment 0 has x = 0 (so y = p - 5): division by zero. Assignment
+    // 7 gets a wrong y: the assertion fails.
+    field_from_u64(ctx.field, &inputs[2 * 7], 1);
+    uint32_t* result = run_batch(&ctx, p, pool, inputs, BATCH, 2);
+    print_witness_failures(p, result, BATCH);
+    if (result[0] == WITNESS_OK || p->program->instrs[result[0]].op != IR_OP_DIV ||
+        result[7] == WITNESS_OK || p->program->instrs[result[7]].op != IR_OP_ASSERT ||
+        p->program->locations[result[7]].line != 4) {
+        printf("FAILED: failure positions\n");
+        failures++;
+    }
+    free(result);
+    context_reset(&ctx);
+
+    // An equality used as a value and an asserted plain value both need
+    // inverse helper variables
+    p = plan(&ctx, "input a\ninput c\nb = a == 3\nassert(c)\nd = b + c\noutput d");
+    printf("\nequality: %u inverses\n", p->inverse_count);
+    if (p->inverse_count != 2) {
+        printf("FAILED: expected 2 inverses\n");
+        failures++;
+    }
+    for (uint32_t i = 0; i < BATCH; i++) {
+        field_from_u64(ctx.field, &inputs[2 * i], i % 5);
+        field_from_u64(ctx.field, &inputs[2 * i + 1], i % 3);
+    }
+    free(run_batch(&ctx, p, pool, inputs, BATCH, (BATCH + 2) / 3));
+    context_reset(&ctx);
+
+    // More workers than assignments
+    p = plan(&ctx, "input a\nb = a * a\noutput b");
+    free(run_batch(&ctx, p, pool, inputs, 3, 0));
+    context_reset(&ctx);
+
+    thread_pool_destroy(pool);
+    context_free(&ctx);
+    if (failures) {
+        printf("%d witness checks failed\n", failures);
+        return 1;
+    }
+    printf("All witness checks passed!\n");
+    return 0;
+}